@@ -0,0 +1,97 @@
+#include <chrono>
+#include <core/vk.h>
+#include <iostream>
+
+using namespace circe::vk;
+
+// Compares the cost of writing descriptor sets through
+// vkUpdateDescriptorSets (VkWriteDescriptorSet arrays) against descriptor
+// update templates (one packed struct per set).
+
+static const uint32_t binding_count = 4;
+static const uint32_t set_count = 256;
+static const uint32_t iterations = 1000;
+static const VkDeviceSize range_size = 256;
+
+// host data of the update template: one descriptor info per binding
+struct SetDescriptors {
+  VkDescriptorBufferInfo buffers[binding_count];
+};
+
+template <typename F> double updatesPerSecond(const F &update) {
+  auto start = std::chrono::high_resolution_clock::now();
+  for (uint32_t it = 0; it < iterations; ++it)
+    for (uint32_t i = 0; i < set_count; ++i)
+      update(i, it);
+  auto end = std::chrono::high_resolution_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+  return iterations * set_count / seconds;
+}
+
+int main(int argc, char const *argv[]) {
+  App app(64, 64, "descriptor update benchmark");
+  if (!app.createLogicalDevice(
+          {VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME})) {
+    std::cerr << "VK_KHR_descriptor_update_template is not supported.\n";
+    return -1;
+  }
+  auto *device = app.logicalDevice();
+  // a buffer with a range for each binding and iteration parity
+  Buffer buffer(device, 2 * binding_count * range_size,
+                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+  DeviceMemory memory(buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  memory.bind(buffer);
+  // sets
+  DescriptorLayoutCache layout_cache(device);
+  std::vector<VkDescriptorSetLayoutBinding> bindings;
+  for (uint32_t b = 0; b < binding_count; ++b)
+    bindings.push_back({b, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1,
+                        VK_SHADER_STAGE_VERTEX_BIT, nullptr});
+  DescriptorSetLayout *layout = layout_cache.setLayout(bindings);
+  DescriptorAllocator allocator(device, set_count);
+  std::vector<VkDescriptorSet> sets(set_count);
+  for (auto &set : sets)
+    if (!allocator.allocate(*layout, set))
+      return -1;
+  // vkUpdateDescriptorSets
+  VkDescriptorBufferInfo buffer_infos[binding_count];
+  VkWriteDescriptorSet writes[binding_count];
+  for (uint32_t b = 0; b < binding_count; ++b) {
+    writes[b] = {};
+    writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[b].dstBinding = b;
+    writes[b].descriptorCount = 1;
+    writes[b].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    writes[b].pBufferInfo = &buffer_infos[b];
+  }
+  double write_rate = updatesPerSecond([&](uint32_t i, uint32_t it) {
+    for (uint32_t b = 0; b < binding_count; ++b) {
+      buffer_infos[b] = {buffer.handle(),
+                         ((it % 2) * binding_count + b) * range_size,
+                         range_size};
+      writes[b].dstSet = sets[i];
+    }
+    vkUpdateDescriptorSets(device->handle(), binding_count, writes, 0,
+                           nullptr);
+  });
+  std::cerr << "vkUpdateDescriptorSets:            " << write_rate
+            << " sets/s\n";
+  // vkUpdateDescriptorSetWithTemplate
+  DescriptorUpdateTemplate *update_template = layout->updateTemplate();
+  if (!update_template) {
+    std::cerr << "descriptor update templates are not supported.\n";
+    return 0;
+  }
+  SetDescriptors descriptors{};
+  double template_rate = updatesPerSecond([&](uint32_t i, uint32_t it) {
+    for (uint32_t b = 0; b < binding_count; ++b)
+      descriptors.buffers[b] = {buffer.handle(),
+                                ((it % 2) * binding_count + b) * range_size,
+                                range_size};
+    update_template->update(sets[i], descriptors);
+  });
+  std::cerr << "vkUpdateDescriptorSetWithTemplate: " << template_rate
+            << " sets/s (" << template_rate / write_rate << "x)\n";
+  device->waitIdle();
+  return 0;
+}
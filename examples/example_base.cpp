@@ -110,20 +110,24 @@ void ExampleBase::setupFramebuffers() {
       VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
           VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
       false));
-  color_image_memory_ = std::make_unique<DeviceMemory>(
-      *color_image_, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  color_image_memory_->bind(*color_image_);
-  color_image_view_.reset(new Image::View(color_image_.get(),
-                                          VK_IMAGE_VIEW_TYPE_2D, app_->render_engine.swapchainSurfaceFormat().format,
-                                          VK_IMAGE_ASPECT_COLOR_BIT));
   // DEPTH BUFFER
   depth_image_.reset(new Image(
       app_->logicalDevice(), VK_IMAGE_TYPE_2D, depth_format_,
       {swapchain->imageSize().width, swapchain->imageSize().height, 1}, 1, 1,
-      msaa_samples_, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, false));
-  depth_image_memory_ = std::make_unique<DeviceMemory>(
-      *depth_image_, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  depth_image_memory_->bind(*depth_image_);
+      msaa_samples_,
+      VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
+          VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+      false));
+  // lazily allocated memory when available, a shared block otherwise
+  attachment_memory_ = std::make_unique<circe::vk::TransientAttachmentAllocator>(
+      app_->logicalDevice());
+  attachment_memory_->add(*color_image_);
+  attachment_memory_->add(*depth_image_);
+  attachment_memory_->allocate();
+  // views can only be created after memory is bound
+  color_image_view_.reset(new Image::View(color_image_.get(),
+                                          VK_IMAGE_VIEW_TYPE_2D, app_->render_engine.swapchainSurfaceFormat().format,
+                                          VK_IMAGE_ASPECT_COLOR_BIT));
   depth_image_view_ =
       std::make_unique<Image::View>(depth_image_.get(), VK_IMAGE_VIEW_TYPE_2D,
                                     depth_format_, VK_IMAGE_ASPECT_DEPTH_BIT);
@@ -29,6 +29,7 @@
 #define EXAMPLE_BASE_H
 
 #include <core/vk_app.h>
+#include <core/vk_transient_memory.h>
 #include <ponos/common/defs.h>
 #include <chrono>
 
@@ -78,10 +79,9 @@ public:
     app_->render_engine.destroy_swapchain_callback = [&]() {
       color_image_view_.reset();
       color_image_.reset();
-      color_image_memory_.reset();
       depth_image_view_.reset();
       depth_image_.reset();
-      depth_image_memory_.reset();
+      attachment_memory_.reset();
       framebuffers_.clear();
     };
     app_->render_engine.create_swapchain_callback = [&]() { this->setupFramebuffers(); };
@@ -121,12 +121,12 @@ protected:
   // color buffer
   std::unique_ptr<circe::vk::Image> color_image_;
   std::unique_ptr<circe::vk::Image::View> color_image_view_;
-  std::unique_ptr<circe::vk::DeviceMemory> color_image_memory_;
   // depth buffer
   VkFormat depth_format_;
   std::unique_ptr<circe::vk::Image> depth_image_;
   std::unique_ptr<circe::vk::Image::View> depth_image_view_;
-  std::unique_ptr<circe::vk::DeviceMemory> depth_image_memory_;
+  // multisampled color and depth never leave the renderpass
+  std::unique_ptr<circe::vk::TransientAttachmentAllocator> attachment_memory_;
   // app
   std::unique_ptr<circe::vk::App> app_; //!< window display
   VkQueue graphics_queue_{nullptr}; //!< device queue
@@ -1,4 +1,3 @@
-#include <array>
 #include <chrono>
 #include <core/vk.h>
 #include <iostream>
@@ -18,14 +17,6 @@ public:
   };
 
   HelloVulkan() : ExampleBase(800, 800) {
-    app_->render_engine.resize_callback = [&](uint32_t w, uint32_t h) {
-      auto &vp = pipeline->viewport_state.viewport(0);
-      vp.width = static_cast<float>(w);
-      vp.height = static_cast<float>(h);
-      auto s = pipeline->viewport_state.scissor(0);
-      s.extent.width = w;
-      s.extent.height = h;
-    };
     app_->render_engine.record_command_buffer_callback =
         [&](CommandBuffer &cb, uint32_t i) {
           Framebuffer &f = this->framebuffers_[i];
@@ -37,12 +28,15 @@ public:
           renderpass_begin_info.addClearDepthStencilValue(1, 0);
           cb.beginRenderPass(renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
           cb.bind(pipeline.get());
+          // viewport and scissor are dynamic, the pipeline survives resizes
+          cb.setViewport(f.width(), f.height());
+          cb.setScissor(0, 0, f.width(), f.height());
           std::vector<VkBuffer> vertex_buffers = {model.vertices().handle()};
           std::vector<VkDeviceSize> offsets = {0};
           cb.bindVertexBuffers(0, vertex_buffers, offsets);
           cb.bindIndexBuffer(model.indices(), 0, VK_INDEX_TYPE_UINT32);
           cb.bind(VK_PIPELINE_BIND_POINT_GRAPHICS,
-                  pipeline_layout.get(), 0, {ds});
+                  pipeline_layout, 0, {ds});
           cb.drawIndexed(model.indices().size() / sizeof(uint32_t));
           cb.endRenderPass();
           cb.end();
@@ -54,9 +48,11 @@ public:
   void prepare() override {
     ExampleBase::prepare();
     loadModel();
-    preparePipeline();
+    if (!preparePipeline())
+      return;
     prepareUniformBuffers();
     prepareDescriptorSets();
+    prepared = true;
   }
 
   void loadModel() {
@@ -79,27 +75,44 @@ public:
     texture_view = std::make_unique<Image::View>(texture->image(), VK_IMAGE_VIEW_TYPE_2D,
                                                  VK_FORMAT_R8G8B8A8_SRGB,
                                                  VK_IMAGE_ASPECT_COLOR_BIT);
-    texture_sampler = std::make_unique<Sampler>(
-        this->app_->logicalDevice(), VK_FILTER_LINEAR, VK_FILTER_LINEAR,
-        VK_SAMPLER_MIPMAP_MODE_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT,
-        VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_ADDRESS_MODE_REPEAT, 0.f,
-        VK_TRUE, 16, VK_FALSE, VK_COMPARE_OP_ALWAYS, 0.f, 0.f,
-        VK_BORDER_COLOR_INT_OPAQUE_BLACK, VK_FALSE);
+    auto sampler_info = SamplerCache::linear(VK_SAMPLER_ADDRESS_MODE_REPEAT);
+    sampler_info.anisotropyEnable = VK_TRUE;
+    sampler_info.maxAnisotropy = 16.f;
+    texture_sampler = std::make_unique<Sampler>(this->app_->logicalDevice(),
+                                                sampler_info);
     // load shaders
     std::string path(SHADERS_PATH);
-    frag_shader_module.setDevice(app_->logicalDevice());
-    frag_shader_module.load(path + "/frag.spv");
-    frag_shader_stage_info.set(VK_SHADER_STAGE_FRAGMENT_BIT, frag_shader_module, "main", nullptr, 0);
-    vert_shader_module.setDevice(app_->logicalDevice());
-    vert_shader_module.load(path + "/vert.spv");
-    vert_shader_stage_info.set(VK_SHADER_STAGE_VERTEX_BIT, vert_shader_module, "main", nullptr, 0);
+    shader_cache = std::make_unique<ShaderModuleCache>(app_->logicalDevice());
+    shader_cache->loadDirectory(path);
+    auto shader_statistics = shader_cache->statistics();
+    std::cerr << "shaders: " << shader_statistics.files << " files, "
+              << shader_statistics.modules << " modules in "
+              << shader_statistics.startup_time << "ms\n";
+    frag_shader_module = shader_cache->load(path + "/frag.spv");
+    frag_shader_stage_info.set(VK_SHADER_STAGE_FRAGMENT_BIT, *frag_shader_module, "main", nullptr, 0);
+    vert_shader_module = shader_cache->load(path + "/vert.spv");
+    vert_shader_stage_info.set(VK_SHADER_STAGE_VERTEX_BIT, *vert_shader_module, "main", nullptr, 0);
   }
-  void preparePipeline() {
+  bool preparePipeline() {
+    // layouts with the same signature are created only once
+    layout_cache = std::make_unique<DescriptorLayoutCache>(this->app_->logicalDevice());
+    // the layout is derived from the bindings the shaders declare
+    auto shader_interface = ShaderReflection::merge(
+        {&vert_shader_module->reflection(), &frag_shader_module->reflection()});
+    auto set_layouts = layout_cache->setLayouts(shader_interface);
+    if (set_layouts.empty()) {
+      std::cerr << "could not derive the descriptor set layouts of the "
+                   "shaders\n";
+      return false;
+    }
+    descriptor_set_layout = set_layouts[0];
+    pipeline_layout = layout_cache->pipelineLayout(
+        set_layouts, shader_interface.pushConstantRanges());
     // create pipeline object
+    pipeline_cache = std::make_unique<PipelineCache>(app_->logicalDevice());
     pipeline = std::make_unique<GraphicsPipeline>(
-        this->app_->logicalDevice(), pipeline_layout.get(), this->renderpass_.get(), 0);
-    pipeline_layout = std::make_unique<PipelineLayout>(this->app_->logicalDevice());
-    pipeline->setLayout(pipeline_layout.get());
+        this->app_->logicalDevice(), pipeline_layout, this->renderpass_.get(), 0);
+    pipeline->setCache(pipeline_cache.get());
     /////////////////////////////////////// ///////////////////////////////////
     pipeline->vertex_input_state.addBindingDescription(0, model_vertex_layout.stride(), VK_VERTEX_INPUT_RATE_VERTEX);
     for (uint32_t i = 0; i < 3; ++i) {
@@ -112,9 +125,6 @@ public:
 
     pipeline->setInputState(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
 
-    pipeline->viewport_state.addViewport(0, 0, 800, 800, 0.f, 1.f);
-    pipeline->viewport_state.addScissor(0, 0, 800, 800);
-
     pipeline->setRasterizationState(
         VK_FALSE, VK_FALSE, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT,
         VK_FRONT_FACE_COUNTER_CLOCKWISE, VK_FALSE, 0.f, 0.f, 0.f, 1.0f);
@@ -131,67 +141,33 @@ public:
 
     pipeline->setDepthStencilState(VK_TRUE, VK_TRUE, VK_COMPARE_OP_LESS,
                                    VK_FALSE, VK_FALSE, {}, {}, 0.0, 1.0);
-    // pipeline.addDynamicState(VK_DYNAMIC_STATE_VIEWPORT);
-    // pipeline.addDynamicState(VK_DYNAMIC_STATE_LINE_WIDTH);
+    // recompiled shaders are picked up without restarting
+    std::string path(SHADERS_PATH);
+    // rebuilds go through the same cache as the original pipeline
+    pipeline_compiler = std::make_unique<PipelineCompiler>(
+        app_->logicalDevice(), pipeline_cache.get(), 1);
+    shader_reloader = std::make_unique<ShaderReloader>(app_->logicalDevice(), *pipeline_compiler);
+    shader_reloader->watch(path + "/frag.spv", frag_shader_module);
+    shader_reloader->watch(path + "/vert.spv", vert_shader_module);
+    shader_reloader->addPipeline(pipeline.get());
+    return true;
   }
   void prepareDescriptorSets() {
     int set_count = app_->render_engine.swapchainImageViews().size();
-    descriptor_pool = std::make_unique<DescriptorPool>(app_->logicalDevice(), set_count);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, set_count);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_SAMPLER, 1000);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1000);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1000);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1000);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1000);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1000);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000);
-    descriptor_pool->setPoolSize(VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1000);
+    // pools grow on demand, sized by the layouts actually allocated
+    descriptor_allocator =
+        std::make_unique<DescriptorAllocator>(app_->logicalDevice(), set_count);
+    // all swapchain images share the same set layout
+    descriptor_sets.resize(set_count, VK_NULL_HANDLE);
     for (int i = 0; i < set_count; ++i) {
-      circe::vk::DescriptorSetLayout &dsl =
-          pipeline_layout->descriptorSetLayout(pipeline_layout->createLayoutSet(i));
-      dsl.addLayoutBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1,
-                           VK_SHADER_STAGE_VERTEX_BIT);
-      dsl.addLayoutBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
-                           VK_SHADER_STAGE_FRAGMENT_BIT);
-    }
-    descriptor_pool->allocate(pipeline_layout->descriptorSetLayouts(), descriptor_sets);
-
-    for (int i = 0; i < set_count; ++i) {
-      VkDescriptorSet ds = descriptor_sets[i];
-      VkBuffer ubo = uniform_buffers[i].handle();
-      VkDescriptorBufferInfo buffer_info = {};
-      buffer_info.buffer = ubo;
-      buffer_info.offset = 0;
-      buffer_info.range = sizeof(UniformBufferObject);
-      VkDescriptorImageInfo image_info = {};
-      image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-      image_info.imageView = texture_view->handle();
-      image_info.sampler = texture_sampler->handle();
-
-      std::array<VkWriteDescriptorSet, 2> descriptor_writes = {};
-
-      descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      descriptor_writes[0].dstSet = ds;
-      descriptor_writes[0].dstBinding = 0;
-      descriptor_writes[0].dstArrayElement = 0;
-      descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-      descriptor_writes[0].descriptorCount = 1;
-      descriptor_writes[0].pBufferInfo = &buffer_info;
-
-      descriptor_writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      descriptor_writes[1].dstSet = ds;
-      descriptor_writes[1].dstBinding = 1;
-      descriptor_writes[1].dstArrayElement = 0;
-      descriptor_writes[1].descriptorType =
-          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-      descriptor_writes[1].descriptorCount = 1;
-      descriptor_writes[1].pImageInfo = &image_info;
-
-      vkUpdateDescriptorSets(app_->logicalDevice()->handle(),
-                             static_cast<uint32_t>(descriptor_writes.size()),
-                             descriptor_writes.data(), 0, nullptr);
+      descriptor_allocator->allocate(*descriptor_set_layout, descriptor_sets[i]);
+      DescriptorResources()
+          .setBuffer(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                     uniform_buffers[i].handle(), 0,
+                     sizeof(UniformBufferObject))
+          .setImage(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                    texture_view->handle(), texture_sampler->handle())
+          .write(app_->logicalDevice(), descriptor_sets[i]);
     }
   }
   void prepareUniformBuffers() {
@@ -205,6 +181,9 @@ public:
     }
   }
   void prepareFrameImage(uint32_t index) override {
+    // frame boundary: swap in pipelines rebuilt from changed shaders
+    if (shader_reloader->update())
+      app_->render_engine.invalidateCommandBuffers();
     auto &ubm = uniform_buffer_memories[index];
     static auto start_time = std::chrono::high_resolution_clock::now();
     auto current_time = std::chrono::high_resolution_clock::now();
@@ -235,28 +214,37 @@ public:
 
   // model
   VertexLayout model_vertex_layout;
-  ShaderModule frag_shader_module;
+  std::unique_ptr<ShaderModuleCache> shader_cache;
+  std::shared_ptr<ShaderModule> frag_shader_module;
   PipelineShaderStage frag_shader_stage_info;
-  ShaderModule vert_shader_module;
+  std::shared_ptr<ShaderModule> vert_shader_module;
   PipelineShaderStage vert_shader_stage_info;
   Model model;
   std::unique_ptr<Texture> texture;
   std::unique_ptr<Image::View> texture_view;
   std::unique_ptr<Sampler> texture_sampler;
   // pipeline
-  std::unique_ptr<PipelineLayout> pipeline_layout;
+  std::unique_ptr<DescriptorLayoutCache> layout_cache;
+  DescriptorSetLayout *descriptor_set_layout{nullptr};
+  PipelineLayout *pipeline_layout{nullptr};
+  std::unique_ptr<PipelineCache> pipeline_cache;
   std::unique_ptr<GraphicsPipeline> pipeline;
+  std::unique_ptr<PipelineCompiler> pipeline_compiler;
+  std::unique_ptr<ShaderReloader> shader_reloader;
   // descriptor sets
-  std::unique_ptr<DescriptorPool> descriptor_pool;
+  std::unique_ptr<DescriptorAllocator> descriptor_allocator;
   std::vector<VkDescriptorSet> descriptor_sets;
   // shader resources
   std::vector<Buffer> uniform_buffers;
   std::vector<DeviceMemory> uniform_buffer_memories;
+  bool prepared{false};
 };
 
 int main(int argc, char const *argv[]) {
   HelloVulkan e;
   e.prepare();
+  if (!e.prepared)
+    return -1;
   e.run();
   return 0;
 }
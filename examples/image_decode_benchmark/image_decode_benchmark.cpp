@@ -0,0 +1,80 @@
+#include <chrono>
+#include <core/vk.h>
+#include <cstring>
+#include <iostream>
+#include <stb_image.h>
+#include <vector>
+
+using namespace circe::vk;
+
+// Host only (no device is created): compares the decoder memory of loading
+// an image into a heap buffer and copying it into staging memory, against
+// decoding it in place with ImageDecoder::decodeRGBA8. A plain vector stands
+// for the mapped staging range.
+//   image_decode_benchmark [image ...]
+// Without arguments the example textures are used.
+
+static bool heapPath(const std::string &filename, std::vector<uint8_t> &staging,
+                     double &ms) {
+  auto start = std::chrono::high_resolution_clock::now();
+  int width = 0, height = 0, channels = 0;
+  // stb allocations go through the decoder allocator, so they are accounted
+  stbi_uc *pixels =
+      stbi_load(filename.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+  if (!pixels)
+    return false;
+  staging.resize(static_cast<size_t>(width) * height * 4);
+  std::memcpy(staging.data(), pixels, staging.size());
+  stbi_image_free(pixels);
+  auto end = std::chrono::high_resolution_clock::now();
+  ms = std::chrono::duration<double, std::milli>(end - start).count();
+  return true;
+}
+
+static bool inPlacePath(const std::string &filename,
+                        std::vector<uint8_t> &staging, double &ms) {
+  auto start = std::chrono::high_resolution_clock::now();
+  VkExtent3D size{};
+  if (!ImageDecoder::info(filename, size))
+    return false;
+  staging.resize(ImageDecoder::destinationSize(size));
+  if (!ImageDecoder::decodeRGBA8(filename, size, staging.data(),
+                                 staging.size()))
+    return false;
+  auto end = std::chrono::high_resolution_clock::now();
+  ms = std::chrono::duration<double, std::milli>(end - start).count();
+  return true;
+}
+
+int main(int argc, char const *argv[]) {
+  std::vector<std::string> images;
+  for (int i = 1; i < argc; ++i)
+    images.emplace_back(argv[i]);
+  if (images.empty())
+    images = {TEXTURES_PATH "/texture.jpg", TEXTURES_PATH "/chalet.jpg"};
+  std::vector<uint8_t> staging;
+  for (const auto &image : images) {
+    VkExtent3D size{};
+    if (!ImageDecoder::info(image, size)) {
+      std::cerr << "unsupported image " << image << "\n";
+      return -1;
+    }
+    std::cerr << image << " (" << size.width << "x" << size.height << ")\n";
+    double ms = 0;
+    // the peak restarts from the current heap usage on each reset
+    ImageDecoder::resetStatistics();
+    if (!heapPath(image, staging, ms))
+      return -1;
+    auto stats = ImageDecoder::statistics();
+    std::cerr << "  heap + copy: " << ms << " ms, peak decoder heap "
+              << stats.peak_heap_bytes / (1024.0 * 1024.0) << " MB\n";
+    ImageDecoder::resetStatistics();
+    if (!inPlacePath(image, staging, ms))
+      return -1;
+    stats = ImageDecoder::statistics();
+    std::cerr << "  in place:    " << ms << " ms, peak decoder heap "
+              << stats.peak_heap_bytes / (1024.0 * 1024.0) << " MB, "
+              << (stats.direct ? "zero copy" : "copied") << "\n";
+  }
+  return 0;
+}
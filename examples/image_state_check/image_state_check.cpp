@@ -0,0 +1,18 @@
+#include <core/vk.h>
+#include <iostream>
+
+using namespace circe::vk;
+
+// Host only (no device is created): checks the layouts, access types and
+// stages of every ImageUsage, and the barriers ImageState generates between
+// every pair of usages. Returns a non zero code on failure, so it can run as
+// a build check.
+
+int main(int argc, char const *argv[]) {
+  if (!ImageState::checkTransitionTable()) {
+    std::cerr << "image usage transition table is inconsistent\n";
+    return -1;
+  }
+  std::cerr << "image usage transition table is consistent\n";
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <chrono>
+#include <core/vk.h>
+#include <iostream>
+#include <random>
+
+using namespace circe::vk;
+
+// Compares the mip chain generation of Texture::generateMipmaps (one blit and
+// its barriers per level) against MipDownsampler (up to 6 levels per
+// dispatch), and times depth pyramid builds. The compute modules are built
+// into the build tree with the example (downsample_shaders target) when CMake
+// finds glslc, otherwise they must be compiled by hand in
+// examples/assets/shaders:
+//   glslc downsample.comp -o downsample.spv
+//   glslc -DSTORAGE_FORMAT=r32f downsample.comp -o downsample_r32f.spv
+
+#ifndef DOWNSAMPLE_SHADERS_PATH
+#define DOWNSAMPLE_SHADERS_PATH SHADERS_PATH
+#endif
+
+static const uint32_t iterations = 20;
+
+// milliseconds per iteration of the recorded commands (submission included)
+template <typename F>
+double milliseconds(const LogicalDevice *device, uint32_t family_index,
+                    VkQueue queue, const F &record) {
+  auto start = std::chrono::high_resolution_clock::now();
+  CommandPool::submitCommandBuffer(device, family_index, queue,
+                                   [&](CommandBuffer &cb) {
+                                     for (uint32_t i = 0; i < iterations; ++i)
+                                       record(cb);
+                                   });
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         iterations;
+}
+
+int main(int argc, char const *argv[]) {
+  App app(64, 64, "mip downsample benchmark");
+  if (!app.createLogicalDevice())
+    return -1;
+  auto *device = app.logicalDevice();
+  auto &family = app.queueFamilies().family("graphics");
+  uint32_t family_index = family.family_index.value();
+  VkQueue queue = family.vk_queues[0];
+  ShaderModule color_module(device,
+                            DOWNSAMPLE_SHADERS_PATH "/downsample.spv");
+  ShaderModule depth_module(device,
+                            DOWNSAMPLE_SHADERS_PATH "/downsample_r32f.spv");
+  if (!color_module.handle() || !depth_module.handle()) {
+    std::cerr << "downsample.spv and downsample_r32f.spv are missing, "
+                 "compile downsample.comp (see source comments).\n";
+    return -1;
+  }
+  const VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+  if (!MipDownsampler::isSupported(*app.physicalDevice(), format)) {
+    std::cerr << "storage images of the texture format are not supported.\n";
+    return -1;
+  }
+  MipDownsampler downsampler(device, color_module);
+  std::mt19937 rng(1);
+  for (uint32_t size : {1024u, 2048u, 4096u}) {
+    uint32_t levels = MipGenerator::levelCount(size, size);
+    Texture texture(device, VK_IMAGE_TYPE_2D,
+                    MipDownsampler::storageFormat(format), {size, size, 1},
+                    levels, 1, VK_SAMPLE_COUNT_1_BIT,
+                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                        VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                        MipDownsampler::imageUsage(),
+                    false, MipDownsampler::imageCreateFlags(format));
+    std::vector<uint8_t> texels(size * size * 4);
+    for (auto &texel : texels)
+      texel = static_cast<uint8_t>(rng());
+    texture.setData(texels.data(), family_index, queue);
+    double blit = milliseconds(device, family_index, queue,
+                               [&](CommandBuffer &cb) {
+                                 // the blit chain expects the levels as
+                                 // transfer destinations
+                                 cb.use(*texture.image(),
+                                        ImageUsage::TRANSFER_DST, 1);
+                                 texture.generateMipmaps(cb);
+                               });
+    uint32_t dispatches = downsampler.dispatchCount();
+    double compute = milliseconds(device, family_index, queue,
+                                  [&](CommandBuffer &cb) {
+                                    texture.generateMipmaps(cb, downsampler,
+                                                            format);
+                                  });
+    dispatches = (downsampler.dispatchCount() - dispatches) / iterations;
+    downsampler.release(*texture.image());
+    std::cerr << size << "x" << size << " (" << levels << " levels): blit "
+              << blit << " ms (" << levels - 1 << " blits), compute "
+              << compute << " ms (" << dispatches << " dispatches)\n";
+  }
+  // depth pyramid of a 1080p depth buffer
+  MipDownsampler pyramid_builder(device, depth_module,
+                                 MipDownsampler::Reduction::MAX);
+  Image depth(device, VK_IMAGE_TYPE_2D, VK_FORMAT_D32_SFLOAT, {1920, 1080, 1},
+              1, 1, VK_SAMPLE_COUNT_1_BIT,
+              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                  VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+              false);
+  DeviceMemory depth_memory(depth, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  depth_memory.bind(depth);
+  Texture pyramid(device, VK_IMAGE_TYPE_2D, VK_FORMAT_R32_SFLOAT,
+                  {960, 540, 1}, MipGenerator::levelCount(960, 540), 1,
+                  VK_SAMPLE_COUNT_1_BIT, MipDownsampler::imageUsage(), false);
+  pyramid.allocateMemory();
+  CommandPool::submitCommandBuffer(
+      device, family_index, queue, [&](CommandBuffer &cb) {
+        cb.use(depth, ImageUsage::TRANSFER_DST);
+        cb.clear(depth, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 {{VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1}},
+                 VkClearDepthStencilValue{1.f, 0});
+      });
+  double pyramid_time = milliseconds(
+      device, family_index, queue, [&](CommandBuffer &cb) {
+        pyramid_builder.recordPyramid(cb, depth, *pyramid.image());
+      });
+  std::cerr << "depth pyramid 1920x1080: " << pyramid_time << " ms ("
+            << pyramid_builder.dispatchCount() / iterations
+            << " dispatches)\n";
+  pyramid_builder.reset();
+  return 0;
+}
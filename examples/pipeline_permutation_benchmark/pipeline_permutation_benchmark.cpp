@@ -0,0 +1,169 @@
+#include <chrono>
+#include <core/vk.h>
+#include <iostream>
+
+using namespace circe::vk;
+
+// Measures how many pipelines a set of material variants needs, and how long
+// creating them takes, with all states baked into the pipelines and with the
+// states covered by VK_EXT_extended_dynamic_state{,2} left dynamic (see
+// GraphicsPipeline::useExtendedDynamicState). Variants differ only on cull
+// mode, front face, topology, depth test/write/compare op and depth bias.
+
+struct Variant {
+  VkCullModeFlags cull_mode;
+  VkFrontFace front_face;
+  VkPrimitiveTopology topology;
+  VkBool32 depth_test;
+  VkBool32 depth_write;
+  VkCompareOp compare_op;
+  VkBool32 depth_bias;
+};
+
+static std::vector<Variant> variants() {
+  const VkCullModeFlags cull_modes[] = {
+      VK_CULL_MODE_NONE, VK_CULL_MODE_FRONT_BIT, VK_CULL_MODE_BACK_BIT};
+  const VkFrontFace front_faces[] = {VK_FRONT_FACE_COUNTER_CLOCKWISE,
+                                     VK_FRONT_FACE_CLOCKWISE};
+  const VkPrimitiveTopology topologies[] = {
+      VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+      VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP};
+  const VkBool32 booleans[] = {VK_TRUE, VK_FALSE};
+  const VkCompareOp compare_ops[] = {VK_COMPARE_OP_LESS,
+                                     VK_COMPARE_OP_LESS_OR_EQUAL,
+                                     VK_COMPARE_OP_GREATER};
+  std::vector<Variant> v;
+  for (auto cull_mode : cull_modes)
+    for (auto front_face : front_faces)
+      for (auto topology : topologies)
+        for (auto depth_test : booleans)
+          for (auto depth_write : booleans)
+            for (auto compare_op : compare_ops)
+              for (auto depth_bias : booleans)
+                v.push_back({cull_mode, front_face, topology, depth_test,
+                             depth_write, compare_op, depth_bias});
+  return v;
+}
+
+int main(int argc, char const *argv[]) {
+  App app(64, 64, "pipeline permutation benchmark");
+  app.pickPhysicalDevice(
+      [](const PhysicalDevice &, QueueFamilies &) -> uint32_t { return 1; });
+  std::vector<const char *> extensions;
+  const void *features_chain = nullptr;
+#ifdef VK_EXT_extended_dynamic_state2
+  VkPhysicalDeviceExtendedDynamicState2FeaturesEXT dynamic_state2{};
+  dynamic_state2.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT;
+  dynamic_state2.extendedDynamicState2 = VK_TRUE;
+  VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamic_state{};
+  dynamic_state.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+  dynamic_state.extendedDynamicState = VK_TRUE;
+  // features are enabled only for the supported extensions
+  const PhysicalDevice *physical_device = app.physicalDevice();
+  if (physical_device->isExtensionSupported(
+          VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)) {
+    extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+    features_chain = &dynamic_state;
+    if (physical_device->isExtensionSupported(
+            VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) {
+      extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+      dynamic_state.pNext = &dynamic_state2;
+    }
+  }
+#endif
+  if (!app.createLogicalDevice(extensions, nullptr, features_chain))
+    return -1;
+  auto *device = app.logicalDevice();
+  // renderpass
+  VkFormat depth_format = VK_FORMAT_D32_SFLOAT;
+  app.physicalDevice()->findSupportedFormat(
+      {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT,
+       VK_FORMAT_D24_UNORM_S8_UINT},
+      VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT,
+      depth_format);
+  RenderPass renderpass(device);
+  auto &subpass = renderpass.newSubpassDescription();
+  subpass.addColorAttachmentRef(
+      renderpass.addAttachment(
+          VK_FORMAT_R8G8B8A8_UNORM, VK_SAMPLE_COUNT_1_BIT,
+          VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+          VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_DONT_CARE,
+          VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL),
+      VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  subpass.setDepthStencilAttachmentRef(
+      renderpass.addAttachment(
+          depth_format, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_CLEAR,
+          VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+          VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_UNDEFINED,
+          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL),
+      VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+  // shaders of hello_vulkan
+  std::string path(SHADERS_PATH);
+  ShaderModule vert_module(device, path + "/vert.spv");
+  ShaderModule frag_module(device, path + "/frag.spv");
+  if (!vert_module.handle() || !frag_module.handle())
+    return -1;
+  PipelineShaderStage vert_stage(VK_SHADER_STAGE_VERTEX_BIT, vert_module,
+                                 "main", nullptr, 0);
+  PipelineShaderStage frag_stage(VK_SHADER_STAGE_FRAGMENT_BIT, frag_module,
+                                 "main", nullptr, 0);
+  DescriptorLayoutCache layout_cache(device);
+  auto shader_interface = ShaderReflection::merge(
+      {&vert_module.reflection(), &frag_module.reflection()});
+  PipelineLayout *layout = layout_cache.pipelineLayout(shader_interface);
+  if (!layout)
+    return -1;
+  // made_dynamic receives the number of states left out of the pipeline
+  auto describe = [&](const Variant &v, bool dynamic, uint32_t &made_dynamic) {
+    auto pipeline =
+        std::make_unique<GraphicsPipeline>(device, layout, &renderpass, 0);
+    uint32_t offset = 0;
+    for (const auto &input : vert_module.reflection().vertexInputs()) {
+      pipeline->vertex_input_state.addAttributeDescription(
+          input.location, 0, input.format, offset);
+      offset += input.size;
+    }
+    pipeline->vertex_input_state.addBindingDescription(
+        0, offset, VK_VERTEX_INPUT_RATE_VERTEX);
+    pipeline->addShaderStage(vert_stage);
+    pipeline->addShaderStage(frag_stage);
+    pipeline->setInputState(v.topology);
+    pipeline->setRasterizationState(VK_FALSE, VK_FALSE, VK_POLYGON_MODE_FILL,
+                                    v.cull_mode, v.front_face, v.depth_bias,
+                                    1.f, 0.f, 1.f, 1.f);
+    pipeline->setMultisampleState(VK_SAMPLE_COUNT_1_BIT, VK_FALSE, 1.f, {},
+                                  VK_FALSE, VK_FALSE);
+    pipeline->color_blend_state.addAttachmentState(
+        VK_FALSE, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+        VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+            VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT);
+    pipeline->setDepthStencilState(v.depth_test, v.depth_write, v.compare_op,
+                                   VK_FALSE, VK_FALSE, {}, {}, 0.f, 1.f);
+    made_dynamic = dynamic ? pipeline->useExtendedDynamicState() : 0;
+    return pipeline;
+  };
+  auto material_variants = variants();
+  for (bool dynamic : {false, true}) {
+    PipelineRegistry registry(device);
+    std::vector<std::shared_ptr<PipelineRegistry::SharedPipeline>> pipelines;
+    uint32_t dynamic_states = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto &variant : material_variants) {
+      auto description = describe(variant, dynamic, dynamic_states);
+      pipelines.emplace_back(registry.acquire(*description));
+      if (!pipelines.back())
+        return -1;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cerr << (dynamic ? "extended dynamic state: " : "baked states: ")
+              << material_variants.size() << " variants -> "
+              << registry.missCount() << " pipelines in " << ms
+              << " ms (" << dynamic_states << " dynamic states)\n";
+  }
+  device->waitIdle();
+  return 0;
+}
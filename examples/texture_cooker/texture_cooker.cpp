@@ -0,0 +1,125 @@
+#include <core/vk.h>
+#include <cstring>
+#include <iostream>
+
+using namespace circe::vk;
+
+// Offline texture cooking: encodes an image (and its mip chain) into BC
+// blocks and writes a DDS file that Texture/TextureLoader upload as is.
+//   texture_cooker <image> <output.dds> [bc1|bc3|bc4|bc5] [--linear]
+//                  [--kaiser] [--threads N]
+// Mip levels are filtered in linear space (box or Kaiser filter). Without
+// arguments, the encoder and the mip generator are benchmarked (megapixels
+// per second and PSNR) on the example texture.
+
+static const char *format_names[] = {"bc1", "bc3", "bc4", "bc5"};
+
+static bool decodeImage(const std::string &filename, std::vector<uint8_t> &rgba,
+                        VkExtent3D &size) {
+  if (!ImageDecoder::info(filename, size))
+    return false;
+  rgba.resize(ImageDecoder::destinationSize(size));
+  return ImageDecoder::decodeRGBA8(filename, size, rgba.data(), rgba.size());
+}
+
+static int benchmark() {
+  std::vector<uint8_t> rgba;
+  VkExtent3D size{};
+  if (!decodeImage(TEXTURES_PATH "/chalet.jpg", rgba, size))
+    return -1;
+  std::cerr << "image " << size.width << "x" << size.height << "\n";
+  std::vector<uint8_t> decoded(ImageDecoder::rgba8Size(size));
+  for (uint32_t f = 0; f < 4; ++f) {
+    auto format = static_cast<BlockEncoder::Format>(f);
+    std::vector<uint8_t> blocks(
+        BlockEncoder::encodedSize(format, size.width, size.height));
+    for (uint32_t threads : {1u, 0u}) {
+      BlockEncoder encoder(threads);
+      for (int i = 0; i < 5; ++i)
+        encoder.encode(format, rgba.data(), size.width, size.height,
+                       blocks.data());
+      std::cerr << format_names[f] << (threads ? " 1 thread: " : ": ")
+                << encoder.statistics().megapixelsPerSecond() << " MP/s\n";
+    }
+    BlockEncoder::decode(format, blocks.data(), size.width, size.height,
+                         decoded.data());
+    std::cerr << format_names[f] << " PSNR: "
+              << BlockEncoder::psnr(format, rgba.data(), decoded.data(),
+                                    size.width, size.height)
+              << " dB, " << blocks.size() / 1024 << " KB (RGBA8 "
+              << ImageDecoder::rgba8Size(size) / 1024 << " KB)\n";
+  }
+  std::vector<std::vector<uint8_t>> levels;
+  for (auto filter : {MipGenerator::Filter::BOX, MipGenerator::Filter::KAISER})
+    for (uint32_t threads : {1u, 0u}) {
+      MipGenerator generator(threads);
+      MipGenerator::Options options;
+      options.filter = filter;
+      for (int i = 0; i < 5; ++i)
+        generator.generate(rgba.data(), size.width, size.height, levels,
+                           options);
+      std::cerr << (filter == MipGenerator::Filter::BOX ? "box" : "kaiser")
+                << " mips" << (threads ? " 1 thread: " : ": ")
+                << generator.statistics().megapixelsPerSecond() << " MP/s\n";
+    }
+  return 0;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 3)
+    return benchmark();
+  BlockEncoder::Format format = BlockEncoder::Format::BC1;
+  bool srgb = true;
+  bool kaiser = false;
+  uint32_t threads = 0;
+  for (int i = 3; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--linear"))
+      srgb = false;
+    else if (!std::strcmp(argv[i], "--kaiser"))
+      kaiser = true;
+    else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+      threads = std::stoi(argv[++i]);
+    else
+      for (uint32_t f = 0; f < 4; ++f)
+        if (!std::strcmp(argv[i], format_names[f]))
+          format = static_cast<BlockEncoder::Format>(f);
+  }
+  std::vector<uint8_t> rgba;
+  VkExtent3D size{};
+  if (!decodeImage(argv[1], rgba, size)) {
+    std::cerr << "could not read " << argv[1] << "\n";
+    return -1;
+  }
+  // BC4/BC5 store data channels (ex: normals), filtered as they are
+  const bool color = format == BlockEncoder::Format::BC1 ||
+                     format == BlockEncoder::Format::BC3;
+  MipGenerator generator(threads);
+  MipGenerator::Options options;
+  options.filter =
+      kaiser ? MipGenerator::Filter::KAISER : MipGenerator::Filter::BOX;
+  options.srgb = srgb && color;
+  options.premultiplied_alpha = color;
+  std::vector<std::vector<uint8_t>> mips;
+  if (!generator.generate(rgba.data(), size.width, size.height, mips,
+                          options))
+    return -1;
+  BlockEncoder encoder(threads);
+  std::vector<std::vector<uint8_t>> levels;
+  for (uint32_t level = 0; level <= mips.size(); ++level) {
+    VkExtent2D extent =
+        MipGenerator::levelSize(size.width, size.height, level);
+    levels.emplace_back(
+        BlockEncoder::encodedSize(format, extent.width, extent.height));
+    encoder.encode(format, level ? mips[level - 1].data() : rgba.data(),
+                   extent.width, extent.height, levels.back().data());
+  }
+  if (!TextureContainer::writeDDS(argv[2],
+                                  BlockEncoder::vkFormat(format, srgb),
+                                  {size.width, size.height}, levels))
+    return -1;
+  std::cerr << "generated mips at "
+            << generator.statistics().megapixelsPerSecond() << " MP/s, "
+            << "encoded " << levels.size() << " levels at "
+            << encoder.statistics().megapixelsPerSecond() << " MP/s\n";
+  return 0;
+}
@@ -88,39 +88,34 @@ struct UniformBufferObject {
 
 class ShaderSet {
 public:
-  ShaderSet(const circe::vk::LogicalDevice *logical_device)
-      : logical_device_(logical_device) {
+  ShaderSet(circe::vk::ShaderModuleCache &shader_cache) {
     // setup shaders
     std::string path(SHADERS_PATH);
     // fragment shader
-    frag_shader_module_ = std::make_shared<circe::vk::ShaderModule>(
-        logical_device, path + "/frag.spv");
+    frag_shader_module_ = shader_cache.load(path + "/frag.spv");
     frag_shader_stage_info_ = std::make_shared<circe::vk::PipelineShaderStage>(
         VK_SHADER_STAGE_FRAGMENT_BIT, *(frag_shader_module_.get()), "main",
         nullptr, 0);
     // vertex shader
-    vert_shader_module_ = std::make_shared<circe::vk::ShaderModule>(
-        logical_device, path + "/vert.spv");
+    vert_shader_module_ = shader_cache.load(path + "/vert.spv");
     vert_shader_stage_info_ = std::make_shared<circe::vk::PipelineShaderStage>(
         VK_SHADER_STAGE_VERTEX_BIT, *(vert_shader_module_.get()), "main",
         nullptr, 0);
   }
   void addTo(circe::vk::GraphicsPipeline &pipeline) {
-    // Vertex data
-    pipeline.vertex_input_state.addBindingDescription(
-        0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX);
-    pipeline.vertex_input_state.addAttributeDescription(
-        0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, pos));
-    pipeline.vertex_input_state.addAttributeDescription(
-        1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color));
-    pipeline.vertex_input_state.addAttributeDescription(
-        2, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, tex_coord));
+    // Vertex data (Vertex is tightly packed in location order)
+    pipeline.vertex_input_state.addReflectedInputs(
+        vert_shader_module_->reflection());
     pipeline.addShaderStage(*(vert_shader_stage_info_.get()));
     pipeline.addShaderStage(*(frag_shader_stage_info_.get()));
   }
+  circe::vk::ShaderReflection interface() const {
+    return circe::vk::ShaderReflection::merge(
+        {&vert_shader_module_->reflection(),
+         &frag_shader_module_->reflection()});
+  }
 
 private:
-  const circe::vk::LogicalDevice *logical_device_;
   // shaders
   std::shared_ptr<circe::vk::ShaderModule> frag_shader_module_,
       vert_shader_module_;
@@ -204,7 +199,9 @@ public:
     app_ = std::make_unique<circe::vk::App>(std::forward<Args>(args)...);
     app_->setValidationLayers({"VK_LAYER_KHRONOS_validation"});
     // init shaders
-    shader_ = std::make_unique<ShaderSet>(app_->logicalDevice());
+    shader_cache_ =
+        std::make_unique<circe::vk::ShaderModuleCache>(app_->logicalDevice());
+    shader_ = std::make_unique<ShaderSet>(*shader_cache_);
     // init mesh
     h_mesh_ = std::make_unique<Mesh>(app_->logicalDevice());
     // retrieve queue for buffer upload operations
@@ -312,11 +309,10 @@ private:
     };
     // describe resources accessed by the shaders
     app_->render_engine.descriptor_set_layout_callback =
-        [](circe::vk::DescriptorSetLayout &dsl) {
-          dsl.addLayoutBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1,
-                               VK_SHADER_STAGE_VERTEX_BIT);
-          dsl.addLayoutBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
-                               VK_SHADER_STAGE_FRAGMENT_BIT);
+        [&](circe::vk::DescriptorSetLayout &dsl) {
+          for (auto &b : shader_->interface().setLayoutBindings(0))
+            dsl.addLayoutBinding(b.binding, b.descriptorType,
+                                 b.descriptorCount, b.stageFlags);
         };
     // set the descriptor set update callback
     app_->render_engine.update_descriptor_set_callback = [&](VkDescriptorSet ds,
@@ -429,6 +425,7 @@ private:
   std::unique_ptr<circe::vk::App> app_;
   std::unique_ptr<circe::vk::RenderPass> imgui_renderpass_;
   std::unique_ptr<circe::vk::DescriptorPool> imgui_descriptor_pool_;
+  std::unique_ptr<circe::vk::ShaderModuleCache> shader_cache_;
   std::unique_ptr<ShaderSet> shader_;
   std::unique_ptr<Mesh> h_mesh_;
   std::unique_ptr<circe::vk::MeshBufferData> mesh_;
@@ -81,13 +81,10 @@ void ImGUI::initResources(RenderPass *render_pass, VkQueue copy_queue,
       VK_IMAGE_ASPECT_COLOR_BIT);
 
   // Font texture Sampler
-  font_texture_sampler_.reset(new Sampler(
-      app_->logicalDevice(), VK_FILTER_LINEAR, VK_FILTER_LINEAR,
-      VK_SAMPLER_MIPMAP_MODE_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
-      VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
-      VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, 0.f, VK_FALSE, 0.f, VK_FALSE,
-      VK_COMPARE_OP_ALWAYS, 0.f, 0.f, VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
-      VK_FALSE));
+  auto sampler_info =
+      SamplerCache::linear(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+  sampler_info.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+  font_texture_sampler_.reset(new Sampler(app_->logicalDevice(), sampler_info));
 
   // Descriptor pool
   descriptor_pool_ = std::make_unique<DescriptorPool>(app_->logicalDevice(), 2);
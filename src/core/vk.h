@@ -1,11 +1,34 @@
 #include "logging.h"
 #include "vk_app.h"
 #include "vk_mesh_buffer_data.h"
+#include "vk_bindless.h"
 #include "vk_command_buffer.h"
+#include "vk_descriptor_allocator.h"
+#include "vk_descriptor_cache.h"
 #include "vk_device_memory.h"
 #include "vk_pipeline.h"
+#include "vk_pipeline_compiler.h"
+#include "vk_pipeline_permutations.h"
+#include "vk_pipeline_registry.h"
+#include "vk_mapped_file.h"
+#include "vk_shader_cache.h"
+#include "vk_shader_reflection.h"
+#include "vk_shader_reloader.h"
+#include "vk_texture_loader.h"
+#include "vk_staging_buffer.h"
+#include "vk_image_decoder.h"
+#include "vk_texture_container.h"
+#include "vk_block_encoder.h"
+#include "vk_mip_generator.h"
+#include "vk_mip_downsampler.h"
+#include "vk_texture_residency.h"
+#include "vk_texture_atlas.h"
+#include "vk_sampler_cache.h"
+#include "vk_image_view_cache.h"
+#include "vk_render_graph.h"
 #include "vk_renderpass.h"
 #include "vk_sampler.h"
 #include "vk_shader_module.h"
 #include "vk_sync.h"
 #include "vk_texture_image.h"
+#include "vk_transient_memory.h"
@@ -28,6 +28,7 @@
 #include "vk_app.h"
 #include "logging.h"
 #include "vulkan_library.h"
+#include <cstring>
 #include <map>
 
 namespace circe::vk {
@@ -71,6 +72,16 @@ bool App::setInstance(const std::vector<const char *> &extensions) {
   auto window_extensions = graphics_display_->requiredVkExtensions();
   for (auto e : window_extensions)
     es.emplace_back(e);
+  // queries such as PhysicalDevice::memoryBudget (VK_EXT_memory_budget) need
+  // vkGetPhysicalDeviceMemoryProperties2KHR on this 1.0 instance. Devices
+  // are not known yet, so it is enabled whenever the loader offers it.
+  const char *properties2 =
+      VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME;
+  bool requested = false;
+  for (auto e : es)
+    requested |= !std::strcmp(e, properties2);
+  if (!requested && SupportInfo().isInstanceExtensionSupported(properties2))
+    es.emplace_back(properties2);
   instance_ = std::make_unique<Instance>(application_name_, es,
                                          validation_layer_names_);
   graphics_display_->createWindowSurface(instance_.get(), vk_surface_);
@@ -112,7 +123,7 @@ bool App::pickPhysicalDevice(
 
 bool App::createLogicalDevice(
     const std::vector<const char *> &desired_extensions,
-    VkPhysicalDeviceFeatures *desired_features) {
+    VkPhysicalDeviceFeatures *desired_features, const void *features_chain) {
   if (!physical_device_)
     pickPhysicalDevice([&](const circe::vk::PhysicalDevice &d,
                            circe::vk::QueueFamilies &q) -> uint32_t {
@@ -127,7 +138,8 @@ bool App::createLogicalDevice(
   extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
   logical_device_ =
       std::make_unique<LogicalDevice>(physical_device_.get(), extensions, &features,
-                                      queue_families_, validation_layer_names_);
+                                      queue_families_, validation_layer_names_,
+                                      features_chain);
   render_engine.setDeviceInfo(logical_device_.get(),
                               queue_families_.family("graphics").family_index.value());
   return logical_device_->good();
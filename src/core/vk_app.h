@@ -64,6 +64,7 @@ public:
                       bool instance_level = true, bool device_level = true);
   /// Internally creates the Vulkan Instance from information about the
   /// application and desired extensions.
+  /// VK_KHR_get_physical_device_properties2 is also enabled when supported.
   /// \param extensions **[in | optional]** list of instance extension names
   /// \return true on success
   bool setInstance(const std::vector<const char *> &extensions =
@@ -85,10 +86,13 @@ public:
   /// \param queue_infos **[in]**
   /// \param desired_extensions **[in]** desired device extensions list
   /// \param desired_features **[in]** desired features list
+  /// \param features_chain **[in | optional = nullptr]** extension feature
+  /// structures chained into the device creation
   /// \return bool true if success
   bool createLogicalDevice(const std::vector<const char *> &desired_extensions =
                                std::vector<char const *>(),
-                           VkPhysicalDeviceFeatures *desired_features = {});
+                           VkPhysicalDeviceFeatures *desired_features = {},
+                           const void *features_chain = nullptr);
   const Instance *instance();
   const LogicalDevice *logicalDevice();
   const PhysicalDevice* physicalDevice();
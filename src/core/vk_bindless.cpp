@@ -0,0 +1,210 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_bindless.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_bindless.h"
+#include "logging.h"
+#include "vulkan_debug.h"
+
+namespace circe::vk {
+
+BindlessTextureTable::BindlessTextureTable(const LogicalDevice *logical_device,
+                                           uint32_t max_images,
+                                           uint32_t max_samplers,
+                                           VkShaderStageFlags stages,
+                                           uint32_t frames_in_flight)
+    : logical_device_(logical_device), max_images_(max_images),
+      max_samplers_(max_samplers), frames_in_flight_(frames_in_flight),
+      layout_(logical_device), live_image_slots_(max_images, false) {
+  if (!isSupported(logical_device))
+    INFO("VK_EXT_descriptor_indexing is not enabled.");
+  VkDescriptorBindingFlagsEXT flags =
+      VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+      VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT;
+  layout_.addLayoutBinding(images_binding, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                           max_images_, stages);
+  layout_.addLayoutBinding(samplers_binding, VK_DESCRIPTOR_TYPE_SAMPLER,
+                           max_samplers_, stages);
+  layout_.setBindingFlags(images_binding, flags);
+  layout_.setBindingFlags(samplers_binding, flags);
+  layout_.setCreateFlags(
+      VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT);
+}
+
+BindlessTextureTable::~BindlessTextureTable() {
+  if (vk_descriptor_pool_ != VK_NULL_HANDLE)
+    vkDestroyDescriptorPool(logical_device_->handle(), vk_descriptor_pool_,
+                            nullptr);
+}
+
+bool BindlessTextureTable::isSupported(const LogicalDevice *logical_device) {
+  return logical_device && logical_device->isExtensionEnabled(
+                               VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+}
+
+VkPhysicalDeviceDescriptorIndexingFeaturesEXT
+BindlessTextureTable::requiredFeatures() {
+  VkPhysicalDeviceDescriptorIndexingFeaturesEXT features{};
+  features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+  features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+  features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+  features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+  features.descriptorBindingPartiallyBound = VK_TRUE;
+  features.runtimeDescriptorArray = VK_TRUE;
+  return features;
+}
+
+DescriptorSetLayout &BindlessTextureTable::descriptorSetLayout() {
+  return layout_;
+}
+
+VkDescriptorSet BindlessTextureTable::descriptorSet() {
+  if (vk_descriptor_set_ != VK_NULL_HANDLE)
+    return vk_descriptor_set_;
+  VkDescriptorPoolSize pool_sizes[2] = {
+      {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, max_images_},
+      {VK_DESCRIPTOR_TYPE_SAMPLER, max_samplers_}};
+  VkDescriptorPoolCreateInfo pool_info = {
+      VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, // VkStructureType sType
+      nullptr, // const void *                pNext
+      VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT, // flags
+      1,          // uint32_t                    maxSets
+      2,          // uint32_t                    poolSizeCount
+      pool_sizes, // const VkDescriptorPoolSize* pPoolSizes
+  };
+  VkResult result = vkCreateDescriptorPool(
+      logical_device_->handle(), &pool_info, nullptr, &vk_descriptor_pool_);
+  CHECK_VULKAN(result);
+  if (result != VK_SUCCESS)
+    return VK_NULL_HANDLE;
+  VkDescriptorSetLayout set_layout = layout_.handle();
+  VkDescriptorSetAllocateInfo allocate_info = {
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, nullptr,
+      vk_descriptor_pool_, 1, &set_layout};
+  result = vkAllocateDescriptorSets(logical_device_->handle(), &allocate_info,
+                                    &vk_descriptor_set_);
+  CHECK_VULKAN(result);
+  if (result != VK_SUCCESS)
+    vk_descriptor_set_ = VK_NULL_HANDLE;
+  return vk_descriptor_set_;
+}
+
+uint32_t BindlessTextureTable::addImage(const Image::View &view,
+                                        VkImageLayout layout) {
+  if (descriptorSet() == VK_NULL_HANDLE)
+    return ~0u;
+  uint32_t index = ~0u;
+  if (!free_image_slots_.empty()) {
+    index = free_image_slots_.back();
+    free_image_slots_.pop_back();
+  } else if (next_image_slot_ < max_images_)
+    index = next_image_slot_++;
+  if (index == ~0u) {
+    INFO("Bindless texture table is full.");
+    return index;
+  }
+  VkDescriptorImageInfo image_info = {VK_NULL_HANDLE, view.handle(), layout};
+  VkWriteDescriptorSet write = {
+      VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, // VkStructureType sType
+      nullptr,                          // const void *            pNext
+      vk_descriptor_set_,               // VkDescriptorSet         dstSet
+      images_binding,                   // uint32_t                dstBinding
+      index,                            // uint32_t                dstArrayElement
+      1,                                // uint32_t                descriptorCount
+      VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, // VkDescriptorType        descriptorType
+      &image_info,                      // const VkDescriptorImageInfo *pImageInfo
+      nullptr,                          // const VkDescriptorBufferInfo*pBufferInfo
+      nullptr                           // const VkBufferView *    pTexelBufferView
+  };
+  vkUpdateDescriptorSets(logical_device_->handle(), 1, &write, 0, nullptr);
+  live_image_slots_[index] = true;
+  image_count_++;
+  return index;
+}
+
+bool BindlessTextureTable::removeImage(uint32_t index) {
+  D_RETURN_FALSE_IF_NOT(index < next_image_slot_ && live_image_slots_[index],
+                        "Bindless image slot is not registered.");
+  // the slot descriptor is left as is: partially bound arrays allow stale
+  // descriptors as long as shaders don't access them
+  live_image_slots_[index] = false;
+  pending_image_slots_.push_back({index, frame_});
+  image_count_--;
+  return true;
+}
+
+uint32_t BindlessTextureTable::addSampler(const Sampler &sampler) {
+  auto it = sampler_slots_.find(sampler.handle());
+  if (it != sampler_slots_.end())
+    return it->second;
+  if (descriptorSet() == VK_NULL_HANDLE)
+    return ~0u;
+  if (sampler_slots_.size() >= max_samplers_) {
+    INFO("Bindless sampler table is full.");
+    return ~0u;
+  }
+  auto index = static_cast<uint32_t>(sampler_slots_.size());
+  VkDescriptorImageInfo image_info = {sampler.handle(), VK_NULL_HANDLE,
+                                      VK_IMAGE_LAYOUT_UNDEFINED};
+  VkWriteDescriptorSet write = {
+      VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, // VkStructureType sType
+      nullptr,                     // const void *                 pNext
+      vk_descriptor_set_,          // VkDescriptorSet              dstSet
+      samplers_binding,            // uint32_t                     dstBinding
+      index,                       // uint32_t                     dstArrayElement
+      1,                           // uint32_t                     descriptorCount
+      VK_DESCRIPTOR_TYPE_SAMPLER,  // VkDescriptorType             descriptorType
+      &image_info,                 // const VkDescriptorImageInfo *pImageInfo
+      nullptr,                     // const VkDescriptorBufferInfo*pBufferInfo
+      nullptr                      // const VkBufferView *         pTexelBufferView
+  };
+  vkUpdateDescriptorSets(logical_device_->handle(), 1, &write, 0, nullptr);
+  sampler_slots_[sampler.handle()] = index;
+  return index;
+}
+
+void BindlessTextureTable::nextFrame() {
+  frame_++;
+  for (size_t i = 0; i < pending_image_slots_.size();) {
+    if (frame_ - pending_image_slots_[i].frame >= frames_in_flight_) {
+      free_image_slots_.emplace_back(pending_image_slots_[i].index);
+      pending_image_slots_[i] = pending_image_slots_.back();
+      pending_image_slots_.pop_back();
+    } else
+      ++i;
+  }
+}
+
+void BindlessTextureTable::bind(CommandBuffer &command_buffer,
+                                PipelineLayout *pipeline_layout, uint32_t set,
+                                VkPipelineBindPoint bind_point) {
+  command_buffer.bind(bind_point, pipeline_layout, set, {descriptorSet()});
+}
+
+uint32_t BindlessTextureTable::imageCount() const { return image_count_; }
+
+} // namespace circe::vk
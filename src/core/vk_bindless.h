@@ -0,0 +1,130 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_bindless.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_BINDLESS_H
+#define CIRCE_VK_BINDLESS_H
+
+#include "vk_command_buffer.h"
+#include "vk_sampler.h"
+#include <unordered_map>
+
+namespace circe::vk {
+
+/// \brief Bindless texture table built on VK_EXT_descriptor_indexing.
+/// A single descriptor set holds a large array of sampled images (binding 0)
+/// and an array of samplers (binding 1). Both are partially bound and
+/// updatable after bind, so textures can be added while the set is in use and
+/// draws only need the indices (through push constants or instance data):
+///   layout(set = S, binding = 0) uniform texture2D textures[];
+///   layout(set = S, binding = 1) uniform sampler samplers[];
+///   texture(sampler2D(textures[nonuniformEXT(i)], samplers[s]), uv);
+/// The device must be created with VK_EXT_descriptor_indexing and the
+/// features returned by requiredFeatures() chained into its creation.
+/// Textures register themselves through Texture::registerBindless.
+class BindlessTextureTable final {
+public:
+  static const uint32_t images_binding = 0;
+  static const uint32_t samplers_binding = 1;
+  ///\param logical_device **[in]**
+  ///\param max_images **[in | optional = 4096]** image array size
+  ///\param max_samplers **[in | optional = 32]** sampler array size
+  ///\param stages **[in | optional = VK_SHADER_STAGE_FRAGMENT_BIT]**
+  ///\param frames_in_flight **[in | optional = 2]** number of frames a
+  /// removed slot waits before being reused
+  explicit BindlessTextureTable(
+      const LogicalDevice *logical_device, uint32_t max_images = 4096,
+      uint32_t max_samplers = 32,
+      VkShaderStageFlags stages = VK_SHADER_STAGE_FRAGMENT_BIT,
+      uint32_t frames_in_flight = 2);
+  ~BindlessTextureTable();
+  ///\param logical_device **[in]**
+  ///\return bool true if the descriptor indexing extension is enabled
+  static bool isSupported(const LogicalDevice *logical_device);
+  ///\return VkPhysicalDeviceDescriptorIndexingFeaturesEXT features to chain
+  /// into the logical device creation
+  static VkPhysicalDeviceDescriptorIndexingFeaturesEXT requiredFeatures();
+  ///\return DescriptorSetLayout& layout to be added to pipeline layouts
+  DescriptorSetLayout &descriptorSetLayout();
+  ///\return VkDescriptorSet the table set (created on first use)
+  VkDescriptorSet descriptorSet();
+  ///\brief Registers an image view into a free slot
+  ///\param view **[in]** must stay alive while registered
+  ///\param layout **[in | optional = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL]**
+  ///\return uint32_t slot index (~0u if the table is full)
+  uint32_t addImage(const Image::View &view,
+                    VkImageLayout layout =
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  ///\brief Releases a slot. The slot is reused only after frames_in_flight
+  /// calls to nextFrame(), so frames still in flight can read it.
+  ///\param index **[in]** slot index returned by addImage
+  ///\return bool false if **index** is not a registered slot (ex: removed
+  /// twice), in which case nothing is done
+  bool removeImage(uint32_t index);
+  ///\brief Registers a sampler (the same sampler always gets the same index)
+  ///\param sampler **[in]**
+  ///\return uint32_t sampler index (~0u if the table is full)
+  uint32_t addSampler(const Sampler &sampler);
+  ///\brief Advances the frame counter, recycling slots removed
+  /// frames_in_flight frames ago
+  void nextFrame();
+  ///\brief Binds the table set
+  ///\param command_buffer **[in]**
+  ///\param pipeline_layout **[in]** layout containing descriptorSetLayout()
+  ///\param set **[in]** set index of the table in the pipeline layout
+  ///\param bind_point **[in | optional = VK_PIPELINE_BIND_POINT_GRAPHICS]**
+  void bind(CommandBuffer &command_buffer, PipelineLayout *pipeline_layout,
+            uint32_t set,
+            VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS);
+  ///\return uint32_t number of registered images
+  [[nodiscard]] uint32_t imageCount() const;
+
+private:
+  struct PendingSlot {
+    uint32_t index;
+    uint64_t frame;
+  };
+
+  const LogicalDevice *logical_device_ = nullptr;
+  uint32_t max_images_{0};
+  uint32_t max_samplers_{0};
+  uint32_t frames_in_flight_{2};
+  DescriptorSetLayout layout_;
+  VkDescriptorPool vk_descriptor_pool_ = VK_NULL_HANDLE;
+  VkDescriptorSet vk_descriptor_set_ = VK_NULL_HANDLE;
+  // slot management
+  uint32_t next_image_slot_{0};
+  std::vector<uint32_t> free_image_slots_;
+  std::vector<PendingSlot> pending_image_slots_;
+  std::vector<bool> live_image_slots_;
+  uint32_t image_count_{0};
+  uint64_t frame_{0};
+  std::unordered_map<VkSampler, uint32_t> sampler_slots_;
+};
+
+} // namespace circe::vk
+
+#endif
@@ -0,0 +1,510 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_block_encoder.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_block_encoder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CIRCE_VK_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace circe::vk {
+
+namespace {
+
+// 4x4 RGBA8 texels of a block, row major
+struct Block {
+  alignas(16) uint8_t texels[64];
+};
+
+void loadBlock(const uint8_t *rgba, uint32_t width, uint32_t height,
+               uint32_t block_x, uint32_t block_y, Block &block) {
+  uint32_t x0 = block_x * 4;
+  uint32_t y0 = block_y * 4;
+  if (x0 + 4 <= width && y0 + 4 <= height) {
+    for (uint32_t y = 0; y < 4; ++y)
+      std::memcpy(block.texels + 16 * y, rgba + ((y0 + y) * width + x0) * 4,
+                  16);
+    return;
+  }
+  // partial block, replicate border texels
+  for (uint32_t y = 0; y < 4; ++y)
+    for (uint32_t x = 0; x < 4; ++x) {
+      uint32_t sx = std::min(x0 + x, width - 1);
+      uint32_t sy = std::min(y0 + y, height - 1);
+      std::memcpy(block.texels + 16 * y + 4 * x,
+                  rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+    }
+}
+
+// per channel minimum and maximum of the block texels
+void channelRange(const Block &block, uint8_t min[4], uint8_t max[4]) {
+#ifdef CIRCE_VK_SSE2
+  auto *rows = reinterpret_cast<const __m128i *>(block.texels);
+  __m128i mn = _mm_min_epu8(_mm_min_epu8(rows[0], rows[1]),
+                            _mm_min_epu8(rows[2], rows[3]));
+  __m128i mx = _mm_max_epu8(_mm_max_epu8(rows[0], rows[1]),
+                            _mm_max_epu8(rows[2], rows[3]));
+  mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+  mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+  mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+  mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+  int32_t packed_min = _mm_cvtsi128_si32(mn);
+  int32_t packed_max = _mm_cvtsi128_si32(mx);
+  std::memcpy(min, &packed_min, 4);
+  std::memcpy(max, &packed_max, 4);
+#else
+  for (int c = 0; c < 4; ++c) {
+    min[c] = 255;
+    max[c] = 0;
+  }
+  for (int i = 0; i < 16; ++i)
+    for (int c = 0; c < 4; ++c) {
+      min[c] = std::min(min[c], block.texels[4 * i + c]);
+      max[c] = std::max(max[c], block.texels[4 * i + c]);
+    }
+#endif
+}
+
+// Projects the RGB of each texel onto the segment origin + [0, 1] * axis,
+// quantized to [0, steps] (scale = steps / |axis|^2)
+void project(const Block &block, const int origin[3], const int axis[3],
+             float scale, int16_t t[16], int16_t steps) {
+#ifdef CIRCE_VK_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i o = _mm_setr_epi16(origin[0], origin[1], origin[2], 0,
+                                   origin[0], origin[1], origin[2], 0);
+  const __m128i d = _mm_setr_epi16(axis[0], axis[1], axis[2], 0, axis[0],
+                                   axis[1], axis[2], 0);
+  const __m128 s = _mm_set1_ps(scale);
+  const __m128i max_step = _mm_set1_epi16(steps);
+  auto *rows = reinterpret_cast<const __m128i *>(block.texels);
+  for (int half = 0; half < 2; ++half) {
+    __m128i dots[2];
+    for (int r = 0; r < 2; ++r) {
+      __m128i row = rows[2 * half + r];
+      // (r * dr + g * dg, b * db) for two texels at a time
+      __m128i a = _mm_madd_epi16(
+          _mm_sub_epi16(_mm_unpacklo_epi8(row, zero), o), d);
+      __m128i b = _mm_madd_epi16(
+          _mm_sub_epi16(_mm_unpackhi_epi8(row, zero), o), d);
+      a = _mm_add_epi32(a, _mm_srli_epi64(a, 32));
+      b = _mm_add_epi32(b, _mm_srli_epi64(b, 32));
+      __m128i dot = _mm_castps_si128(
+          _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b),
+                         _MM_SHUFFLE(2, 0, 2, 0)));
+      dots[r] = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(dot), s));
+    }
+    __m128i packed = _mm_packs_epi32(dots[0], dots[1]);
+    packed = _mm_min_epi16(_mm_max_epi16(packed, zero), max_step);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(t + 8 * half), packed);
+  }
+#else
+  for (int i = 0; i < 16; ++i) {
+    int dot = 0;
+    for (int c = 0; c < 3; ++c)
+      dot += (block.texels[4 * i + c] - origin[c]) * axis[c];
+    auto v = static_cast<int16_t>(
+        std::lrint(static_cast<float>(dot) * scale));
+    t[i] = std::min<int16_t>(std::max<int16_t>(v, 0), steps);
+  }
+#endif
+}
+
+// copies one channel of the block texels
+void extractChannel(const Block &block, int channel, uint8_t values[16]) {
+#ifdef CIRCE_VK_SSE2
+  auto *rows = reinterpret_cast<const __m128i *>(block.texels);
+  const __m128i mask = _mm_set1_epi32(0xff);
+  const __m128i shift = _mm_cvtsi32_si128(8 * channel);
+  __m128i r[4];
+  for (int i = 0; i < 4; ++i)
+    r[i] = _mm_and_si128(_mm_srl_epi32(rows[i], shift), mask);
+  __m128i packed = _mm_packus_epi16(_mm_packs_epi32(r[0], r[1]),
+                                    _mm_packs_epi32(r[2], r[3]));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(values), packed);
+#else
+  for (int i = 0; i < 16; ++i)
+    values[i] = block.texels[4 * i + channel];
+#endif
+}
+
+uint16_t to565(const int color[3]) {
+  return static_cast<uint16_t>(((color[0] * 31 + 127) / 255) << 11 |
+                               ((color[1] * 63 + 127) / 255) << 5 |
+                               ((color[2] * 31 + 127) / 255));
+}
+
+void from565(uint16_t value, int color[3]) {
+  int r = (value >> 11) & 31;
+  int g = (value >> 5) & 63;
+  int b = value & 31;
+  color[0] = (r << 3) | (r >> 2);
+  color[1] = (g << 2) | (g >> 4);
+  color[2] = (b << 3) | (b >> 2);
+}
+
+// BC1 color block (always in 4 color mode, as required by BC3)
+void encodeColor(const Block &block, uint8_t *out) {
+  uint8_t mn[4], mx[4];
+  channelRange(block, mn, mx);
+  int lo[3], hi[3], mid[3];
+  int reference = 0;
+  for (int c = 0; c < 3; ++c) {
+    // the extremes are usually outliers, inset the box by 1/16 of its size
+    int inset = (mx[c] - mn[c]) >> 4;
+    lo[c] = mn[c] + inset;
+    hi[c] = mx[c] - inset;
+    mid[c] = (mn[c] + mx[c]) / 2;
+    if (mx[c] - mn[c] > mx[reference] - mn[reference])
+      reference = c;
+  }
+  // choose the box diagonal: channels negatively correlated with the widest
+  // channel run in the opposite direction
+  for (int c = 0; c < 3; ++c) {
+    if (c == reference)
+      continue;
+    int covariance = 0;
+    for (int i = 0; i < 16; ++i)
+      covariance += (block.texels[4 * i + reference] - mid[reference]) *
+                    (block.texels[4 * i + c] - mid[c]);
+    if (covariance < 0)
+      std::swap(lo[c], hi[c]);
+  }
+  uint16_t c0 = to565(hi);
+  uint16_t c1 = to565(lo);
+  if (c0 < c1)
+    std::swap(c0, c1);
+  out[0] = c0 & 0xff;
+  out[1] = c0 >> 8;
+  out[2] = c1 & 0xff;
+  out[3] = c1 >> 8;
+  uint32_t indices = 0;
+  if (c0 != c1) {
+    int e0[3], e1[3], axis[3];
+    from565(c0, e0);
+    from565(c1, e1);
+    int length2 = 0;
+    for (int c = 0; c < 3; ++c) {
+      axis[c] = e0[c] - e1[c];
+      length2 += axis[c] * axis[c];
+    }
+    int16_t t[16];
+    project(block, e1, axis, 3.f / length2, t, 3);
+    // palette order: e0, e1, 2/3 e0 + 1/3 e1, 1/3 e0 + 2/3 e1
+    static const uint32_t index_of_step[4] = {1, 3, 2, 0};
+    for (int i = 0; i < 16; ++i)
+      indices |= index_of_step[t[i]] << (2 * i);
+  }
+  std::memcpy(out + 4, &indices, 4);
+}
+
+// BC4 block (8 values mode)
+void encodeChannel(const Block &block, int channel, uint8_t *out) {
+  uint8_t values[16];
+  extractChannel(block, channel, values);
+  int16_t t[16];
+  uint8_t mn = 255, mx = 0;
+#ifdef CIRCE_VK_SSE2
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+  __m128i vmin = v, vmax = v;
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 8));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 8));
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 4));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 4));
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 2));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 2));
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 1));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 1));
+  mn = static_cast<uint8_t>(_mm_cvtsi128_si32(vmin) & 0xff);
+  mx = static_cast<uint8_t>(_mm_cvtsi128_si32(vmax) & 0xff);
+#else
+  for (auto value : values) {
+    mn = std::min(mn, value);
+    mx = std::max(mx, value);
+  }
+#endif
+  out[0] = mx;
+  out[1] = mn;
+  uint64_t indices = 0;
+  if (mx != mn) {
+    int range = mx - mn;
+    // t = round(7 * (v - min) / range) in 8.8 fixed point, (v - min) * scale
+    // never exceeds 16 bits
+    int scale = (7 * 256 + range / 2) / range;
+#ifdef CIRCE_VK_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i vmn = _mm_set1_epi16(mn);
+    const __m128i s = _mm_set1_epi16(static_cast<int16_t>(scale));
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i seven = _mm_set1_epi16(7);
+    __m128i lo_t = _mm_sub_epi16(_mm_unpacklo_epi8(v, zero), vmn);
+    __m128i hi_t = _mm_sub_epi16(_mm_unpackhi_epi8(v, zero), vmn);
+    lo_t = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo_t, s), half), 8);
+    hi_t = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi_t, s), half), 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(t),
+                     _mm_min_epi16(lo_t, seven));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(t + 8),
+                     _mm_min_epi16(hi_t, seven));
+#else
+    for (int i = 0; i < 16; ++i)
+      t[i] = std::min((((values[i] - mn) * scale + 128) >> 8), 7);
+#endif
+    // palette order: max, min, then from max to min
+    for (int i = 0; i < 16; ++i) {
+      uint64_t index = t[i] == 7 ? 0 : t[i] == 0 ? 1 : 8 - t[i];
+      indices |= index << (3 * i);
+    }
+  }
+  for (int i = 0; i < 6; ++i)
+    out[2 + i] = (indices >> (8 * i)) & 0xff;
+}
+
+void decodeColor(const uint8_t *in, uint8_t texels[64]) {
+  uint16_t c0 = in[0] | (in[1] << 8);
+  uint16_t c1 = in[2] | (in[3] << 8);
+  int palette[4][3];
+  from565(c0, palette[0]);
+  from565(c1, palette[1]);
+  for (int c = 0; c < 3; ++c)
+    if (c0 > c1) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    } else {
+      palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+      palette[3][c] = 0;
+    }
+  uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) |
+                     (static_cast<uint32_t>(in[7]) << 24);
+  for (int i = 0; i < 16; ++i)
+    for (int c = 0; c < 3; ++c)
+      texels[4 * i + c] =
+          static_cast<uint8_t>(palette[(indices >> (2 * i)) & 3][c]);
+}
+
+void decodeChannel(const uint8_t *in, int channel, uint8_t texels[64]) {
+  int palette[8] = {in[0], in[1]};
+  if (in[0] > in[1]) {
+    for (int i = 2; i < 8; ++i)
+      palette[i] = ((8 - i) * in[0] + (i - 1) * in[1]) / 7;
+  } else {
+    for (int i = 2; i < 6; ++i)
+      palette[i] = ((6 - i) * in[0] + (i - 1) * in[1]) / 5;
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+  uint64_t indices = 0;
+  for (int i = 0; i < 6; ++i)
+    indices |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+  for (int i = 0; i < 16; ++i)
+    texels[4 * i + channel] =
+        static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+}
+
+// bit c is set if channel c is stored by the format
+uint32_t channelMask(BlockEncoder::Format format) {
+  switch (format) {
+  case BlockEncoder::Format::BC1:
+    return 0x7;
+  case BlockEncoder::Format::BC3:
+    return 0xf;
+  case BlockEncoder::Format::BC4:
+    return 0x1;
+  case BlockEncoder::Format::BC5:
+    return 0x3;
+  }
+  return 0;
+}
+
+} // namespace
+
+double BlockEncoder::Statistics::megapixelsPerSecond() const {
+  if (encode_time <= 0)
+    return 0;
+  return pixels / 1e6 / (encode_time / 1000.0);
+}
+
+BlockEncoder::BlockEncoder(uint32_t thread_count)
+    : thread_count_(thread_count) {
+  if (!thread_count_)
+    thread_count_ = std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool BlockEncoder::encode(Format format, const uint8_t *rgba, uint32_t width,
+                          uint32_t height, uint8_t *blocks) {
+  if (!rgba || !blocks || !width || !height)
+    return false;
+  auto start = std::chrono::steady_clock::now();
+  const uint32_t blocks_x = (width + 3) / 4;
+  const uint32_t blocks_y = (height + 3) / 4;
+  const uint32_t block_size = blockSize(format);
+  // rows of blocks are handed to threads as they finish the previous one
+  std::atomic<uint32_t> next{0};
+  auto worker = [&]() {
+    Block block;
+    for (uint32_t y = next++; y < blocks_y; y = next++) {
+      uint8_t *out = blocks + static_cast<size_t>(y) * blocks_x * block_size;
+      for (uint32_t x = 0; x < blocks_x; ++x, out += block_size) {
+        loadBlock(rgba, width, height, x, y, block);
+        switch (format) {
+        case Format::BC1:
+          encodeColor(block, out);
+          break;
+        case Format::BC3:
+          encodeChannel(block, 3, out);
+          encodeColor(block, out + 8);
+          break;
+        case Format::BC4:
+          encodeChannel(block, 0, out);
+          break;
+        case Format::BC5:
+          encodeChannel(block, 0, out);
+          encodeChannel(block, 1, out + 8);
+          break;
+        }
+      }
+    }
+  };
+  uint32_t thread_count = std::min(thread_count_, blocks_y);
+  std::vector<std::thread> threads;
+  for (uint32_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::lock_guard<std::mutex> guard(mutex_);
+  statistics_.pixels += static_cast<uint64_t>(width) * height;
+  statistics_.encode_time += elapsed.count();
+  return true;
+}
+
+BlockEncoder::Statistics BlockEncoder::statistics() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return statistics_;
+}
+
+void BlockEncoder::decode(Format format, const uint8_t *blocks,
+                          uint32_t width, uint32_t height, uint8_t *rgba) {
+  const uint32_t blocks_x = (width + 3) / 4;
+  const uint32_t blocks_y = (height + 3) / 4;
+  const uint32_t block_size = blockSize(format);
+  for (uint32_t by = 0; by < blocks_y; ++by)
+    for (uint32_t bx = 0; bx < blocks_x; ++bx) {
+      const uint8_t *in =
+          blocks + (static_cast<size_t>(by) * blocks_x + bx) * block_size;
+      uint8_t texels[64] = {};
+      for (int i = 0; i < 16; ++i)
+        texels[4 * i + 3] = 255;
+      switch (format) {
+      case Format::BC1:
+        decodeColor(in, texels);
+        break;
+      case Format::BC3:
+        decodeChannel(in, 3, texels);
+        decodeColor(in + 8, texels);
+        break;
+      case Format::BC4:
+        decodeChannel(in, 0, texels);
+        break;
+      case Format::BC5:
+        decodeChannel(in, 0, texels);
+        decodeChannel(in + 8, 1, texels);
+        break;
+      }
+      for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y)
+        for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x)
+          std::memcpy(rgba + ((static_cast<size_t>(by) * 4 + y) * width +
+                              bx * 4 + x) *
+                                 4,
+                      texels + 16 * y + 4 * x, 4);
+    }
+}
+
+double BlockEncoder::psnr(Format format, const uint8_t *original,
+                          const uint8_t *decoded, uint32_t width,
+                          uint32_t height) {
+  uint32_t mask = channelMask(format);
+  double error = 0;
+  uint64_t count = 0;
+  for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i)
+    for (int c = 0; c < 4; ++c)
+      if (mask & (1u << c)) {
+        double d = double(original[4 * i + c]) - decoded[4 * i + c];
+        error += d * d;
+        count++;
+      }
+  if (!count || error == 0)
+    return std::numeric_limits<double>::infinity();
+  double mse = error / count;
+  return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+uint32_t BlockEncoder::blockSize(Format format) {
+  switch (format) {
+  case Format::BC1:
+  case Format::BC4:
+    return 8;
+  case Format::BC3:
+  case Format::BC5:
+    return 16;
+  }
+  return 0;
+}
+
+VkDeviceSize BlockEncoder::encodedSize(Format format, uint32_t width,
+                                       uint32_t height) {
+  return static_cast<VkDeviceSize>((width + 3) / 4) * ((height + 3) / 4) *
+         blockSize(format);
+}
+
+VkFormat BlockEncoder::vkFormat(Format format, bool srgb) {
+  switch (format) {
+  case Format::BC1:
+    return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+  case Format::BC3:
+    return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+  case Format::BC4:
+    return VK_FORMAT_BC4_UNORM_BLOCK;
+  case Format::BC5:
+    return VK_FORMAT_BC5_UNORM_BLOCK;
+  }
+  return VK_FORMAT_UNDEFINED;
+}
+
+} // namespace circe::vk
@@ -0,0 +1,120 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_block_encoder.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_BLOCK_ENCODER_H
+#define CIRCE_VK_BLOCK_ENCODER_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <mutex>
+
+namespace circe::vk {
+
+/// \brief CPU block-compression encoder for offline texture cooking.
+/// Converts RGBA8 images into BC1, BC3, BC4 or BC5 blocks. Each 4x4 block is
+/// encoded with a bounding box fit (inset box, diagonal chosen by the sign of
+/// the channel covariances) and endpoint projection. The per-block work is
+/// SSE2 vectorized (the 16 texels of a block fit in 4 registers), and rows
+/// of blocks are distributed among threads.
+/// Usage:
+///   BlockEncoder encoder;
+///   std::vector<uint8_t> blocks(
+///       BlockEncoder::encodedSize(BlockEncoder::Format::BC1, w, h));
+///   encoder.encode(BlockEncoder::Format::BC1, rgba, w, h, blocks.data());
+///   TextureContainer::writeDDS("albedo.dds",
+///       BlockEncoder::vkFormat(BlockEncoder::Format::BC1, true), {w, h},
+///       {blocks});
+class BlockEncoder final {
+public:
+  enum class Format {
+    BC1, //!< RGB, 8 bytes per block (alpha is ignored)
+    BC3, //!< RGBA, 16 bytes per block
+    BC4, //!< R, 8 bytes per block
+    BC5  //!< RG, 16 bytes per block
+  };
+  struct Statistics {
+    uint64_t pixels{0};      //!< encoded pixels
+    double encode_time{0};   //!< wall time spent in encode (ms)
+    ///\return double encoded megapixels per second
+    [[nodiscard]] double megapixelsPerSecond() const;
+  };
+  ///\param thread_count **[in | optional = 0]** 0 means one thread per
+  /// hardware thread
+  explicit BlockEncoder(uint32_t thread_count = 0);
+  ///\brief Encodes the image. Blocks are stored row by row, partial blocks
+  /// at the right and bottom borders replicate the border texels.
+  ///\param format **[in]**
+  ///\param rgba **[in]** width * height tightly packed RGBA8 texels
+  ///\param width **[in]**
+  ///\param height **[in]**
+  ///\param blocks **[out]** at least encodedSize(format, width, height) bytes
+  ///\return bool true if success
+  bool encode(Format format, const uint8_t *rgba, uint32_t width,
+              uint32_t height, uint8_t *blocks);
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+  ///\brief Decodes blocks produced by encode (used to measure quality).
+  /// Channels not stored by the format are set to 0 (alpha to 255).
+  ///\param format **[in]**
+  ///\param blocks **[in]**
+  ///\param width **[in]**
+  ///\param height **[in]**
+  ///\param rgba **[out]** width * height RGBA8 texels
+  static void decode(Format format, const uint8_t *blocks, uint32_t width,
+                     uint32_t height, uint8_t *rgba);
+  ///\brief Peak signal to noise ratio over the channels stored by the format
+  ///\param format **[in]**
+  ///\param original **[in]** RGBA8 texels
+  ///\param decoded **[in]** RGBA8 texels
+  ///\param width **[in]**
+  ///\param height **[in]**
+  ///\return double PSNR in dB (higher is better, infinity if equal)
+  static double psnr(Format format, const uint8_t *original,
+                     const uint8_t *decoded, uint32_t width, uint32_t height);
+  ///\param format **[in]**
+  ///\return uint32_t bytes per 4x4 block
+  static uint32_t blockSize(Format format);
+  ///\param format **[in]**
+  ///\param width **[in]**
+  ///\param height **[in]**
+  ///\return VkDeviceSize bytes of the encoded image
+  static VkDeviceSize encodedSize(Format format, uint32_t width,
+                                  uint32_t height);
+  ///\param format **[in]**
+  ///\param srgb **[in]** BC1 and BC3 color data interpreted as sRGB
+  ///\return VkFormat
+  static VkFormat vkFormat(Format format, bool srgb);
+
+private:
+  uint32_t thread_count_{1};
+  mutable std::mutex mutex_;
+  Statistics statistics_;
+};
+
+} // namespace circe::vk
+
+#endif
@@ -102,8 +102,10 @@ const VkRenderPassBeginInfo *RenderPassBeginInfo::info() const {
   return &info_;
 }
 
-CommandBuffer::CommandBuffer(VkCommandBuffer vk_command_buffer_)
-    : vk_command_buffer_(vk_command_buffer_) {}
+CommandBuffer::CommandBuffer(VkCommandBuffer vk_command_buffer_,
+                             const LogicalDevice *logical_device)
+    : vk_command_buffer_(vk_command_buffer_), logical_device_(logical_device) {
+}
 
 VkCommandBuffer CommandBuffer::handle() const { return vk_command_buffer_; }
 
@@ -179,7 +181,7 @@ void CommandBuffer::clear(const Image &image, VkImageLayout layout,
                               &value, ranges.size(), ranges.data());
 }
 
-void CommandBuffer::bind(const ComputePipeline &compute_pipeline) const {
+void CommandBuffer::bind(ComputePipeline &compute_pipeline) const {
   vkCmdBindPipeline(vk_command_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE,
                     compute_pipeline.handle());
 }
@@ -189,6 +191,11 @@ void CommandBuffer::bind(GraphicsPipeline *graphics_pipeline) const {
                     graphics_pipeline->handle());
 }
 
+void CommandBuffer::bind(VkPipelineBindPoint pipeline_bind_point,
+                         VkPipeline pipeline) const {
+  vkCmdBindPipeline(vk_command_buffer_, pipeline_bind_point, pipeline);
+}
+
 void CommandBuffer::bind(VkPipelineBindPoint pipeline_bind_point,
                          PipelineLayout *layout, uint32_t first_set,
                          const std::vector<VkDescriptorSet> &descriptor_sets,
@@ -229,6 +236,32 @@ void CommandBuffer::pushConstants(PipelineLayout &pipeline_layout,
                      offset, size, values);
 }
 
+void CommandBuffer::pushDescriptorSet(
+    VkPipelineBindPoint pipeline_bind_point, PipelineLayout &pipeline_layout,
+    uint32_t set, const std::vector<VkWriteDescriptorSet> &writes) const {
+  auto push = pipeline_layout.device()->extensionFunctions()
+                  .vkCmdPushDescriptorSetKHR;
+  if (!push) {
+    INFO("VK_KHR_push_descriptor is not enabled.");
+    return;
+  }
+  push(vk_command_buffer_, pipeline_bind_point, pipeline_layout.handle(), set,
+       static_cast<uint32_t>(writes.size()), writes.data());
+}
+
+void CommandBuffer::pushDescriptorSet(DescriptorUpdateTemplate &update_template,
+                                      PipelineLayout &pipeline_layout,
+                                      uint32_t set, const void *data) const {
+  auto push = pipeline_layout.device()->extensionFunctions()
+                  .vkCmdPushDescriptorSetWithTemplateKHR;
+  if (!push || !update_template.isPushTemplate()) {
+    INFO("Update template can't push descriptors.");
+    return;
+  }
+  push(vk_command_buffer_, update_template.handle(), pipeline_layout.handle(),
+       set, data);
+}
+
 void CommandBuffer::beginRenderPass(const RenderPassBeginInfo &info,
                                     VkSubpassContents contents) const {
   vkCmdBeginRenderPass(vk_command_buffer_, info.info(), contents);
@@ -271,6 +304,30 @@ void CommandBuffer::transitionImageLayout(
                        nullptr, 0, nullptr, 1, &barrier_handle);
 }
 
+void CommandBuffer::transitionImageLayout(
+    const std::vector<ImageMemoryBarrier> &barriers,
+    VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages) const {
+  if (barriers.empty())
+    return;
+  std::vector<VkImageMemoryBarrier> barrier_handles;
+  barrier_handles.reserve(barriers.size());
+  for (const auto &barrier : barriers)
+    barrier_handles.emplace_back(barrier.handle());
+  vkCmdPipelineBarrier(vk_command_buffer_, src_stages, dst_stages, 0, 0,
+                       nullptr, 0, nullptr, barrier_handles.size(),
+                       barrier_handles.data());
+}
+
+void CommandBuffer::use(const Image &image, ImageUsage usage,
+                        uint32_t base_mip_level, uint32_t mip_level_count,
+                        uint32_t base_array_layer,
+                        uint32_t array_layer_count) const {
+  PipelineBarrier barriers;
+  barriers.add(image, usage, base_mip_level, mip_level_count, base_array_layer,
+               array_layer_count);
+  barriers.flush(*this);
+}
+
 void CommandBuffer::blit(const Image &src_image, VkImageLayout src_image_layout,
                          const Image &dst_image, VkImageLayout dst_image_layout,
                          const std::vector<VkImageBlit> &regions,
@@ -281,7 +338,7 @@ void CommandBuffer::blit(const Image &src_image, VkImageLayout src_image_layout,
 }
 
 void CommandBuffer::setViewport(float width, float height, float min_depth,
-                                float max_depth) {
+                                float max_depth) const {
   VkViewport viewport{};
 
   viewport.width = width;
@@ -292,7 +349,8 @@ void CommandBuffer::setViewport(float width, float height, float min_depth,
 }
 
 void CommandBuffer::setScissor(int32_t offset_x, int32_t offset_y,
-                               uint32_t extent_width, uint32_t extent_height) {
+                               uint32_t extent_width,
+                               uint32_t extent_height) const {
   VkRect2D scissor_rect{};
   scissor_rect.offset.x = offset_x;
   scissor_rect.offset.y = offset_y;
@@ -301,6 +359,91 @@ void CommandBuffer::setScissor(int32_t offset_x, int32_t offset_y,
   vkCmdSetScissor(vk_command_buffer_, 0, 1, &scissor_rect);
 }
 
+const LogicalDevice::ExtensionFunctions *
+CommandBuffer::extensionFunctions() const {
+  return logical_device_ ? &logical_device_->extensionFunctions() : nullptr;
+}
+
+void CommandBuffer::setCullMode(VkCullModeFlags cull_mode) const {
+#ifdef VK_EXT_extended_dynamic_state
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetCullModeEXT)
+    f->vkCmdSetCullModeEXT(vk_command_buffer_, cull_mode);
+#endif
+}
+
+void CommandBuffer::setFrontFace(VkFrontFace front_face) const {
+#ifdef VK_EXT_extended_dynamic_state
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetFrontFaceEXT)
+    f->vkCmdSetFrontFaceEXT(vk_command_buffer_, front_face);
+#endif
+}
+
+void CommandBuffer::setPrimitiveTopology(VkPrimitiveTopology topology) const {
+#ifdef VK_EXT_extended_dynamic_state
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetPrimitiveTopologyEXT)
+    f->vkCmdSetPrimitiveTopologyEXT(vk_command_buffer_, topology);
+#endif
+}
+
+void CommandBuffer::setDepthTestEnable(VkBool32 enable) const {
+#ifdef VK_EXT_extended_dynamic_state
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetDepthTestEnableEXT)
+    f->vkCmdSetDepthTestEnableEXT(vk_command_buffer_, enable);
+#endif
+}
+
+void CommandBuffer::setDepthWriteEnable(VkBool32 enable) const {
+#ifdef VK_EXT_extended_dynamic_state
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetDepthWriteEnableEXT)
+    f->vkCmdSetDepthWriteEnableEXT(vk_command_buffer_, enable);
+#endif
+}
+
+void CommandBuffer::setDepthCompareOp(VkCompareOp compare_op) const {
+#ifdef VK_EXT_extended_dynamic_state
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetDepthCompareOpEXT)
+    f->vkCmdSetDepthCompareOpEXT(vk_command_buffer_, compare_op);
+#endif
+}
+
+void CommandBuffer::setDepthBiasEnable(VkBool32 enable) const {
+#ifdef VK_EXT_extended_dynamic_state2
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetDepthBiasEnableEXT)
+    f->vkCmdSetDepthBiasEnableEXT(vk_command_buffer_, enable);
+#endif
+}
+
+void CommandBuffer::setPrimitiveRestartEnable(VkBool32 enable) const {
+#ifdef VK_EXT_extended_dynamic_state2
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetPrimitiveRestartEnableEXT)
+    f->vkCmdSetPrimitiveRestartEnableEXT(vk_command_buffer_, enable);
+#endif
+}
+
+void CommandBuffer::setRasterizerDiscardEnable(VkBool32 enable) const {
+#ifdef VK_EXT_extended_dynamic_state2
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetRasterizerDiscardEnableEXT)
+    f->vkCmdSetRasterizerDiscardEnableEXT(vk_command_buffer_, enable);
+#endif
+}
+
+void CommandBuffer::setPolygonMode(VkPolygonMode polygon_mode) const {
+#ifdef VK_EXT_extended_dynamic_state3
+  auto *f = extensionFunctions();
+  if (f && f->vkCmdSetPolygonModeEXT)
+    f->vkCmdSetPolygonModeEXT(vk_command_buffer_, polygon_mode);
+#endif
+}
+
 CommandPool::CommandPool(const LogicalDevice *logical_device,
                          VkCommandPoolCreateFlags parameters,
                          uint32_t queue_family)
@@ -339,7 +482,7 @@ bool CommandPool::allocateCommandBuffers(
                                           vk_command_buffers.data()));
   command_buffers.clear();
   for (auto cb : vk_command_buffers)
-    command_buffers.emplace_back(cb);
+    command_buffers.emplace_back(cb, logical_device_);
   return true;
 }
 
@@ -89,7 +89,10 @@ public:
   ///\brief Construct a new Command Buffer object
   ///
   ///\param vk_command_buffer **[in]**
-  explicit CommandBuffer(VkCommandBuffer vk_command_buffer_);
+  ///\param logical_device **[in | optional = nullptr]** provides extension
+  /// functions (ex: extended dynamic state setters)
+  explicit CommandBuffer(VkCommandBuffer vk_command_buffer_,
+                         const LogicalDevice *logical_device = nullptr);
   ~CommandBuffer() = default;
   [[nodiscard]] VkCommandBuffer handle() const;
   ///\brief
@@ -221,12 +224,17 @@ public:
   ///
   ///\param compute_pipeline **[in]**
   ///\return bool
-  void bind(const ComputePipeline &compute_pipeline) const;
+  void bind(ComputePipeline &compute_pipeline) const;
   ///\brief
   ///
   ///\param graphics_pipeline **[in]**
   ///\return bool
   void bind(GraphicsPipeline *graphics_pipeline) const;
+  ///\brief Binds a pipeline not owned by a Pipeline object (ex: shared by a
+  /// PipelineRegistry)
+  ///\param pipeline_bind_point **[in]**
+  ///\param pipeline **[in]**
+  void bind(VkPipelineBindPoint pipeline_bind_point, VkPipeline pipeline) const;
   ///
   /// \param pipeline_bind_point
   /// \param layout
@@ -282,6 +290,25 @@ public:
   void pushConstants(PipelineLayout &pipeline_layout,
                      VkShaderStageFlags stage_flags, uint32_t offset,
                      uint32_t size, const void *values) const;
+  ///\brief Writes descriptors directly into the command buffer, without
+  /// allocating a descriptor set (requires VK_KHR_push_descriptor and a push
+  /// descriptor set layout, see PushDescriptorWriter for a fallback).
+  ///\param pipeline_bind_point **[in]**
+  ///\param pipeline_layout **[in]**
+  ///\param set **[in]** set index of a push descriptor layout
+  ///\param writes **[in]** descriptor writes (dstSet is ignored)
+  void pushDescriptorSet(VkPipelineBindPoint pipeline_bind_point,
+                         PipelineLayout &pipeline_layout, uint32_t set,
+                         const std::vector<VkWriteDescriptorSet> &writes) const;
+  ///\brief Pushes descriptors with an update template
+  ///\param update_template **[in]** push template (see
+  /// DescriptorUpdateTemplate::setPushDescriptorTarget)
+  ///\param pipeline_layout **[in]**
+  ///\param set **[in]**
+  ///\param data **[in]** host data following the template entries
+  void pushDescriptorSet(DescriptorUpdateTemplate &update_template,
+                         PipelineLayout &pipeline_layout, uint32_t set,
+                         const void *data) const;
   ///\brief Sets the current renderpass object and configures the set of output
   /// images that will be drawn into.
   ///\param info **[in]** Parameters describing the renderpass
@@ -322,6 +349,28 @@ public:
   void transitionImageLayout(const ImageMemoryBarrier &barrier,
                              VkPipelineStageFlags src_stages,
                              VkPipelineStageFlags dst_stages) const;
+  ///\brief Records all barriers with a single pipeline barrier command.
+  ///
+  ///\param barriers **[in]**
+  ///\param src_stages **[in]**
+  ///\param dst_stages **[in]**
+  void transitionImageLayout(const std::vector<ImageMemoryBarrier> &barriers,
+                             VkPipelineStageFlags src_stages,
+                             VkPipelineStageFlags dst_stages) const;
+  ///\brief Declares the intended usage of a range of subresources of the
+  /// image and records only the barriers needed to reach it from the tracked
+  /// image state. Use PipelineBarrier to batch the declarations of several
+  /// images into one command.
+  ///\param image **[in]**
+  ///\param usage **[in]**
+  ///\param base_mip_level **[in | optional = 0]**
+  ///\param mip_level_count **[in | optional = VK_REMAINING_MIP_LEVELS]**
+  ///\param base_array_layer **[in | optional = 0]**
+  ///\param array_layer_count **[in | optional = VK_REMAINING_ARRAY_LAYERS]**
+  void use(const Image &image, ImageUsage usage, uint32_t base_mip_level = 0,
+           uint32_t mip_level_count = VK_REMAINING_MIP_LEVELS,
+           uint32_t base_array_layer = 0,
+           uint32_t array_layer_count = VK_REMAINING_ARRAY_LAYERS) const;
   ///\brief
   ///
   ///\param src_image **[in]**
@@ -339,7 +388,8 @@ public:
   ///\param height **[in]**
   ///\param min_depth **[in]**
   ///\param max_depth **[in]**
-  void setViewport(float width, float height, float min_depth, float max_depth);
+  void setViewport(float width, float height, float min_depth = 0.f,
+                   float max_depth = 1.f) const;
   ///\brief Set the Scissor object
   ///
   ///\param offset_x **[in]**
@@ -347,10 +397,31 @@ public:
   ///\param extent_width **[in]**
   ///\param extent_height **[in]**
   void setScissor(int32_t offset_x, int32_t offset_y, uint32_t extent_width,
-                  uint32_t extent_height);
+                  uint32_t extent_height) const;
+  // Extended dynamic state setters (see
+  // GraphicsPipeline::useExtendedDynamicState). They are ignored when the
+  // corresponding VK_EXT_extended_dynamic_state{,2,3} extension or its
+  // feature was not enabled on the device, or the Vulkan headers predate it.
+  void setCullMode(VkCullModeFlags cull_mode) const;
+  void setFrontFace(VkFrontFace front_face) const;
+  ///\param topology **[in]** must be of the same class (points, lines,
+  /// triangles or patches) of the pipeline topology
+  void setPrimitiveTopology(VkPrimitiveTopology topology) const;
+  void setDepthTestEnable(VkBool32 enable) const;
+  void setDepthWriteEnable(VkBool32 enable) const;
+  void setDepthCompareOp(VkCompareOp compare_op) const;
+  void setDepthBiasEnable(VkBool32 enable) const;
+  void setPrimitiveRestartEnable(VkBool32 enable) const;
+  void setRasterizerDiscardEnable(VkBool32 enable) const;
+  void setPolygonMode(VkPolygonMode polygon_mode) const;
 
 private:
+  ///\return const LogicalDevice::ExtensionFunctions* nullptr without device
+  [[nodiscard]] const LogicalDevice::ExtensionFunctions *
+  extensionFunctions() const;
+
   VkCommandBuffer vk_command_buffer_ = VK_NULL_HANDLE;
+  const LogicalDevice *logical_device_ = nullptr;
 };
 
 /// Command pools cannot be used concurrently, we must create a separate
@@ -0,0 +1,213 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_descriptor_allocator.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_descriptor_allocator.h"
+#include "logging.h"
+#include "vulkan_debug.h"
+#include <algorithm>
+
+namespace circe::vk {
+
+DescriptorAllocator::DescriptorAllocator(const LogicalDevice *logical_device,
+                                         uint32_t initial_max_sets)
+    : logical_device_(logical_device),
+      next_max_sets_(std::max(1u, initial_max_sets)) {}
+
+DescriptorAllocator::DescriptorAllocator(DescriptorAllocator &&other) noexcept
+    : logical_device_(other.logical_device_),
+      vk_descriptor_pools_(std::move(other.vk_descriptor_pools_)),
+      current_pool_(other.current_pool_), next_max_sets_(other.next_max_sets_),
+      allocated_sets_(other.allocated_sets_), peak_sets_(other.peak_sets_),
+      observed_descriptors_(std::move(other.observed_descriptors_)),
+      observed_sets_(other.observed_sets_) {
+  other.vk_descriptor_pools_.clear();
+}
+
+DescriptorAllocator::~DescriptorAllocator() { destroy(); }
+
+void DescriptorAllocator::destroy() {
+  for (auto pool : vk_descriptor_pools_)
+    vkDestroyDescriptorPool(logical_device_->handle(), pool, nullptr);
+  vk_descriptor_pools_.clear();
+  current_pool_ = 0;
+  allocated_sets_ = 0;
+}
+
+bool DescriptorAllocator::allocate(DescriptorSetLayout &layout,
+                                   VkDescriptorSet &descriptor_set) {
+  std::map<VkDescriptorType, uint32_t> requested;
+  for (auto &binding : layout.bindings())
+    requested[binding.descriptorType] += binding.descriptorCount;
+  return allocate({layout.handle()}, requested, &descriptor_set);
+}
+
+bool DescriptorAllocator::allocate(std::vector<DescriptorSetLayout> &layouts,
+                                   std::vector<VkDescriptorSet> &descriptor_sets) {
+  descriptor_sets.clear();
+  if (layouts.empty())
+    return true;
+  std::vector<VkDescriptorSetLayout> handles;
+  handles.reserve(layouts.size());
+  std::map<VkDescriptorType, uint32_t> requested;
+  for (auto &layout : layouts) {
+    handles.emplace_back(layout.handle());
+    for (auto &binding : layout.bindings())
+      requested[binding.descriptorType] += binding.descriptorCount;
+  }
+  descriptor_sets.resize(layouts.size(), VK_NULL_HANDLE);
+  return allocate(handles, requested, descriptor_sets.data());
+}
+
+bool DescriptorAllocator::allocate(
+    const std::vector<VkDescriptorSetLayout> &layouts,
+    const std::map<VkDescriptorType, uint32_t> &requested,
+    VkDescriptorSet *descriptor_sets) {
+  for (auto &r : requested)
+    observed_descriptors_[r.first] += r.second;
+  observed_sets_ += layouts.size();
+  VkResult result = VK_ERROR_OUT_OF_POOL_MEMORY;
+  if (!vk_descriptor_pools_.empty())
+    result = tryAllocate(layouts, descriptor_sets);
+  while (result == VK_ERROR_OUT_OF_POOL_MEMORY ||
+         result == VK_ERROR_FRAGMENTED_POOL) {
+    // move to the next pool, previous pools were reset but are full now
+    if (!vk_descriptor_pools_.empty())
+      current_pool_++;
+    bool fresh_pool = current_pool_ >= vk_descriptor_pools_.size();
+    if (fresh_pool) {
+      D_RETURN_FALSE_IF_NOT(createPool(requested, layouts.size()),
+                            "Could not create descriptor pool.");
+      current_pool_ = vk_descriptor_pools_.size() - 1;
+    }
+    result = tryAllocate(layouts, descriptor_sets);
+    // a new pool is sized for the request, failing again is a real error
+    if (fresh_pool)
+      break;
+  }
+  R_CHECK_VULKAN(result);
+  allocated_sets_ += layouts.size();
+  peak_sets_ = std::max(peak_sets_, allocated_sets_);
+  return true;
+}
+
+bool DescriptorAllocator::reset() {
+  if (vk_descriptor_pools_.size() > 1) {
+    // the last frame did not fit into one pool: replace all pools by a single
+    // one (created on the next allocation) that fits the observed peak
+    destroy();
+    next_max_sets_ = std::max(next_max_sets_, peak_sets_);
+    return true;
+  }
+  for (auto pool : vk_descriptor_pools_)
+    R_CHECK_VULKAN(
+        vkResetDescriptorPool(logical_device_->handle(), pool, 0));
+  current_pool_ = 0;
+  allocated_sets_ = 0;
+  return true;
+}
+
+uint32_t DescriptorAllocator::poolCount() const {
+  return vk_descriptor_pools_.size();
+}
+
+uint32_t DescriptorAllocator::allocatedSetCount() const {
+  return allocated_sets_;
+}
+
+uint32_t DescriptorAllocator::peakSetCount() const { return peak_sets_; }
+
+VkDescriptorPool DescriptorAllocator::createPool(
+    const std::map<VkDescriptorType, uint32_t> &requested,
+    uint32_t requested_sets) {
+  uint32_t max_sets = std::max(next_max_sets_, requested_sets);
+  // each type gets the average count per set observed so far
+  std::vector<VkDescriptorPoolSize> pool_sizes;
+  for (auto &observed : observed_descriptors_) {
+    auto count = static_cast<uint32_t>(
+        (observed.second * max_sets + observed_sets_ - 1) / observed_sets_);
+    auto it = requested.find(observed.first);
+    if (it != requested.end())
+      count = std::max(count, it->second);
+    pool_sizes.push_back({observed.first, std::max(count, 1u)});
+  }
+  VkDescriptorPoolCreateInfo info = {
+      VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, // VkStructureType sType
+      nullptr,  // const void *                pNext
+      0,        // VkDescriptorPoolCreateFlags flags
+      max_sets, // uint32_t                    maxSets
+      static_cast<uint32_t>(pool_sizes.size()), // uint32_t poolSizeCount
+      pool_sizes.data() // const VkDescriptorPoolSize* pPoolSizes
+  };
+  VkDescriptorPool pool = VK_NULL_HANDLE;
+  VkResult result =
+      vkCreateDescriptorPool(logical_device_->handle(), &info, nullptr, &pool);
+  CHECK_VULKAN(result);
+  if (result != VK_SUCCESS)
+    return VK_NULL_HANDLE;
+  vk_descriptor_pools_.emplace_back(pool);
+  // big scenes should not need a new pool every few sets
+  next_max_sets_ = std::min(next_max_sets_ * 2, 4096u);
+  return pool;
+}
+
+VkResult
+DescriptorAllocator::tryAllocate(const std::vector<VkDescriptorSetLayout> &layouts,
+                                 VkDescriptorSet *descriptor_sets) {
+  VkDescriptorSetAllocateInfo allocate_info = {
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, nullptr,
+      vk_descriptor_pools_[current_pool_],
+      static_cast<uint32_t>(layouts.size()), layouts.data()};
+  return vkAllocateDescriptorSets(logical_device_->handle(), &allocate_info,
+                                  descriptor_sets);
+}
+
+FrameDescriptorAllocator::FrameDescriptorAllocator(
+    const LogicalDevice *logical_device, uint32_t frames_in_flight,
+    uint32_t initial_max_sets) {
+  for (uint32_t i = 0; i < std::max(1u, frames_in_flight); ++i)
+    allocators_.emplace_back(logical_device, initial_max_sets);
+}
+
+bool FrameDescriptorAllocator::beginFrame(uint32_t frame) {
+  current_frame_ = frame % allocators_.size();
+  return allocators_[current_frame_].reset();
+}
+
+bool FrameDescriptorAllocator::allocate(DescriptorSetLayout &layout,
+                                        VkDescriptorSet &descriptor_set) {
+  return allocators_[current_frame_].allocate(layout, descriptor_set);
+}
+
+DescriptorAllocator &FrameDescriptorAllocator::current() {
+  return allocators_[current_frame_];
+}
+
+uint32_t FrameDescriptorAllocator::currentFrame() const {
+  return current_frame_;
+}
+
+} // namespace circe::vk
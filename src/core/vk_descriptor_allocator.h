@@ -0,0 +1,138 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_descriptor_allocator.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_DESCRIPTOR_ALLOCATOR_H
+#define CIRCE_VK_DESCRIPTOR_ALLOCATOR_H
+
+#include "vk_pipeline.h"
+#include <map>
+
+namespace circe::vk {
+
+/// \brief Allocates descriptor sets from a growing list of descriptor pools.
+/// Pools are created without VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+/// sets are never freed individually: all pools are recycled at once by
+/// reset(). When a pool runs out of space (VK_ERROR_OUT_OF_POOL_MEMORY or
+/// VK_ERROR_FRAGMENTED_POOL) a new one is created. Pool sizes follow the
+/// descriptor types observed in the allocated layouts, and the number of sets
+/// per pool grows with the observed peak, so a steady workload ends up using a
+/// single pool.
+class DescriptorAllocator final {
+public:
+  ///\param logical_device **[in]**
+  ///\param initial_max_sets **[in | optional = 32]** number of sets of the
+  /// first pool
+  explicit DescriptorAllocator(const LogicalDevice *logical_device,
+                               uint32_t initial_max_sets = 32);
+  DescriptorAllocator(const DescriptorAllocator &other) = delete;
+  DescriptorAllocator(DescriptorAllocator &&other) noexcept;
+  ~DescriptorAllocator();
+  ///\brief Destroys all pools (and so all sets allocated from them)
+  void destroy();
+  ///\param layout **[in]**
+  ///\param descriptor_set **[out]**
+  ///\return bool true if success
+  bool allocate(DescriptorSetLayout &layout, VkDescriptorSet &descriptor_set);
+  ///\param layouts **[in]**
+  ///\param descriptor_sets **[out]** one set per layout
+  ///\return bool true if success
+  bool allocate(std::vector<DescriptorSetLayout> &layouts,
+                std::vector<VkDescriptorSet> &descriptor_sets);
+  ///\brief Returns all sets to their pools. If more than one pool was needed
+  /// since the last reset, pools are replaced by a single one big enough for
+  /// the observed peak.
+  ///\return bool true if success
+  bool reset();
+  ///\return uint32_t number of pools currently alive
+  [[nodiscard]] uint32_t poolCount() const;
+  ///\return uint32_t number of sets allocated since the last reset
+  [[nodiscard]] uint32_t allocatedSetCount() const;
+  ///\return uint32_t highest number of sets allocated between resets
+  [[nodiscard]] uint32_t peakSetCount() const;
+
+private:
+  ///\param layouts **[in]**
+  ///\param requested **[in]** descriptors of each type needed by the layouts
+  ///\param descriptor_sets **[out]** one set per layout
+  ///\return bool true if success
+  bool allocate(const std::vector<VkDescriptorSetLayout> &layouts,
+                const std::map<VkDescriptorType, uint32_t> &requested,
+                VkDescriptorSet *descriptor_sets);
+  ///\param requested **[in]** descriptors needed by the failed allocation
+  ///\param requested_sets **[in]** sets needed by the failed allocation
+  ///\return VkDescriptorPool new pool (VK_NULL_HANDLE on failure)
+  VkDescriptorPool
+  createPool(const std::map<VkDescriptorType, uint32_t> &requested,
+             uint32_t requested_sets);
+  ///\return VkResult result of vkAllocateDescriptorSets on the current pool
+  VkResult tryAllocate(const std::vector<VkDescriptorSetLayout> &layouts,
+                       VkDescriptorSet *descriptor_sets);
+
+  const LogicalDevice *logical_device_ = nullptr;
+  std::vector<VkDescriptorPool> vk_descriptor_pools_;
+  size_t current_pool_{0};
+  uint32_t next_max_sets_{32};
+  uint32_t allocated_sets_{0};
+  uint32_t peak_sets_{0};
+  // descriptors of each type allocated since construction, used to estimate
+  // how many descriptors of each type a set needs
+  std::map<VkDescriptorType, uint64_t> observed_descriptors_;
+  uint64_t observed_sets_{0};
+};
+
+/// \brief Keeps one DescriptorAllocator per frame in flight. Sets allocated
+/// during a frame are valid until the same frame index comes back, when
+/// beginFrame() recycles them (after the frame's fence has been waited).
+class FrameDescriptorAllocator final {
+public:
+  ///\param logical_device **[in]**
+  ///\param frames_in_flight **[in]**
+  ///\param initial_max_sets **[in | optional = 32]**
+  FrameDescriptorAllocator(const LogicalDevice *logical_device,
+                           uint32_t frames_in_flight,
+                           uint32_t initial_max_sets = 32);
+  ///\brief Selects the allocator of **frame** and recycles its sets
+  ///\param frame **[in]** frame in flight index
+  ///\return bool true if success
+  bool beginFrame(uint32_t frame);
+  ///\param layout **[in]**
+  ///\param descriptor_set **[out]** valid until the frame index comes back
+  ///\return bool true if success
+  bool allocate(DescriptorSetLayout &layout, VkDescriptorSet &descriptor_set);
+  ///\return DescriptorAllocator& allocator of the current frame
+  DescriptorAllocator &current();
+  ///\return uint32_t current frame in flight index
+  [[nodiscard]] uint32_t currentFrame() const;
+
+private:
+  std::vector<DescriptorAllocator> allocators_;
+  uint32_t current_frame_{0};
+};
+
+} // namespace circe::vk
+
+#endif
@@ -0,0 +1,376 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_descriptor_cache.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_descriptor_cache.h"
+#include "logging.h"
+#include "vk_hash.h"
+#include <algorithm>
+
+namespace circe::vk {
+
+bool DescriptorLayoutCache::SetLayoutKey::operator==(
+    const SetLayoutKey &other) const {
+  if (bindings.size() != other.bindings.size())
+    return false;
+  for (size_t i = 0; i < bindings.size(); ++i) {
+    const auto &a = bindings[i];
+    const auto &b = other.bindings[i];
+    if (a.binding != b.binding || a.descriptorType != b.descriptorType ||
+        a.descriptorCount != b.descriptorCount ||
+        a.stageFlags != b.stageFlags)
+      return false;
+  }
+  return true;
+}
+
+size_t DescriptorLayoutCache::SetLayoutKeyHash::operator()(
+    const SetLayoutKey &key) const {
+  size_t seed = key.bindings.size();
+  for (auto &b : key.bindings)
+    hashCombine(seed, b.binding, b.descriptorType, b.descriptorCount,
+                b.stageFlags);
+  return seed;
+}
+
+bool DescriptorLayoutCache::PipelineLayoutKey::operator==(
+    const PipelineLayoutKey &other) const {
+  if (set_layouts != other.set_layouts ||
+      push_constant_ranges.size() != other.push_constant_ranges.size())
+    return false;
+  for (size_t i = 0; i < push_constant_ranges.size(); ++i) {
+    const auto &a = push_constant_ranges[i];
+    const auto &b = other.push_constant_ranges[i];
+    if (a.stageFlags != b.stageFlags || a.offset != b.offset ||
+        a.size != b.size)
+      return false;
+  }
+  return true;
+}
+
+size_t DescriptorLayoutCache::PipelineLayoutKeyHash::operator()(
+    const PipelineLayoutKey &key) const {
+  size_t seed = key.set_layouts.size();
+  for (auto *set_layout : key.set_layouts)
+    hashCombine(seed, set_layout);
+  for (auto &range : key.push_constant_ranges)
+    hashCombine(seed, range.stageFlags, range.offset, range.size);
+  return seed;
+}
+
+DescriptorLayoutCache::DescriptorLayoutCache(
+    const LogicalDevice *logical_device)
+    : logical_device_(logical_device) {}
+
+DescriptorSetLayout *DescriptorLayoutCache::setLayout(
+    std::vector<VkDescriptorSetLayoutBinding> bindings) {
+  // binding order does not change the layout
+  std::sort(bindings.begin(), bindings.end(),
+            [](const VkDescriptorSetLayoutBinding &a,
+               const VkDescriptorSetLayoutBinding &b) {
+              return a.binding < b.binding;
+            });
+  SetLayoutKey key{std::move(bindings)};
+  auto it = set_layouts_.find(key);
+  if (it != set_layouts_.end()) {
+    hits_++;
+    return it->second.get();
+  }
+  auto layout = std::make_unique<DescriptorSetLayout>(logical_device_);
+  for (auto &b : key.bindings)
+    layout->addLayoutBinding(b.binding, b.descriptorType, b.descriptorCount,
+                             b.stageFlags);
+  auto *ptr = layout.get();
+  set_layouts_[std::move(key)] = std::move(layout);
+  return ptr;
+}
+
+PipelineLayout *DescriptorLayoutCache::pipelineLayout(
+    const std::vector<DescriptorSetLayout *> &set_layouts,
+    const std::vector<VkPushConstantRange> &push_constant_ranges) {
+  PipelineLayoutKey key{set_layouts, push_constant_ranges};
+  auto it = pipeline_layouts_.find(key);
+  if (it != pipeline_layouts_.end()) {
+    hits_++;
+    return it->second.get();
+  }
+  auto layout = std::make_unique<PipelineLayout>(logical_device_);
+  for (auto *set_layout : set_layouts)
+    layout->addDescriptorSetLayout(set_layout);
+  for (auto &range : push_constant_ranges)
+    layout->addPushConstantRange(range.stageFlags, range.offset, range.size);
+  auto *ptr = layout.get();
+  pipeline_layouts_[std::move(key)] = std::move(layout);
+  return ptr;
+}
+
+std::vector<DescriptorSetLayout *> DescriptorLayoutCache::setLayouts(
+    const ShaderReflection &reflection,
+    const std::vector<DescriptorSetLayout *> &external_sets) {
+  if (!reflection.good()) {
+    INFO("Invalid shader reflection.")
+    return {};
+  }
+  uint32_t set_count = std::max(reflection.setCount(),
+                                static_cast<uint32_t>(external_sets.size()));
+  std::vector<DescriptorSetLayout *> layouts(set_count, nullptr);
+  for (uint32_t set = 0; set < set_count; ++set) {
+    if (set < external_sets.size() && external_sets[set]) {
+      layouts[set] = external_sets[set];
+      continue;
+    }
+    auto bindings = reflection.setLayoutBindings(set);
+    for (auto &binding : bindings)
+      if (!binding.descriptorCount) {
+        INFO("Unsized descriptor array requires an external set layout.")
+        return {};
+      }
+    layouts[set] = setLayout(std::move(bindings));
+  }
+  return layouts;
+}
+
+PipelineLayout *DescriptorLayoutCache::pipelineLayout(
+    const ShaderReflection &reflection,
+    const std::vector<DescriptorSetLayout *> &external_sets) {
+  auto set_layouts = setLayouts(reflection, external_sets);
+  if (!reflection.good() || (set_layouts.empty() && reflection.setCount()))
+    return nullptr;
+  return pipelineLayout(set_layouts, reflection.pushConstantRanges());
+}
+
+size_t DescriptorLayoutCache::setLayoutCount() const {
+  return set_layouts_.size();
+}
+
+size_t DescriptorLayoutCache::pipelineLayoutCount() const {
+  return pipeline_layouts_.size();
+}
+
+uint64_t DescriptorLayoutCache::hitCount() const { return hits_; }
+
+DescriptorResources &
+DescriptorResources::setBuffer(uint32_t binding, VkDescriptorType type,
+                               VkBuffer buffer, VkDeviceSize offset,
+                               VkDeviceSize range, uint32_t array_element) {
+  Resource resource{};
+  resource.binding = binding;
+  resource.array_element = array_element;
+  resource.type = type;
+  resource.buffer_info = {buffer, offset, range};
+  resources_.emplace_back(resource);
+  return *this;
+}
+
+DescriptorResources &
+DescriptorResources::setImage(uint32_t binding, VkDescriptorType type,
+                              VkImageView image_view, VkSampler sampler,
+                              VkImageLayout layout, uint32_t array_element) {
+  Resource resource{};
+  resource.binding = binding;
+  resource.array_element = array_element;
+  resource.type = type;
+  resource.image_info = {sampler, image_view, layout};
+  resources_.emplace_back(resource);
+  return *this;
+}
+
+void DescriptorResources::write(const LogicalDevice *logical_device,
+                                VkDescriptorSet descriptor_set) const {
+  auto set_writes = writes(descriptor_set);
+  vkUpdateDescriptorSets(logical_device->handle(),
+                         static_cast<uint32_t>(set_writes.size()),
+                         set_writes.data(), 0, nullptr);
+}
+
+std::vector<VkWriteDescriptorSet>
+DescriptorResources::writes(VkDescriptorSet descriptor_set) const {
+  std::vector<VkWriteDescriptorSet> writes;
+  writes.reserve(resources_.size());
+  for (auto &resource : resources_) {
+    VkWriteDescriptorSet write = {
+        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, // VkStructureType sType
+        nullptr,                // const void *                  pNext
+        descriptor_set,         // VkDescriptorSet               dstSet
+        resource.binding,       // uint32_t                      dstBinding
+        resource.array_element, // uint32_t                      dstArrayElement
+        1,                      // uint32_t                      descriptorCount
+        resource.type,          // VkDescriptorType              descriptorType
+        &resource.image_info,   // const VkDescriptorImageInfo * pImageInfo
+        &resource.buffer_info,  // const VkDescriptorBufferInfo *pBufferInfo
+        nullptr                 // const VkBufferView *          pTexelBufferView
+    };
+    writes.emplace_back(write);
+  }
+  return writes;
+}
+
+size_t DescriptorResources::hash() const {
+  size_t seed = resources_.size();
+  for (auto &r : resources_)
+    hashCombine(seed, r.binding, r.array_element, r.type, r.buffer_info.buffer,
+                r.buffer_info.offset, r.buffer_info.range,
+                r.image_info.sampler, r.image_info.imageView,
+                r.image_info.imageLayout);
+  return seed;
+}
+
+bool DescriptorResources::operator==(const DescriptorResources &other) const {
+  if (resources_.size() != other.resources_.size())
+    return false;
+  for (size_t i = 0; i < resources_.size(); ++i) {
+    const auto &a = resources_[i];
+    const auto &b = other.resources_[i];
+    if (a.binding != b.binding || a.array_element != b.array_element ||
+        a.type != b.type || a.buffer_info.buffer != b.buffer_info.buffer ||
+        a.buffer_info.offset != b.buffer_info.offset ||
+        a.buffer_info.range != b.buffer_info.range ||
+        a.image_info.sampler != b.image_info.sampler ||
+        a.image_info.imageView != b.image_info.imageView ||
+        a.image_info.imageLayout != b.image_info.imageLayout)
+      return false;
+  }
+  return true;
+}
+
+bool DescriptorSetCache::Key::operator==(const Key &other) const {
+  return layout == other.layout && resources == other.resources;
+}
+
+size_t DescriptorSetCache::KeyHash::operator()(const Key &key) const {
+  size_t seed = key.resources.hash();
+  hashCombine(seed, key.layout);
+  return seed;
+}
+
+DescriptorSetCache::DescriptorSetCache(const LogicalDevice *logical_device,
+                                       uint32_t frames_in_flight)
+    : logical_device_(logical_device),
+      allocator_(logical_device, frames_in_flight),
+      frame_sets_(std::max(1u, frames_in_flight)) {}
+
+bool DescriptorSetCache::beginFrame(uint32_t frame) {
+  current_frame_ = frame % frame_sets_.size();
+  frame_sets_[current_frame_].clear();
+  return allocator_.beginFrame(current_frame_);
+}
+
+VkDescriptorSet
+DescriptorSetCache::descriptorSet(DescriptorSetLayout &layout,
+                                  const DescriptorResources &resources) {
+  Key key{layout.handle(), resources};
+  auto &sets = frame_sets_[current_frame_];
+  auto it = sets.find(key);
+  if (it != sets.end()) {
+    hits_++;
+    return it->second;
+  }
+  VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+  if (!allocator_.allocate(layout, descriptor_set))
+    return VK_NULL_HANDLE;
+  resources.write(logical_device_, descriptor_set);
+  misses_++;
+  sets[std::move(key)] = descriptor_set;
+  return descriptor_set;
+}
+
+uint64_t DescriptorSetCache::hitCount() const { return hits_; }
+
+uint64_t DescriptorSetCache::missCount() const { return misses_; }
+
+PushDescriptorWriter::PushDescriptorWriter(const LogicalDevice *logical_device,
+                                           uint32_t frames_in_flight)
+    : logical_device_(logical_device),
+      fallback_allocator_(logical_device, frames_in_flight) {}
+
+bool PushDescriptorWriter::isSupported(const LogicalDevice *logical_device) {
+  return logical_device &&
+         logical_device->extensionFunctions().vkCmdPushDescriptorSetKHR;
+}
+
+bool PushDescriptorWriter::beginFrame(uint32_t frame) {
+  return fallback_allocator_.beginFrame(frame);
+}
+
+bool PushDescriptorWriter::push(CommandBuffer &command_buffer,
+                                VkPipelineBindPoint bind_point,
+                                PipelineLayout &pipeline_layout, uint32_t set,
+                                const DescriptorResources &resources) {
+  if (pipeline_layout.descriptorSetLayout(set).isPushDescriptor()) {
+    command_buffer.pushDescriptorSet(bind_point, pipeline_layout, set,
+                                     resources.writes(VK_NULL_HANDLE));
+    pushed_++;
+    return true;
+  }
+  VkDescriptorSet descriptor_set = allocateFallback(pipeline_layout, set);
+  RETURN_FALSE_IF_NOT(descriptor_set != VK_NULL_HANDLE);
+  resources.write(logical_device_, descriptor_set);
+  command_buffer.bind(bind_point, &pipeline_layout, set, {descriptor_set});
+  return true;
+}
+
+bool PushDescriptorWriter::push(CommandBuffer &command_buffer,
+                                VkPipelineBindPoint bind_point,
+                                PipelineLayout &pipeline_layout, uint32_t set,
+                                DescriptorUpdateTemplate &update_template,
+                                const void *data, size_t data_size) {
+  // push layouts cannot be allocated from, so the layout decides the path
+  // and the template must match it
+  bool push_layout =
+      pipeline_layout.descriptorSetLayout(set).isPushDescriptor();
+  D_RETURN_FALSE_IF_NOT(push_layout == update_template.isPushTemplate(),
+                        "update template does not match the set layout.");
+  if (push_layout) {
+    D_RETURN_FALSE_IF_NOT(data_size >= update_template.dataSize(),
+                          "descriptor data smaller than the update template.");
+    command_buffer.pushDescriptorSet(update_template, pipeline_layout, set,
+                                     data);
+    pushed_++;
+    return true;
+  }
+  VkDescriptorSet descriptor_set = allocateFallback(pipeline_layout, set);
+  RETURN_FALSE_IF_NOT(descriptor_set != VK_NULL_HANDLE);
+  RETURN_FALSE_IF_NOT(update_template.update(descriptor_set, data, data_size));
+  command_buffer.bind(bind_point, &pipeline_layout, set, {descriptor_set});
+  return true;
+}
+
+uint64_t PushDescriptorWriter::pushedCount() const { return pushed_; }
+
+uint64_t PushDescriptorWriter::fallbackCount() const { return fallbacks_; }
+
+VkDescriptorSet
+PushDescriptorWriter::allocateFallback(PipelineLayout &pipeline_layout,
+                                       uint32_t set) {
+  VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+  if (!fallback_allocator_.allocate(pipeline_layout.descriptorSetLayout(set),
+                                    descriptor_set))
+    return VK_NULL_HANDLE;
+  fallbacks_++;
+  return descriptor_set;
+}
+
+} // namespace circe::vk
@@ -0,0 +1,270 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_descriptor_cache.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_DESCRIPTOR_CACHE_H
+#define CIRCE_VK_DESCRIPTOR_CACHE_H
+
+#include "vk_command_buffer.h"
+#include "vk_descriptor_allocator.h"
+#include <memory>
+#include <unordered_map>
+
+namespace circe::vk {
+
+/// \brief Deduplicates descriptor set layouts and pipeline layouts by their
+/// signature. Two requests with the same bindings (in any order) get the same
+/// object, so descriptor sets and pipelines created from them are compatible
+/// and layouts are created only once.
+class DescriptorLayoutCache final {
+public:
+  ///\param logical_device **[in]**
+  explicit DescriptorLayoutCache(const LogicalDevice *logical_device);
+  ///\param bindings **[in]** set layout bindings (immutable samplers are not
+  /// supported)
+  ///\return DescriptorSetLayout* cached layout, owned by the cache
+  DescriptorSetLayout *
+  setLayout(std::vector<VkDescriptorSetLayoutBinding> bindings);
+  ///\param set_layouts **[in]** layouts of each set, in set order (usually
+  /// retrieved from setLayout)
+  ///\param push_constant_ranges **[in | optional = {}]**
+  ///\return PipelineLayout* cached layout, owned by the cache
+  PipelineLayout *
+  pipelineLayout(const std::vector<DescriptorSetLayout *> &set_layouts,
+                 const std::vector<VkPushConstantRange> &push_constant_ranges =
+                     {});
+  ///\brief Derives the set layouts of a shader interface. Each set gets
+  /// only the bindings the shaders use; sets in between used sets get empty
+  /// layouts.
+  ///\param reflection **[in]** usually merged from all pipeline stages (see
+  /// ShaderReflection::merge)
+  ///\param external_sets **[in | optional = {}]** layouts replacing the
+  /// derived ones at the same set index when not null (ex: the layout of a
+  /// BindlessTextureTable, required for sets with unsized arrays)
+  ///\return std::vector<DescriptorSetLayout *> empty on failure
+  std::vector<DescriptorSetLayout *>
+  setLayouts(const ShaderReflection &reflection,
+             const std::vector<DescriptorSetLayout *> &external_sets = {});
+  ///\brief Derives the pipeline layout of a shader interface, with the set
+  /// layouts of setLayouts and the reflected push constant ranges.
+  ///\param reflection **[in]**
+  ///\param external_sets **[in | optional = {}]**
+  ///\return PipelineLayout* cached layout, nullptr on failure
+  PipelineLayout *
+  pipelineLayout(const ShaderReflection &reflection,
+                 const std::vector<DescriptorSetLayout *> &external_sets = {});
+  ///\return size_t number of distinct set layouts
+  [[nodiscard]] size_t setLayoutCount() const;
+  ///\return size_t number of distinct pipeline layouts
+  [[nodiscard]] size_t pipelineLayoutCount() const;
+  ///\return uint64_t number of requests served by an existing layout
+  [[nodiscard]] uint64_t hitCount() const;
+
+private:
+  struct SetLayoutKey {
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    bool operator==(const SetLayoutKey &other) const;
+  };
+  struct SetLayoutKeyHash {
+    size_t operator()(const SetLayoutKey &key) const;
+  };
+  struct PipelineLayoutKey {
+    std::vector<DescriptorSetLayout *> set_layouts;
+    std::vector<VkPushConstantRange> push_constant_ranges;
+    bool operator==(const PipelineLayoutKey &other) const;
+  };
+  struct PipelineLayoutKeyHash {
+    size_t operator()(const PipelineLayoutKey &key) const;
+  };
+
+  const LogicalDevice *logical_device_ = nullptr;
+  std::unordered_map<SetLayoutKey, std::unique_ptr<DescriptorSetLayout>,
+                     SetLayoutKeyHash>
+      set_layouts_;
+  std::unordered_map<PipelineLayoutKey, std::unique_ptr<PipelineLayout>,
+                     PipelineLayoutKeyHash>
+      pipeline_layouts_;
+  uint64_t hits_{0};
+};
+
+/// \brief Describes the resources bound to a descriptor set. It can write
+/// them into a set with a single vkUpdateDescriptorSets call and is hashable,
+/// so it can be used as a key for already written sets.
+class DescriptorResources {
+public:
+  ///\param binding **[in]**
+  ///\param type **[in]** ex: VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+  ///\param buffer **[in]**
+  ///\param offset **[in | optional = 0]**
+  ///\param range **[in | optional = VK_WHOLE_SIZE]**
+  ///\param array_element **[in | optional = 0]**
+  ///\return DescriptorResources& this object
+  DescriptorResources &setBuffer(uint32_t binding, VkDescriptorType type,
+                                 VkBuffer buffer, VkDeviceSize offset = 0,
+                                 VkDeviceSize range = VK_WHOLE_SIZE,
+                                 uint32_t array_element = 0);
+  ///\param binding **[in]**
+  ///\param type **[in]** ex: VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+  ///\param image_view **[in]**
+  ///\param sampler **[in]** (ignored by non sampler types)
+  ///\param layout **[in | optional = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL]**
+  ///\param array_element **[in | optional = 0]**
+  ///\return DescriptorResources& this object
+  DescriptorResources &
+  setImage(uint32_t binding, VkDescriptorType type, VkImageView image_view,
+           VkSampler sampler,
+           VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+           uint32_t array_element = 0);
+  ///\brief Writes all resources into **descriptor_set**
+  ///\param logical_device **[in]**
+  ///\param descriptor_set **[in]**
+  void write(const LogicalDevice *logical_device,
+             VkDescriptorSet descriptor_set) const;
+  ///\param descriptor_set **[in]** destination set (ignored by push
+  /// descriptors)
+  ///\return std::vector<VkWriteDescriptorSet> writes of all resources, valid
+  /// while this object is not modified
+  [[nodiscard]] std::vector<VkWriteDescriptorSet>
+  writes(VkDescriptorSet descriptor_set) const;
+  ///\return size_t hash of all resources
+  [[nodiscard]] size_t hash() const;
+  bool operator==(const DescriptorResources &other) const;
+
+private:
+  struct Resource {
+    uint32_t binding;
+    uint32_t array_element;
+    VkDescriptorType type;
+    VkDescriptorBufferInfo buffer_info;
+    VkDescriptorImageInfo image_info;
+  };
+  std::vector<Resource> resources_;
+};
+
+/// \brief Per frame in flight cache of written descriptor sets. Requests with
+/// the same layout and resources during a frame return the same set, which is
+/// allocated and written only once. Sets are recycled when their frame index
+/// comes back in beginFrame().
+class DescriptorSetCache final {
+public:
+  ///\param logical_device **[in]**
+  ///\param frames_in_flight **[in]**
+  DescriptorSetCache(const LogicalDevice *logical_device,
+                     uint32_t frames_in_flight);
+  ///\brief Recycles the sets of **frame** (its fence must have been waited)
+  ///\param frame **[in]** frame in flight index
+  ///\return bool true if success
+  bool beginFrame(uint32_t frame);
+  ///\param layout **[in]**
+  ///\param resources **[in]**
+  ///\return VkDescriptorSet written set (VK_NULL_HANDLE on failure)
+  VkDescriptorSet descriptorSet(DescriptorSetLayout &layout,
+                                const DescriptorResources &resources);
+  ///\return uint64_t number of requests served by an already written set
+  [[nodiscard]] uint64_t hitCount() const;
+  ///\return uint64_t number of sets allocated and written
+  [[nodiscard]] uint64_t missCount() const;
+
+private:
+  struct Key {
+    VkDescriptorSetLayout layout;
+    DescriptorResources resources;
+    bool operator==(const Key &other) const;
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  const LogicalDevice *logical_device_ = nullptr;
+  FrameDescriptorAllocator allocator_;
+  std::vector<std::unordered_map<Key, VkDescriptorSet, KeyHash>> frame_sets_;
+  uint32_t current_frame_{0};
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+/// \brief Per draw descriptors without descriptor set management. Sets with
+/// push descriptor layouts are written directly into the command buffer
+/// (VK_KHR_push_descriptor). When the extension is missing, the layout is
+/// created as a regular layout and the descriptors go to a set taken from a
+/// per frame linear allocator, which is written and bound instead.
+class PushDescriptorWriter final {
+public:
+  ///\param logical_device **[in]**
+  ///\param frames_in_flight **[in]** frames of the fallback allocator
+  PushDescriptorWriter(const LogicalDevice *logical_device,
+                       uint32_t frames_in_flight);
+  ///\param logical_device **[in]**
+  ///\return bool true if descriptors can be pushed
+  static bool isSupported(const LogicalDevice *logical_device);
+  ///\brief Recycles the fallback sets of **frame** (its fence must have been
+  /// waited)
+  ///\param frame **[in]** frame in flight index
+  ///\return bool true if success
+  bool beginFrame(uint32_t frame);
+  ///\param command_buffer **[in]**
+  ///\param bind_point **[in]**
+  ///\param pipeline_layout **[in]**
+  ///\param set **[in]** set index
+  ///\param resources **[in]**
+  ///\return bool true if success
+  bool push(CommandBuffer &command_buffer, VkPipelineBindPoint bind_point,
+            PipelineLayout &pipeline_layout, uint32_t set,
+            const DescriptorResources &resources);
+  ///\param command_buffer **[in]**
+  ///\param bind_point **[in]**
+  ///\param pipeline_layout **[in]**
+  ///\param set **[in]** set index
+  ///\param update_template **[in]** push template if the set layout is a
+  /// push descriptor layout, a regular template of the set layout otherwise
+  ///\param data **[in]** host data following the template entries
+  ///\param data_size **[in]** size of **data** in bytes
+  ///\return bool true if success
+  bool push(CommandBuffer &command_buffer, VkPipelineBindPoint bind_point,
+            PipelineLayout &pipeline_layout, uint32_t set,
+            DescriptorUpdateTemplate &update_template, const void *data,
+            size_t data_size);
+  ///\return uint64_t number of sets pushed into command buffers
+  [[nodiscard]] uint64_t pushedCount() const;
+  ///\return uint64_t number of sets allocated by the fallback path
+  [[nodiscard]] uint64_t fallbackCount() const;
+
+private:
+  ///\param pipeline_layout **[in]**
+  ///\param set **[in]**
+  ///\return VkDescriptorSet allocated fallback set
+  VkDescriptorSet allocateFallback(PipelineLayout &pipeline_layout,
+                                   uint32_t set);
+
+  const LogicalDevice *logical_device_ = nullptr;
+  FrameDescriptorAllocator fallback_allocator_;
+  uint64_t pushed_{0};
+  uint64_t fallbacks_{0};
+};
+
+} // namespace circe::vk
+
+#endif
@@ -99,6 +99,8 @@ bool DeviceMemory::allocate(VkMemoryRequirements memory_requirements,
   destroy();
   uint32_t heap_index = device_->chooseMemoryType(
       memory_requirements, required_flags, preferred_flags);
+  D_RETURN_FALSE_IF_NOT(heap_index != ~0u,
+                        "No memory type satisfies the required flags.");
   // try to allocate memory
   VkMemoryAllocateInfo buffer_memory_allocate_info = {
       VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, // VkStructureType    sType
@@ -0,0 +1,63 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_hash.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_HASH_H
+#define CIRCE_VK_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace circe::vk {
+
+/// Mixes the hash of **value** into **seed** (boost::hash_combine)
+template <typename T> void hashCombine(size_t &seed, const T &value) {
+  seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+/// Mixes all given values into **seed**
+template <typename T, typename... Args>
+void hashCombine(size_t &seed, const T &value, const Args &... args) {
+  hashCombine(seed, value);
+  hashCombine(seed, args...);
+}
+
+/// FNV-1a hash of raw memory. Structs must be zero initialized (padding
+/// included) to hash consistently.
+inline size_t hashBytes(const void *data, size_t size, size_t seed = 0) {
+  uint64_t h = 14695981039346656037ull ^ seed;
+  auto *bytes = reinterpret_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    h ^= bytes[i];
+    h *= 1099511628211ull;
+  }
+  return static_cast<size_t>(h);
+}
+
+} // namespace circe::vk
+
+#endif
@@ -32,8 +32,12 @@
 namespace circe::vk {
 
 Image::View::View(const Image *image, VkImageViewType view_type,
-                  VkFormat format, VkImageAspectFlags aspect)
+                  VkFormat format, VkImageAspectFlags aspect,
+                  uint32_t base_mip_level, uint32_t mip_level_count,
+                  uint32_t base_array_layer, uint32_t array_layer_count)
     : image_(image) {
+  if (mip_level_count == VK_REMAINING_MIP_LEVELS)
+    mip_level_count = image->mipLevels() - base_mip_level;
   VkImageViewCreateInfo image_view_create_info = {
       VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO, // VkStructureType sType
       nullptr,         // const void               * pNext
@@ -50,11 +54,11 @@ Image::View::View(const Image *image, VkImageViewType view_type,
       },
       {
           // VkImageSubresourceRange    subresourceRange
-          aspect,             // VkImageAspectFlags         aspectMask
-          0,                  // uint32_t                   baseMipLevel
-          image->mipLevels(), // uint32_t levelCount VK_REMAINING_MIP_LEVELS
-          0,                  // uint32_t                   baseArrayLayer
-          VK_REMAINING_ARRAY_LAYERS // uint32_t                   layerCount
+          aspect,            // VkImageAspectFlags         aspectMask
+          base_mip_level,    // uint32_t                   baseMipLevel
+          mip_level_count,   // uint32_t                   levelCount
+          base_array_layer,  // uint32_t                   baseArrayLayer
+          array_layer_count  // uint32_t                   layerCount
       }};
 
   CHECK_VULKAN(vkCreateImageView(image->device()->handle(),
@@ -78,19 +82,22 @@ VkImageView Image::View::handle() const { return vk_image_view_; }
 Image::Image(const LogicalDevice *logical_device, VkImageType type,
              VkFormat format, VkExtent3D size, uint32_t num_mipmaps,
              uint32_t num_layers, VkSampleCountFlagBits samples,
-             VkImageUsageFlags usage_scenarios, bool cubemap)
+             VkImageUsageFlags usage_scenarios, bool cubemap,
+             VkImageCreateFlags create_flags)
     : logical_device_(logical_device), format_(format), size_(size),
-      mip_levels_(num_mipmaps), do_not_destroy_(false) {
+      mip_levels_(num_mipmaps),
+      array_layers_(cubemap ? 6 * num_layers : num_layers),
+      usage_(usage_scenarios), do_not_destroy_(false) {
   VkImageCreateInfo image_create_info = {
       VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO, // VkStructureType          sType
       nullptr,                             // const void             * pNext
-      cubemap ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT
-              : 0u, // VkImageCreateFlags       flags
+      create_flags | (cubemap ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT
+                              : 0u), // VkImageCreateFlags       flags
       type,         // VkImageType              imageType
       format,       // VkFormat                 format
       size,         // VkExtent3D               extent
       mip_levels_,  // uint32_t                 mipLevels
-      cubemap ? 6 * num_layers : num_layers, // uint32_t arrayLayers
+      array_layers_, // uint32_t                 arrayLayers
       samples,                               // VkSampleCountFlagBits    samples
       VK_IMAGE_TILING_OPTIMAL,               // VkImageTiling            tiling
       usage_scenarios,                       // VkImageUsageFlags        usage
@@ -103,14 +110,21 @@ Image::Image(const LogicalDevice *logical_device, VkImageType type,
                              nullptr, &vk_image_));
   if (vk_image_ == VK_NULL_HANDLE)
     INFO("Could not create image.");
+  state_ = ImageState(mip_levels_, array_layers_, aspectMask());
 }
 
-Image::Image(const LogicalDevice *logical_device, VkImage handle)
-    : logical_device_(logical_device), vk_image_(handle),
-      do_not_destroy_(true) {}
+Image::Image(const LogicalDevice *logical_device, VkImage handle,
+             VkFormat format, VkExtent2D size,
+             VkImageUsageFlags usage_scenarios)
+    : logical_device_(logical_device), vk_image_(handle), format_(format),
+      size_{size.width, size.height, 1}, usage_(usage_scenarios),
+      state_(1, 1, VK_IMAGE_ASPECT_COLOR_BIT), do_not_destroy_(true) {}
 
 Image::Image(Image &&other) noexcept
     : logical_device_(other.logical_device_), vk_image_(other.vk_image_),
+      format_(other.format_), size_(other.size_),
+      mip_levels_(other.mip_levels_), array_layers_(other.array_layers_),
+      usage_(other.usage_), state_(std::move(other.state_)),
       do_not_destroy_(other.do_not_destroy_) {
   other.vk_image_ = VK_NULL_HANDLE;
 }
@@ -151,4 +165,28 @@ VkExtent3D Image::size() const { return size_; }
 
 VkFormat Image::format() const { return format_; }
 
+uint32_t Image::arrayLayers() const { return array_layers_; }
+
+VkImageUsageFlags Image::usage() const { return usage_; }
+
+VkImageAspectFlags Image::aspectMask() const {
+  switch (format_) {
+  case VK_FORMAT_D16_UNORM:
+  case VK_FORMAT_X8_D24_UNORM_PACK32:
+  case VK_FORMAT_D32_SFLOAT:
+    return VK_IMAGE_ASPECT_DEPTH_BIT;
+  case VK_FORMAT_S8_UINT:
+    return VK_IMAGE_ASPECT_STENCIL_BIT;
+  case VK_FORMAT_D16_UNORM_S8_UINT:
+  case VK_FORMAT_D24_UNORM_S8_UINT:
+  case VK_FORMAT_D32_SFLOAT_S8_UINT:
+    return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+  default:
+    break;
+  }
+  return VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+ImageState &Image::state() const { return state_; }
+
 } // namespace circe::vk
\ No newline at end of file
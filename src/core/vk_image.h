@@ -28,6 +28,7 @@
 #ifndef CIRCE_VK_IMAGE_H
 #define CIRCE_VK_IMAGE_H
 
+#include "vk_image_state.h"
 #include "vulkan_logical_device.h"
 
 namespace circe::vk {
@@ -48,10 +49,16 @@ public:
     /// \param view_type **[in]**
     /// \param format **[in]** data format
     /// \param aspect **[in]** context: color, depth or stencil
-    /// \param image_view **[out]** image view object
-    /// \return bool true if success
+    /// \param base_mip_level **[in | optional = 0]** first visible level
+    /// \param mip_level_count **[in | optional = VK_REMAINING_MIP_LEVELS]**
+    /// \param base_array_layer **[in | optional = 0]** first visible layer
+    /// \param array_layer_count **[in | optional =
+    /// VK_REMAINING_ARRAY_LAYERS]**
     View(const Image *image, VkImageViewType view_type, VkFormat format,
-         VkImageAspectFlags aspect);
+         VkImageAspectFlags aspect, uint32_t base_mip_level = 0,
+         uint32_t mip_level_count = VK_REMAINING_MIP_LEVELS,
+         uint32_t base_array_layer = 0,
+         uint32_t array_layer_count = VK_REMAINING_ARRAY_LAYERS);
     View(const View &&other) = delete;
     View(View &&other) noexcept;
     ~View();
@@ -89,11 +96,21 @@ public:
   /// \param samples **[in]** number of samples
   /// \param usage_scenarios **[in]**
   /// \param cubemap **[in]**
+  /// \param create_flags **[in | optional = 0]** extra creation flags (ex:
+  /// VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT, so views can use other formats)
   Image(const LogicalDevice *logical_device, VkImageType type, VkFormat format,
         VkExtent3D size, uint32_t num_mipmaps, uint32_t num_layers,
         VkSampleCountFlagBits samples, VkImageUsageFlags usage_scenarios,
-        bool cubemap);
-  Image(const LogicalDevice *logical_device, VkImage handle);
+        bool cubemap, VkImageCreateFlags create_flags = 0);
+  /// Wraps an image owned by someone else (ex: swapchain images)
+  /// \param logical_device **[in]**
+  /// \param handle **[in]** image handle (not destroyed by this object)
+  /// \param format **[in | optional = VK_FORMAT_UNDEFINED]**
+  /// \param size **[in | optional = {}]**
+  /// \param usage_scenarios **[in | optional = 0]**
+  Image(const LogicalDevice *logical_device, VkImage handle,
+        VkFormat format = VK_FORMAT_UNDEFINED, VkExtent2D size = {},
+        VkImageUsageFlags usage_scenarios = 0);
   Image(const Image &&other) = delete;
   Image(Image &&other) noexcept;
   ~Image();
@@ -131,6 +148,17 @@ public:
   VkExtent3D size() const;
   ///\return VkFormat
   VkFormat format() const;
+  ///\return uint32_t number of array layers (6 per layer for cubemaps)
+  uint32_t arrayLayers() const;
+  ///\return VkImageUsageFlags usage scenarios the image was created with
+  VkImageUsageFlags usage() const;
+  ///\return VkImageAspectFlags aspects of the image format
+  VkImageAspectFlags aspectMask() const;
+  ///\brief Tracked layout, access and stages of each subresource. The state
+  /// is updated by CommandBuffer::use and PipelineBarrier::add, it must be
+  /// updated manually when layouts change implicitly (ex: renderpasses).
+  ///\return ImageState&
+  ImageState &state() const;
 
 private:
   const LogicalDevice *logical_device_ = nullptr;
@@ -138,6 +166,9 @@ private:
   VkFormat format_{};
   VkExtent3D size_{};
   uint32_t mip_levels_{1};
+  uint32_t array_layers_{1};
+  VkImageUsageFlags usage_{0};
+  mutable ImageState state_;
   bool do_not_destroy_ = false;
 };
 
@@ -0,0 +1,224 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_image_decoder.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_image_decoder.h"
+#include "logging.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+// Destination of the image being decoded by this thread. The first
+// allocation large enough for the output image (and that fits) is served by
+// it.
+struct DecodeTarget {
+  void *memory = nullptr;
+  size_t image_size = 0;
+  size_t size = 0;
+  bool taken = false;
+};
+
+// some decoders over-allocate their output by a few bytes
+constexpr size_t kDestinationPadding = 16;
+thread_local DecodeTarget decode_target;
+
+std::mutex statistics_mutex;
+circe::vk::ImageDecoder::Statistics decoder_statistics;
+
+// heap allocations carry their size in a header to account memory usage
+constexpr size_t kHeaderSize = 16;
+
+void accountHeap(int64_t delta) {
+  std::lock_guard<std::mutex> lock(statistics_mutex);
+  decoder_statistics.heap_bytes += delta;
+  if (decoder_statistics.heap_bytes > decoder_statistics.peak_heap_bytes)
+    decoder_statistics.peak_heap_bytes = decoder_statistics.heap_bytes;
+}
+
+void *heapAllocate(size_t size) {
+  auto *block = static_cast<unsigned char *>(std::malloc(size + kHeaderSize));
+  if (!block)
+    return nullptr;
+  *reinterpret_cast<size_t *>(block) = size;
+  accountHeap(static_cast<int64_t>(size));
+  return block + kHeaderSize;
+}
+
+size_t heapSize(void *p) {
+  return *reinterpret_cast<size_t *>(static_cast<unsigned char *>(p) -
+                                     kHeaderSize);
+}
+
+void decoderFree(void *p) {
+  if (!p || p == decode_target.memory)
+    return;
+  accountHeap(-static_cast<int64_t>(heapSize(p)));
+  std::free(static_cast<unsigned char *>(p) - kHeaderSize);
+}
+
+void *decoderMalloc(size_t size) {
+  if (decode_target.memory && !decode_target.taken &&
+      size >= decode_target.image_size && size <= decode_target.size) {
+    decode_target.taken = true;
+    return decode_target.memory;
+  }
+  return heapAllocate(size);
+}
+
+void *decoderRealloc(void *p, size_t size) {
+  if (!p)
+    return decoderMalloc(size);
+  if (p == decode_target.memory) {
+    // the destination cannot grow, move the contents to the heap
+    void *q = heapAllocate(size);
+    if (q)
+      std::memcpy(q, p,
+                  size < decode_target.size ? size : decode_target.size);
+    return q;
+  }
+  size_t old_size = heapSize(p);
+  auto *block = static_cast<unsigned char *>(
+      std::realloc(static_cast<unsigned char *>(p) - kHeaderSize,
+                   size + kHeaderSize));
+  if (!block)
+    return nullptr;
+  *reinterpret_cast<size_t *>(block) = size;
+  accountHeap(static_cast<int64_t>(size) - static_cast<int64_t>(old_size));
+  return block + kHeaderSize;
+}
+
+} // namespace
+
+#define STBI_MALLOC(sz) decoderMalloc(sz)
+#define STBI_REALLOC(p, newsz) decoderRealloc(p, newsz)
+#define STBI_FREE(p) decoderFree(p)
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace circe::vk {
+
+double ImageDecoder::Statistics::copyBandwidth() const {
+  if (copy_time <= 0)
+    return 0;
+  return copied_bytes / (1024.0 * 1024.0) / (copy_time / 1000.0);
+}
+
+double ImageDecoder::Statistics::decodeBandwidth() const {
+  if (decode_time <= 0)
+    return 0;
+  return bytes / (1024.0 * 1024.0) / (decode_time / 1000.0);
+}
+
+bool ImageDecoder::info(const std::string &filename, VkExtent3D &size) {
+  int width = 0, height = 0, channels = 0;
+  if (!stbi_info(filename.c_str(), &width, &height, &channels))
+    return false;
+  size = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
+  return true;
+}
+
+VkDeviceSize ImageDecoder::rgba8Size(const VkExtent3D &size) {
+  return static_cast<VkDeviceSize>(size.width) * size.height * size.depth * 4;
+}
+
+VkDeviceSize ImageDecoder::destinationSize(const VkExtent3D &size) {
+  return rgba8Size(size) + kDestinationPadding;
+}
+
+bool ImageDecoder::decodeRGBA8(const std::string &filename,
+                               const VkExtent3D &size, void *destination,
+                               VkDeviceSize destination_size) {
+  auto start = std::chrono::steady_clock::now();
+  decode_target.memory = destination;
+  decode_target.image_size = static_cast<size_t>(rgba8Size(size));
+  decode_target.size = static_cast<size_t>(destination_size);
+  decode_target.taken = false;
+  int width = 0, height = 0, channels = 0;
+  stbi_uc *pixels = stbi_load(filename.c_str(), &width, &height, &channels,
+                              STBI_rgb_alpha);
+  decode_target = {};
+  if (!pixels) {
+    INFO("could not decode image file " + filename + ": " +
+         stbi_failure_reason());
+    return false;
+  }
+  auto bytes = static_cast<VkDeviceSize>(width) * height * 4;
+  bool direct = pixels == destination;
+  if (static_cast<uint32_t>(width) != size.width ||
+      static_cast<uint32_t>(height) != size.height) {
+    INFO("image file " + filename + " changed while decoding");
+    if (!direct)
+      stbi_image_free(pixels);
+    return false;
+  }
+  std::chrono::duration<double, std::milli> decode_time =
+      std::chrono::steady_clock::now() - start;
+  double copy_time = 0;
+  if (!direct) {
+    if (bytes > destination_size) {
+      INFO("image file " + filename + " does not fit the destination");
+      stbi_image_free(pixels);
+      return false;
+    }
+    start = std::chrono::steady_clock::now();
+    std::memcpy(destination, pixels, static_cast<size_t>(bytes));
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    copy_time = elapsed.count();
+    stbi_image_free(pixels);
+  }
+  std::lock_guard<std::mutex> lock(statistics_mutex);
+  decoder_statistics.images++;
+  decoder_statistics.bytes += bytes;
+  decoder_statistics.decode_time += decode_time.count();
+  if (direct) {
+    decoder_statistics.direct++;
+  } else {
+    decoder_statistics.copied++;
+    decoder_statistics.copied_bytes += bytes;
+    decoder_statistics.copy_time += copy_time;
+  }
+  return true;
+}
+
+ImageDecoder::Statistics ImageDecoder::statistics() {
+  std::lock_guard<std::mutex> lock(statistics_mutex);
+  return decoder_statistics;
+}
+
+void ImageDecoder::resetStatistics() {
+  std::lock_guard<std::mutex> lock(statistics_mutex);
+  Statistics statistics;
+  statistics.heap_bytes = decoder_statistics.heap_bytes;
+  statistics.peak_heap_bytes = decoder_statistics.heap_bytes;
+  decoder_statistics = statistics;
+}
+
+} // namespace circe::vk
@@ -0,0 +1,96 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_image_decoder.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_IMAGE_DECODER_H
+#define CIRCE_VK_IMAGE_DECODER_H
+
+#include <vulkan/vulkan.h>
+#include <string>
+
+namespace circe::vk {
+
+/// \brief Decodes image files (stb_image) straight into caller owned memory,
+/// typically a range reserved in a mapped StagingBuffer.
+/// stb_image allocates its output itself. The decoder hooks stb's allocator
+/// so that, on the decoding thread, the allocation of the output image is
+/// served by the destination memory. Formats whose final image is produced
+/// by a conversion pass (ex: 16-bit PNGs) end up in a heap allocation, that
+/// is copied into the destination, and are reported as copies.
+/// Usage:
+///   VkExtent3D size;
+///   ImageDecoder::info(filename, size);
+///   auto bytes = ImageDecoder::destinationSize(size);
+///   void *texels = staging.reserve(bytes, offset);
+///   ImageDecoder::decodeRGBA8(filename, size, texels, bytes);
+class ImageDecoder final {
+public:
+  /// Process wide decoding counters
+  struct Statistics {
+    uint64_t images{0};        //!< successfully decoded images
+    uint64_t direct{0};        //!< images decoded in place (zero copy)
+    uint64_t copied{0};        //!< images copied from a heap allocation
+    uint64_t bytes{0};         //!< decoded RGBA8 bytes
+    uint64_t copied_bytes{0};  //!< bytes moved by copies
+    double decode_time{0};     //!< sum of decoding times (ms)
+    double copy_time{0};       //!< sum of copy times (ms)
+    uint64_t heap_bytes{0};    //!< bytes currently allocated by the decoder
+    uint64_t peak_heap_bytes{0}; //!< maximum of heap_bytes
+    ///\return double copy bandwidth (MB/s)
+    [[nodiscard]] double copyBandwidth() const;
+    ///\return double decoded megabytes per second of decoding time
+    [[nodiscard]] double decodeBandwidth() const;
+  };
+  ///\brief Reads the image dimensions from the file header only
+  ///\param filename **[in]**
+  ///\param size **[out]** dimensions in texels (depth = 1)
+  ///\return bool true if the file is a supported image
+  static bool info(const std::string &filename, VkExtent3D &size);
+  ///\param size **[in]**
+  ///\return VkDeviceSize number of bytes of the image in RGBA8
+  static VkDeviceSize rgba8Size(const VkExtent3D &size);
+  ///\brief Some decoders allocate a few bytes past the image (ex: JPEG)
+  ///\param size **[in]**
+  ///\return VkDeviceSize number of bytes to reserve for decodeRGBA8
+  static VkDeviceSize destinationSize(const VkExtent3D &size);
+  ///\brief Decodes the image as 4 x 8-bit channels. Texels are tightly
+  /// packed at the beginning of the destination.
+  ///\param filename **[in]**
+  ///\param size **[in]** image dimensions given by info()
+  ///\param destination **[in]** memory receiving the texels
+  ///\param destination_size **[in]** at least destinationSize(size)
+  ///\return bool true if success
+  static bool decodeRGBA8(const std::string &filename, const VkExtent3D &size,
+                          void *destination, VkDeviceSize destination_size);
+  ///\return Statistics
+  static Statistics statistics();
+  ///\brief Zeroes counters (heap usage is kept)
+  static void resetStatistics();
+};
+
+} // namespace circe::vk
+
+#endif
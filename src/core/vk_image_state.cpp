@@ -0,0 +1,428 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_image_state.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_image_state.h"
+#include "logging.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace circe::vk {
+
+namespace {
+
+constexpr ImageUsage usages[] = {ImageUsage::TRANSFER_SRC,
+                                 ImageUsage::TRANSFER_DST,
+                                 ImageUsage::SAMPLED_VERTEX,
+                                 ImageUsage::SAMPLED_FRAGMENT,
+                                 ImageUsage::SAMPLED_COMPUTE,
+                                 ImageUsage::STORAGE_READ_COMPUTE,
+                                 ImageUsage::STORAGE_WRITE_COMPUTE,
+                                 ImageUsage::COLOR_ATTACHMENT,
+                                 ImageUsage::DEPTH_STENCIL_ATTACHMENT,
+                                 ImageUsage::DEPTH_STENCIL_READ,
+                                 ImageUsage::PRESENT};
+
+constexpr VkPipelineStageFlags shader_stages =
+    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+    VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT |
+    VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT |
+    VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT |
+    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+/// Stages that can perform an access type (vulkan spec, "Supported access
+/// types"), ignoring the ALL_* stages
+VkPipelineStageFlags supportedStages(VkAccessFlagBits access) {
+  switch (access) {
+  case VK_ACCESS_INDIRECT_COMMAND_READ_BIT:
+    return VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+  case VK_ACCESS_INDEX_READ_BIT:
+  case VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT:
+    return VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+  case VK_ACCESS_UNIFORM_READ_BIT:
+  case VK_ACCESS_SHADER_READ_BIT:
+  case VK_ACCESS_SHADER_WRITE_BIT:
+    return shader_stages;
+  case VK_ACCESS_INPUT_ATTACHMENT_READ_BIT:
+    return VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+  case VK_ACCESS_COLOR_ATTACHMENT_READ_BIT:
+  case VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT:
+    return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  case VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT:
+  case VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT:
+    return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+           VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+  case VK_ACCESS_TRANSFER_READ_BIT:
+  case VK_ACCESS_TRANSFER_WRITE_BIT:
+    return VK_PIPELINE_STAGE_TRANSFER_BIT;
+  case VK_ACCESS_HOST_READ_BIT:
+  case VK_ACCESS_HOST_WRITE_BIT:
+    return VK_PIPELINE_STAGE_HOST_BIT;
+  default:
+    break;
+  }
+  return ~0u;
+}
+
+/// Access types an image can be accessed with while in a layout
+VkAccessFlags allowedAccess(VkImageLayout layout) {
+  switch (layout) {
+  case VK_IMAGE_LAYOUT_GENERAL:
+    return ~0u;
+  case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+    return VK_ACCESS_TRANSFER_READ_BIT;
+  case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+    return VK_ACCESS_TRANSFER_WRITE_BIT;
+  case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+    return VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+  case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+    return VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+           VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+    return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+           VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+    return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+           VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+  default:
+    break;
+  }
+  // undefined, preinitialized and present layouts are not accessed by commands
+  return 0;
+}
+
+///\return bool true if every access type of access is performed by stages
+bool stagesSupport(VkPipelineStageFlags stages, VkAccessFlags access) {
+  if (stages & VK_PIPELINE_STAGE_ALL_COMMANDS_BIT)
+    return true;
+  for (uint32_t bit = 0; bit < 32; ++bit) {
+    auto flag = static_cast<VkAccessFlagBits>(1u << bit);
+    if ((access & flag) && !(stages & supportedStages(flag)))
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+bool ImageState::Subresource::operator==(const Subresource &other) const {
+  return layout == other.layout && write_access == other.write_access &&
+         write_stages == other.write_stages &&
+         read_stages == other.read_stages &&
+         visible_access == other.visible_access &&
+         visible_stages == other.visible_stages;
+}
+
+ImageState::Access ImageState::access(ImageUsage usage) {
+  switch (usage) {
+  case ImageUsage::TRANSFER_SRC:
+    return {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT};
+  case ImageUsage::TRANSFER_DST:
+    return {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT};
+  case ImageUsage::SAMPLED_VERTEX:
+    return {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT};
+  case ImageUsage::SAMPLED_FRAGMENT:
+    return {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT};
+  case ImageUsage::SAMPLED_COMPUTE:
+    return {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT};
+  case ImageUsage::STORAGE_READ_COMPUTE:
+    return {VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT};
+  case ImageUsage::STORAGE_WRITE_COMPUTE:
+    return {VK_IMAGE_LAYOUT_GENERAL,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT};
+  case ImageUsage::COLOR_ATTACHMENT:
+    return {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+  case ImageUsage::DEPTH_STENCIL_ATTACHMENT:
+    return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT};
+  case ImageUsage::DEPTH_STENCIL_READ:
+    return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT};
+  case ImageUsage::PRESENT:
+    return {VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 0,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT};
+  }
+  return {};
+}
+
+bool ImageState::isWrite(VkAccessFlags access) {
+  return access &
+         (VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+          VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT |
+          VK_ACCESS_MEMORY_WRITE_BIT);
+}
+
+bool ImageState::checkTransitionTable() {
+  for (auto usage : usages) {
+    auto name = "usage " + std::to_string(static_cast<int>(usage));
+    Access a = access(usage);
+    D_RETURN_FALSE_IF_NOT(a.stages, name + " has no stages")
+    D_RETURN_FALSE_IF_NOT(a.layout != VK_IMAGE_LAYOUT_UNDEFINED,
+                          name + " has no layout")
+    D_RETURN_FALSE_IF_NOT(stagesSupport(a.stages, a.access),
+                          name + " accesses are not supported by its stages")
+    D_RETURN_FALSE_IF_NOT(!(a.access & ~allowedAccess(a.layout)),
+                          name + " accesses are not allowed by its layout")
+  }
+  for (auto from : usages)
+    for (auto to : usages) {
+      auto name = "transition " + std::to_string(static_cast<int>(from)) +
+                  " -> " + std::to_string(static_cast<int>(to));
+      Access a = access(from);
+      Access b = access(to);
+      // 2 mips x 2 layers in the same state must produce a single barrier
+      ImageState state(2, 2, VK_IMAGE_ASPECT_COLOR_BIT);
+      std::vector<VkImageMemoryBarrier> barriers;
+      VkPipelineStageFlags src_stages = 0, dst_stages = 0;
+      state.use(a, VK_NULL_HANDLE, barriers, src_stages, dst_stages);
+      barriers.clear();
+      src_stages = dst_stages = 0;
+      uint32_t count =
+          state.use(b, VK_NULL_HANDLE, barriers, src_stages, dst_stages);
+      // reads in the same layout wait only if they see new stages or accesses
+      bool needs_barrier = a.layout != b.layout || isWrite(a.access) ||
+                           isWrite(b.access) || (b.stages & ~a.stages) ||
+                           (b.access & ~a.access);
+      D_RETURN_FALSE_IF_NOT(count == (needs_barrier ? 1u : 0u),
+                            name + " generated a wrong number of barriers")
+      if (!count)
+        continue;
+      const auto &barrier = barriers[0];
+      D_RETURN_FALSE_IF_NOT(barrier.oldLayout == a.layout &&
+                                barrier.newLayout == b.layout,
+                            name + " has wrong layouts")
+      D_RETURN_FALSE_IF_NOT(barrier.subresourceRange.levelCount == 2 &&
+                                barrier.subresourceRange.layerCount == 2,
+                            name + " barrier does not cover the image")
+      D_RETURN_FALSE_IF_NOT(
+          !isWrite(a.access) || (barrier.srcAccessMask & a.access) == a.access,
+          name + " does not make the previous write available")
+      D_RETURN_FALSE_IF_NOT((src_stages & a.stages) == a.stages,
+                            name + " does not wait for the previous stages")
+      D_RETURN_FALSE_IF_NOT(dst_stages == b.stages,
+                            name + " has wrong destination stages")
+      D_RETURN_FALSE_IF_NOT(
+          stagesSupport(src_stages, barrier.srcAccessMask) &&
+              stagesSupport(dst_stages, barrier.dstAccessMask),
+          name + " accesses are not supported by its stages")
+      // a second read in the same state is free
+      if (!isWrite(b.access)) {
+        barriers.clear();
+        D_RETURN_FALSE_IF_NOT(!state.use(b, VK_NULL_HANDLE, barriers,
+                                         src_stages, dst_stages),
+                              name + " repeats a barrier for the same read")
+      }
+    }
+  return true;
+}
+
+ImageState::ImageState(uint32_t mip_levels, uint32_t array_layers,
+                       VkImageAspectFlags aspect_mask,
+                       VkImageLayout initial_layout)
+    : mip_levels_(mip_levels), array_layers_(array_layers),
+      aspect_mask_(aspect_mask) {
+  Subresource initial_state;
+  initial_state.layout = initial_layout;
+  subresources_.resize(mip_levels * array_layers, initial_state);
+}
+
+uint32_t ImageState::use(const Access &access, VkImage image,
+                         std::vector<VkImageMemoryBarrier> &barriers,
+                         VkPipelineStageFlags &src_stages,
+                         VkPipelineStageFlags &dst_stages,
+                         uint32_t base_mip_level, uint32_t mip_level_count,
+                         uint32_t base_array_layer,
+                         uint32_t array_layer_count) {
+  if (base_mip_level >= mip_levels_ || base_array_layer >= array_layers_)
+    return 0;
+  uint32_t end_mip =
+      base_mip_level + std::min(mip_level_count, mip_levels_ - base_mip_level);
+  uint32_t end_layer =
+      base_array_layer +
+      std::min(array_layer_count, array_layers_ - base_array_layer);
+  size_t first_barrier = barriers.size();
+  for (uint32_t layer = base_array_layer; layer < end_layer; ++layer) {
+    uint32_t mip = base_mip_level;
+    while (mip < end_mip) {
+      // subresources sharing the same state end up with the same barrier
+      const Subresource current = subresources_[layer * mip_levels_ + mip];
+      uint32_t run_end = mip + 1;
+      while (run_end < end_mip &&
+             subresources_[layer * mip_levels_ + run_end] == current)
+        ++run_end;
+      VkAccessFlags barrier_src_access = 0;
+      VkPipelineStageFlags barrier_src_stages = 0;
+      Subresource next;
+      if (transition(current, access, barrier_src_access, barrier_src_stages,
+                     next)) {
+        src_stages |= barrier_src_stages ? barrier_src_stages
+                                         : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        dst_stages |= access.stages;
+        // try to extend a barrier of the previous layer
+        bool merged = false;
+        for (size_t i = first_barrier; i < barriers.size() && !merged; ++i) {
+          auto &b = barriers[i].subresourceRange;
+          if (b.baseMipLevel == mip && b.levelCount == run_end - mip &&
+              b.baseArrayLayer + b.layerCount == layer &&
+              barriers[i].oldLayout == current.layout &&
+              barriers[i].srcAccessMask == barrier_src_access) {
+            b.layerCount++;
+            merged = true;
+          }
+        }
+        if (!merged) {
+          VkImageMemoryBarrier barrier = {
+              VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER, // VkStructureType sType
+              nullptr,                                // const void * pNext
+              barrier_src_access,      // VkAccessFlags srcAccessMask
+              access.access,           // VkAccessFlags dstAccessMask
+              current.layout,          // VkImageLayout oldLayout
+              access.layout,           // VkImageLayout newLayout
+              VK_QUEUE_FAMILY_IGNORED, // uint32_t srcQueueFamilyIndex
+              VK_QUEUE_FAMILY_IGNORED, // uint32_t dstQueueFamilyIndex
+              image,                   // VkImage image
+              {
+                  // VkImageSubresourceRange subresourceRange
+                  aspect_mask_,   // VkImageAspectFlags aspectMask
+                  mip,            // uint32_t baseMipLevel
+                  run_end - mip,  // uint32_t levelCount
+                  layer,          // uint32_t baseArrayLayer
+                  1               // uint32_t layerCount
+              }};
+          barriers.emplace_back(barrier);
+        }
+      }
+      for (uint32_t i = mip; i < run_end; ++i)
+        subresources_[layer * mip_levels_ + i] = next;
+      mip = run_end;
+    }
+  }
+  return barriers.size() - first_barrier;
+}
+
+void ImageState::set(const Access &access, uint32_t base_mip_level,
+                     uint32_t mip_level_count, uint32_t base_array_layer,
+                     uint32_t array_layer_count) {
+  if (base_mip_level >= mip_levels_ || base_array_layer >= array_layers_)
+    return;
+  uint32_t end_mip =
+      base_mip_level + std::min(mip_level_count, mip_levels_ - base_mip_level);
+  uint32_t end_layer =
+      base_array_layer +
+      std::min(array_layer_count, array_layers_ - base_array_layer);
+  Subresource state;
+  state.layout = access.layout;
+  if (isWrite(access.access)) {
+    state.write_access = access.access;
+    state.write_stages = access.stages;
+  } else {
+    state.read_stages = access.stages;
+    state.visible_access = access.access;
+    state.visible_stages = access.stages;
+  }
+  for (uint32_t layer = base_array_layer; layer < end_layer; ++layer)
+    for (uint32_t mip = base_mip_level; mip < end_mip; ++mip)
+      subresources_[layer * mip_levels_ + mip] = state;
+}
+
+const ImageState::Subresource &
+ImageState::subresource(uint32_t mip_level, uint32_t array_layer) const {
+  return subresources_[array_layer * mip_levels_ + mip_level];
+}
+
+uint32_t ImageState::mipLevels() const { return mip_levels_; }
+
+uint32_t ImageState::arrayLayers() const { return array_layers_; }
+
+bool ImageState::transition(const Subresource &current, const Access &access,
+                            VkAccessFlags &src_access,
+                            VkPipelineStageFlags &src_stages,
+                            Subresource &next) {
+  next = current;
+  if (current.layout != access.layout || isWrite(access.access)) {
+    // layout transitions and writes must wait for all previous accesses, but
+    // only previous writes need to be made available
+    src_stages = current.write_stages | current.read_stages;
+    src_access = current.write_access;
+    next.layout = access.layout;
+    if (isWrite(access.access)) {
+      next.write_access = access.access;
+      next.write_stages = access.stages;
+      next.read_stages = 0;
+      next.visible_access = 0;
+      next.visible_stages = 0;
+    } else {
+      // the layout transition is the last write, it is visible to the
+      // destination of the barrier
+      next.write_access = 0;
+      next.write_stages = 0;
+      next.read_stages = access.stages;
+      next.visible_access = access.access;
+      next.visible_stages = access.stages;
+    }
+    return current.layout != access.layout || src_stages != 0;
+  }
+  // read in the current layout
+  next.read_stages |= access.stages;
+  if (!(access.stages & ~current.visible_stages) &&
+      !(access.access & ~current.visible_access))
+    return false;
+  if (current.write_stages) {
+    src_stages = current.write_stages;
+    src_access = current.write_access;
+  } else if (current.visible_stages) {
+    // the last layout transition is waited by the stages that already see it,
+    // so chaining on them is enough
+    src_stages = current.visible_stages;
+    src_access = 0;
+  } else
+    return false;
+  next.visible_stages |= access.stages;
+  next.visible_access |= access.access;
+  return true;
+}
+
+} // namespace circe::vk
@@ -0,0 +1,163 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_image_state.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_IMAGE_STATE_H
+#define CIRCE_VK_IMAGE_STATE_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace circe::vk {
+
+/// Common ways an image subresource is used by commands. Each usage maps to
+/// the layout the image must be in, and the access types and pipeline stages
+/// of the operations that use it.
+enum class ImageUsage {
+  TRANSFER_SRC,
+  TRANSFER_DST,
+  SAMPLED_VERTEX,
+  SAMPLED_FRAGMENT,
+  SAMPLED_COMPUTE,
+  STORAGE_READ_COMPUTE,
+  STORAGE_WRITE_COMPUTE,
+  COLOR_ATTACHMENT,
+  DEPTH_STENCIL_ATTACHMENT,
+  DEPTH_STENCIL_READ,
+  PRESENT
+};
+
+/// Tracks the layout, access and pipeline stages of each subresource (mip
+/// level and array layer) of an image, so the barriers required by a new usage
+/// can be computed automatically. Only the barriers needed to avoid hazards
+/// are generated:
+/// - read after read in the same layout needs no barrier (unless the
+///   previous write was not made visible to the new stages yet);
+/// - write after read needs an execution dependency only;
+/// - layout transitions and accesses after writes need full barriers.
+/// This class performs no vulkan calls, it is a plain model of the image
+/// state. The tracked state assumes that commands are submitted in the same
+/// order they are recorded.
+class ImageState {
+public:
+  /// Layout, access types and stages of an image usage
+  struct Access {
+    VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+    VkAccessFlags access{0};
+    VkPipelineStageFlags stages{0};
+  };
+  /// State of a single subresource
+  struct Subresource {
+    bool operator==(const Subresource &other) const;
+    VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+    VkAccessFlags write_access{0};        //!< last write access
+    VkPipelineStageFlags write_stages{0}; //!< stages of the last write
+    VkPipelineStageFlags read_stages{0};  //!< stages reading since last write
+    VkAccessFlags visible_access{0}; //!< accesses that see the last write
+    VkPipelineStageFlags visible_stages{0}; //!< stages that see the last write
+  };
+  ///\param usage **[in]**
+  ///\return Access layout, access and stages associated to the usage
+  static Access access(ImageUsage usage);
+  ///\param access **[in]**
+  ///\return bool true if access contains any write access type
+  static bool isWrite(VkAccessFlags access);
+  ///\brief Checks the usage table without touching the device: the access
+  /// types of each usage must be supported by its stages and allowed by its
+  /// layout, and the barriers generated from every usage to every other usage
+  /// must be valid, cover the previous write and be merged into one barrier.
+  /// Run by the image_state_check example.
+  ///\return bool true if the table is consistent (errors go to stderr)
+  static bool checkTransitionTable();
+  ImageState() = default;
+  ///\param mip_levels **[in]**
+  ///\param array_layers **[in]**
+  ///\param aspect_mask **[in]** aspect used by the generated barriers
+  ///\param initial_layout **[in | optional = VK_IMAGE_LAYOUT_UNDEFINED]**
+  ImageState(uint32_t mip_levels, uint32_t array_layers,
+             VkImageAspectFlags aspect_mask,
+             VkImageLayout initial_layout = VK_IMAGE_LAYOUT_UNDEFINED);
+  ///\brief Declares a new usage of a range of subresources. The barriers
+  /// needed before the usage are appended to barriers (adjacent subresources
+  /// sharing the same state are merged into a single barrier) and the stage
+  /// masks of the barriers are or-ed into src_stages and dst_stages.
+  ///\param access **[in]** new usage
+  ///\param image **[in]** image handle written in the barriers
+  ///\param barriers **[out]**
+  ///\param src_stages **[out]**
+  ///\param dst_stages **[out]**
+  ///\param base_mip_level **[in | optional = 0]**
+  ///\param mip_level_count **[in | optional = VK_REMAINING_MIP_LEVELS]**
+  ///\param base_array_layer **[in | optional = 0]**
+  ///\param array_layer_count **[in | optional = VK_REMAINING_ARRAY_LAYERS]**
+  ///\return uint32_t number of barriers appended
+  uint32_t use(const Access &access, VkImage image,
+               std::vector<VkImageMemoryBarrier> &barriers,
+               VkPipelineStageFlags &src_stages,
+               VkPipelineStageFlags &dst_stages, uint32_t base_mip_level = 0,
+               uint32_t mip_level_count = VK_REMAINING_MIP_LEVELS,
+               uint32_t base_array_layer = 0,
+               uint32_t array_layer_count = VK_REMAINING_ARRAY_LAYERS);
+  ///\brief Overrides the state of a range of subresources without generating
+  /// barriers. Useful when the layout changes implicitly (ex: renderpass
+  /// final layouts).
+  ///\param access **[in]**
+  ///\param base_mip_level **[in | optional = 0]**
+  ///\param mip_level_count **[in | optional = VK_REMAINING_MIP_LEVELS]**
+  ///\param base_array_layer **[in | optional = 0]**
+  ///\param array_layer_count **[in | optional = VK_REMAINING_ARRAY_LAYERS]**
+  void set(const Access &access, uint32_t base_mip_level = 0,
+           uint32_t mip_level_count = VK_REMAINING_MIP_LEVELS,
+           uint32_t base_array_layer = 0,
+           uint32_t array_layer_count = VK_REMAINING_ARRAY_LAYERS);
+  ///\param mip_level **[in]**
+  ///\param array_layer **[in]**
+  ///\return const Subresource&
+  [[nodiscard]] const Subresource &subresource(uint32_t mip_level,
+                                               uint32_t array_layer) const;
+  [[nodiscard]] uint32_t mipLevels() const;
+  [[nodiscard]] uint32_t arrayLayers() const;
+
+private:
+  ///\brief Computes the state of a subresource after a new usage
+  ///\param current **[in]**
+  ///\param access **[in]**
+  ///\param src_access **[out]**
+  ///\param src_stages **[out]**
+  ///\param next **[out]**
+  ///\return bool true if a barrier is needed
+  static bool transition(const Subresource &current, const Access &access,
+                         VkAccessFlags &src_access,
+                         VkPipelineStageFlags &src_stages, Subresource &next);
+  uint32_t mip_levels_{0};
+  uint32_t array_layers_{0};
+  VkImageAspectFlags aspect_mask_{VK_IMAGE_ASPECT_COLOR_BIT};
+  std::vector<Subresource> subresources_; //!< indexed by layer * mips + mip
+};
+
+} // namespace circe::vk
+
+#endif
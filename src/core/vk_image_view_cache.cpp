@@ -0,0 +1,119 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_image_view_cache.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_image_view_cache.h"
+#include "vk_hash.h"
+
+namespace circe::vk {
+
+double ImageViewCache::Statistics::hitRate() const {
+  return requests ? static_cast<double>(hits) / requests : 0.0;
+}
+
+bool ImageViewCache::Key::operator==(const Key &other) const {
+  return image == other.image && view_type == other.view_type &&
+         format == other.format && range.aspectMask == other.range.aspectMask &&
+         range.baseMipLevel == other.range.baseMipLevel &&
+         range.levelCount == other.range.levelCount &&
+         range.baseArrayLayer == other.range.baseArrayLayer &&
+         range.layerCount == other.range.layerCount;
+}
+
+size_t ImageViewCache::KeyHash::operator()(const Key &key) const {
+  size_t seed = 0;
+  hashCombine(seed, key.image, key.view_type, key.format,
+              key.range.aspectMask, key.range.baseMipLevel,
+              key.range.levelCount, key.range.baseArrayLayer,
+              key.range.layerCount);
+  return seed;
+}
+
+std::shared_ptr<Image::View>
+ImageViewCache::view(const Image *image, VkImageViewType view_type,
+                     VkFormat format, VkImageAspectFlags aspect,
+                     uint32_t base_mip_level, uint32_t mip_level_count,
+                     uint32_t base_array_layer, uint32_t array_layer_count) {
+  if (!image || !image->good())
+    return nullptr;
+  requests_++;
+  // remaining counts are resolved, so both ways of asking for the same range
+  // share the view
+  if (mip_level_count == VK_REMAINING_MIP_LEVELS)
+    mip_level_count = image->mipLevels() - base_mip_level;
+  if (array_layer_count == VK_REMAINING_ARRAY_LAYERS)
+    array_layer_count = image->arrayLayers() - base_array_layer;
+  Key key;
+  key.image = image->handle();
+  key.view_type = view_type;
+  key.format = format == VK_FORMAT_UNDEFINED ? image->format() : format;
+  key.range = {aspect, base_mip_level, mip_level_count, base_array_layer,
+               array_layer_count};
+  auto it = views_.find(key);
+  if (it != views_.end()) {
+    hits_++;
+    return it->second;
+  }
+  auto view = std::make_shared<Image::View>(
+      image, view_type, key.format, aspect, base_mip_level, mip_level_count,
+      base_array_layer, array_layer_count);
+  if (view->handle() == VK_NULL_HANDLE)
+    return nullptr;
+  views_[key] = view;
+  return view;
+}
+
+size_t ImageViewCache::release(const Image *image) {
+  size_t count = 0;
+  for (auto it = views_.begin(); it != views_.end();)
+    if (it->first.image == image->handle()) {
+      it = views_.erase(it);
+      count++;
+    } else
+      ++it;
+  return count;
+}
+
+size_t ImageViewCache::purge() {
+  size_t count = 0;
+  for (auto it = views_.begin(); it != views_.end();)
+    if (it->second.use_count() == 1) {
+      it = views_.erase(it);
+      count++;
+    } else
+      ++it;
+  return count;
+}
+
+ImageViewCache::Statistics ImageViewCache::statistics() const {
+  Statistics statistics;
+  statistics.requests = requests_;
+  statistics.hits = hits_;
+  statistics.views = views_.size();
+  return statistics;
+}
+
+} // namespace circe::vk
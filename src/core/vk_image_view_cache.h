@@ -0,0 +1,106 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_image_view_cache.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_IMAGE_VIEW_CACHE_H
+#define CIRCE_VK_IMAGE_VIEW_CACHE_H
+
+#include "vk_image.h"
+#include <memory>
+#include <unordered_map>
+
+namespace circe::vk {
+
+/// \brief Deduplicates image views by image, view type, format, aspect and
+/// subresource range. Users asking for the same view of a texture (ex:
+/// several materials sampling the same image) share one view.
+/// Views are keyed by the image handle, so the views of an image must be
+/// released before the image is destroyed.
+/// Usage:
+///   ImageViewCache views;
+///   auto view = views.view(texture.image(), VK_IMAGE_VIEW_TYPE_2D);
+///   ...
+///   views.release(texture.image()); // before destroying the texture
+class ImageViewCache final {
+public:
+  struct Statistics {
+    uint64_t requests{0}; //!< calls to view()
+    uint64_t hits{0};     //!< requests served by an existing view
+    size_t views{0};      //!< distinct views alive in the cache
+    ///\return double hits / requests
+    [[nodiscard]] double hitRate() const;
+  };
+  ImageViewCache() = default;
+  ///\param image **[in]**
+  ///\param view_type **[in]**
+  ///\param format **[in | optional = VK_FORMAT_UNDEFINED]** undefined means
+  /// the image format
+  ///\param aspect **[in | optional = VK_IMAGE_ASPECT_COLOR_BIT]**
+  ///\param base_mip_level **[in | optional = 0]**
+  ///\param mip_level_count **[in | optional = VK_REMAINING_MIP_LEVELS]**
+  ///\param base_array_layer **[in | optional = 0]**
+  ///\param array_layer_count **[in | optional = VK_REMAINING_ARRAY_LAYERS]**
+  ///\return std::shared_ptr<Image::View> shared view, nullptr on failure
+  std::shared_ptr<Image::View>
+  view(const Image *image, VkImageViewType view_type,
+       VkFormat format = VK_FORMAT_UNDEFINED,
+       VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+       uint32_t base_mip_level = 0,
+       uint32_t mip_level_count = VK_REMAINING_MIP_LEVELS,
+       uint32_t base_array_layer = 0,
+       uint32_t array_layer_count = VK_REMAINING_ARRAY_LAYERS);
+  ///\brief Drops the cached views of an image. Views still referenced
+  /// elsewhere are destroyed by their last owner, which must happen before
+  /// the image is destroyed.
+  ///\param image **[in]**
+  ///\return size_t number of dropped views
+  size_t release(const Image *image);
+  ///\brief Destroys the views no longer referenced outside the cache
+  ///\return size_t number of destroyed views
+  size_t purge();
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+
+private:
+  struct Key {
+    VkImage image{VK_NULL_HANDLE};
+    VkImageViewType view_type{VK_IMAGE_VIEW_TYPE_2D};
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    VkImageSubresourceRange range{};
+    bool operator==(const Key &other) const;
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  std::unordered_map<Key, std::shared_ptr<Image::View>, KeyHash> views_;
+  uint64_t requests_{0};
+  uint64_t hits_{0};
+};
+
+} // namespace circe::vk
+
+#endif
@@ -0,0 +1,102 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_mapped_file.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_mapped_file.h"
+#include <fstream>
+#include <utility>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace circe::vk {
+
+MappedFile::MappedFile(const std::string &path) { open(path); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(other.data_), size_(other.size_), mapped_(other.mapped_),
+      buffer_(std::move(other.buffer_)) {
+  if (!mapped_)
+    data_ = buffer_.data();
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.mapped_ = false;
+}
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const std::string &path) {
+  close();
+#ifndef _WIN32
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st {};
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void *ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                     MAP_PRIVATE, fd, 0);
+    if (ptr != MAP_FAILED) {
+      data_ = ptr;
+      size_ = static_cast<size_t>(st.st_size);
+      mapped_ = true;
+    }
+  }
+  ::close(fd);
+  if (mapped_)
+    return true;
+#endif
+  std::ifstream file(path, std::ios::ate | std::ios::binary);
+  if (!file.is_open())
+    return false;
+  buffer_.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  file.read(buffer_.data(), buffer_.size());
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+  return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+  if (mapped_)
+    munmap(const_cast<void *>(data_), size_);
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+  buffer_.clear();
+}
+
+bool MappedFile::good() const { return data_ != nullptr; }
+
+const void *MappedFile::data() const { return data_; }
+
+size_t MappedFile::size() const { return size_; }
+
+} // namespace circe::vk
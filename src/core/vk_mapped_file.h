@@ -0,0 +1,68 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_mapped_file.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_MAPPED_FILE_H
+#define CIRCE_VK_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace circe::vk {
+
+/// \brief Read-only view of a whole file. The file is memory mapped, so its
+/// contents are paged in on access and never copied into a user buffer.
+/// Platforms without mmap fall back to reading the file into memory.
+class MappedFile final {
+public:
+  MappedFile() = default;
+  ///\param path **[in]**
+  explicit MappedFile(const std::string &path);
+  MappedFile(const MappedFile &other) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  ~MappedFile();
+  ///\param path **[in]**
+  ///\return bool true if success
+  bool open(const std::string &path);
+  void close();
+  ///\return bool true if the file is mapped
+  [[nodiscard]] bool good() const;
+  ///\return const void* file contents
+  [[nodiscard]] const void *data() const;
+  ///\return size_t file size in bytes
+  [[nodiscard]] size_t size() const;
+
+private:
+  const void *data_ = nullptr;
+  size_t size_{0};
+  bool mapped_{false};
+  std::vector<char> buffer_; // fallback storage
+};
+
+} // namespace circe::vk
+
+#endif
@@ -0,0 +1,254 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_mip_downsampler.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_mip_downsampler.h"
+#include "logging.h"
+#include "vk_sampler_cache.h"
+#include "vk_sync.h"
+#include <algorithm>
+#include <iostream>
+
+namespace circe::vk {
+
+namespace {
+
+// matches the push constant block of downsample.comp
+struct PushConstants {
+  int32_t source_size[2];
+  uint32_t level_count;
+  uint32_t srgb;
+};
+
+// texels of the first level written by a workgroup, in each direction
+const uint32_t tile_size = 32;
+
+} // namespace
+
+MipDownsampler::MipDownsampler(const LogicalDevice *logical_device,
+                               const ShaderModule &module,
+                               Reduction reduction)
+    : logical_device_(logical_device),
+      reduction_(static_cast<uint32_t>(reduction)),
+      pipeline_layout_(logical_device),
+      descriptor_allocator_(logical_device, 16) {
+  auto &set_layout = pipeline_layout_.descriptorSetLayout(
+      pipeline_layout_.createLayoutSet(0));
+  set_layout.addLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
+                              VK_SHADER_STAGE_COMPUTE_BIT);
+  set_layout.addLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                              levels_per_dispatch,
+                              VK_SHADER_STAGE_COMPUTE_BIT);
+  pipeline_layout_.addPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                                        sizeof(PushConstants));
+  // the reduction is a specialization constant, so the shader has no
+  // branches on it
+  stage_.set(VK_SHADER_STAGE_COMPUTE_BIT, module, "main", &reduction_,
+             sizeof(reduction_));
+  stage_.addSpecializationMapEntry(0, 0, sizeof(reduction_));
+  pipeline_ = std::make_unique<ComputePipeline>(logical_device_, stage_,
+                                                pipeline_layout_);
+  // texels are fetched, filtering is never used
+  sampler_ = std::make_unique<Sampler>(
+      logical_device_,
+      SamplerCache::nearest(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE));
+}
+
+MipDownsampler::~MipDownsampler() { targets_.clear(); }
+
+bool MipDownsampler::record(CommandBuffer &cb, const Image &image,
+                            VkFormat format, ImageUsage final_usage) {
+  if (format == VK_FORMAT_UNDEFINED)
+    format = image.format();
+  if (image.mipLevels() > 1)
+    RETURN_FALSE_IF_NOT(recordPasses(cb, image, format,
+                                     VK_IMAGE_ASPECT_COLOR_BIT, image, 1,
+                                     storageFormat(format) != format))
+  cb.use(image, final_usage);
+  return true;
+}
+
+bool MipDownsampler::recordPyramid(CommandBuffer &cb, const Image &depth,
+                                   const Image &pyramid,
+                                   ImageUsage final_usage) {
+  RETURN_FALSE_IF_NOT(recordPasses(cb, depth, depth.format(),
+                                   VK_IMAGE_ASPECT_DEPTH_BIT, pyramid, 0,
+                                   false))
+  cb.use(pyramid, final_usage);
+  return true;
+}
+
+bool MipDownsampler::recordPasses(CommandBuffer &cb, const Image &source,
+                                  VkFormat source_format,
+                                  VkImageAspectFlags source_aspect,
+                                  const Image &destination,
+                                  uint32_t first_level, bool srgb) {
+  Target *pass_target = target(source, source_format, source_aspect,
+                               destination, first_level);
+  D_RETURN_FALSE_IF_NOT(pass_target,
+                        "could not create mip downsampler descriptors");
+  cb.bind(*pipeline_);
+  const uint32_t mip_levels = destination.mipLevels();
+  uint32_t pass = 0;
+  for (uint32_t level = first_level; level < mip_levels;
+       level += levels_per_dispatch, ++pass) {
+    // the first pass reads the source, the next ones read the last level
+    // written by the previous pass
+    const Image &pass_source = pass ? destination : source;
+    const uint32_t source_level = pass ? level - 1 : 0;
+    const uint32_t level_count =
+        std::min(levels_per_dispatch, mip_levels - level);
+    PipelineBarrier barriers;
+    barriers.add(pass_source, ImageUsage::SAMPLED_COMPUTE, source_level, 1);
+    barriers.add(destination, ImageUsage::STORAGE_WRITE_COMPUTE, level,
+                 level_count);
+    barriers.flush(cb);
+    VkExtent3D size = pass_source.size();
+    PushConstants push_constants = {
+        {static_cast<int32_t>(std::max(size.width >> source_level, 1u)),
+         static_cast<int32_t>(std::max(size.height >> source_level, 1u))},
+        level_count,
+        srgb ? 1u : 0u};
+    cb.bind(VK_PIPELINE_BIND_POINT_COMPUTE, &pipeline_layout_, 0,
+            {pass_target->descriptor_sets[pass]});
+    cb.pushConstants(pipeline_layout_, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                     sizeof(PushConstants), &push_constants);
+    uint32_t width = std::max(size.width >> (source_level + 1), 1u);
+    uint32_t height = std::max(size.height >> (source_level + 1), 1u);
+    cb.dispatch((width + tile_size - 1) / tile_size,
+                (height + tile_size - 1) / tile_size, 1);
+    dispatch_count_++;
+  }
+  return true;
+}
+
+MipDownsampler::Target *
+MipDownsampler::target(const Image &source, VkFormat source_format,
+                       VkImageAspectFlags source_aspect,
+                       const Image &destination, uint32_t first_level) {
+  TargetKey key{source.handle(), destination.handle(), source_format};
+  auto it = targets_.find(key);
+  if (it != targets_.end())
+    return &it->second;
+  // levels written by a pass are read by the next one in the format the
+  // destination is sampled with
+  const VkFormat destination_format =
+      &source == &destination ? source_format : destination.format();
+  const VkFormat storage_format = storageFormat(destination.format());
+  Target target;
+  for (uint32_t level = first_level; level < destination.mipLevels();
+       level += levels_per_dispatch) {
+    VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+    if (!descriptor_allocator_.allocate(
+            pipeline_layout_.descriptorSetLayout(0), descriptor_set))
+      return nullptr;
+    if (level == first_level)
+      target.views.emplace_back(std::make_unique<Image::View>(
+          &source, VK_IMAGE_VIEW_TYPE_2D, source_format, source_aspect, 0, 1));
+    else
+      target.views.emplace_back(std::make_unique<Image::View>(
+          &destination, VK_IMAGE_VIEW_TYPE_2D, destination_format,
+          VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 1));
+    VkDescriptorImageInfo source_info = {
+        sampler_->handle(), target.views.back()->handle(),
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    // every element of the array must be valid, levels past the last one
+    // repeat it (the shader never writes them)
+    std::vector<VkDescriptorImageInfo> level_infos;
+    for (uint32_t i = 0; i < levels_per_dispatch; ++i) {
+      if (level + i < destination.mipLevels())
+        target.views.emplace_back(std::make_unique<Image::View>(
+            &destination, VK_IMAGE_VIEW_TYPE_2D, storage_format,
+            VK_IMAGE_ASPECT_COLOR_BIT, level + i, 1));
+      level_infos.push_back({VK_NULL_HANDLE, target.views.back()->handle(),
+                             VK_IMAGE_LAYOUT_GENERAL});
+    }
+    VkWriteDescriptorSet writes[2] = {};
+    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[0].dstSet = descriptor_set;
+    writes[0].dstBinding = 0;
+    writes[0].descriptorCount = 1;
+    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writes[0].pImageInfo = &source_info;
+    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[1].dstSet = descriptor_set;
+    writes[1].dstBinding = 1;
+    writes[1].descriptorCount = levels_per_dispatch;
+    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    writes[1].pImageInfo = level_infos.data();
+    vkUpdateDescriptorSets(logical_device_->handle(), 2, writes, 0, nullptr);
+    target.descriptor_sets.emplace_back(descriptor_set);
+  }
+  return &(targets_[key] = std::move(target));
+}
+
+void MipDownsampler::release(const Image &image) {
+  for (auto it = targets_.begin(); it != targets_.end();)
+    if (std::get<0>(it->first) == image.handle() ||
+        std::get<1>(it->first) == image.handle())
+      it = targets_.erase(it);
+    else
+      ++it;
+}
+
+void MipDownsampler::reset() {
+  targets_.clear();
+  descriptor_allocator_.reset();
+}
+
+uint32_t MipDownsampler::dispatchCount() const { return dispatch_count_; }
+
+bool MipDownsampler::isSupported(const PhysicalDevice &physical_device,
+                                 VkFormat format) {
+  VkFormatProperties properties;
+  if (!physical_device.formatProperties(format, properties) ||
+      !(properties.optimalTilingFeatures &
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT))
+    return false;
+  if (!physical_device.formatProperties(storageFormat(format), properties))
+    return false;
+  return properties.optimalTilingFeatures &
+         VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+}
+
+VkFormat MipDownsampler::storageFormat(VkFormat format) {
+  // the storage format qualifier of the shader must match the view format,
+  // so only the sRGB version of rgba8 is translated
+  if (format == VK_FORMAT_R8G8B8A8_SRGB)
+    return VK_FORMAT_R8G8B8A8_UNORM;
+  return format;
+}
+
+VkImageUsageFlags MipDownsampler::imageUsage() {
+  return VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+}
+
+VkImageCreateFlags MipDownsampler::imageCreateFlags(VkFormat format) {
+  return storageFormat(format) != format ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT
+                                         : 0;
+}
+
+} // namespace circe::vk
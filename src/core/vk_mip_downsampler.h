@@ -0,0 +1,168 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_mip_downsampler.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_MIP_DOWNSAMPLER_H
+#define CIRCE_VK_MIP_DOWNSAMPLER_H
+
+#include "vk_command_buffer.h"
+#include "vk_descriptor_allocator.h"
+#include "vk_image.h"
+#include "vk_pipeline.h"
+#include "vk_sampler.h"
+#include <map>
+#include <tuple>
+
+namespace circe::vk {
+
+/// \brief Compute mip chain generator.
+/// Each dispatch reduces the source level into up to 6 levels: workgroups
+/// reduce 64x64 tiles and keep the intermediate levels in shared memory, so
+/// the 13 levels of a 4096x4096 texture take 2 dispatches (and 2 barriers)
+/// instead of 12 serialized blits. The source level is read through a
+/// sampled view (sRGB views decode for free) and levels are written through
+/// storage views, sRGB textures are encoded by the shader.
+/// The reduction can be the average (color textures) or the min/max of the
+/// texels, which also builds hierarchical depth pyramids for occlusion
+/// culling (see recordPyramid).
+/// The shader module comes from examples/assets/shaders/downsample.comp,
+/// compiled with the storage format of the destination (rgba8 or r32f).
+/// Images need VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT (see
+/// imageUsage()), sRGB images must be created with their storage format and
+/// imageCreateFlags() and sampled through sRGB views.
+/// Usage:
+///   MipDownsampler downsampler(device, module);
+///   Texture texture(device, VK_IMAGE_TYPE_2D,
+///                   MipDownsampler::storageFormat(VK_FORMAT_R8G8B8A8_SRGB),
+///                   size, levels, 1, VK_SAMPLE_COUNT_1_BIT,
+///                   MipDownsampler::imageUsage() | ..., false,
+///                   MipDownsampler::imageCreateFlags(
+///                       VK_FORMAT_R8G8B8A8_SRGB));
+///   ...
+///   downsampler.record(cb, *texture.image(), VK_FORMAT_R8G8B8A8_SRGB);
+class MipDownsampler final {
+public:
+  enum class Reduction {
+    AVERAGE, //!< box filter
+    MIN,     //!< farthest depth of reversed-z pyramids
+    MAX      //!< farthest depth of pyramids
+  };
+  /// levels written by a single dispatch
+  static const uint32_t levels_per_dispatch = 6;
+  ///\param logical_device **[in]**
+  ///\param module **[in]** downsample.comp compiled for the storage format
+  /// of the images this object will process
+  ///\param reduction **[in | optional = AVERAGE]**
+  MipDownsampler(const LogicalDevice *logical_device,
+                 const ShaderModule &module,
+                 Reduction reduction = Reduction::AVERAGE);
+  MipDownsampler(const MipDownsampler &other) = delete;
+  ~MipDownsampler();
+  ///\brief Records the generation of levels [1, mipLevels()) of the image
+  /// from its first level.
+  ///\param cb **[in]**
+  ///\param image **[in]**
+  ///\param format **[in | optional = VK_FORMAT_UNDEFINED]** format in which
+  /// texels are interpreted (ex: the sRGB version of the image format).
+  /// Undefined means the image format.
+  ///\param final_usage **[in | optional = SAMPLED_FRAGMENT]** usage of all
+  /// levels after the generation
+  ///\return bool true if success
+  bool record(CommandBuffer &cb, const Image &image,
+              VkFormat format = VK_FORMAT_UNDEFINED,
+              ImageUsage final_usage = ImageUsage::SAMPLED_FRAGMENT);
+  ///\brief Records the generation of a depth pyramid: the first level of
+  /// the pyramid reduces 2x2 texels of the depth image, and so on. Odd sizes
+  /// repeat the last row/column, pyramids of power of two sizes keep the
+  /// reduction conservative.
+  ///\param cb **[in]**
+  ///\param depth **[in]** depth image (sampled in its depth aspect)
+  ///\param pyramid **[in]** R32_SFLOAT image of half the depth size
+  ///\param final_usage **[in | optional = SAMPLED_COMPUTE]** usage of all
+  /// pyramid levels after the generation
+  ///\return bool true if success
+  bool recordPyramid(CommandBuffer &cb, const Image &depth,
+                     const Image &pyramid,
+                     ImageUsage final_usage = ImageUsage::SAMPLED_COMPUTE);
+  ///\brief Destroys the views and descriptors created for the image. Must
+  /// be called before the image is destroyed, once the GPU is done with
+  /// previous recordings.
+  ///\param image **[in]**
+  void release(const Image &image);
+  ///\brief Releases all images and returns descriptor sets to the pool
+  void reset();
+  ///\return uint32_t dispatches recorded so far
+  [[nodiscard]] uint32_t dispatchCount() const;
+  ///\brief Checks if the device can write the format (or its storage format)
+  /// from compute shaders
+  ///\param physical_device **[in]**
+  ///\param format **[in]**
+  ///\return bool
+  static bool isSupported(const PhysicalDevice &physical_device,
+                          VkFormat format);
+  ///\param format **[in]**
+  ///\return VkFormat format of the storage views (sRGB formats can't be
+  /// written by shaders, their UNORM version is used instead)
+  static VkFormat storageFormat(VkFormat format);
+  ///\return VkImageUsageFlags usage required by the images
+  static VkImageUsageFlags imageUsage();
+  ///\param format **[in]**
+  ///\return VkImageCreateFlags flags required by images of the format
+  static VkImageCreateFlags imageCreateFlags(VkFormat format);
+
+private:
+  /// views and descriptor sets of a source/destination pair, reused by
+  /// every recording of the pair (ex: a depth pyramid built each frame)
+  struct Target {
+    std::vector<std::unique_ptr<Image::View>> views;
+    std::vector<VkDescriptorSet> descriptor_sets;
+  };
+  using TargetKey = std::tuple<VkImage, VkImage, VkFormat>;
+  ///\brief Records dispatches writing destination levels [first_level,
+  /// mipLevels()) from the source level
+  bool recordPasses(CommandBuffer &cb, const Image &source,
+                    VkFormat source_format, VkImageAspectFlags source_aspect,
+                    const Image &destination, uint32_t first_level,
+                    bool srgb);
+  ///\brief Creates the views and descriptor sets of the passes
+  Target *target(const Image &source, VkFormat source_format,
+                 VkImageAspectFlags source_aspect, const Image &destination,
+                 uint32_t first_level);
+
+  const LogicalDevice *logical_device_ = nullptr;
+  uint32_t reduction_{0};
+  PipelineShaderStage stage_;
+  PipelineLayout pipeline_layout_;
+  std::unique_ptr<ComputePipeline> pipeline_;
+  std::unique_ptr<Sampler> sampler_;
+  DescriptorAllocator descriptor_allocator_;
+  std::map<TargetKey, Target> targets_;
+  uint32_t dispatch_count_{0};
+};
+
+} // namespace circe::vk
+
+#endif
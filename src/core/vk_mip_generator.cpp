@@ -0,0 +1,369 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_mip_generator.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_mip_generator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CIRCE_VK_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace circe::vk {
+
+namespace {
+
+// sRGB transfer function lookup tables
+struct SRGBTables {
+  SRGBTables() {
+    for (int i = 0; i < 256; ++i) {
+      float c = i / 255.f;
+      to_linear[i] = c <= 0.04045f ? c / 12.92f
+                                   : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    for (int i = 0; i < 4096; ++i) {
+      float c = i / 4095.f;
+      float s = c <= 0.0031308f ? c * 12.92f
+                                : 1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+      to_srgb[i] = static_cast<uint8_t>(std::lround(s * 255.f));
+    }
+  }
+  float to_linear[256];
+  uint8_t to_srgb[4096];
+};
+
+const SRGBTables &srgbTables() {
+  static SRGBTables tables;
+  return tables;
+}
+
+// Kaiser windowed sinc (width 3, alpha 4) for a 2:1 reduction. Output texel
+// x is centered between source texels 2x and 2x + 1, so all output texels
+// share the same weights over source texels [2x - 5, 2x + 6].
+constexpr int kKaiserTaps = 12;
+constexpr int kKaiserFirstTap = -5;
+
+struct KaiserKernel {
+  KaiserKernel() {
+    // M_PI is not standard (MSVC hides it behind _USE_MATH_DEFINES)
+    constexpr double pi = 3.14159265358979323846;
+    const double width = 3.0;
+    const double alpha = 4.0;
+    auto bessel0 = [](double x) {
+      double sum = 1, term = 1;
+      for (int k = 1; k < 32; ++k) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+      }
+      return sum;
+    };
+    double total = 0;
+    double w[kKaiserTaps];
+    for (int k = 0; k < kKaiserTaps; ++k) {
+      // distance from the output texel center, in output texels
+      double d = (k + kKaiserFirstTap + 0.5 - 1.0) / 2.0;
+      double sinc = d == 0 ? 1 : std::sin(pi * d) / (pi * d);
+      double x = d / width;
+      double window =
+          std::abs(x) >= 1 ? 0 : bessel0(alpha * std::sqrt(1 - x * x)) /
+                                     bessel0(alpha);
+      w[k] = sinc * window;
+      total += w[k];
+    }
+    for (int k = 0; k < kKaiserTaps; ++k)
+      weights[k] = static_cast<float>(w[k] / total);
+  }
+  float weights[kKaiserTaps];
+};
+
+const KaiserKernel &kaiserKernel() {
+  static KaiserKernel kernel;
+  return kernel;
+}
+
+// A linear RGBA texel, color premultiplied by alpha if requested
+#ifdef CIRCE_VK_SSE2
+struct Texel {
+  __m128 v;
+};
+
+inline Texel texelZero() { return {_mm_setzero_ps()}; }
+
+inline Texel texelMadd(Texel sum, Texel t, float w) {
+  return {_mm_add_ps(sum.v, _mm_mul_ps(t.v, _mm_set1_ps(w)))};
+}
+#else
+struct Texel {
+  float c[4];
+};
+
+inline Texel texelZero() { return {{0, 0, 0, 0}}; }
+
+inline Texel texelMadd(Texel sum, Texel t, float w) {
+  for (int i = 0; i < 4; ++i)
+    sum.c[i] += t.c[i] * w;
+  return sum;
+}
+#endif
+
+inline Texel loadTexel(const uint8_t *p, const MipGenerator::Options &options,
+                       const float *to_linear) {
+  float a = p[3] / 255.f;
+  float m = options.premultiplied_alpha ? a : 1.f;
+#ifdef CIRCE_VK_SSE2
+  __m128 t = _mm_setr_ps(to_linear[p[0]], to_linear[p[1]], to_linear[p[2]],
+                         1.f);
+  return {_mm_mul_ps(t, _mm_setr_ps(m, m, m, a))};
+#else
+  return {{to_linear[p[0]] * m, to_linear[p[1]] * m, to_linear[p[2]] * m, a}};
+#endif
+}
+
+inline void storeTexel(Texel t, uint8_t *p,
+                       const MipGenerator::Options &options,
+                       const uint8_t *to_srgb) {
+  // color is quantized to 4096 steps before the transfer function
+  const float color_scale = options.srgb ? 4095.f : 255.f;
+  int32_t q[4];
+#ifdef CIRCE_VK_SSE2
+  __m128 c = t.v;
+  float a = _mm_cvtss_f32(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3)));
+  if (options.premultiplied_alpha && a > 1.f / 512.f) {
+    float inv = 1.f / a;
+    c = _mm_mul_ps(c, _mm_setr_ps(inv, inv, inv, 1.f));
+  }
+  c = _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()), _mm_set1_ps(1.f));
+  __m128i v = _mm_cvtps_epi32(_mm_mul_ps(
+      c, _mm_setr_ps(color_scale, color_scale, color_scale, 255.f)));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(q), v);
+#else
+  float a = t.c[3];
+  float inv = options.premultiplied_alpha && a > 1.f / 512.f ? 1.f / a : 1.f;
+  for (int i = 0; i < 4; ++i) {
+    float c = std::min(std::max(t.c[i] * (i < 3 ? inv : 1.f), 0.f), 1.f);
+    q[i] = static_cast<int32_t>(
+        std::lrint(c * (i < 3 ? color_scale : 255.f)));
+  }
+#endif
+  for (int i = 0; i < 3; ++i)
+    p[i] = options.srgb ? to_srgb[q[i]] : static_cast<uint8_t>(q[i]);
+  p[3] = static_cast<uint8_t>(q[3]);
+}
+
+// filters output row y of a level
+void boxRow(const uint8_t *src, uint32_t width, uint32_t height, uint8_t *dst,
+            uint32_t dst_width, uint32_t y,
+            const MipGenerator::Options &options, const float *to_linear,
+            const uint8_t *to_srgb) {
+  const uint8_t *row0 = src + static_cast<size_t>(std::min(2 * y, height - 1)) *
+                                  width * 4;
+  const uint8_t *row1 =
+      src + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * width * 4;
+  for (uint32_t x = 0; x < dst_width; ++x) {
+    uint32_t x0 = std::min(2 * x, width - 1) * 4;
+    uint32_t x1 = std::min(2 * x + 1, width - 1) * 4;
+    Texel sum = texelZero();
+    sum = texelMadd(sum, loadTexel(row0 + x0, options, to_linear), 0.25f);
+    sum = texelMadd(sum, loadTexel(row0 + x1, options, to_linear), 0.25f);
+    sum = texelMadd(sum, loadTexel(row1 + x0, options, to_linear), 0.25f);
+    sum = texelMadd(sum, loadTexel(row1 + x1, options, to_linear), 0.25f);
+    storeTexel(sum, dst + (static_cast<size_t>(y) * dst_width + x) * 4,
+               options, to_srgb);
+  }
+}
+
+// separable filter: the vertical pass of the source columns goes into row,
+// then the horizontal pass produces the output row
+void kaiserRow(const uint8_t *src, uint32_t width, uint32_t height,
+               uint8_t *dst, uint32_t dst_width, uint32_t y,
+               std::vector<Texel> &row, const MipGenerator::Options &options,
+               const float *to_linear, const uint8_t *to_srgb) {
+  const float *weights = kaiserKernel().weights;
+  const uint8_t *rows[kKaiserTaps];
+  for (int k = 0; k < kKaiserTaps; ++k) {
+    int sy = std::clamp(static_cast<int>(2 * y) + kKaiserFirstTap + k, 0,
+                        static_cast<int>(height) - 1);
+    rows[k] = src + static_cast<size_t>(sy) * width * 4;
+  }
+  for (uint32_t x = 0; x < width; ++x) {
+    Texel sum = texelZero();
+    for (int k = 0; k < kKaiserTaps; ++k)
+      sum = texelMadd(sum, loadTexel(rows[k] + x * 4, options, to_linear),
+                      weights[k]);
+    row[x] = sum;
+  }
+  for (uint32_t x = 0; x < dst_width; ++x) {
+    Texel sum = texelZero();
+    for (int k = 0; k < kKaiserTaps; ++k) {
+      int sx = std::clamp(static_cast<int>(2 * x) + kKaiserFirstTap + k, 0,
+                          static_cast<int>(width) - 1);
+      sum = texelMadd(sum, row[sx], weights[k]);
+    }
+    storeTexel(sum, dst + (static_cast<size_t>(y) * dst_width + x) * 4,
+               options, to_srgb);
+  }
+}
+
+} // namespace
+
+double MipGenerator::Statistics::megapixelsPerSecond() const {
+  if (time <= 0)
+    return 0;
+  return pixels / 1e6 / (time / 1000.0);
+}
+
+MipGenerator::MipGenerator(uint32_t thread_count)
+    : thread_count_(thread_count) {
+  if (!thread_count_)
+    thread_count_ = std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool MipGenerator::generate(const uint8_t *rgba, uint32_t width,
+                            uint32_t height,
+                            const std::vector<uint8_t *> &levels,
+                            const Options &options) {
+  const uint32_t level_count = levelCount(width, height);
+  if (!rgba || !width || !height || levels.size() + 1 < level_count)
+    return false;
+  auto start = std::chrono::steady_clock::now();
+  // identity tables when the data is not sRGB encoded
+  static const SRGBTables &srgb = srgbTables();
+  static const auto linear = [] {
+    SRGBTables tables;
+    for (int i = 0; i < 256; ++i)
+      tables.to_linear[i] = i / 255.f;
+    return tables;
+  }();
+  const float *to_linear = options.srgb ? srgb.to_linear : linear.to_linear;
+  const uint8_t *to_srgb = srgb.to_srgb;
+  uint64_t pixels = 0;
+  const uint8_t *src = rgba;
+  for (uint32_t level = 1; level < level_count; ++level) {
+    VkExtent2D src_size = levelSize(width, height, level - 1);
+    VkExtent2D dst_size = levelSize(width, height, level);
+    uint8_t *dst = levels[level - 1];
+    // each level depends on the whole previous level, rows of a level are
+    // independent
+    std::atomic<uint32_t> next{0};
+    auto worker = [&]() {
+      std::vector<Texel> row(
+          options.filter == Filter::KAISER ? src_size.width : 0);
+      for (uint32_t y = next++; y < dst_size.height; y = next++)
+        if (options.filter == Filter::KAISER)
+          kaiserRow(src, src_size.width, src_size.height, dst, dst_size.width,
+                    y, row, options, to_linear, to_srgb);
+        else
+          boxRow(src, src_size.width, src_size.height, dst, dst_size.width, y,
+                 options, to_linear, to_srgb);
+    };
+    // small levels are not worth a thread
+    uint32_t thread_count =
+        std::min(thread_count_, std::max(1u, dst_size.height / 16));
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < thread_count; ++i)
+      threads.emplace_back(worker);
+    worker();
+    for (auto &thread : threads)
+      thread.join();
+    pixels += static_cast<uint64_t>(dst_size.width) * dst_size.height;
+    src = dst;
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::lock_guard<std::mutex> guard(mutex_);
+  statistics_.pixels += pixels;
+  statistics_.time += elapsed.count();
+  return true;
+}
+
+bool MipGenerator::generate(const uint8_t *rgba, uint32_t width,
+                            uint32_t height,
+                            std::vector<std::vector<uint8_t>> &levels,
+                            const Options &options) {
+  const uint32_t level_count = levelCount(width, height);
+  levels.resize(level_count - 1);
+  std::vector<uint8_t *> destinations;
+  for (uint32_t level = 1; level < level_count; ++level) {
+    VkExtent2D size = levelSize(width, height, level);
+    levels[level - 1].resize(static_cast<size_t>(size.width) * size.height *
+                             4);
+    destinations.emplace_back(levels[level - 1].data());
+  }
+  return generate(rgba, width, height, destinations, options);
+}
+
+MipGenerator::Statistics MipGenerator::statistics() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return statistics_;
+}
+
+uint32_t MipGenerator::levelCount(uint32_t width, uint32_t height) {
+  uint32_t count = 1;
+  while ((width | height) >> count)
+    count++;
+  return count;
+}
+
+VkExtent2D MipGenerator::levelSize(uint32_t width, uint32_t height,
+                                   uint32_t level) {
+  return {std::max(width >> level, 1u), std::max(height >> level, 1u)};
+}
+
+VkDeviceSize MipGenerator::chainSize(uint32_t width, uint32_t height) {
+  VkDeviceSize size = 0;
+  for (uint32_t level = 0; level < levelCount(width, height); ++level) {
+    VkExtent2D extent = levelSize(width, height, level);
+    size += static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+  }
+  return size;
+}
+
+std::vector<VkBufferImageCopy>
+MipGenerator::copyRegions(uint32_t width, uint32_t height,
+                          VkDeviceSize offset) {
+  std::vector<VkBufferImageCopy> regions;
+  for (uint32_t level = 0; level < levelCount(width, height); ++level) {
+    VkExtent2D extent = levelSize(width, height, level);
+    VkBufferImageCopy region = {};
+    region.bufferOffset = offset;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = level;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {extent.width, extent.height, 1};
+    regions.emplace_back(region);
+    // RGBA8 levels keep offsets multiple of the texel size
+    offset += static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+  }
+  return regions;
+}
+
+} // namespace circe::vk
@@ -0,0 +1,128 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_mip_generator.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_MIP_GENERATOR_H
+#define CIRCE_VK_MIP_GENERATOR_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace circe::vk {
+
+/// \brief CPU mip chain generator for RGBA8 images.
+/// Used when the device can not blit the image format with linear filtering
+/// and for offline cooking. Texels are filtered in linear space: sRGB color
+/// channels are decoded before filtering and encoded afterwards, and color
+/// is weighted by alpha (premultiplied) so transparent texels do not bleed
+/// into opaque ones. Each level is produced from the previous one, rows of
+/// a level are distributed among threads and each RGBA texel is processed
+/// as a single SSE vector.
+/// Usage:
+///   MipGenerator generator;
+///   std::vector<std::vector<uint8_t>> mips;
+///   generator.generate(rgba, width, height, mips);
+class MipGenerator final {
+public:
+  enum class Filter {
+    BOX,   //!< 2x2 average
+    KAISER //!< Kaiser windowed sinc (sharper, 12 taps per direction)
+  };
+  struct Options {
+    // explicit constructor instead of member initializers, so Options{} can
+    // be a default argument inside MipGenerator
+    Options() : filter(Filter::BOX), srgb(true), premultiplied_alpha(true) {}
+    Filter filter;
+    bool srgb;                //!< RGB channels are sRGB encoded
+    bool premultiplied_alpha; //!< weight color by alpha
+  };
+  struct Statistics {
+    uint64_t pixels{0};     //!< generated texels
+    double time{0};         //!< wall time spent generating (ms)
+    ///\return double generated megapixels per second
+    [[nodiscard]] double megapixelsPerSecond() const;
+  };
+  ///\param thread_count **[in | optional = 0]** 0 means one thread per
+  /// hardware thread
+  explicit MipGenerator(uint32_t thread_count = 0);
+  ///\brief Generates levels 1 to levelCount() - 1 into caller memory
+  ///\param rgba **[in]** first level, tightly packed RGBA8
+  ///\param width **[in]**
+  ///\param height **[in]**
+  ///\param levels **[in]** destination of each level after the first, each
+  /// one with room for its tightly packed RGBA8 texels
+  ///\param options **[in | optional = {}]**
+  ///\return bool true if success
+  bool generate(const uint8_t *rgba, uint32_t width, uint32_t height,
+                const std::vector<uint8_t *> &levels,
+                const Options &options = {});
+  ///\brief Generates levels 1 to levelCount() - 1
+  ///\param rgba **[in]** first level, tightly packed RGBA8
+  ///\param width **[in]**
+  ///\param height **[in]**
+  ///\param levels **[out]** texels of each level after the first
+  ///\param options **[in | optional = {}]**
+  ///\return bool true if success
+  bool generate(const uint8_t *rgba, uint32_t width, uint32_t height,
+                std::vector<std::vector<uint8_t>> &levels,
+                const Options &options = {});
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+  ///\param width **[in]**
+  ///\param height **[in]**
+  ///\return uint32_t number of levels of the full chain (including the first)
+  static uint32_t levelCount(uint32_t width, uint32_t height);
+  ///\param width **[in]** first level width
+  ///\param height **[in]** first level height
+  ///\param level **[in]**
+  ///\return VkExtent2D size of the level
+  static VkExtent2D levelSize(uint32_t width, uint32_t height,
+                              uint32_t level);
+  ///\param width **[in]** first level width
+  ///\param height **[in]** first level height
+  ///\return VkDeviceSize bytes of the full chain of tightly packed RGBA8
+  /// levels
+  static VkDeviceSize chainSize(uint32_t width, uint32_t height);
+  ///\brief Computes the copies of the full chain stored level after level in
+  /// a buffer, so all levels can be uploaded with a single copy command
+  ///\param width **[in]** first level width
+  ///\param height **[in]** first level height
+  ///\param offset **[in]** buffer offset of the first level
+  ///\return std::vector<VkBufferImageCopy> one region per level
+  static std::vector<VkBufferImageCopy>
+  copyRegions(uint32_t width, uint32_t height, VkDeviceSize offset);
+
+private:
+  uint32_t thread_count_{1};
+  mutable std::mutex mutex_;
+  Statistics statistics_;
+};
+
+} // namespace circe::vk
+
+#endif
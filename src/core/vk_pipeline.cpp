@@ -28,6 +28,7 @@
 #include "vk_pipeline.h"
 #include "logging.h"
 #include "vulkan_debug.h"
+#include <algorithm>
 #include <fstream>
 #include <utility>
 
@@ -39,18 +40,24 @@ DescriptorSetLayout::DescriptorSetLayout(const LogicalDevice *logical_device)
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) noexcept
     : logical_device_(other.logical_device_),
       vk_descriptor_set_layout_(other.vk_descriptor_set_layout_),
-      bindings_(other.bindings_) {
+      bindings_(other.bindings_), binding_flags_(other.binding_flags_),
+      create_flags_(other.create_flags_),
+      update_template_(std::move(other.update_template_)) {
   other.vk_descriptor_set_layout_ = VK_NULL_HANDLE;
 }
 
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &other) noexcept
     : logical_device_(other.logical_device_),
       vk_descriptor_set_layout_(other.vk_descriptor_set_layout_),
-      bindings_(other.bindings_) {
+      bindings_(other.bindings_), binding_flags_(other.binding_flags_),
+      create_flags_(other.create_flags_),
+      update_template_(std::move(other.update_template_)) {
   other.vk_descriptor_set_layout_ = VK_NULL_HANDLE;
 }
 
 DescriptorSetLayout::~DescriptorSetLayout() {
+  // the template must go before the layout
+  update_template_.reset();
   if (vk_descriptor_set_layout_ != VK_NULL_HANDLE)
     vkDestroyDescriptorSetLayout(logical_device_->handle(),
                                  vk_descriptor_set_layout_, nullptr);
@@ -58,8 +65,19 @@ DescriptorSetLayout::~DescriptorSetLayout() {
 
 VkDescriptorSetLayout DescriptorSetLayout::handle() {
   if (vk_descriptor_set_layout_ == VK_NULL_HANDLE) {
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT flags_info = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT,
+        nullptr, static_cast<uint32_t>(binding_flags_.size()),
+        binding_flags_.data()};
+    bool has_binding_flags = false;
+    for (auto flags : binding_flags_)
+      has_binding_flags |= flags != 0;
+    auto create_flags = create_flags_;
+    if (!isPushDescriptor())
+      create_flags &= ~VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
     VkDescriptorSetLayoutCreateInfo info = {
-        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, nullptr, 0,
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        has_binding_flags ? &flags_info : nullptr, create_flags,
         static_cast<uint32_t>(bindings_.size()),
         (bindings_.size()) ? bindings_.data() : nullptr};
     VkResult result = vkCreateDescriptorSetLayout(
@@ -78,9 +96,198 @@ void DescriptorSetLayout::addLayoutBinding(uint32_t binding,
   VkDescriptorSetLayoutBinding layout_binding = {
       binding, descriptor_type, descriptor_count, stage_flags, nullptr};
   bindings_.emplace_back(layout_binding);
+  binding_flags_.emplace_back(0);
+}
+
+void DescriptorSetLayout::setBindingFlags(uint32_t binding,
+                                          VkDescriptorBindingFlagsEXT flags) {
+  for (size_t i = 0; i < bindings_.size(); ++i)
+    if (bindings_[i].binding == binding)
+      binding_flags_[i] = flags;
+}
+
+void DescriptorSetLayout::setCreateFlags(
+    VkDescriptorSetLayoutCreateFlags flags) {
+  create_flags_ = flags;
+}
+
+bool DescriptorSetLayout::isPushDescriptor() const {
+  return (create_flags_ &
+          VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR) &&
+         logical_device_->extensionFunctions().vkCmdPushDescriptorSetKHR;
+}
+
+const std::vector<VkDescriptorSetLayoutBinding> &
+DescriptorSetLayout::bindings() const {
+  return bindings_;
+}
+
+DescriptorUpdateTemplate *DescriptorSetLayout::updateTemplate() {
+  if (!update_template_ &&
+      DescriptorUpdateTemplate::isSupported(logical_device_))
+    update_template_ =
+        std::make_unique<DescriptorUpdateTemplate>(logical_device_, *this);
+  return update_template_.get();
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(
+    const LogicalDevice *logical_device, DescriptorSetLayout &layout)
+    : logical_device_(logical_device),
+      vk_descriptor_set_layout_(layout.handle()) {
+  vkCreateDescriptorUpdateTemplate_ =
+      reinterpret_cast<PFN_vkCreateDescriptorUpdateTemplate>(
+          logical_device->procAddress(
+              "vkCreateDescriptorUpdateTemplate",
+              "vkCreateDescriptorUpdateTemplateKHR"));
+  vkDestroyDescriptorUpdateTemplate_ =
+      reinterpret_cast<PFN_vkDestroyDescriptorUpdateTemplate>(
+          logical_device->procAddress(
+              "vkDestroyDescriptorUpdateTemplate",
+              "vkDestroyDescriptorUpdateTemplateKHR"));
+  vkUpdateDescriptorSetWithTemplate_ =
+      reinterpret_cast<PFN_vkUpdateDescriptorSetWithTemplate>(
+          logical_device->procAddress(
+              "vkUpdateDescriptorSetWithTemplate",
+              "vkUpdateDescriptorSetWithTemplateKHR"));
+  // default entries: descriptor infos packed in binding order
+  auto bindings = layout.bindings();
+  std::sort(bindings.begin(), bindings.end(),
+            [](const VkDescriptorSetLayoutBinding &a,
+               const VkDescriptorSetLayoutBinding &b) {
+              return a.binding < b.binding;
+            });
+  size_t offset = 0;
+  for (auto &binding : bindings) {
+    addEntry(binding.binding, binding.descriptorType, offset,
+             binding.descriptorCount);
+    offset += descriptorInfoSize(binding.descriptorType) *
+              binding.descriptorCount;
+  }
+  entries_from_layout_ = true;
+}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate() {
+  if (vk_update_template_ != VK_NULL_HANDLE &&
+      vkDestroyDescriptorUpdateTemplate_)
+    vkDestroyDescriptorUpdateTemplate_(logical_device_->handle(),
+                                       vk_update_template_, nullptr);
+}
+
+bool DescriptorUpdateTemplate::isSupported(
+    const LogicalDevice *logical_device) {
+  return logical_device &&
+         (logical_device->isExtensionEnabled(
+              VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME) ||
+          logical_device->procAddress("vkUpdateDescriptorSetWithTemplate"));
+}
+
+bool DescriptorUpdateTemplate::addEntry(uint32_t binding,
+                                        VkDescriptorType type, size_t offset,
+                                        uint32_t count, uint32_t array_element,
+                                        size_t stride) {
+  // empty entries are invalid and would wrap the data size below
+  if (!count)
+    return false;
+  if (entries_from_layout_) {
+    entries_.clear();
+    data_size_ = 0;
+    entries_from_layout_ = false;
+  }
+  if (!stride)
+    stride = descriptorInfoSize(type);
+  VkDescriptorUpdateTemplateEntry entry = {
+      binding,       // uint32_t         dstBinding
+      array_element, // uint32_t         dstArrayElement
+      count,         // uint32_t         descriptorCount
+      type,          // VkDescriptorType descriptorType
+      offset,        // size_t           offset
+      stride         // size_t           stride
+  };
+  entries_.emplace_back(entry);
+  data_size_ = std::max(data_size_, offset + stride * (count - 1) +
+                                        descriptorInfoSize(type));
+  return true;
+}
+
+bool DescriptorUpdateTemplate::setPushDescriptorTarget(
+    VkPipelineBindPoint bind_point, PipelineLayout &pipeline_layout,
+    uint32_t set) {
+  D_RETURN_FALSE_IF_NOT(vk_update_template_ == VK_NULL_HANDLE,
+                        "update template already created.");
+  if (!pipeline_layout.descriptorSetLayout(set).isPushDescriptor() ||
+      !logical_device_->extensionFunctions()
+           .vkCmdPushDescriptorSetWithTemplateKHR)
+    return false;
+  template_type_ = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR;
+  bind_point_ = bind_point;
+  vk_pipeline_layout_ = pipeline_layout.handle();
+  set_ = set;
+  return true;
+}
+
+bool DescriptorUpdateTemplate::isPushTemplate() const {
+  return template_type_ ==
+         VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR;
+}
+
+VkDescriptorUpdateTemplate DescriptorUpdateTemplate::handle() {
+  if (vk_update_template_ == VK_NULL_HANDLE &&
+      vkCreateDescriptorUpdateTemplate_) {
+    VkDescriptorUpdateTemplateCreateInfo info = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO, // sType
+        nullptr, // const void *                            pNext
+        0,       // VkDescriptorUpdateTemplateCreateFlags   flags
+        static_cast<uint32_t>(
+            entries_.size()), // uint32_t descriptorUpdateEntryCount
+        entries_.data(), // const VkDescriptorUpdateTemplateEntry *pEntries
+        template_type_, // VkDescriptorUpdateTemplateType templateType
+        vk_descriptor_set_layout_, // VkDescriptorSetLayout descriptorSetLayout
+        bind_point_,         // VkPipelineBindPoint (push descriptors only)
+        vk_pipeline_layout_, // VkPipelineLayout    (push descriptors only)
+        set_                 // uint32_t set        (push descriptors only)
+    };
+    VkResult result = vkCreateDescriptorUpdateTemplate_(
+        logical_device_->handle(), &info, nullptr, &vk_update_template_);
+    CHECK_VULKAN(result);
+    if (result != VK_SUCCESS)
+      vk_update_template_ = VK_NULL_HANDLE;
+  }
+  return vk_update_template_;
+}
+
+size_t DescriptorUpdateTemplate::dataSize() const { return data_size_; }
+
+bool DescriptorUpdateTemplate::update(VkDescriptorSet descriptor_set,
+                                      const void *data, size_t data_size) {
+  D_RETURN_FALSE_IF_NOT(!isPushTemplate(),
+                        "push templates are used by command buffers.");
+  D_RETURN_FALSE_IF_NOT(data_size >= data_size_,
+                        "descriptor data smaller than the update template.");
+  RETURN_FALSE_IF_NOT(handle() != VK_NULL_HANDLE);
+  vkUpdateDescriptorSetWithTemplate_(logical_device_->handle(), descriptor_set,
+                                     vk_update_template_, data);
+  return true;
+}
+
+size_t DescriptorUpdateTemplate::descriptorInfoSize(VkDescriptorType type) {
+  switch (type) {
+  case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+  case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+    return sizeof(VkBufferView);
+  case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+  case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+  case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+  case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+    return sizeof(VkDescriptorBufferInfo);
+  default:
+    break;
+  }
+  return sizeof(VkDescriptorImageInfo);
 }
 
 DescriptorSetLayout &PipelineLayout::descriptorSetLayout(uint32_t id) {
+  if (!shared_descriptor_sets_.empty())
+    return *shared_descriptor_sets_[id];
   return descriptor_sets_[id];
 }
 
@@ -97,11 +304,15 @@ void PipelineLayout::destroy() {
   }
 }
 
+const LogicalDevice *PipelineLayout::device() const { return logical_device_; }
+
 VkPipelineLayout PipelineLayout::handle() {
   if (vk_pipeline_layout_ == VK_NULL_HANDLE) {
     std::vector<VkDescriptorSetLayout> layout_handles;
     for (auto &ds : descriptor_sets_)
       layout_handles.emplace_back(ds.handle());
+    for (auto *ds : shared_descriptor_sets_)
+      layout_handles.emplace_back(ds->handle());
     VkPipelineLayoutCreateInfo info = {
         VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         nullptr,
@@ -124,6 +335,12 @@ uint32_t PipelineLayout::createLayoutSet(uint32_t id) {
   return descriptor_sets_.size() - 1;
 }
 
+uint32_t PipelineLayout::addDescriptorSetLayout(DescriptorSetLayout *layout) {
+  ASSERT(descriptor_sets_.empty());
+  shared_descriptor_sets_.emplace_back(layout);
+  return shared_descriptor_sets_.size() - 1;
+}
+
 void PipelineLayout::addPushConstantRange(VkShaderStageFlags stage_flags,
                                           uint32_t offset, uint32_t size) {
   VkPushConstantRange pc = {stage_flags, offset, size};
@@ -246,6 +463,58 @@ const VkSpecializationInfo *PipelineShaderStage::specializationInfo() const {
   return &specialization_info_;
 }
 
+PipelineCache::PipelineCache(const LogicalDevice *logical_device,
+                             const std::string &path)
+    : logical_device_(logical_device) {
+  std::vector<char> data;
+  if (!path.empty()) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (file.good()) {
+      data.resize(static_cast<size_t>(file.tellg()));
+      file.seekg(0);
+      file.read(data.data(), data.size());
+    }
+  }
+  VkPipelineCacheCreateInfo info = {
+      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO, // VkStructureType sType
+      nullptr,     // const void *                 pNext
+      0,           // VkPipelineCacheCreateFlags   flags
+      data.size(), // size_t                       initialDataSize
+      data.empty() ? nullptr : data.data() // const void * pInitialData
+  };
+  VkResult result = vkCreatePipelineCache(logical_device->handle(), &info,
+                                          nullptr, &vk_pipeline_cache_);
+  if (result != VK_SUCCESS && !data.empty()) {
+    // stale data (ex: driver update), start from an empty cache
+    info.initialDataSize = 0;
+    info.pInitialData = nullptr;
+    result = vkCreatePipelineCache(logical_device->handle(), &info, nullptr,
+                                   &vk_pipeline_cache_);
+  }
+  CHECK_VULKAN(result);
+}
+
+PipelineCache::~PipelineCache() {
+  if (vk_pipeline_cache_ != VK_NULL_HANDLE)
+    vkDestroyPipelineCache(logical_device_->handle(), vk_pipeline_cache_,
+                           nullptr);
+}
+
+VkPipelineCache PipelineCache::handle() const { return vk_pipeline_cache_; }
+
+bool PipelineCache::save(const std::string &path) const {
+  size_t size = 0;
+  R_CHECK_VULKAN(vkGetPipelineCacheData(logical_device_->handle(),
+                                        vk_pipeline_cache_, &size, nullptr));
+  std::vector<char> data(size);
+  R_CHECK_VULKAN(vkGetPipelineCacheData(
+      logical_device_->handle(), vk_pipeline_cache_, &size, data.data()));
+  std::ofstream file(path, std::ios::binary);
+  RETURN_FALSE_IF_NOT(file.good());
+  file.write(data.data(), size);
+  return true;
+}
+
 Pipeline::Pipeline(const LogicalDevice *logical_device)
     : logical_device_(logical_device) {}
 
@@ -261,22 +530,21 @@ void Pipeline::destroy() {
 bool Pipeline::saveCache(const std::string &path) {
   size_t cache_data_size;
   // Determine the size of the cache data
-  R_CHECK_VULKAN(vkGetPipelineCacheData(logical_device_->handle(),
-                                        vk_pipeline_cache_, &cache_data_size,
-                                        nullptr));
+  R_CHECK_VULKAN(vkGetPipelineCacheData(logical_device_->handle(), cache(),
+                                        &cache_data_size, nullptr));
   VkResult result = VK_ERROR_OUT_OF_HOST_MEMORY;
   if (cache_data_size != 0) {
     void *data = new char[cache_data_size];
     if (data) {
       // Retrieve the actual data from the cache
       result =
-          vkGetPipelineCacheData(logical_device_->handle(), vk_pipeline_cache_,
+          vkGetPipelineCacheData(logical_device_->handle(), cache(),
                                  &cache_data_size, data);
       CHECK_VULKAN(result);
       if (result == VK_SUCCESS) {
         std::ofstream ofile(path, std::ios::binary);
         if (ofile.good()) {
-          ofile.write((char *) &data, cache_data_size);
+          ofile.write((char *) data, cache_data_size);
           ofile.close();
         }
       }
@@ -286,7 +554,16 @@ bool Pipeline::saveCache(const std::string &path) {
   return result == VK_SUCCESS;
 }
 
-VkPipelineCache Pipeline::cache() const { return vk_pipeline_cache_; }
+void Pipeline::setSpecializationInfo(const VkSpecializationInfo *info) {
+  for (auto &stage : shader_stage_infos_)
+    stage.pSpecializationInfo = info;
+}
+
+void Pipeline::setCache(PipelineCache *cache) { cache_ = cache; }
+
+VkPipelineCache Pipeline::cache() const {
+  return cache_ ? cache_->handle() : vk_pipeline_cache_;
+}
 
 VkPipeline Pipeline::handle() const { return vk_pipeline_; }
 
@@ -307,18 +584,32 @@ ComputePipeline::ComputePipeline(const LogicalDevice *logical_device,
                                  PipelineLayout &layout, Pipeline *cache,
                                  ComputePipeline *base_pipeline,
                                  uint32_t base_pipeline_index)
-    : Pipeline(logical_device) {
-  VkComputePipelineCreateInfo info = {
-      VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
-      nullptr,
-      0,
-      this->shader_stage_infos_[0],
-      layout.handle(),
-      (base_pipeline ? base_pipeline->handle() : VK_NULL_HANDLE),
-      static_cast<int32_t>(base_pipeline_index)};
-  vkCreateComputePipelines(this->logical_device_->handle(),
-                           (cache ? cache->cache() : VK_NULL_HANDLE), 1, &info,
-                           nullptr, &this->vk_pipeline_);
+    : Pipeline(logical_device), layout_(&layout), cache_pipeline_(cache),
+      base_pipeline_(base_pipeline) {
+  addShaderStage(stage);
+  info_.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  info_.basePipelineIndex = static_cast<int32_t>(base_pipeline_index);
+}
+
+VkPipeline ComputePipeline::handle() {
+  if (vk_pipeline_ == VK_NULL_HANDLE) {
+    VkPipelineCache vk_cache = cache();
+    if (vk_cache == VK_NULL_HANDLE && cache_pipeline_)
+      vk_cache = cache_pipeline_->cache();
+    VkResult result =
+        vkCreateComputePipelines(logical_device_->handle(), vk_cache, 1,
+                                 createInfo(), nullptr, &vk_pipeline_);
+    CHECK_VULKAN(result);
+  }
+  return vk_pipeline_;
+}
+
+const VkComputePipelineCreateInfo *ComputePipeline::createInfo() {
+  info_.stage = shader_stage_infos_[0];
+  info_.layout = layout_->handle();
+  info_.basePipelineHandle =
+      base_pipeline_ ? base_pipeline_->handle() : VK_NULL_HANDLE;
+  return &info_;
 }
 
 GraphicsPipeline::VertexInputState::VertexInputState() {
@@ -347,6 +638,18 @@ void GraphicsPipeline::VertexInputState::addAttributeDescription(
   info_.pVertexAttributeDescriptions = attribute_descriptions_.data();
 }
 
+uint32_t GraphicsPipeline::VertexInputState::addReflectedInputs(
+    const ShaderReflection &reflection, uint32_t binding,
+    VkVertexInputRate input_rate) {
+  uint32_t offset = 0;
+  for (const auto &input : reflection.vertexInputs()) {
+    addAttributeDescription(input.location, binding, input.format, offset);
+    offset += input.size;
+  }
+  addBindingDescription(binding, offset, input_rate);
+  return offset;
+}
+
 const VkPipelineVertexInputStateCreateInfo *
 GraphicsPipeline::VertexInputState::info() const {
   return &info_;
@@ -448,6 +751,8 @@ GraphicsPipeline::GraphicsPipeline(const LogicalDevice *logical_device,
   info_.basePipelineHandle =
       base_pipeline ? base_pipeline->handle() : VK_NULL_HANDLE;
   info_.basePipelineIndex = base_pipeline_index;
+  addDynamicState(VK_DYNAMIC_STATE_VIEWPORT);
+  addDynamicState(VK_DYNAMIC_STATE_SCISSOR);
 }
 
 void GraphicsPipeline::setLayout(PipelineLayout *layout) { layout_ = layout; }
@@ -458,33 +763,36 @@ void GraphicsPipeline::setRendePass(RenderPass *renderpass) {
 
 VkPipeline GraphicsPipeline::handle() {
   if (this->vk_pipeline_ == VK_NULL_HANDLE) {
-    info_.layout = layout_->handle();
-    info_.renderPass = renderpass_->handle();
-    info_.stageCount = this->shader_stage_infos_.size();
-    info_.pStages = this->shader_stage_infos_.data();
-    info_.pVertexInputState = vertex_input_state.info();
-    info_.pInputAssemblyState = input_assembly_state_.get();
-    info_.pTessellationState = tesselation_state_.get();
-    info_.pViewportState = viewport_state.info();
-    info_.pRasterizationState = rasterization_state_.get();
-    info_.pMultisampleState = multisample_state_.get();
-    info_.pDepthStencilState = depth_stencil_state_.get();
-    info_.pColorBlendState = color_blend_state.info();
-    VkPipelineDynamicStateCreateInfo d_info = {
-        VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO, // VkStructureType
-        nullptr,                                              // pNext
-        0, // VkPipelineDynamicStateCreateFlags
-        static_cast<uint32_t>(dynamic_states_.size()), // dynamicStateCount;
-        (dynamic_states_.size()) ? dynamic_states_.data() : nullptr};
-    info_.pDynamicState = &d_info;
-
-    VkResult result = vkCreateGraphicsPipelines(this->logical_device_->handle(),
-                                                VK_NULL_HANDLE, 1, &info_,
-                                                nullptr, &this->vk_pipeline_);
+    VkResult result = vkCreateGraphicsPipelines(
+        this->logical_device_->handle(), cache(), 1, createInfo(), nullptr,
+        &this->vk_pipeline_);
     CHECK_VULKAN(result);
   }
   return this->vk_pipeline_;
-} // namespace vk
+}
+
+const VkGraphicsPipelineCreateInfo *GraphicsPipeline::createInfo() {
+  info_.layout = layout_->handle();
+  info_.renderPass = renderpass_->handle();
+  info_.stageCount = this->shader_stage_infos_.size();
+  info_.pStages = this->shader_stage_infos_.data();
+  info_.pVertexInputState = vertex_input_state.info();
+  info_.pInputAssemblyState = input_assembly_state_.get();
+  info_.pTessellationState = tesselation_state_.get();
+  // dynamic viewports and scissors still need their counts
+  viewport_info_ = *viewport_state.info();
+  if (isDynamicState(VK_DYNAMIC_STATE_VIEWPORT))
+    viewport_info_.viewportCount = std::max(viewport_info_.viewportCount, 1u);
+  if (isDynamicState(VK_DYNAMIC_STATE_SCISSOR))
+    viewport_info_.scissorCount = std::max(viewport_info_.scissorCount, 1u);
+  info_.pViewportState = &viewport_info_;
+  info_.pRasterizationState = rasterization_state_.get();
+  info_.pMultisampleState = multisample_state_.get();
+  info_.pDepthStencilState = depth_stencil_state_.get();
+  info_.pColorBlendState = color_blend_state.info();
+  info_.pDynamicState = dynamic_state_.get();
+  return &info_;
+}
 
 void GraphicsPipeline::setInputState(VkPrimitiveTopology topology,
                                      VkBool32 primitive_restart_enable) {
@@ -572,6 +880,8 @@ void GraphicsPipeline::setDepthStencilState(
 }
 
 void GraphicsPipeline::addDynamicState(VkDynamicState dynamic_state) {
+  if (isDynamicState(dynamic_state))
+    return;
   if (!dynamic_state_) {
     dynamic_state_ = std::make_unique<VkPipelineDynamicStateCreateInfo>();
     dynamic_state_->sType =
@@ -579,10 +889,61 @@ void GraphicsPipeline::addDynamicState(VkDynamicState dynamic_state) {
     dynamic_state_->pNext = nullptr;
     dynamic_state_->flags = 0;
   }
-
   dynamic_states_.emplace_back(dynamic_state);
   dynamic_state_->dynamicStateCount = dynamic_states_.size();
   dynamic_state_->pDynamicStates = dynamic_states_.data();
 }
 
+void GraphicsPipeline::removeDynamicState(VkDynamicState dynamic_state) {
+  dynamic_states_.erase(std::remove(dynamic_states_.begin(),
+                                    dynamic_states_.end(), dynamic_state),
+                        dynamic_states_.end());
+  if (dynamic_states_.empty()) {
+    dynamic_state_.reset();
+    return;
+  }
+  dynamic_state_->dynamicStateCount = dynamic_states_.size();
+  dynamic_state_->pDynamicStates = dynamic_states_.data();
+}
+
+bool GraphicsPipeline::isDynamicState(VkDynamicState dynamic_state) const {
+  return std::find(dynamic_states_.begin(), dynamic_states_.end(),
+                   dynamic_state) != dynamic_states_.end();
+}
+
+uint32_t GraphicsPipeline::useExtendedDynamicState() {
+  // entry points are only loaded when the extension and its feature are
+  // enabled on the device
+  const auto &f = logical_device_->extensionFunctions();
+  std::vector<VkDynamicState> states;
+#ifdef VK_EXT_extended_dynamic_state
+  if (f.vkCmdSetCullModeEXT)
+    states.insert(states.end(), {VK_DYNAMIC_STATE_CULL_MODE_EXT,
+                                 VK_DYNAMIC_STATE_FRONT_FACE_EXT,
+                                 VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT,
+                                 VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT,
+                                 VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT,
+                                 VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT});
+#endif
+#ifdef VK_EXT_extended_dynamic_state2
+  if (f.vkCmdSetDepthBiasEnableEXT)
+    states.insert(states.end(),
+                  {VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT,
+                   VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT,
+                   VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT});
+#endif
+#ifdef VK_EXT_extended_dynamic_state3
+  if (f.vkCmdSetPolygonModeEXT)
+    states.emplace_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+#endif
+  (void)f;
+  uint32_t count = 0;
+  for (auto state : states)
+    if (!isDynamicState(state)) {
+      addDynamicState(state);
+      count++;
+    }
+  return count;
+}
+
 } // namespace circe::vk
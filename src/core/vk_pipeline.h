@@ -30,11 +30,16 @@
 
 #include "vk_renderpass.h"
 #include "vk_shader_module.h"
+#include <memory>
+#include <type_traits>
 
 namespace circe {
 
 namespace vk {
 
+class DescriptorUpdateTemplate;
+class PipelineLayout;
+
 /// A descriptor set is a set of resources that are bound into the pipeline
 /// as a group. Multiple sets can be bound to a pipeline at a time. Each set
 /// has layout, which describes the order and types of resources in the set.
@@ -65,11 +70,135 @@ public:
   void addLayoutBinding(uint32_t binding, VkDescriptorType descriptor_type,
                         uint32_t descriptor_count,
                         VkShaderStageFlags stage_flags);
+  ///\brief Sets descriptor indexing flags of a binding
+  /// (requires VK_EXT_descriptor_indexing)
+  ///\param binding **[in]** binding number
+  ///\param flags **[in]** ex: VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT
+  void setBindingFlags(uint32_t binding, VkDescriptorBindingFlagsEXT flags);
+  ///\param flags **[in]** ex:
+  /// VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT
+  /// VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR is dropped when
+  /// VK_KHR_push_descriptor is not enabled, so the layout can still be used
+  /// with regular descriptor sets.
+  void setCreateFlags(VkDescriptorSetLayoutCreateFlags flags);
+  ///\return bool true if descriptors of this layout are pushed into command
+  /// buffers instead of allocated
+  [[nodiscard]] bool isPushDescriptor() const;
+  ///\return const std::vector<VkDescriptorSetLayoutBinding>& layout bindings
+  [[nodiscard]] const std::vector<VkDescriptorSetLayoutBinding> &
+  bindings() const;
+  ///\brief Update template following the bindings of this layout (see
+  /// DescriptorUpdateTemplate), created on first use. Push descriptor layouts
+  /// need DescriptorUpdateTemplate::setPushDescriptorTarget before the
+  /// template is used.
+  ///\return DescriptorUpdateTemplate* nullptr if templates are not supported
+  DescriptorUpdateTemplate *updateTemplate();
 
 private:
   const LogicalDevice *logical_device_ = nullptr;
   VkDescriptorSetLayout vk_descriptor_set_layout_ = VK_NULL_HANDLE;
   std::vector<VkDescriptorSetLayoutBinding> bindings_;
+  std::vector<VkDescriptorBindingFlagsEXT> binding_flags_;
+  VkDescriptorSetLayoutCreateFlags create_flags_{0};
+  std::unique_ptr<DescriptorUpdateTemplate> update_template_;
+};
+
+/// Descriptor update templates write a whole descriptor set from a block of
+/// host memory in a single call, avoiding the construction of
+/// VkWriteDescriptorSet arrays. Requires VK_KHR_descriptor_update_template
+/// (or Vulkan 1.1) to be enabled in the logical device.
+/// Without explicit entries, the host data must hold the descriptors of each
+/// layout binding in binding order, packed as VkDescriptorBufferInfo
+/// (buffers), VkDescriptorImageInfo (images and samplers) or VkBufferView
+/// (texel buffers). Ex:
+///   struct MaterialDescriptors {
+///     VkDescriptorBufferInfo ubo;     // binding 0
+///     VkDescriptorImageInfo albedo;   // binding 1
+///   };
+///   layout.updateTemplate()->update(set, material_descriptors);
+class DescriptorUpdateTemplate {
+public:
+  ///\param logical_device **[in]**
+  ///\param layout **[in]** layout of the sets updated by this template
+  DescriptorUpdateTemplate(const LogicalDevice *logical_device,
+                           DescriptorSetLayout &layout);
+  DescriptorUpdateTemplate(const DescriptorUpdateTemplate &other) = delete;
+  ~DescriptorUpdateTemplate();
+  ///\param logical_device **[in]**
+  ///\return bool true if the device exposes descriptor update templates
+  static bool isSupported(const LogicalDevice *logical_device);
+  ///\brief Describes where the descriptors of a binding are in the host
+  /// data. Once an entry is added, entries are no longer derived from the
+  /// layout.
+  ///\param binding **[in]**
+  ///\param type **[in]**
+  ///\param offset **[in]** offset of the first descriptor info in the data
+  ///\param count **[in | optional = 1]** number of descriptors
+  ///\param array_element **[in | optional = 0]** first array element
+  ///\param stride **[in | optional = 0]** distance between descriptor infos
+  /// (0 means tightly packed)
+  ///\return bool false if count is 0 (the entry is not added)
+  bool addEntry(uint32_t binding, VkDescriptorType type, size_t offset,
+                uint32_t count = 1, uint32_t array_element = 0,
+                size_t stride = 0);
+  ///\brief Makes this a push descriptor template (see
+  /// CommandBuffer::pushDescriptorSet). Must be called before the template
+  /// is created.
+  ///\param bind_point **[in]**
+  ///\param pipeline_layout **[in]**
+  ///\param set **[in]** set index of a push descriptor layout
+  ///\return bool false if the set layout is not a push descriptor layout (ex:
+  /// VK_KHR_push_descriptor is not enabled), the template keeps updating sets
+  bool setPushDescriptorTarget(VkPipelineBindPoint bind_point,
+                               PipelineLayout &pipeline_layout, uint32_t set);
+  ///\return bool true if the template pushes descriptors
+  [[nodiscard]] bool isPushTemplate() const;
+  ///\return VkDescriptorUpdateTemplate template handle (created on first use)
+  VkDescriptorUpdateTemplate handle();
+  ///\return size_t minimum size of the host data
+  [[nodiscard]] size_t dataSize() const;
+  ///\brief Writes all descriptors of **descriptor_set**
+  ///\param descriptor_set **[in]**
+  ///\param data **[in]** host data following the template entries
+  ///\param data_size **[in]** size of **data** in bytes
+  ///\return bool true if success
+  bool update(VkDescriptorSet descriptor_set, const void *data,
+              size_t data_size);
+  ///\brief Writes all descriptors of **descriptor_set** from a packed struct
+  ///\tparam T struct of descriptor infos
+  ///\param descriptor_set **[in]**
+  ///\param data **[in]**
+  ///\return bool true if success
+  template <typename T>
+  bool update(VkDescriptorSet descriptor_set, const T &data) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "descriptor data must be a plain struct");
+    return update(descriptor_set, &data, sizeof(T));
+  }
+
+private:
+  ///\param type **[in]**
+  ///\return size_t size of the descriptor info used by **type**
+  static size_t descriptorInfoSize(VkDescriptorType type);
+
+  const LogicalDevice *logical_device_ = nullptr;
+  VkDescriptorSetLayout vk_descriptor_set_layout_ = VK_NULL_HANDLE;
+  VkDescriptorUpdateTemplate vk_update_template_ = VK_NULL_HANDLE;
+  std::vector<VkDescriptorUpdateTemplateEntry> entries_;
+  bool entries_from_layout_{true};
+  size_t data_size_{0};
+  // push descriptors target
+  VkDescriptorUpdateTemplateType template_type_{
+      VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET};
+  VkPipelineBindPoint bind_point_{VK_PIPELINE_BIND_POINT_GRAPHICS};
+  VkPipelineLayout vk_pipeline_layout_ = VK_NULL_HANDLE;
+  uint32_t set_{0};
+  PFN_vkCreateDescriptorUpdateTemplate vkCreateDescriptorUpdateTemplate_ =
+      nullptr;
+  PFN_vkDestroyDescriptorUpdateTemplate vkDestroyDescriptorUpdateTemplate_ =
+      nullptr;
+  PFN_vkUpdateDescriptorSetWithTemplate vkUpdateDescriptorSetWithTemplate_ =
+      nullptr;
 };
 
 /// Groups descriptor sets to be used by a pipeline.
@@ -82,6 +211,8 @@ public:
   ~PipelineLayout();
   void destroy();
   VkPipelineLayout handle();
+  ///\return const LogicalDevice* device owner of the layout
+  [[nodiscard]] const LogicalDevice *device() const;
   ///\brief Create a Layout Set object
   ///
   ///\param id **[in]**
@@ -92,6 +223,12 @@ public:
   ///\param id **[in]**
   ///\return DescriptorSet&
   DescriptorSetLayout &descriptorSetLayout(uint32_t id);
+  ///\brief Appends a descriptor set layout owned by someone else (ex: a
+  /// DescriptorLayoutCache). Shared layouts and layouts created by
+  /// createLayoutSet can't be mixed in the same pipeline layout.
+  ///\param layout **[in]** must outlive this pipeline layout
+  ///\return uint32_t set index
+  uint32_t addDescriptorSetLayout(DescriptorSetLayout *layout);
   ///\brief
   /// A push constant is a uniform variable in a shader that can be used just
   /// like a member of a uniform block, but has faster access.
@@ -108,6 +245,7 @@ private:
   const LogicalDevice *logical_device_ = nullptr;
   VkPipelineLayout vk_pipeline_layout_ = VK_NULL_HANDLE;
   std::vector<DescriptorSetLayout> descriptor_sets_;
+  std::vector<DescriptorSetLayout *> shared_descriptor_sets_;
   std::vector<VkPushConstantRange> vk_push_constant_ranges_;
 };
 
@@ -221,6 +359,29 @@ private:
 //    Consisted of a single compute shader stage, compute pipelines are used
 //    to perform mathematical operations.
 
+/// Pipeline caches store the results of pipeline compilation, they can be
+/// shared by many pipelines (and threads) and saved to disk, so the next run
+/// skips most of the compilation work.
+class PipelineCache {
+public:
+  ///\param logical_device **[in]**
+  ///\param path **[in | optional = ""]** file with data previously saved by
+  /// save() (ignored if it doesn't exist)
+  explicit PipelineCache(const LogicalDevice *logical_device,
+                         const std::string &path = "");
+  PipelineCache(const PipelineCache &other) = delete;
+  ~PipelineCache();
+  ///\return VkPipelineCache
+  [[nodiscard]] VkPipelineCache handle() const;
+  ///\param path **[in]**
+  ///\return bool true if success
+  bool save(const std::string &path) const;
+
+private:
+  const LogicalDevice *logical_device_ = nullptr;
+  VkPipelineCache vk_pipeline_cache_ = VK_NULL_HANDLE;
+};
+
 class Pipeline {
 public:
   ///\brief Construct a new Pipeline object
@@ -233,6 +394,13 @@ public:
   ///
   ///\param stage **[in]**
   void addShaderStage(const PipelineShaderStage &stage);
+  ///\brief Overrides the specialization constants of all shader stages
+  /// (must be called before the pipeline is created)
+  ///\param info **[in]** must outlive the pipeline creation
+  void setSpecializationInfo(const VkSpecializationInfo *info);
+  ///\brief Sets the cache used on pipeline creation
+  ///\param cache **[in]** must outlive the pipeline creation
+  void setCache(PipelineCache *cache);
   ///\brief
   ///
   ///\param path **[in]**
@@ -242,16 +410,21 @@ public:
   [[nodiscard]] VkPipelineCache cache() const;
 
 protected:
+  friend class PipelineCompiler;
+  friend class ShaderReloader;
+
   const LogicalDevice *logical_device_ = nullptr;
   VkPipeline vk_pipeline_ = VK_NULL_HANDLE;
   VkPipelineCache vk_pipeline_cache_ = VK_NULL_HANDLE;
+  PipelineCache *cache_ = nullptr;
   std::vector<VkPipelineShaderStageCreateInfo> shader_stage_infos_;
 };
 
 class ComputePipeline : public Pipeline {
 public:
   ////\brief Construct a new Compute Pipeline object
-  ///
+  /// The pipeline is created on the first call to handle() (or by a
+  /// PipelineCompiler).
   ///\param logical_device **[in]**
   ///\param stage **[in]**
   ///\param layout **[in]**
@@ -263,6 +436,16 @@ public:
                   Pipeline *cache = nullptr,
                   ComputePipeline *base_pipeline = nullptr,
                   uint32_t base_pipeline_index = 0);
+  VkPipeline handle();
+  ///\brief Resolves the layout and fills the create info
+  ///\return const VkComputePipelineCreateInfo* valid while this object lives
+  const VkComputePipelineCreateInfo *createInfo();
+
+private:
+  PipelineLayout *layout_ = nullptr;
+  Pipeline *cache_pipeline_ = nullptr;
+  ComputePipeline *base_pipeline_ = nullptr;
+  VkComputePipelineCreateInfo info_ = {};
 };
 
 class GraphicsPipeline : public Pipeline {
@@ -286,6 +469,15 @@ public:
     ///\param offset **[in]**
     void addAttributeDescription(uint32_t location, uint32_t binding,
                                  VkFormat format, uint32_t offset);
+    ///\brief Adds the vertex inputs of a shader as the attributes of a
+    /// single interleaved binding, tightly packed in location order.
+    ///\param reflection **[in]** vertex stage (or merged) reflection
+    ///\param binding **[in | optional = 0]**
+    ///\param input_rate **[in | optional = VK_VERTEX_INPUT_RATE_VERTEX]**
+    ///\return uint32_t stride of the binding
+    uint32_t addReflectedInputs(
+        const ShaderReflection &reflection, uint32_t binding = 0,
+        VkVertexInputRate input_rate = VK_VERTEX_INPUT_RATE_VERTEX);
 
     [[nodiscard]] const VkPipelineVertexInputStateCreateInfo *info() const;
 
@@ -356,7 +548,9 @@ public:
     std::vector<VkPipelineColorBlendAttachmentState> attachments_;
   };
   ///\brief Construct a new Graphics Pipeline object
-  ///
+  /// Viewport and scissor are dynamic by default (see
+  /// CommandBuffer::setViewport and CommandBuffer::setScissor), so pipelines
+  /// don't depend on the framebuffer size.
   ///\param logical_device **[in]**
   ///\param layout **[in]**
   ///\param renderpass **[in]**
@@ -372,6 +566,9 @@ public:
   void setLayout(PipelineLayout *layout);
   void setRendePass(RenderPass *renderpass);
   VkPipeline handle();
+  ///\brief Resolves layout and renderpass handles and fills the create info
+  ///\return const VkGraphicsPipelineCreateInfo* valid while this object lives
+  const VkGraphicsPipelineCreateInfo *createInfo();
 
   ///\brief Set the Input State object
   ///
@@ -439,6 +636,25 @@ public:
   ///
   ///\param dynamic_state **[in]**
   void addDynamicState(VkDynamicState dynamic_state);
+  ///\brief Bakes a dynamic state back into the pipeline
+  ///\param dynamic_state **[in]** ex: VK_DYNAMIC_STATE_VIEWPORT
+  void removeDynamicState(VkDynamicState dynamic_state);
+  ///\param dynamic_state **[in]**
+  ///\return bool true if **dynamic_state** is set by command buffers
+  [[nodiscard]] bool isDynamicState(VkDynamicState dynamic_state) const;
+  ///\brief Makes dynamic all states covered by the enabled
+  /// VK_EXT_extended_dynamic_state extensions:
+  ///  1: cull mode, front face, topology (class), depth test/write/compare op
+  ///  2: depth bias enable, primitive restart, rasterizer discard
+  ///  3: polygon mode
+  /// An extension counts as enabled only if it was requested on logical
+  /// device creation together with its feature bit (extendedDynamicState,
+  /// extendedDynamicState2, extendedDynamicState3PolygonMode) chained in
+  /// the features_chain of the LogicalDevice. The values of the dynamic
+  /// states must then be set with the CommandBuffer setters before drawing,
+  /// and pipelines that differ only on them become the same.
+  ///\return uint32_t number of states made dynamic
+  uint32_t useExtendedDynamicState();
 
   VertexInputState vertex_input_state;
   ViewportState viewport_state;
@@ -455,6 +671,7 @@ private:
   std::unique_ptr<VkPipelineDepthStencilStateCreateInfo> depth_stencil_state_;
   std::unique_ptr<VkPipelineDynamicStateCreateInfo> dynamic_state_;
   std::vector<VkDynamicState> dynamic_states_;
+  VkPipelineViewportStateCreateInfo viewport_info_ = {};
   VkGraphicsPipelineCreateInfo info_ = {};
 };
 
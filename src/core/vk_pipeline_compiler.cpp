@@ -0,0 +1,256 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_pipeline_compiler.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_pipeline_compiler.h"
+#include "vulkan_debug.h"
+#include <algorithm>
+#include <chrono>
+
+namespace circe::vk {
+
+PipelineCompiler::Request::Request(std::shared_ptr<State> state)
+    : state_(std::move(state)) {}
+
+bool PipelineCompiler::Request::ready() const {
+  if (!state_)
+    return false;
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->done;
+}
+
+bool PipelineCompiler::Request::wait() const { return get() != VK_NULL_HANDLE; }
+
+VkPipeline PipelineCompiler::Request::get() const {
+  if (!state_)
+    return VK_NULL_HANDLE;
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->done_condition.wait(lock, [&] { return state_->done; });
+  return state_->vk_pipeline;
+}
+
+double PipelineCompiler::Request::batchTime() const {
+  if (!state_)
+    return 0;
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->batch_time;
+}
+
+uint32_t PipelineCompiler::Request::batchSize() const {
+  if (!state_)
+    return 0;
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->batch_size;
+}
+
+bool PipelineCompiler::Request::valid() const { return state_ != nullptr; }
+
+PipelineCompiler::PipelineCompiler(const LogicalDevice *logical_device,
+                                   PipelineCache *cache, uint32_t worker_count,
+                                   uint32_t max_batch_size)
+    : logical_device_(logical_device), cache_(cache),
+      max_batch_size_(std::max(1u, max_batch_size)) {
+  if (!worker_count) {
+    // hardware_concurrency() may return 0
+    auto hardware_threads = std::thread::hardware_concurrency();
+    worker_count = hardware_threads > 1 ? hardware_threads - 1 : 1;
+  }
+  for (uint32_t i = 0; i < worker_count; ++i)
+    workers_.emplace_back(&PipelineCompiler::workerLoop, this);
+}
+
+PipelineCompiler::~PipelineCompiler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  jobs_condition_.notify_all();
+  for (auto &worker : workers_)
+    worker.join();
+}
+
+PipelineCompiler::Request PipelineCompiler::compile(GraphicsPipeline *pipeline) {
+  Job job;
+  job.pipeline = pipeline;
+  job.graphics = true;
+  job.graphics_info = *pipeline->createInfo();
+  return submit(std::move(job));
+}
+
+PipelineCompiler::Request PipelineCompiler::compile(ComputePipeline *pipeline) {
+  Job job;
+  job.pipeline = pipeline;
+  job.graphics = false;
+  job.compute_info = *pipeline->createInfo();
+  return submit(std::move(job));
+}
+
+PipelineCompiler::Request
+PipelineCompiler::compile(const VkGraphicsPipelineCreateInfo &info) {
+  Job job;
+  job.graphics = true;
+  job.graphics_info = info;
+  return submit(std::move(job));
+}
+
+PipelineCompiler::Request
+PipelineCompiler::compile(const VkComputePipelineCreateInfo &info) {
+  Job job;
+  job.graphics = false;
+  job.compute_info = info;
+  return submit(std::move(job));
+}
+
+std::vector<PipelineCompiler::Request>
+PipelineCompiler::compile(const std::vector<GraphicsPipeline *> &pipelines) {
+  std::vector<Job> jobs(pipelines.size());
+  std::vector<Request> requests;
+  for (size_t i = 0; i < pipelines.size(); ++i) {
+    jobs[i].pipeline = pipelines[i];
+    jobs[i].graphics = true;
+    jobs[i].graphics_info = *pipelines[i]->createInfo();
+    jobs[i].state = std::make_shared<Request::State>();
+    requests.emplace_back(Request(jobs[i].state));
+  }
+  {
+    // enqueue together so workers can take them as batches
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &job : jobs)
+      jobs_.emplace_back(std::move(job));
+    pending_ += pipelines.size();
+  }
+  jobs_condition_.notify_all();
+  return requests;
+}
+
+void PipelineCompiler::waitIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_condition_.wait(lock, [&] { return pending_ == 0; });
+}
+
+uint32_t PipelineCompiler::pendingCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_;
+}
+
+PipelineCompiler::Statistics PipelineCompiler::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+PipelineCompiler::Request PipelineCompiler::submit(Job &&job) {
+  job.state = std::make_shared<Request::State>();
+  Request request(job.state);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.emplace_back(std::move(job));
+    pending_++;
+  }
+  jobs_condition_.notify_one();
+  return request;
+}
+
+void PipelineCompiler::workerLoop() {
+  std::vector<Job> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      jobs_condition_.wait(lock, [&] { return stop_ || !jobs_.empty(); });
+      if (jobs_.empty())
+        return;
+      // take consecutive jobs of the same kind
+      bool graphics = jobs_.front().graphics;
+      while (!jobs_.empty() && jobs_.front().graphics == graphics &&
+             batch.size() < max_batch_size_) {
+        batch.emplace_back(std::move(jobs_.front()));
+        jobs_.pop_front();
+      }
+    }
+    run(batch);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_ -= batch.size();
+      if (!pending_)
+        idle_condition_.notify_all();
+    }
+    batch.clear();
+  }
+}
+
+void PipelineCompiler::run(std::vector<Job> &jobs) {
+  auto count = static_cast<uint32_t>(jobs.size());
+  std::vector<VkPipeline> vk_pipelines(count, VK_NULL_HANDLE);
+  VkPipelineCache vk_cache = cache_ ? cache_->handle() : VK_NULL_HANDLE;
+  auto start = std::chrono::high_resolution_clock::now();
+  VkResult result;
+  if (jobs[0].graphics) {
+    std::vector<VkGraphicsPipelineCreateInfo> infos;
+    for (auto &job : jobs)
+      infos.emplace_back(job.graphics_info);
+    result = vkCreateGraphicsPipelines(logical_device_->handle(), vk_cache,
+                                       count, infos.data(), nullptr,
+                                       vk_pipelines.data());
+  } else {
+    std::vector<VkComputePipelineCreateInfo> infos;
+    for (auto &job : jobs)
+      infos.emplace_back(job.compute_info);
+    result = vkCreateComputePipelines(logical_device_->handle(), vk_cache,
+                                      count, infos.data(), nullptr,
+                                      vk_pipelines.data());
+  }
+  double elapsed = std::chrono::duration<double, std::milli>(
+                       std::chrono::high_resolution_clock::now() - start)
+                       .count();
+  CHECK_VULKAN(result);
+  uint32_t failed = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    // on failure, successfully created pipelines are still valid
+    if (jobs[i].pipeline) {
+      // recompilation: the previous handle is no longer in use (see compile)
+      if (jobs[i].pipeline->vk_pipeline_ != VK_NULL_HANDLE)
+        vkDestroyPipeline(logical_device_->handle(),
+                          jobs[i].pipeline->vk_pipeline_, nullptr);
+      jobs[i].pipeline->vk_pipeline_ = vk_pipelines[i];
+    }
+    failed += vk_pipelines[i] == VK_NULL_HANDLE;
+    {
+      std::lock_guard<std::mutex> lock(jobs[i].state->mutex);
+      jobs[i].state->vk_pipeline = vk_pipelines[i];
+      jobs[i].state->batch_time = elapsed;
+      jobs[i].state->batch_size = count;
+      jobs[i].state->done = true;
+    }
+    jobs[i].state->done_condition.notify_all();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  statistics_.compiled += count - failed;
+  statistics_.failed += failed;
+  statistics_.batches++;
+  statistics_.total_time += elapsed;
+  statistics_.max_time = std::max(statistics_.max_time, elapsed);
+}
+
+} // namespace circe::vk
@@ -0,0 +1,170 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_pipeline_compiler.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_PIPELINE_COMPILER_H
+#define CIRCE_VK_PIPELINE_COMPILER_H
+
+#include "vk_pipeline.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace circe::vk {
+
+/// \brief Compiles pipelines ahead of use on a pool of worker threads.
+/// Create infos are resolved on the submitting thread, so layouts and
+/// renderpasses are created there; workers only call vkCreate*Pipelines
+/// through the shared pipeline cache, grouping consecutive requests of the
+/// same kind into a single call. Submitted pipelines must not be used (or
+/// destroyed) until their request is ready. Ex:
+///   PipelineCompiler compiler(device, &cache);
+///   auto request = compiler.compile(&material_pipeline);
+///   ...
+///   if (request.ready()) cb.bind(&material_pipeline);
+class PipelineCompiler final {
+public:
+  /// \brief Future-like handle of a compilation request
+  class Request {
+  public:
+    Request() = default;
+    ///\return bool true if the pipeline creation finished (never blocks)
+    [[nodiscard]] bool ready() const;
+    ///\brief Blocks until the pipeline creation finishes
+    ///\return bool true if the pipeline was created
+    bool wait() const;
+    ///\brief Blocks until the pipeline creation finishes
+    ///\return VkPipeline created pipeline (VK_NULL_HANDLE on failure)
+    VkPipeline get() const;
+    ///\return double duration in milliseconds of the vkCreate*Pipelines call
+    /// that created the pipeline, shared by all batchSize() pipelines of the
+    /// call. Drivers do not report the cost of each pipeline of a call, so
+    /// this is a per-pipeline compile time only when batchSize() is 1 (build
+    /// the compiler with max_batch_size = 1 to measure pipelines alone).
+    [[nodiscard]] double batchTime() const;
+    ///\return uint32_t number of pipelines created by the same call
+    [[nodiscard]] uint32_t batchSize() const;
+    ///\return bool true if this handle refers to a request
+    [[nodiscard]] bool valid() const;
+
+  private:
+    friend class PipelineCompiler;
+    struct State {
+      std::mutex mutex;
+      std::condition_variable done_condition;
+      bool done{false};
+      VkPipeline vk_pipeline = VK_NULL_HANDLE;
+      double batch_time{0};
+      uint32_t batch_size{0};
+    };
+    explicit Request(std::shared_ptr<State> state);
+    std::shared_ptr<State> state_;
+  };
+  struct Statistics {
+    uint64_t compiled{0};  //!< pipelines created
+    uint64_t failed{0};    //!< pipelines that failed to compile
+    uint64_t batches{0};   //!< vkCreate*Pipelines calls
+    double total_time{0};  //!< sum of call durations (ms)
+    double max_time{0};    //!< longest call (ms)
+  };
+  ///\param logical_device **[in]**
+  ///\param cache **[in | optional = nullptr]** cache shared by all
+  /// compilations
+  ///\param worker_count **[in | optional = 0]** 0 means one less than the
+  /// number of hardware threads
+  ///\param max_batch_size **[in | optional = 16]** maximum number of create
+  /// infos per call (1 times each pipeline separately, see
+  /// Request::batchTime())
+  explicit PipelineCompiler(const LogicalDevice *logical_device,
+                            PipelineCache *cache = nullptr,
+                            uint32_t worker_count = 0,
+                            uint32_t max_batch_size = 16);
+  PipelineCompiler(const PipelineCompiler &other) = delete;
+  ///\brief Finishes pending requests and joins the workers
+  ~PipelineCompiler();
+  ///\brief Compiles (or recompiles) the pipeline. A handle the pipeline
+  /// already has is destroyed when the new one is created, so it must no
+  /// longer be in use by the device.
+  ///\param pipeline **[in]** must outlive the request
+  ///\return Request
+  Request compile(GraphicsPipeline *pipeline);
+  ///\param pipeline **[in]** must outlive the request (see above)
+  ///\return Request
+  Request compile(ComputePipeline *pipeline);
+  ///\brief Creates a pipeline not owned by any Pipeline object. The result
+  /// is only available through the request and must be destroyed by the
+  /// caller.
+  ///\param info **[in]** everything it points to must stay valid until the
+  /// request is ready
+  ///\return Request
+  Request compile(const VkGraphicsPipelineCreateInfo &info);
+  ///\param info **[in]** everything it points to must stay valid until the
+  /// request is ready
+  ///\return Request
+  Request compile(const VkComputePipelineCreateInfo &info);
+  ///\brief Submits all pipelines at once, so they can share calls
+  ///\param pipelines **[in]** must outlive the requests
+  ///\return std::vector<Request> one request per pipeline
+  std::vector<Request> compile(const std::vector<GraphicsPipeline *> &pipelines);
+  ///\brief Blocks until all submitted requests are finished
+  void waitIdle();
+  ///\return uint32_t number of requests not finished yet
+  [[nodiscard]] uint32_t pendingCount() const;
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+
+private:
+  struct Job {
+    Pipeline *pipeline = nullptr;
+    bool graphics = true;
+    VkGraphicsPipelineCreateInfo graphics_info{};
+    VkComputePipelineCreateInfo compute_info{};
+    std::shared_ptr<Request::State> state;
+  };
+  ///\param job **[in]**
+  ///\return Request
+  Request submit(Job &&job);
+  void workerLoop();
+  ///\param jobs **[in]** jobs of the same kind
+  void run(std::vector<Job> &jobs);
+
+  const LogicalDevice *logical_device_ = nullptr;
+  PipelineCache *cache_ = nullptr;
+  uint32_t max_batch_size_{16};
+  std::vector<std::thread> workers_;
+  mutable std::mutex mutex_;
+  std::condition_variable jobs_condition_;
+  std::condition_variable idle_condition_;
+  std::deque<Job> jobs_;
+  uint32_t pending_{0};
+  bool stop_{false};
+  Statistics statistics_;
+};
+
+} // namespace circe::vk
+
+#endif
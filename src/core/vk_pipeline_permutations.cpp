@@ -0,0 +1,120 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_pipeline_permutations.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_pipeline_permutations.h"
+#include <algorithm>
+
+namespace circe::vk {
+
+void SpecializationSpace::addToggle(uint32_t constant_id) {
+  addValues(constant_id, {VK_FALSE, VK_TRUE});
+}
+
+void SpecializationSpace::addRange(uint32_t constant_id, uint32_t first,
+                                   uint32_t last) {
+  std::vector<uint32_t> values;
+  // 64-bit counter: v <= last is always true when last is UINT32_MAX
+  for (uint64_t v = first; v <= last; ++v)
+    values.emplace_back(static_cast<uint32_t>(v));
+  addValues(constant_id, values);
+}
+
+void SpecializationSpace::addValues(uint32_t constant_id,
+                                    const std::vector<uint32_t> &values) {
+  if (values.empty())
+    return;
+  // one map entry per constant id, a second declaration replaces the values
+  for (auto &c : constants_)
+    if (c.id == constant_id) {
+      c.values = values;
+      return;
+    }
+  auto offset = static_cast<uint32_t>(constants_.size() * sizeof(uint32_t));
+  VkSpecializationMapEntry entry = {
+      constant_id,     // uint32_t constantID
+      offset,          // uint32_t offset
+      sizeof(uint32_t) // size_t   size
+  };
+  map_entries_.emplace_back(entry);
+  constants_.push_back({constant_id, values});
+}
+
+uint64_t SpecializationSpace::variantCount() const {
+  uint64_t count = 1;
+  for (auto &c : constants_)
+    count *= c.values.size();
+  return count;
+}
+
+uint64_t SpecializationSpace::key(
+    const std::vector<std::pair<uint32_t, uint32_t>> &values) const {
+  // mixed radix number, one digit per constant
+  uint64_t key = 0;
+  uint64_t radix = 1;
+  for (auto &c : constants_) {
+    uint64_t digit = 0;
+    for (auto &v : values)
+      if (v.first == c.id) {
+        auto it = std::find(c.values.begin(), c.values.end(), v.second);
+        if (it == c.values.end())
+          return invalid_key;
+        digit = it - c.values.begin();
+      }
+    key += digit * radix;
+    radix *= c.values.size();
+  }
+  for (auto &v : values)
+    if (std::none_of(constants_.begin(), constants_.end(),
+                     [&](const Constant &c) { return c.id == v.first; }))
+      return invalid_key;
+  return key;
+}
+
+uint32_t SpecializationSpace::value(uint64_t key, uint32_t constant_id) const {
+  for (auto &c : constants_) {
+    if (c.id == constant_id)
+      return c.values[key % c.values.size()];
+    key /= c.values.size();
+  }
+  return 0;
+}
+
+void SpecializationSpace::data(uint64_t key,
+                               std::vector<uint32_t> &data) const {
+  data.clear();
+  for (auto &c : constants_) {
+    data.emplace_back(c.values[key % c.values.size()]);
+    key /= c.values.size();
+  }
+}
+
+const std::vector<VkSpecializationMapEntry> &
+SpecializationSpace::mapEntries() const {
+  return map_entries_;
+}
+
+} // namespace circe::vk
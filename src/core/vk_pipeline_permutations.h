@@ -0,0 +1,200 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_pipeline_permutations.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_PIPELINE_PERMUTATIONS_H
+#define CIRCE_VK_PIPELINE_PERMUTATIONS_H
+
+#include "vk_pipeline_compiler.h"
+#include <functional>
+#include <unordered_map>
+
+namespace circe::vk {
+
+/// \brief Declares the specialization constants of a shader set and the
+/// values each one can take. Every combination of values is a variant,
+/// identified by a key. All constants are 32 bit words (VkBool32, int,
+/// uint or float bits) and are shared by all stages (stages simply ignore
+/// ids they don't declare). Ex:
+///   SpecializationSpace space;
+///   space.addToggle(0);          // layout(constant_id = 0) const bool SHADOWS
+///   space.addRange(1, 0, 4);     // layout(constant_id = 1) const uint LIGHTS
+///   auto key = space.key({{0, VK_TRUE}, {1, 2}});
+class SpecializationSpace {
+public:
+  static const uint64_t invalid_key = ~0ull;
+  ///\brief Declares a boolean constant (VK_FALSE or VK_TRUE)
+  ///\param constant_id **[in]**
+  void addToggle(uint32_t constant_id);
+  ///\brief Declares a constant taking all values in [first, last]
+  ///\param constant_id **[in]**
+  ///\param first **[in]**
+  ///\param last **[in]**
+  void addRange(uint32_t constant_id, uint32_t first, uint32_t last);
+  ///\brief Declares a constant taking the given values (the first one is
+  /// the default). Declaring a constant again replaces its values, keys
+  /// computed before are no longer valid.
+  ///\param constant_id **[in]**
+  ///\param values **[in]** raw 32 bit values
+  void addValues(uint32_t constant_id, const std::vector<uint32_t> &values);
+  ///\return uint64_t number of variants
+  [[nodiscard]] uint64_t variantCount() const;
+  ///\brief Computes the key of a variant. Constants not listed take their
+  /// first value.
+  ///\param values **[in]** pairs of (constant id, value)
+  ///\return uint64_t invalid_key if a constant or value was not declared
+  [[nodiscard]] uint64_t
+  key(const std::vector<std::pair<uint32_t, uint32_t>> &values) const;
+  ///\param key **[in]**
+  ///\param constant_id **[in]**
+  ///\return uint32_t value of the constant in the variant
+  [[nodiscard]] uint32_t value(uint64_t key, uint32_t constant_id) const;
+  ///\param key **[in]**
+  ///\param data **[out]** values of all constants in declaration order
+  void data(uint64_t key, std::vector<uint32_t> &data) const;
+  ///\return const std::vector<VkSpecializationMapEntry>& map entries of
+  /// data()
+  [[nodiscard]] const std::vector<VkSpecializationMapEntry> &
+  mapEntries() const;
+
+private:
+  struct Constant {
+    uint32_t id;
+    std::vector<uint32_t> values;
+  };
+  std::vector<Constant> constants_;
+  std::vector<VkSpecializationMapEntry> map_entries_;
+};
+
+/// \brief Specialized variants of a pipeline, built lazily or ahead of time.
+/// The factory creates a fully configured pipeline (stages, states, layout)
+/// without specialization data, the permutation set fills the specialization
+/// constants of each variant and creates it through the pipeline cache.
+/// Variants are selected at record time by key:
+///   PipelinePermutations<GraphicsPipeline> lit(space, makeLit, &cache);
+///   lit.precompile(compiler);  // optional, all or some variants
+///   ...
+///   cb.bind(VK_PIPELINE_BIND_POINT_GRAPHICS, lit.handle(key));
+///\tparam P GraphicsPipeline or ComputePipeline
+template <typename P> class PipelinePermutations {
+public:
+  using Factory = std::function<std::unique_ptr<P>()>;
+  ///\param space **[in]** declared specialization constants
+  ///\param factory **[in]** creates the pipeline of a variant
+  ///\param cache **[in | optional = nullptr]** cache used by all variants
+  PipelinePermutations(SpecializationSpace space, Factory factory,
+                       PipelineCache *cache = nullptr)
+      : space_(std::move(space)), factory_(std::move(factory)),
+        cache_(cache) {}
+  ///\param key **[in]**
+  ///\return P* pipeline object of the variant (nullptr for invalid keys)
+  P *variant(uint64_t key) {
+    auto it = variants_.find(key);
+    if (it != variants_.end())
+      return it->second->pipeline.get();
+    if (key >= space_.variantCount())
+      return nullptr;
+    auto v = std::make_unique<Variant>();
+    v->pipeline = factory_();
+    if (!v->pipeline)
+      return nullptr;
+    space_.data(key, v->data);
+    v->info.mapEntryCount =
+        static_cast<uint32_t>(space_.mapEntries().size());
+    v->info.pMapEntries = space_.mapEntries().data();
+    v->info.dataSize = v->data.size() * sizeof(uint32_t);
+    v->info.pData = v->data.data();
+    v->pipeline->setSpecializationInfo(&v->info);
+    if (cache_)
+      v->pipeline->setCache(cache_);
+    return (variants_[key] = std::move(v))->pipeline.get();
+  }
+  ///\brief Retrieves the pipeline of a variant, creating it if needed. If the
+  /// variant is being precompiled, waits for it.
+  ///\param key **[in]**
+  ///\return VkPipeline
+  VkPipeline handle(uint64_t key) {
+    P *pipeline = variant(key);
+    if (!pipeline)
+      return VK_NULL_HANDLE;
+    auto &request = variants_[key]->request;
+    if (request.valid())
+      return request.get();
+    return pipeline->handle();
+  }
+  ///\param key **[in]**
+  ///\return bool true if the variant pipeline exists (never blocks)
+  bool ready(uint64_t key) const {
+    auto it = variants_.find(key);
+    if (it == variants_.end())
+      return false;
+    if (it->second->request.valid())
+      return it->second->request.ready();
+    // base handle() doesn't create the pipeline
+    const Pipeline &pipeline = *it->second->pipeline;
+    return pipeline.handle() != VK_NULL_HANDLE;
+  }
+  ///\brief Submits variants to the compiler
+  ///\param compiler **[in]**
+  ///\param keys **[in | optional = {}]** all variants if empty
+  ///\return size_t number of variants submitted
+  size_t precompile(PipelineCompiler &compiler,
+                    const std::vector<uint64_t> &keys = {}) {
+    std::vector<uint64_t> selected = keys;
+    if (selected.empty())
+      for (uint64_t k = 0; k < space_.variantCount(); ++k)
+        selected.emplace_back(k);
+    size_t count = 0;
+    for (auto k : selected) {
+      P *pipeline = variant(k);
+      if (!pipeline || ready(k) || variants_[k]->request.valid())
+        continue;
+      variants_[k]->request = compiler.compile(pipeline);
+      count++;
+    }
+    return count;
+  }
+  ///\return size_t number of variants created so far
+  [[nodiscard]] size_t variantCount() const { return variants_.size(); }
+  ///\return const SpecializationSpace&
+  [[nodiscard]] const SpecializationSpace &space() const { return space_; }
+
+private:
+  struct Variant {
+    std::unique_ptr<P> pipeline;
+    std::vector<uint32_t> data;
+    VkSpecializationInfo info{};
+    PipelineCompiler::Request request;
+  };
+  SpecializationSpace space_;
+  Factory factory_;
+  PipelineCache *cache_ = nullptr;
+  std::unordered_map<uint64_t, std::unique_ptr<Variant>> variants_;
+};
+
+} // namespace circe::vk
+
+#endif
@@ -0,0 +1,363 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_pipeline_registry.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_pipeline_registry.h"
+#include "vk_hash.h"
+#include "vulkan_debug.h"
+#include <algorithm>
+#include <cstring>
+
+namespace circe::vk {
+
+namespace {
+
+/// Appends values to a byte key. Only plain fields are serialized (pointers,
+/// sType and pNext are skipped), so padding never reaches the key.
+class KeyWriter {
+public:
+  explicit KeyWriter(std::vector<uint8_t> &bytes) : bytes_(bytes) {}
+  template <typename T> void add(const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "plain types only");
+    add(&value, sizeof(T));
+  }
+  void add(const void *data, size_t size) {
+    auto *b = reinterpret_cast<const uint8_t *>(data);
+    bytes_.insert(bytes_.end(), b, b + size);
+  }
+  void addString(const char *s) {
+    size_t size = s ? std::strlen(s) : 0;
+    add(size);
+    add(s, size);
+  }
+  // marks the presence of optional states
+  template <typename T> bool present(const T *state) {
+    add<uint8_t>(state != nullptr);
+    return state != nullptr;
+  }
+
+private:
+  std::vector<uint8_t> &bytes_;
+};
+
+uint8_t topologyClass(VkPrimitiveTopology topology) {
+  switch (topology) {
+  case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+    return 0;
+  case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+  case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+  case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+  case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+    return 1;
+  case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+    return 3;
+  default:
+    break;
+  }
+  return 2;
+}
+
+// Extended dynamic states, VK_DYNAMIC_STATE_MAX_ENUM (never dynamic) when the
+// Vulkan headers predate the extension.
+#ifdef VK_EXT_extended_dynamic_state
+const VkDynamicState dynamic_cull_mode = VK_DYNAMIC_STATE_CULL_MODE_EXT;
+const VkDynamicState dynamic_front_face = VK_DYNAMIC_STATE_FRONT_FACE_EXT;
+const VkDynamicState dynamic_topology =
+    VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT;
+const VkDynamicState dynamic_depth_test =
+    VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT;
+const VkDynamicState dynamic_depth_write =
+    VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT;
+const VkDynamicState dynamic_depth_compare_op =
+    VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT;
+#else
+const VkDynamicState dynamic_cull_mode = VK_DYNAMIC_STATE_MAX_ENUM;
+const VkDynamicState dynamic_front_face = VK_DYNAMIC_STATE_MAX_ENUM;
+const VkDynamicState dynamic_topology = VK_DYNAMIC_STATE_MAX_ENUM;
+const VkDynamicState dynamic_depth_test = VK_DYNAMIC_STATE_MAX_ENUM;
+const VkDynamicState dynamic_depth_write = VK_DYNAMIC_STATE_MAX_ENUM;
+const VkDynamicState dynamic_depth_compare_op = VK_DYNAMIC_STATE_MAX_ENUM;
+#endif
+#ifdef VK_EXT_extended_dynamic_state2
+const VkDynamicState dynamic_depth_bias =
+    VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT;
+const VkDynamicState dynamic_primitive_restart =
+    VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT;
+const VkDynamicState dynamic_rasterizer_discard =
+    VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT;
+#else
+const VkDynamicState dynamic_depth_bias = VK_DYNAMIC_STATE_MAX_ENUM;
+const VkDynamicState dynamic_primitive_restart = VK_DYNAMIC_STATE_MAX_ENUM;
+const VkDynamicState dynamic_rasterizer_discard = VK_DYNAMIC_STATE_MAX_ENUM;
+#endif
+#ifdef VK_EXT_extended_dynamic_state3
+const VkDynamicState dynamic_polygon_mode = VK_DYNAMIC_STATE_POLYGON_MODE_EXT;
+#else
+const VkDynamicState dynamic_polygon_mode = VK_DYNAMIC_STATE_MAX_ENUM;
+#endif
+
+} // namespace
+
+PipelineRegistry::SharedPipeline::SharedPipeline(
+    const LogicalDevice *logical_device, VkPipeline vk_pipeline, size_t hash)
+    : logical_device_(logical_device), vk_pipeline_(vk_pipeline), hash_(hash) {}
+
+PipelineRegistry::SharedPipeline::~SharedPipeline() {
+  if (vk_pipeline_ != VK_NULL_HANDLE)
+    vkDestroyPipeline(logical_device_->handle(), vk_pipeline_, nullptr);
+}
+
+VkPipeline PipelineRegistry::SharedPipeline::handle() const {
+  return vk_pipeline_;
+}
+
+size_t PipelineRegistry::SharedPipeline::hash() const { return hash_; }
+
+PipelineRegistry::PipelineRegistry(const LogicalDevice *logical_device,
+                                   PipelineCache *cache)
+    : logical_device_(logical_device), cache_(cache) {}
+
+std::shared_ptr<PipelineRegistry::SharedPipeline>
+PipelineRegistry::acquire(GraphicsPipeline &description) {
+  auto key = stateKey(description);
+  size_t hash = hashBytes(key.data(), key.size());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &entry : entries_[hash])
+      if (entry.key == key)
+        if (auto pipeline = entry.pipeline.lock()) {
+          hits_++;
+          return pipeline;
+        }
+  }
+  // compiled without the lock, so hits are not blocked by compilations
+  VkPipeline vk_pipeline = VK_NULL_HANDLE;
+  VkResult result = vkCreateGraphicsPipelines(
+      logical_device_->handle(),
+      cache_ ? cache_->handle() : VK_NULL_HANDLE, 1, description.createInfo(),
+      nullptr, &vk_pipeline);
+  CHECK_VULKAN(result);
+  if (result != VK_SUCCESS)
+    return nullptr;
+  // declared before the lock, a duplicate is destroyed after unlocking
+  auto created =
+      std::make_shared<SharedPipeline>(logical_device_, vk_pipeline, hash);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &bucket = entries_[hash];
+  for (auto &entry : bucket)
+    if (entry.key == key) {
+      // another thread may have created the same state meanwhile
+      if (auto pipeline = entry.pipeline.lock()) {
+        hits_++;
+        return pipeline;
+      }
+      // reuse an expired entry
+      misses_++;
+      entry.pipeline = created;
+      return created;
+    }
+  misses_++;
+  bucket.push_back({std::move(key), created});
+  return created;
+}
+
+size_t PipelineRegistry::stateHash(GraphicsPipeline &description) {
+  auto key = stateKey(description);
+  return hashBytes(key.data(), key.size());
+}
+
+void PipelineRegistry::purge() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto &bucket = it->second;
+    bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                [](const Entry &entry) {
+                                  return entry.pipeline.expired();
+                                }),
+                 bucket.end());
+    if (bucket.empty())
+      it = entries_.erase(it);
+    else
+      ++it;
+  }
+}
+
+size_t PipelineRegistry::pipelineCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = 0;
+  for (auto &bucket : entries_)
+    for (auto &entry : bucket.second)
+      count += !entry.pipeline.expired();
+  return count;
+}
+
+uint64_t PipelineRegistry::hitCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t PipelineRegistry::missCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+std::vector<uint8_t> PipelineRegistry::stateKey(GraphicsPipeline &description) {
+  const VkGraphicsPipelineCreateInfo *info = description.createInfo();
+  std::vector<uint8_t> bytes;
+  bytes.reserve(512);
+  KeyWriter key(bytes);
+  key.add(info->flags);
+  key.add(info->layout);
+  key.add(info->renderPass);
+  key.add(info->subpass);
+  key.add(info->basePipelineHandle);
+  key.add(info->basePipelineIndex);
+  // shader stages
+  key.add(info->stageCount);
+  for (uint32_t i = 0; i < info->stageCount; ++i) {
+    const auto &stage = info->pStages[i];
+    key.add(stage.flags);
+    key.add(stage.stage);
+    key.add(stage.module);
+    key.addString(stage.pName);
+    if (key.present(stage.pSpecializationInfo)) {
+      const auto *spec = stage.pSpecializationInfo;
+      key.add(spec->mapEntryCount);
+      for (uint32_t e = 0; e < spec->mapEntryCount; ++e) {
+        key.add(spec->pMapEntries[e].constantID);
+        key.add(spec->pMapEntries[e].offset);
+        key.add(spec->pMapEntries[e].size);
+      }
+      key.add(spec->dataSize);
+      key.add(spec->pData, spec->dataSize);
+    }
+  }
+  // dynamic states
+  std::vector<VkDynamicState> dynamic_states;
+  if (info->pDynamicState)
+    dynamic_states.assign(info->pDynamicState->pDynamicStates,
+                          info->pDynamicState->pDynamicStates +
+                              info->pDynamicState->dynamicStateCount);
+  std::sort(dynamic_states.begin(), dynamic_states.end());
+  key.add(dynamic_states.size());
+  for (auto state : dynamic_states)
+    key.add(state);
+  auto isDynamic = [&](VkDynamicState state) {
+    return std::binary_search(dynamic_states.begin(), dynamic_states.end(),
+                              state);
+  };
+  // vertex input
+  if (key.present(info->pVertexInputState)) {
+    const auto *vi = info->pVertexInputState;
+    key.add(vi->vertexBindingDescriptionCount);
+    for (uint32_t i = 0; i < vi->vertexBindingDescriptionCount; ++i)
+      key.add(vi->pVertexBindingDescriptions[i]);
+    key.add(vi->vertexAttributeDescriptionCount);
+    for (uint32_t i = 0; i < vi->vertexAttributeDescriptionCount; ++i)
+      key.add(vi->pVertexAttributeDescriptions[i]);
+  }
+  if (key.present(info->pInputAssemblyState)) {
+    // a dynamic topology only fixes the topology class
+    if (isDynamic(dynamic_topology))
+      key.add(topologyClass(info->pInputAssemblyState->topology));
+    else
+      key.add(info->pInputAssemblyState->topology);
+    if (!isDynamic(dynamic_primitive_restart))
+      key.add(info->pInputAssemblyState->primitiveRestartEnable);
+  }
+  if (key.present(info->pTessellationState))
+    key.add(info->pTessellationState->patchControlPoints);
+  // viewport values are irrelevant when they are dynamic
+  if (key.present(info->pViewportState)) {
+    const auto *vp = info->pViewportState;
+    key.add(vp->viewportCount);
+    key.add(vp->scissorCount);
+    if (!isDynamic(VK_DYNAMIC_STATE_VIEWPORT) && vp->pViewports)
+      for (uint32_t i = 0; i < vp->viewportCount; ++i)
+        key.add(vp->pViewports[i]);
+    if (!isDynamic(VK_DYNAMIC_STATE_SCISSOR) && vp->pScissors)
+      for (uint32_t i = 0; i < vp->scissorCount; ++i)
+        key.add(vp->pScissors[i]);
+  }
+  if (key.present(info->pRasterizationState)) {
+    const auto *rs = info->pRasterizationState;
+    key.add(rs->depthClampEnable);
+    if (!isDynamic(dynamic_rasterizer_discard))
+      key.add(rs->rasterizerDiscardEnable);
+    if (!isDynamic(dynamic_polygon_mode))
+      key.add(rs->polygonMode);
+    if (!isDynamic(dynamic_cull_mode))
+      key.add(rs->cullMode);
+    if (!isDynamic(dynamic_front_face))
+      key.add(rs->frontFace);
+    if (!isDynamic(dynamic_depth_bias))
+      key.add(rs->depthBiasEnable);
+    key.add(rs->depthBiasConstantFactor);
+    key.add(rs->depthBiasClamp);
+    key.add(rs->depthBiasSlopeFactor);
+    key.add(rs->lineWidth);
+  }
+  if (key.present(info->pMultisampleState)) {
+    const auto *ms = info->pMultisampleState;
+    key.add(ms->rasterizationSamples);
+    key.add(ms->sampleShadingEnable);
+    key.add(ms->minSampleShading);
+    if (key.present(ms->pSampleMask))
+      key.add(ms->pSampleMask,
+              sizeof(VkSampleMask) * ((ms->rasterizationSamples + 31) / 32));
+    key.add(ms->alphaToCoverageEnable);
+    key.add(ms->alphaToOneEnable);
+  }
+  if (key.present(info->pDepthStencilState)) {
+    const auto *ds = info->pDepthStencilState;
+    if (!isDynamic(dynamic_depth_test))
+      key.add(ds->depthTestEnable);
+    if (!isDynamic(dynamic_depth_write))
+      key.add(ds->depthWriteEnable);
+    if (!isDynamic(dynamic_depth_compare_op))
+      key.add(ds->depthCompareOp);
+    key.add(ds->depthBoundsTestEnable);
+    key.add(ds->stencilTestEnable);
+    key.add(ds->front);
+    key.add(ds->back);
+    key.add(ds->minDepthBounds);
+    key.add(ds->maxDepthBounds);
+  }
+  if (key.present(info->pColorBlendState)) {
+    const auto *cb = info->pColorBlendState;
+    key.add(cb->logicOpEnable);
+    if (cb->logicOpEnable)
+      key.add(cb->logicOp);
+    key.add(cb->attachmentCount);
+    for (uint32_t i = 0; i < cb->attachmentCount; ++i)
+      key.add(cb->pAttachments[i]);
+    if (!isDynamic(VK_DYNAMIC_STATE_BLEND_CONSTANTS))
+      key.add(cb->blendConstants);
+  }
+  return bytes;
+}
+
+} // namespace circe::vk
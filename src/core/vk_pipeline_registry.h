@@ -0,0 +1,111 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_pipeline_registry.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_PIPELINE_REGISTRY_H
+#define CIRCE_VK_PIPELINE_REGISTRY_H
+
+#include "vk_pipeline.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace circe::vk {
+
+/// \brief Deduplicates graphics pipelines by their complete create state.
+/// GraphicsPipeline objects are used as descriptions: shader stages (module,
+/// entry point and specialization data), vertex input, input assembly,
+/// tessellation, viewport (ignored when dynamic), rasterization, multisample,
+/// depth stencil, color blend, dynamic states, layout, renderpass and subpass
+/// are serialized into a key. States made dynamic (see
+/// GraphicsPipeline::useExtendedDynamicState) are left out of the key.
+/// Descriptions with equal keys share the same
+/// VkPipeline, which is destroyed when its last reference goes away. Ex:
+///   auto pipeline = registry.acquire(material_description);
+///   cb.bind(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->handle());
+class PipelineRegistry final {
+public:
+  /// \brief Pipeline owned by its references
+  class SharedPipeline {
+  public:
+    SharedPipeline(const LogicalDevice *logical_device, VkPipeline vk_pipeline,
+                   size_t hash);
+    SharedPipeline(const SharedPipeline &other) = delete;
+    ~SharedPipeline();
+    ///\return VkPipeline
+    [[nodiscard]] VkPipeline handle() const;
+    ///\return size_t hash of the create state
+    [[nodiscard]] size_t hash() const;
+
+  private:
+    const LogicalDevice *logical_device_ = nullptr;
+    VkPipeline vk_pipeline_ = VK_NULL_HANDLE;
+    size_t hash_{0};
+  };
+  ///\param logical_device **[in]**
+  ///\param cache **[in | optional = nullptr]** used to create new pipelines
+  explicit PipelineRegistry(const LogicalDevice *logical_device,
+                            PipelineCache *cache = nullptr);
+  ///\brief Retrieves the pipeline matching the state of **description**,
+  /// creating it if no live pipeline has the same state. The description is
+  /// not modified and doesn't need to outlive the returned pipeline.
+  /// Pipelines are created outside the registry lock: threads acquiring the
+  /// same new state at once may both compile it, only the first one is kept.
+  ///\param description **[in]**
+  ///\return std::shared_ptr<SharedPipeline> nullptr on failure
+  std::shared_ptr<SharedPipeline> acquire(GraphicsPipeline &description);
+  ///\brief Computes the create state hash used as registry key
+  ///\param description **[in]**
+  ///\return size_t
+  static size_t stateHash(GraphicsPipeline &description);
+  ///\brief Removes entries of pipelines that are no longer referenced
+  void purge();
+  ///\return size_t number of live pipelines
+  [[nodiscard]] size_t pipelineCount() const;
+  ///\return uint64_t number of requests served by an existing pipeline
+  [[nodiscard]] uint64_t hitCount() const;
+  ///\return uint64_t number of pipelines created
+  [[nodiscard]] uint64_t missCount() const;
+
+private:
+  struct Entry {
+    std::vector<uint8_t> key;
+    std::weak_ptr<SharedPipeline> pipeline;
+  };
+  ///\param description **[in]**
+  ///\return std::vector<uint8_t> serialized create state
+  static std::vector<uint8_t> stateKey(GraphicsPipeline &description);
+
+  const LogicalDevice *logical_device_ = nullptr;
+  PipelineCache *cache_ = nullptr;
+  mutable std::mutex mutex_;
+  std::unordered_map<size_t, std::vector<Entry>> entries_;
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+} // namespace circe::vk
+
+#endif
@@ -100,6 +100,7 @@ void RenderEngine::recreateSwapchain() {
   if (record_command_buffer_callback)
     for (size_t i = 0; i < swapchain_image_views_.size(); ++i)
       record_command_buffer_callback(draw_command_buffers_[i], i);
+  outdated_command_buffers_.assign(draw_command_buffers_.size(), false);
 }
 
 RenderEngine::RenderEngine() = default;
@@ -233,6 +234,10 @@ std::vector<CommandBuffer> &RenderEngine::commandBuffers() {
   return draw_command_buffers_;
 }
 
+void RenderEngine::invalidateCommandBuffers() {
+  outdated_command_buffers_.assign(draw_command_buffers_.size(), true);
+}
+
 void RenderEngine::init() {
   recreateSwapchain();
   images_in_flight_.resize(swapchain_image_views_.size(), VK_NULL_HANDLE);
@@ -261,6 +266,15 @@ void RenderEngine::draw(VkQueue graphics_queue, VkQueue presentation_queue) {
   if (prepare_frame_callback)
     prepare_frame_callback(image_index);
 
+  // the image fence was waited above, so its command buffer is not in use
+  if (image_index < outdated_command_buffers_.size() &&
+      outdated_command_buffers_[image_index]) {
+    if (record_command_buffer_callback)
+      record_command_buffer_callback(draw_command_buffers_[image_index],
+                                     image_index);
+    outdated_command_buffers_[image_index] = false;
+  }
+
   VkSubmitInfo submitInfo = {};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -75,6 +75,11 @@ public:
   std::vector<CommandBuffer> &commandBuffers();
   void init();
   void draw(VkQueue graphics_queue, VkQueue presentation_queue);
+  /// Marks all draw command buffers as outdated (ex: a pipeline they use was
+  /// replaced). Each one is recorded again by record_command_buffer_callback
+  /// right before its next submission, once its previous submission is done,
+  /// so no frame waits for the device to be idle.
+  void invalidateCommandBuffers();
 
   std::function<void(uint32_t width, uint32_t height)> resize_callback;
   std::function<void(CommandBuffer &, uint32_t)> record_command_buffer_callback;
@@ -112,6 +117,7 @@ private:
   // command buffers
   std::unique_ptr<CommandPool> draw_command_pool_; //!< command pool used for draw command buffers
   std::vector<CommandBuffer> draw_command_buffers_; //!< command buffers used for rendering
+  std::vector<bool> outdated_command_buffers_; //!< need to be recorded again
   // synchronization
   std::vector<Semaphore> render_finished_semaphores_;
   std::vector<Semaphore> image_available_semaphores_;
@@ -0,0 +1,546 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_render_graph.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_render_graph.h"
+#include "logging.h"
+#include <algorithm>
+
+namespace circe::vk {
+
+namespace {
+
+VkImageUsageFlags imageUsageFlags(ImageUsage usage) {
+  switch (usage) {
+  case ImageUsage::TRANSFER_SRC:
+    return VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  case ImageUsage::TRANSFER_DST:
+    return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  case ImageUsage::SAMPLED_VERTEX:
+  case ImageUsage::SAMPLED_FRAGMENT:
+  case ImageUsage::SAMPLED_COMPUTE:
+    return VK_IMAGE_USAGE_SAMPLED_BIT;
+  case ImageUsage::STORAGE_READ_COMPUTE:
+  case ImageUsage::STORAGE_WRITE_COMPUTE:
+    return VK_IMAGE_USAGE_STORAGE_BIT;
+  case ImageUsage::COLOR_ATTACHMENT:
+    return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  case ImageUsage::DEPTH_STENCIL_ATTACHMENT:
+    return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+  case ImageUsage::DEPTH_STENCIL_READ:
+    return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+           VK_IMAGE_USAGE_SAMPLED_BIT;
+  case ImageUsage::PRESENT:
+    break;
+  }
+  return 0;
+}
+
+bool isAttachment(ImageUsage usage) {
+  return usage == ImageUsage::COLOR_ATTACHMENT ||
+         usage == ImageUsage::DEPTH_STENCIL_ATTACHMENT;
+}
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return alignment > 1 ? (value + alignment - 1) / alignment * alignment
+                       : value;
+}
+
+} // namespace
+
+RenderGraph::Pass::Pass(std::string name) : name_(std::move(name)) {}
+
+RenderGraph::Pass &RenderGraph::Pass::read(ResourceId resource,
+                                           ImageUsage usage) {
+  uses_.push_back({resource, usage, false});
+  return *this;
+}
+
+RenderGraph::Pass &RenderGraph::Pass::write(ResourceId resource,
+                                            ImageUsage usage) {
+  uses_.push_back({resource, usage, true});
+  if (isAttachment(usage))
+    attachments_.emplace_back(resource);
+  return *this;
+}
+
+RenderGraph::Pass &RenderGraph::Pass::setClearColor(ResourceId resource,
+                                                    float r, float g, float b,
+                                                    float a) {
+  VkClearValue v;
+  v.color.float32[0] = r;
+  v.color.float32[1] = g;
+  v.color.float32[2] = b;
+  v.color.float32[3] = a;
+  clear_values_[resource] = v;
+  return *this;
+}
+
+RenderGraph::Pass &RenderGraph::Pass::setClearDepthStencil(ResourceId resource,
+                                                           float depth,
+                                                           uint32_t stencil) {
+  VkClearValue v;
+  v.depthStencil.depth = depth;
+  v.depthStencil.stencil = stencil;
+  clear_values_[resource] = v;
+  return *this;
+}
+
+RenderGraph::Pass &
+RenderGraph::Pass::setRecordCallback(const RecordCallback &callback) {
+  record_callback_ = callback;
+  return *this;
+}
+
+const std::string &RenderGraph::Pass::name() const { return name_; }
+
+bool RenderGraph::Pass::culled() const { return culled_; }
+
+RenderPass *RenderGraph::Pass::renderpass() { return renderpass_.get(); }
+
+RenderGraph::RenderGraph(const LogicalDevice *logical_device)
+    : logical_device_(logical_device) {}
+
+RenderGraph::~RenderGraph() {
+  // views and framebuffers must go before the images
+  for (auto &pass : passes_)
+    pass->framebuffers_.clear();
+  imported_views_.clear();
+  for (auto &resource : resources_) {
+    resource.view.reset();
+    resource.image.reset();
+  }
+}
+
+RenderGraph::ResourceId
+RenderGraph::createImage(const std::string &name,
+                         const ImageDescription &description) {
+  Resource resource;
+  resource.name = name;
+  resource.description = description;
+  resources_.emplace_back(std::move(resource));
+  compiled_ = false;
+  return resources_.size() - 1;
+}
+
+RenderGraph::ResourceId RenderGraph::importImage(const std::string &name,
+                                                 const Image *image) {
+  Resource resource;
+  resource.name = name;
+  resource.imported = true;
+  resource.imported_image = image;
+  resources_.emplace_back(std::move(resource));
+  compiled_ = false;
+  return resources_.size() - 1;
+}
+
+void RenderGraph::setImportedImage(ResourceId resource, const Image *image) {
+  if (resource < resources_.size() && resources_[resource].imported)
+    resources_[resource].imported_image = image;
+}
+
+void RenderGraph::markOutput(ResourceId resource, ImageUsage final_usage) {
+  if (resource >= resources_.size())
+    return;
+  resources_[resource].output = true;
+  resources_[resource].final_usage = final_usage;
+  compiled_ = false;
+}
+
+RenderGraph::Pass &RenderGraph::addPass(const std::string &name) {
+  passes_.emplace_back(std::make_unique<Pass>(name));
+  compiled_ = false;
+  return *passes_.back();
+}
+
+bool RenderGraph::compile() {
+  for (auto &pass : passes_) {
+    for (auto &use : pass->uses_)
+      D_RETURN_FALSE_IF_NOT(use.resource < resources_.size(),
+                            "invalid resource in pass " + pass->name_);
+    pass->renderpass_.reset();
+    pass->framebuffers_.clear();
+  }
+  cull();
+  // compute lifetimes
+  for (auto &resource : resources_)
+    resource.live = false;
+  for (uint32_t p = 0; p < passes_.size(); ++p) {
+    if (passes_[p]->culled_)
+      continue;
+    for (auto &use : passes_[p]->uses_) {
+      auto &resource = resources_[use.resource];
+      if (!resource.live) {
+        resource.live = true;
+        resource.range.first_pass = p;
+      }
+      resource.range.last_pass = p;
+    }
+  }
+  D_RETURN_FALSE_IF_NOT(createTransientImages(),
+                        "could not create render graph transient images");
+  createRenderPasses();
+  compiled_ = true;
+  return true;
+}
+
+void RenderGraph::cull() {
+  std::vector<bool> needed(resources_.size(), false);
+  for (size_t r = 0; r < resources_.size(); ++r)
+    needed[r] = resources_[r].output;
+  // walk backwards: a pass is live if it writes something needed, and then
+  // everything it uses becomes needed
+  for (auto p = passes_.rbegin(); p != passes_.rend(); ++p) {
+    auto &pass = **p;
+    pass.culled_ = true;
+    for (auto &use : pass.uses_)
+      if (use.write && needed[use.resource])
+        pass.culled_ = false;
+    if (pass.culled_)
+      continue;
+    for (auto &use : pass.uses_)
+      needed[use.resource] = true;
+  }
+}
+
+VkDeviceSize
+RenderGraph::placeMemoryRanges(std::vector<MemoryRange> &ranges) {
+  std::vector<size_t> order(ranges.size());
+  for (size_t i = 0; i < ranges.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return ranges[a].size > ranges[b].size;
+  });
+  auto lifetimes_overlap = [](const MemoryRange &a, const MemoryRange &b) {
+    return a.first_pass <= b.last_pass && b.first_pass <= a.last_pass;
+  };
+  std::vector<size_t> placed;
+  VkDeviceSize total_size = 0;
+  for (auto i : order) {
+    auto &range = ranges[i];
+    // candidates are the beginning of the block and the end of every range
+    // that is alive at the same time
+    std::vector<VkDeviceSize> candidates = {0};
+    for (auto j : placed)
+      if (lifetimes_overlap(range, ranges[j]))
+        candidates.emplace_back(
+            alignUp(ranges[j].offset + ranges[j].size, range.alignment));
+    std::sort(candidates.begin(), candidates.end());
+    for (auto offset : candidates) {
+      bool fits = true;
+      for (auto j : placed)
+        if (lifetimes_overlap(range, ranges[j]) &&
+            offset < ranges[j].offset + ranges[j].size &&
+            ranges[j].offset < offset + range.size) {
+          fits = false;
+          break;
+        }
+      if (fits) {
+        range.offset = offset;
+        break;
+      }
+    }
+    total_size = std::max(total_size, range.offset + range.size);
+    placed.emplace_back(i);
+  }
+  return total_size;
+}
+
+bool RenderGraph::createTransientImages() {
+  transient_memory_.reset();
+  transient_memory_size_ = unaliased_memory_size_ = 0;
+  std::vector<ResourceId> transient;
+  std::vector<MemoryRange> ranges;
+  std::vector<VkMemoryRequirements> requirements;
+  uint32_t memory_type_bits = ~0u;
+  VkDeviceSize alignment = 1;
+  for (ResourceId r = 0; r < resources_.size(); ++r) {
+    auto &resource = resources_[r];
+    resource.view.reset();
+    resource.image.reset();
+    resource.memory.reset();
+    if (resource.imported || !resource.live)
+      continue;
+    VkImageUsageFlags usage = resource.description.usage;
+    for (auto &pass : passes_)
+      if (!pass->culled_)
+        for (auto &use : pass->uses_)
+          if (use.resource == r)
+            usage |= imageUsageFlags(use.usage);
+    const auto &d = resource.description;
+    resource.image = std::make_unique<Image>(
+        logical_device_, VK_IMAGE_TYPE_2D, d.format,
+        VkExtent3D{d.size.width, d.size.height, 1}, d.mip_levels,
+        d.array_layers, d.samples, usage, false);
+    D_RETURN_FALSE_IF_NOT(resource.image->good(),
+                          "could not create image " + resource.name);
+    VkMemoryRequirements memory_requirements{};
+    resource.image->memoryRequirements(memory_requirements);
+    resource.range.size = memory_requirements.size;
+    resource.range.alignment = memory_requirements.alignment;
+    unaliased_memory_size_ =
+        alignUp(unaliased_memory_size_, memory_requirements.alignment) +
+        memory_requirements.size;
+    memory_type_bits &= memory_requirements.memoryTypeBits;
+    alignment = std::max(alignment, memory_requirements.alignment);
+    transient.emplace_back(r);
+    ranges.emplace_back(resource.range);
+    requirements.emplace_back(memory_requirements);
+  }
+  if (transient.empty())
+    return true;
+  if (!memory_type_bits) {
+    // images can't share a memory type, each one gets its own allocation
+    INFO("render graph transient images can not be aliased.");
+    for (size_t i = 0; i < transient.size(); ++i) {
+      auto &resource = resources_[transient[i]];
+      resource.memory = std::make_unique<DeviceMemory>(
+          *resource.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+      RETURN_FALSE_IF_NOT(resource.memory->bind(*resource.image));
+      resource.range.offset = 0;
+      resource.alias_wait = {};
+    }
+    transient_memory_size_ = unaliased_memory_size_;
+    return true;
+  }
+  transient_memory_size_ = placeMemoryRanges(ranges);
+  transient_memory_ = std::make_unique<DeviceMemory>();
+  transient_memory_->setDevice(logical_device_);
+  VkMemoryRequirements block_requirements = {transient_memory_size_, alignment,
+                                             memory_type_bits};
+  D_RETURN_FALSE_IF_NOT(
+      transient_memory_->allocate(block_requirements,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+      "could not allocate render graph transient memory");
+  for (size_t i = 0; i < transient.size(); ++i) {
+    auto &resource = resources_[transient[i]];
+    resource.range = ranges[i];
+    RETURN_FALSE_IF_NOT(
+        transient_memory_->bind(*resource.image, resource.range.offset));
+  }
+  // Before its first use, a resource must wait for the last accesses of all
+  // resources that used the same memory before (including itself in the
+  // previous execution of the graph).
+  for (size_t i = 0; i < transient.size(); ++i) {
+    auto &resource = resources_[transient[i]];
+    resource.alias_wait = {};
+    for (size_t j = 0; j < transient.size(); ++j) {
+      const auto &other = ranges[j];
+      if (j != i && (other.offset >= ranges[i].offset + ranges[i].size ||
+                     ranges[i].offset >= other.offset + other.size))
+        continue;
+      for (auto &use : passes_[other.last_pass]->uses_)
+        if (use.resource == transient[j]) {
+          auto access = ImageState::access(use.usage);
+          resource.alias_wait.access |= access.access;
+          resource.alias_wait.stages |= access.stages;
+        }
+    }
+  }
+  return true;
+}
+
+void RenderGraph::createRenderPasses() {
+  for (uint32_t p = 0; p < passes_.size(); ++p) {
+    auto &pass = *passes_[p];
+    if (pass.culled_ || pass.attachments_.empty())
+      continue;
+    pass.renderpass_ = std::make_unique<RenderPass>(logical_device_);
+    auto &subpass = pass.renderpass_->newSubpassDescription();
+    for (auto &use : pass.uses_) {
+      if (!use.write || !isAttachment(use.usage))
+        continue;
+      auto &resource = resources_[use.resource];
+      const Image *image = resourceImage(resource);
+      VkFormat format =
+          image ? image->format() : resource.description.format;
+      VkSampleCountFlagBits samples = resource.imported
+                                          ? VK_SAMPLE_COUNT_1_BIT
+                                          : resource.description.samples;
+      if (image) {
+        pass.extent_.width = image->size().width;
+        pass.extent_.height = image->size().height;
+      }
+      // contents are loaded only if someone wrote them before
+      bool written_before = resource.imported;
+      for (uint32_t q = 0; q < p && !written_before; ++q)
+        if (!passes_[q]->culled_)
+          for (auto &other : passes_[q]->uses_)
+            if (other.resource == use.resource && other.write)
+              written_before = true;
+      // contents are stored only if someone needs them later
+      bool used_after = resource.output;
+      for (uint32_t q = p + 1; q < passes_.size() && !used_after; ++q)
+        if (!passes_[q]->culled_)
+          for (auto &other : passes_[q]->uses_)
+            if (other.resource == use.resource)
+              used_after = true;
+      VkAttachmentLoadOp load_op =
+          pass.clear_values_.count(use.resource)
+              ? VK_ATTACHMENT_LOAD_OP_CLEAR
+              : (written_before ? VK_ATTACHMENT_LOAD_OP_LOAD
+                                : VK_ATTACHMENT_LOAD_OP_DONT_CARE);
+      VkAttachmentStoreOp store_op = used_after
+                                         ? VK_ATTACHMENT_STORE_OP_STORE
+                                         : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+      // layouts are handled by the barriers recorded before the renderpass
+      VkImageLayout layout = ImageState::access(use.usage).layout;
+      bool depth = use.usage == ImageUsage::DEPTH_STENCIL_ATTACHMENT;
+      uint32_t attachment = pass.renderpass_->addAttachment(
+          format, samples, load_op, store_op,
+          depth ? load_op : VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+          depth ? store_op : VK_ATTACHMENT_STORE_OP_DONT_CARE, layout, layout);
+      if (depth)
+        subpass.setDepthStencilAttachmentRef(attachment, layout);
+      else
+        subpass.addColorAttachmentRef(attachment, layout);
+    }
+  }
+}
+
+const Image *RenderGraph::resourceImage(const Resource &resource) const {
+  return resource.imported ? resource.imported_image : resource.image.get();
+}
+
+const Image::View *RenderGraph::resourceView(Resource &resource) {
+  const Image *image = resourceImage(resource);
+  if (!image)
+    return nullptr;
+  if (!resource.imported) {
+    if (!resource.view)
+      resource.view = std::make_unique<Image::View>(
+          image, VK_IMAGE_VIEW_TYPE_2D, image->format(), image->aspectMask());
+    return resource.view.get();
+  }
+  auto &view = imported_views_[image->handle()];
+  if (!view)
+    view = std::make_unique<Image::View>(image, VK_IMAGE_VIEW_TYPE_2D,
+                                         image->format(), image->aspectMask());
+  return view.get();
+}
+
+void RenderGraph::execute(const CommandBuffer &command_buffer) {
+  if (!compiled_ && !compile())
+    return;
+  for (uint32_t p = 0; p < passes_.size(); ++p) {
+    auto &pass = *passes_[p];
+    if (pass.culled_)
+      continue;
+    PipelineBarrier barriers;
+    for (auto &use : pass.uses_) {
+      auto &resource = resources_[use.resource];
+      const Image *image = resourceImage(resource);
+      if (!image)
+        continue;
+      if (!resource.imported && resource.range.first_pass == p) {
+        // the memory may hold another resource: discard the contents, but
+        // wait for the previous accesses
+        ImageState::Access discard = resource.alias_wait;
+        discard.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image->state().set(discard);
+      }
+      barriers.add(*image, use.usage);
+    }
+    barriers.flush(command_buffer);
+    if (!pass.renderpass_) {
+      if (pass.record_callback_)
+        pass.record_callback_(command_buffer);
+      continue;
+    }
+    // framebuffers are cached by attachment views, so imported images (ex:
+    // swapchain images) get one framebuffer each
+    std::vector<VkImageView> views;
+    std::vector<const Image::View *> attachment_views;
+    for (auto &use : pass.uses_)
+      if (use.write && isAttachment(use.usage)) {
+        auto *view = resourceView(resources_[use.resource]);
+        if (!view)
+          return;
+        const Image *image = resourceImage(resources_[use.resource]);
+        pass.extent_.width = image->size().width;
+        pass.extent_.height = image->size().height;
+        views.emplace_back(view->handle());
+        attachment_views.emplace_back(view);
+      }
+    auto &framebuffer = pass.framebuffers_[views];
+    if (!framebuffer) {
+      framebuffer = std::make_unique<Framebuffer>(
+          logical_device_, pass.renderpass_.get(), pass.extent_.width,
+          pass.extent_.height, 1);
+      for (auto *view : attachment_views)
+        framebuffer->addAttachment(*view);
+    }
+    RenderPassBeginInfo info(pass.renderpass_.get(), framebuffer.get());
+    for (auto &use : pass.uses_)
+      if (use.write && isAttachment(use.usage)) {
+        // clear values are indexed by attachment
+        auto it = pass.clear_values_.find(use.resource);
+        VkClearValue v = it != pass.clear_values_.end() ? it->second
+                                                        : VkClearValue{};
+        if (use.usage == ImageUsage::DEPTH_STENCIL_ATTACHMENT)
+          info.addClearDepthStencilValue(v.depthStencil.depth,
+                                         v.depthStencil.stencil);
+        else
+          info.addClearColorValuef(v.color.float32[0], v.color.float32[1],
+                                   v.color.float32[2], v.color.float32[3]);
+      }
+    command_buffer.beginRenderPass(info, VK_SUBPASS_CONTENTS_INLINE);
+    if (pass.record_callback_)
+      pass.record_callback_(command_buffer);
+    command_buffer.endRenderPass();
+  }
+  // leave outputs ready for their consumers
+  PipelineBarrier barriers;
+  for (auto &resource : resources_)
+    if (resource.output && resource.live && resourceImage(resource))
+      barriers.add(*resourceImage(resource), resource.final_usage);
+  barriers.flush(command_buffer);
+}
+
+void RenderGraph::invalidateImportedImages() {
+  for (auto &pass : passes_)
+    pass->framebuffers_.clear();
+  imported_views_.clear();
+}
+
+const Image *RenderGraph::image(ResourceId resource) const {
+  return resource < resources_.size() ? resourceImage(resources_[resource])
+                                      : nullptr;
+}
+
+uint32_t RenderGraph::culledPassCount() const {
+  uint32_t count = 0;
+  for (auto &pass : passes_)
+    if (pass->culled_)
+      count++;
+  return count;
+}
+
+VkDeviceSize RenderGraph::transientMemorySize(bool aliased) const {
+  return aliased ? transient_memory_size_ : unaliased_memory_size_;
+}
+
+} // namespace circe::vk
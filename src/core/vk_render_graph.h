@@ -0,0 +1,221 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_render_graph.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_RENDER_GRAPH_H
+#define CIRCE_VK_RENDER_GRAPH_H
+
+#include "vk_command_buffer.h"
+#include "vk_device_memory.h"
+#include "vk_renderpass.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace circe::vk {
+
+/// A render graph (or frame graph) describes the work of a frame as a list of
+/// passes that declare which images they read and write. From these
+/// declarations the graph:
+/// - culls passes that do not contribute to the graph outputs;
+/// - creates the renderpasses and framebuffers of passes that render into
+///   attachments (load/store operations are deduced from the other passes);
+/// - records the barriers and layout transitions required between passes
+///   (through the image state tracker);
+/// - creates the transient images owned by the graph and aliases their memory
+///   when their lifetimes do not overlap.
+/// Usage:
+///   RenderGraph graph(device);
+///   auto color = graph.createImage("color", {format, extent});
+///   auto backbuffer = graph.importImage("backbuffer", swapchain_image);
+///   graph.addPass("scene").write(color, ImageUsage::COLOR_ATTACHMENT)
+///        .setClearColor(color, 0, 0, 0, 1).setRecordCallback(...);
+///   graph.addPass("post").read(color, ImageUsage::SAMPLED_FRAGMENT)
+///        .write(backbuffer, ImageUsage::COLOR_ATTACHMENT)...;
+///   graph.markOutput(backbuffer, ImageUsage::PRESENT);
+///   graph.compile();
+///   graph.execute(command_buffer);
+/// Passes are executed in the order they were added.
+class RenderGraph {
+public:
+  using ResourceId = uint32_t;
+  using RecordCallback = std::function<void(const CommandBuffer &)>;
+  /// Description of an image created and owned by the graph
+  struct ImageDescription {
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    VkExtent2D size{};
+    VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+    uint32_t mip_levels{1};
+    uint32_t array_layers{1};
+    /// extra usage flags, flags implied by the declared usages are added
+    /// automatically
+    VkImageUsageFlags usage{0};
+  };
+  /// Memory block of a transient resource and its lifetime in the graph
+  struct MemoryRange {
+    VkDeviceSize offset{0};
+    VkDeviceSize size{0};
+    VkDeviceSize alignment{1};
+    uint32_t first_pass{0}; //!< first (live) pass using the resource
+    uint32_t last_pass{0};  //!< last (live) pass using the resource
+  };
+  class Pass {
+  public:
+    explicit Pass(std::string name);
+    ///\brief Declares that the pass reads the resource
+    ///\param resource **[in]**
+    ///\param usage **[in]** ex: SAMPLED_FRAGMENT, TRANSFER_SRC
+    ///\return Pass&
+    Pass &read(ResourceId resource, ImageUsage usage);
+    ///\brief Declares that the pass writes the resource. COLOR_ATTACHMENT and
+    /// DEPTH_STENCIL_ATTACHMENT usages become attachments of the pass
+    /// renderpass.
+    ///\param resource **[in]**
+    ///\param usage **[in]**
+    ///\return Pass&
+    Pass &write(ResourceId resource, ImageUsage usage);
+    ///\brief Clears the attachment when the renderpass begins
+    Pass &setClearColor(ResourceId resource, float r, float g, float b,
+                        float a);
+    ///\brief Clears the attachment when the renderpass begins
+    Pass &setClearDepthStencil(ResourceId resource, float depth,
+                               uint32_t stencil = 0);
+    ///\param callback **[in]** records the commands of the pass (inside the
+    /// renderpass, if the pass has attachments)
+    Pass &setRecordCallback(const RecordCallback &callback);
+    [[nodiscard]] const std::string &name() const;
+    [[nodiscard]] bool culled() const;
+    ///\return RenderPass* renderpass created for the pass attachments
+    /// (nullptr if the pass has no attachments or was not compiled yet)
+    [[nodiscard]] RenderPass *renderpass();
+
+  private:
+    friend class RenderGraph;
+    struct Use {
+      ResourceId resource;
+      ImageUsage usage;
+      bool write;
+    };
+    std::string name_;
+    std::vector<Use> uses_;
+    std::vector<ResourceId> attachments_;
+    std::unordered_map<ResourceId, VkClearValue> clear_values_;
+    RecordCallback record_callback_;
+    bool culled_ = false;
+    VkExtent2D extent_{};
+    std::unique_ptr<RenderPass> renderpass_;
+    std::map<std::vector<VkImageView>, std::unique_ptr<Framebuffer>>
+        framebuffers_;
+  };
+
+  explicit RenderGraph(const LogicalDevice *logical_device);
+  ~RenderGraph();
+  ///\brief Creates an image owned by the graph (transient), its memory may be
+  /// shared with other transient images.
+  ///\param name **[in]**
+  ///\param description **[in]**
+  ///\return ResourceId
+  ResourceId createImage(const std::string &name,
+                         const ImageDescription &description);
+  ///\brief Registers an image owned by someone else (ex: swapchain images)
+  ///\param name **[in]**
+  ///\param image **[in]** can be changed later with setImportedImage
+  ///\return ResourceId
+  ResourceId importImage(const std::string &name, const Image *image);
+  ///\param resource **[in]** imported resource
+  ///\param image **[in]**
+  void setImportedImage(ResourceId resource, const Image *image);
+  ///\brief Marks the resource as a result of the graph. Passes that do not
+  /// contribute (directly or indirectly) to an output are culled.
+  ///\param resource **[in]**
+  ///\param final_usage **[in]** usage the resource is transitioned to after
+  /// the graph execution (ex: PRESENT)
+  void markOutput(ResourceId resource, ImageUsage final_usage);
+  ///\param name **[in]**
+  ///\return Pass&
+  Pass &addPass(const std::string &name);
+  ///\brief Culls passes, computes resource lifetimes, creates and aliases
+  /// transient images and creates renderpasses.
+  ///\return bool true if success
+  bool compile();
+  ///\brief Records all live passes and the barriers between them.
+  ///\param command_buffer **[in]**
+  void execute(const CommandBuffer &command_buffer);
+  ///\brief Destroys cached views and framebuffers of imported images (ex:
+  /// after swapchain recreation).
+  void invalidateImportedImages();
+  ///\param resource **[in]**
+  ///\return const Image*
+  [[nodiscard]] const Image *image(ResourceId resource) const;
+  ///\return uint32_t number of passes removed by culling
+  [[nodiscard]] uint32_t culledPassCount() const;
+  ///\param aliased **[in]** true to get the actual allocated size, false to
+  /// get the size required without memory aliasing
+  ///\return VkDeviceSize peak memory of transient resources
+  [[nodiscard]] VkDeviceSize transientMemorySize(bool aliased = true) const;
+  ///\brief Places memory ranges so ranges with overlapping lifetimes do not
+  /// overlap in memory (greedy, biggest ranges first).
+  ///\param ranges **[in/out]** receive their offsets
+  ///\return VkDeviceSize total size needed by the placement
+  static VkDeviceSize placeMemoryRanges(std::vector<MemoryRange> &ranges);
+
+private:
+  struct Resource {
+    std::string name;
+    bool imported = false;
+    ImageDescription description;
+    const Image *imported_image = nullptr;
+    std::unique_ptr<Image> image;
+    std::unique_ptr<Image::View> view;
+    std::unique_ptr<DeviceMemory> memory; //!< only if not aliased
+    MemoryRange range;
+    bool output = false;
+    ImageUsage final_usage = ImageUsage::PRESENT;
+    bool live = false;
+    /// accesses of previous owners of the memory the resource must wait for
+    ImageState::Access alias_wait;
+  };
+  [[nodiscard]] const Image *resourceImage(const Resource &resource) const;
+  const Image::View *resourceView(Resource &resource);
+  void cull();
+  bool createTransientImages();
+  void createRenderPasses();
+
+  const LogicalDevice *logical_device_ = nullptr;
+  std::vector<Resource> resources_;
+  std::vector<std::unique_ptr<Pass>> passes_;
+  std::unordered_map<VkImage, std::unique_ptr<Image::View>> imported_views_;
+  std::unique_ptr<DeviceMemory> transient_memory_;
+  VkDeviceSize transient_memory_size_ = 0;
+  VkDeviceSize unaliased_memory_size_ = 0;
+  bool compiled_ = false;
+};
+
+} // namespace circe::vk
+
+#endif
@@ -66,6 +66,7 @@ Sampler::Sampler(const LogicalDevice *logical_device,
   info.maxLod = max_lod;
   info.borderColor = border_color;
   info.unnormalizedCoordinates = unnormalized_coordinates;
+  info_ = info;
 
   CHECK_VULKAN(vkCreateSampler(logical_device_->handle(),
                                &info,
@@ -73,6 +74,16 @@ Sampler::Sampler(const LogicalDevice *logical_device,
                                &vk_sampler_));
 }
 
+Sampler::Sampler(const LogicalDevice *logical_device,
+                 const VkSamplerCreateInfo &info)
+    : logical_device_(logical_device), info_(info) {
+  CHECK_VULKAN(vkCreateSampler(logical_device_->handle(),
+                               &info,
+                               nullptr,
+                               &vk_sampler_));
+  info_.pNext = nullptr;
+}
+
 Sampler::~Sampler() {
   if (vk_sampler_ != VK_NULL_HANDLE)
     vkDestroySampler(logical_device_->handle(), vk_sampler_, nullptr);
@@ -82,4 +93,8 @@ VkSampler Sampler::handle() const {
   return vk_sampler_;
 }
 
+const VkSamplerCreateInfo &Sampler::info() const {
+  return info_;
+}
+
 } // circe::vk namespace
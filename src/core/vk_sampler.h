@@ -50,12 +50,19 @@ public:
           float max_lod,
           VkBorderColor border_color,
           VkBool32 unnormalized_coordinates);
+  ///\param logical_device **[in]**
+  ///\param info **[in]** full sampler description
+  Sampler(const LogicalDevice *logical_device, const VkSamplerCreateInfo &info);
   ~Sampler();
   [[nodiscard]] VkSampler handle() const;
+  ///\return const VkSamplerCreateInfo& description the sampler was created
+  /// with (pNext is not kept)
+  [[nodiscard]] const VkSamplerCreateInfo &info() const;
 
 private:
   const LogicalDevice *logical_device_ = nullptr;
   VkSampler vk_sampler_ = VK_NULL_HANDLE;
+  VkSamplerCreateInfo info_{};
 };
 
 } // circe::vk namespace
@@ -0,0 +1,136 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_sampler_cache.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_sampler_cache.h"
+#include "logging.h"
+#include "vk_hash.h"
+#include <iostream>
+
+namespace circe::vk {
+
+double SamplerCache::Statistics::hitRate() const {
+  return requests ? static_cast<double>(hits) / requests : 0.0;
+}
+
+bool SamplerCache::Key::operator==(const Key &other) const {
+  const auto &a = info;
+  const auto &b = other.info;
+  return a.flags == b.flags && a.magFilter == b.magFilter &&
+         a.minFilter == b.minFilter && a.mipmapMode == b.mipmapMode &&
+         a.addressModeU == b.addressModeU &&
+         a.addressModeV == b.addressModeV &&
+         a.addressModeW == b.addressModeW && a.mipLodBias == b.mipLodBias &&
+         a.anisotropyEnable == b.anisotropyEnable &&
+         a.maxAnisotropy == b.maxAnisotropy &&
+         a.compareEnable == b.compareEnable && a.compareOp == b.compareOp &&
+         a.minLod == b.minLod && a.maxLod == b.maxLod &&
+         a.borderColor == b.borderColor &&
+         a.unnormalizedCoordinates == b.unnormalizedCoordinates;
+}
+
+size_t SamplerCache::KeyHash::operator()(const Key &key) const {
+  const auto &info = key.info;
+  size_t seed = 0;
+  hashCombine(seed, info.flags, info.magFilter, info.minFilter,
+              info.mipmapMode, info.addressModeU, info.addressModeV,
+              info.addressModeW, info.mipLodBias, info.anisotropyEnable,
+              info.maxAnisotropy, info.compareEnable, info.compareOp,
+              info.minLod, info.maxLod, info.borderColor,
+              info.unnormalizedCoordinates);
+  return seed;
+}
+
+SamplerCache::SamplerCache(const LogicalDevice *logical_device)
+    : logical_device_(logical_device) {}
+
+std::shared_ptr<Sampler>
+SamplerCache::sampler(const VkSamplerCreateInfo &info) {
+  if (info.pNext) {
+    INFO("sampler cache does not support sampler extension structures");
+    return nullptr;
+  }
+  requests_++;
+  Key key{info};
+  auto it = samplers_.find(key);
+  if (it != samplers_.end()) {
+    hits_++;
+    return it->second;
+  }
+  auto sampler = std::make_shared<Sampler>(logical_device_, info);
+  if (sampler->handle() == VK_NULL_HANDLE)
+    return nullptr;
+  samplers_[key] = sampler;
+  return sampler;
+}
+
+size_t SamplerCache::purge() {
+  size_t count = 0;
+  for (auto it = samplers_.begin(); it != samplers_.end();)
+    if (it->second.use_count() == 1) {
+      it = samplers_.erase(it);
+      count++;
+    } else
+      ++it;
+  return count;
+}
+
+SamplerCache::Statistics SamplerCache::statistics() const {
+  Statistics statistics;
+  statistics.requests = requests_;
+  statistics.hits = hits_;
+  statistics.samplers = samplers_.size();
+  statistics.max_samplers = logical_device_->physicalDevice()
+                                ->properties()
+                                .limits.maxSamplerAllocationCount;
+  return statistics;
+}
+
+VkSamplerCreateInfo SamplerCache::linear(VkSamplerAddressMode address_mode) {
+  VkSamplerCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  info.magFilter = VK_FILTER_LINEAR;
+  info.minFilter = VK_FILTER_LINEAR;
+  info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+  info.addressModeU = address_mode;
+  info.addressModeV = address_mode;
+  info.addressModeW = address_mode;
+  info.maxAnisotropy = 1.f;
+  info.compareOp = VK_COMPARE_OP_ALWAYS;
+  info.maxLod = VK_LOD_CLAMP_NONE;
+  info.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+  return info;
+}
+
+VkSamplerCreateInfo SamplerCache::nearest(VkSamplerAddressMode address_mode) {
+  VkSamplerCreateInfo info = linear(address_mode);
+  info.magFilter = VK_FILTER_NEAREST;
+  info.minFilter = VK_FILTER_NEAREST;
+  info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  return info;
+}
+
+} // namespace circe::vk
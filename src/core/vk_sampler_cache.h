@@ -0,0 +1,95 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_sampler_cache.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_SAMPLER_CACHE_H
+#define CIRCE_VK_SAMPLER_CACHE_H
+
+#include "vk_sampler.h"
+#include <memory>
+#include <unordered_map>
+
+namespace circe::vk {
+
+/// \brief Deduplicates samplers by their full description. Identical
+/// requests share one sampler, which matters because devices limit the
+/// number of samplers alive at once (maxSamplerAllocationCount, as low as
+/// 4000) and materials tend to ask for the same few combinations.
+/// Extension structures (pNext) are not supported.
+/// Usage:
+///   SamplerCache samplers(device);
+///   auto info = SamplerCache::linear(VK_SAMPLER_ADDRESS_MODE_REPEAT);
+///   info.anisotropyEnable = VK_TRUE;
+///   info.maxAnisotropy = 8.f;
+///   std::shared_ptr<Sampler> sampler = samplers.sampler(info);
+class SamplerCache final {
+public:
+  struct Statistics {
+    uint64_t requests{0}; //!< calls to sampler()
+    uint64_t hits{0};     //!< requests served by an existing sampler
+    size_t samplers{0};   //!< distinct samplers alive in the cache
+    uint32_t max_samplers{0}; //!< maxSamplerAllocationCount of the device
+    ///\return double hits / requests
+    [[nodiscard]] double hitRate() const;
+  };
+  ///\param logical_device **[in]**
+  explicit SamplerCache(const LogicalDevice *logical_device);
+  ///\param info **[in]** sampler description (pNext must be null)
+  ///\return std::shared_ptr<Sampler> shared sampler, nullptr on failure
+  std::shared_ptr<Sampler> sampler(const VkSamplerCreateInfo &info);
+  ///\brief Destroys the samplers no longer referenced outside the cache
+  ///\return size_t number of destroyed samplers
+  size_t purge();
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+  ///\brief Trilinear sampler description covering the whole mip chain
+  ///\param address_mode **[in]** used for u, v and w
+  ///\return VkSamplerCreateInfo
+  static VkSamplerCreateInfo linear(VkSamplerAddressMode address_mode);
+  ///\brief Nearest (texel and level) sampler description covering the whole
+  /// mip chain
+  ///\param address_mode **[in]** used for u, v and w
+  ///\return VkSamplerCreateInfo
+  static VkSamplerCreateInfo nearest(VkSamplerAddressMode address_mode);
+
+private:
+  struct Key {
+    VkSamplerCreateInfo info{};
+    bool operator==(const Key &other) const;
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  const LogicalDevice *logical_device_ = nullptr;
+  std::unordered_map<Key, std::shared_ptr<Sampler>, KeyHash> samplers_;
+  uint64_t requests_{0};
+  uint64_t hits_{0};
+};
+
+} // namespace circe::vk
+
+#endif
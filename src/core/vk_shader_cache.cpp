@@ -0,0 +1,210 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_shader_cache.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_shader_cache.h"
+#include "logging.h"
+#include "vk_hash.h"
+#include "vk_mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+namespace circe::vk {
+
+namespace {
+
+std::string normalizedPath(const std::string &filename) {
+  return std::filesystem::path(filename).lexically_normal().string();
+}
+
+} // namespace
+
+ShaderModuleCache::ShaderModuleCache(const LogicalDevice *logical_device)
+    : logical_device_(logical_device) {}
+
+ShaderModuleCache::~ShaderModuleCache() = default;
+
+std::shared_ptr<ShaderModule>
+ShaderModuleCache::load(const std::string &filename) {
+  MappedFile file(filename);
+  if (!file.good()) {
+    INFO("Could not read shader file: " + filename);
+    return nullptr;
+  }
+  auto module = create(file.data(), file.size());
+  if (module) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    files_[normalizedPath(filename)] = module;
+  }
+  return module;
+}
+
+std::shared_ptr<ShaderModule> ShaderModuleCache::create(const void *code,
+                                                        size_t size) {
+  if (!logical_device_ || !code || !size)
+    return nullptr;
+  size_t hash = hashBytes(code, size);
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (auto module = find(hash, code, size)) {
+      hits_++;
+      return module;
+    }
+  }
+  // modules are created outside the lock, so threads loading different
+  // files don't serialize on the driver
+  auto module = std::make_shared<ShaderModule>(logical_device_, code, size);
+  if (module->handle() == VK_NULL_HANDLE)
+    return nullptr;
+  std::lock_guard<std::mutex> guard(mutex_);
+  // another thread may have created the same code in the meantime
+  if (auto existing = find(hash, code, size)) {
+    hits_++;
+    return existing;
+  }
+  auto *bytes = reinterpret_cast<const uint8_t *>(code);
+  modules_[hash].push_back({std::vector<uint8_t>(bytes, bytes + size), module});
+  return module;
+}
+
+size_t ShaderModuleCache::loadDirectory(const std::string &directory,
+                                        const std::string &extension,
+                                        uint32_t thread_count) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::string> filenames;
+  std::error_code error;
+  for (std::filesystem::recursive_directory_iterator it(directory, error), end;
+       !error && it != end; it.increment(error))
+    if (it->is_regular_file() && it->path().extension() == extension)
+      filenames.emplace_back(it->path().string());
+  if (error) {
+    INFO("Could not list shader directory: " + directory);
+    return 0;
+  }
+  if (!thread_count)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  thread_count = std::min<uint32_t>(thread_count, filenames.size());
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> loaded{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < filenames.size(); i = next++)
+      if (load(filenames[i]))
+        loaded++;
+  };
+  std::vector<std::thread> threads;
+  for (uint32_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::lock_guard<std::mutex> guard(mutex_);
+  startup_time_ = elapsed.count();
+  return loaded;
+}
+
+std::shared_ptr<ShaderModule>
+ShaderModuleCache::get(const std::string &filename) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = files_.find(normalizedPath(filename));
+  if (it == files_.end())
+    return nullptr;
+  return it->second;
+}
+
+void ShaderModuleCache::purge() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  // besides its modules_ entry, a module is referenced by each file entry
+  // pointing to it; anything above that is an outside reference
+  std::unordered_map<const ShaderModule *, long> file_references;
+  for (const auto &file : files_)
+    file_references[file.second.get()]++;
+  std::unordered_map<const ShaderModule *, bool> released;
+  for (auto it = modules_.begin(); it != modules_.end();) {
+    auto &entries = it->second;
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&](const Entry &entry) {
+                                   auto *module = entry.module.get();
+                                   if (entry.module.use_count() >
+                                       1 + file_references[module])
+                                     return false;
+                                   released[module] = true;
+                                   return true;
+                                 }),
+                  entries.end());
+    if (entries.empty())
+      it = modules_.erase(it);
+    else
+      ++it;
+  }
+  for (auto it = files_.begin(); it != files_.end();)
+    if (released.count(it->second.get()))
+      it = files_.erase(it);
+    else
+      ++it;
+}
+
+size_t ShaderModuleCache::moduleCount() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  size_t count = 0;
+  for (const auto &bucket : modules_)
+    count += bucket.second.size();
+  return count;
+}
+
+ShaderModuleCache::Statistics ShaderModuleCache::statistics() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  Statistics statistics;
+  statistics.files = files_.size();
+  for (const auto &bucket : modules_)
+    for (const auto &entry : bucket.second) {
+      statistics.modules++;
+      statistics.bytes += entry.code.size();
+    }
+  statistics.hits = hits_;
+  statistics.startup_time = startup_time_;
+  return statistics;
+}
+
+std::shared_ptr<ShaderModule>
+ShaderModuleCache::find(size_t hash, const void *code, size_t size) const {
+  auto it = modules_.find(hash);
+  if (it == modules_.end())
+    return nullptr;
+  for (const auto &entry : it->second)
+    // hashes may collide, only equal bytes share a module
+    if (entry.code.size() == size &&
+        !std::memcmp(entry.code.data(), code, size))
+      return entry.module;
+  return nullptr;
+}
+
+} // namespace circe::vk
@@ -0,0 +1,112 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_shader_cache.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_SHADER_CACHE_H
+#define CIRCE_VK_SHADER_CACHE_H
+
+#include "vk_shader_module.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace circe::vk {
+
+/// \brief Shares shader modules by SPIR-V content. Files are read through a
+/// memory mapping and hashed in place; code equal (same bytes) to an
+/// already loaded module maps to the same VkShaderModule, no matter the file
+/// it came from. Whole shader directories can be loaded at startup by a pool
+/// of threads. Ex:
+///   ShaderModuleCache shaders(&device);
+///   shaders.loadDirectory(SHADERS_PATH);
+///   auto vert = shaders.load(std::string(SHADERS_PATH) + "/vert.spv");
+class ShaderModuleCache final {
+public:
+  struct Statistics {
+    size_t files{0};        //!< distinct file paths loaded
+    size_t modules{0};      //!< live VkShaderModule objects
+    size_t bytes{0};        //!< SPIR-V bytes of live modules
+    uint64_t hits{0};       //!< requests served by an existing module
+    double startup_time{0}; //!< last loadDirectory duration (ms)
+  };
+  ///\param logical_device **[in]**
+  explicit ShaderModuleCache(const LogicalDevice *logical_device);
+  ShaderModuleCache(const ShaderModuleCache &other) = delete;
+  ~ShaderModuleCache();
+  ///\brief Retrieves the module of a SPIR-V file, creating it if its content
+  /// was not seen before. Thread safe.
+  ///\param filename **[in]**
+  ///\return std::shared_ptr<ShaderModule> nullptr on failure
+  std::shared_ptr<ShaderModule> load(const std::string &filename);
+  ///\brief Retrieves the module of the given SPIR-V code. Thread safe.
+  ///\param code **[in]**
+  ///\param size **[in]** code size in bytes
+  ///\return std::shared_ptr<ShaderModule> nullptr on failure
+  std::shared_ptr<ShaderModule> create(const void *code, size_t size);
+  ///\brief Loads every file with the given extension under **directory**
+  /// (recursively), creating modules in parallel.
+  ///\param directory **[in]**
+  ///\param extension **[in | optional = ".spv"]**
+  ///\param thread_count **[in | optional = 0]** 0 uses hardware concurrency
+  ///\return size_t number of files successfully loaded
+  size_t loadDirectory(const std::string &directory,
+                       const std::string &extension = ".spv",
+                       uint32_t thread_count = 0);
+  ///\brief Retrieves a module previously loaded from **filename**
+  ///\param filename **[in]**
+  ///\return std::shared_ptr<ShaderModule> nullptr if never loaded
+  std::shared_ptr<ShaderModule> get(const std::string &filename) const;
+  ///\brief Releases modules not referenced outside the cache
+  void purge();
+  ///\return size_t number of live modules
+  [[nodiscard]] size_t moduleCount() const;
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+
+private:
+  struct Entry {
+    std::vector<uint8_t> code; //!< compared on hash hits
+    std::shared_ptr<ShaderModule> module;
+  };
+  ///\param hash **[in]** content hash
+  ///\param code **[in]** content
+  ///\param size **[in]** content size in bytes
+  ///\return std::shared_ptr<ShaderModule> nullptr if not cached
+  std::shared_ptr<ShaderModule> find(size_t hash, const void *code,
+                                     size_t size) const;
+
+  const LogicalDevice *logical_device_ = nullptr;
+  mutable std::mutex mutex_;
+  std::unordered_map<size_t, std::vector<Entry>> modules_;
+  std::unordered_map<std::string, std::shared_ptr<ShaderModule>> files_;
+  uint64_t hits_{0};
+  double startup_time_{0};
+};
+
+} // namespace circe::vk
+
+#endif
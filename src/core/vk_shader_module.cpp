@@ -26,66 +26,31 @@
 ///\brief
 
 #include "vk_shader_module.h"
+#include "vk_mapped_file.h"
 #include "vulkan_debug.h"
-#include <fstream>
 
 namespace circe {
 
 namespace vk {
 
-bool readFile(const std::string &filename, std::vector<char> &buffer) {
-  std::ifstream file(filename, std::ios::ate | std::ios::binary);
-
-  if (!file.is_open())
-    return false;
-
-  size_t fileSize = (size_t) file.tellg();
-  buffer.resize(fileSize);
-
-  file.seekg(0);
-  file.read(buffer.data(), fileSize);
-
-  file.close();
-  return true;
-}
-
 ShaderModule::ShaderModule() = default;
 
 ShaderModule::ShaderModule(const LogicalDevice *logical_device,
                            const std::string &filename)
     : logical_device_(logical_device) {
-  std::vector<char> source_code;
-  if (!readFile(filename, source_code)) {
-    std::cerr << "Could not read shader file:" << filename << std::endl;
-    return;
-  }
-  VkShaderModuleCreateInfo shader_module_create_info = {
-      VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, // VkStructureType sType
-      nullptr,            // const void                 * pNext
-      0,                  // VkShaderModuleCreateFlags    flags
-      source_code.size(), // size_t                       codeSize
-      reinterpret_cast<uint32_t const *>(
-          source_code.data()) // const uint32_t             * pCode
-  };
-  CHECK_VULKAN(vkCreateShaderModule(logical_device->handle(),
-                                    &shader_module_create_info, nullptr,
-                                    &vk_shader_module_));
+  load(filename);
 }
 
 ShaderModule::ShaderModule(const LogicalDevice *logical_device,
                            std::vector<char> const &source_code)
     : logical_device_(logical_device) {
-  VkShaderModuleCreateInfo shader_module_create_info = {
-      VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, // VkStructureType sType
-      nullptr,            // const void                 * pNext
-      0,                  // VkShaderModuleCreateFlags    flags
-      source_code.size(), // size_t                       codeSize
-      reinterpret_cast<uint32_t const *>(
-          source_code.data()) // const uint32_t             * pCode
-  };
-  CHECK_VULKAN(vkCreateShaderModule(logical_device->handle(),
-                                    &shader_module_create_info, nullptr,
-                                    &vk_shader_module_));
+  create(source_code.data(), source_code.size());
+}
+
+ShaderModule::ShaderModule(const LogicalDevice *logical_device,
+                           const void *code, size_t size)
+    : logical_device_(logical_device) {
+  create(code, size);
 }
 
 ShaderModule::~ShaderModule() {
@@ -101,26 +66,42 @@ void ShaderModule::setDevice(const LogicalDevice *logical_device) {
 bool ShaderModule::load(const std::string &filename) {
   if (!logical_device_)
     return false;
-  std::vector<char> source_code;
-  if (!readFile(filename, source_code)) {
+  MappedFile file(filename);
+  if (!file.good()) {
     std::cerr << "Could not read shader file:" << filename << std::endl;
     return false;
   }
+  return create(file.data(), file.size());
+}
+
+bool ShaderModule::create(const void *code, size_t size) {
+  if (!logical_device_ || !code || !size || size % 4)
+    return false;
+  if (VK_NULL_HANDLE != vk_shader_module_)
+    vkDestroyShaderModule(logical_device_->handle(), vk_shader_module_,
+                          nullptr);
+  vk_shader_module_ = VK_NULL_HANDLE;
   VkShaderModuleCreateInfo shader_module_create_info = {
       VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, // VkStructureType sType
-      nullptr,            // const void                 * pNext
-      0,                  // VkShaderModuleCreateFlags    flags
-      source_code.size(), // size_t                       codeSize
+      nullptr, // const void                 * pNext
+      0,       // VkShaderModuleCreateFlags    flags
+      size,    // size_t                       codeSize
       reinterpret_cast<uint32_t const *>(
-          source_code.data()) // const uint32_t             * pCode
+          code) // const uint32_t             * pCode
   };
-  CHECK_VULKAN(vkCreateShaderModule(logical_device_->handle(),
-                                    &shader_module_create_info, nullptr,
-                                    &vk_shader_module_));
+  R_CHECK_VULKAN(vkCreateShaderModule(logical_device_->handle(),
+                                      &shader_module_create_info, nullptr,
+                                      &vk_shader_module_))
+  reflection_.parse(code, size);
+  return true;
 }
 
 VkShaderModule ShaderModule::handle() const { return vk_shader_module_; }
 
+const ShaderReflection &ShaderModule::reflection() const {
+  return reflection_;
+}
+
 } // namespace vk
 
 } // namespace circe
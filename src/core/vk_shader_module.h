@@ -28,6 +28,7 @@
 #ifndef CIRCE_VULKAN_SHADER_MODULE_H
 #define CIRCE_VULKAN_SHADER_MODULE_H
 
+#include "vk_shader_reflection.h"
 #include "vulkan_logical_device.h"
 
 namespace circe {
@@ -56,14 +57,28 @@ public:
                const std::string &filename);
   ShaderModule(const LogicalDevice *logical_device,
                std::vector<char> const &source_code);
+  ///\param logical_device **[in]**
+  ///\param code **[in]** SPIR-V words (not retained after creation)
+  ///\param size **[in]** code size in bytes
+  ShaderModule(const LogicalDevice *logical_device, const void *code,
+               size_t size);
+  ShaderModule(const ShaderModule &other) = delete;
   ~ShaderModule();
   void setDevice(const LogicalDevice* logical_device);
+  /// Reads the SPIR-V file through a memory mapping, so the code is handed
+  /// to the driver without an intermediate copy.
   bool load(const std::string& filename);
   VkShaderModule handle() const;
+  ///\return const ShaderReflection& interface of the module, parsed from
+  /// its SPIR-V on creation
+  const ShaderReflection &reflection() const;
 
 private:
+  bool create(const void *code, size_t size);
+
   const LogicalDevice *logical_device_ = nullptr;
   VkShaderModule vk_shader_module_ = VK_NULL_HANDLE;
+  ShaderReflection reflection_;
 };
 
 } // namespace vk
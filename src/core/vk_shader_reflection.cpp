@@ -0,0 +1,651 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_shader_reflection.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_shader_reflection.h"
+#include "logging.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace circe::vk {
+
+namespace {
+
+// SPIR-V opcodes, decorations and enumerants used by the parser
+enum SpvOp : uint32_t {
+  op_name = 5,
+  op_entry_point = 15,
+  op_type_bool = 20,
+  op_type_int = 21,
+  op_type_float = 22,
+  op_type_vector = 23,
+  op_type_matrix = 24,
+  op_type_image = 25,
+  op_type_sampler = 26,
+  op_type_sampled_image = 27,
+  op_type_array = 28,
+  op_type_runtime_array = 29,
+  op_type_struct = 30,
+  op_type_pointer = 32,
+  op_constant = 43,
+  op_spec_constant_true = 48,
+  op_spec_constant_false = 49,
+  op_spec_constant = 50,
+  op_variable = 59,
+  op_decorate = 71,
+  op_member_decorate = 72,
+};
+
+enum SpvDecoration : uint32_t {
+  decoration_spec_id = 1,
+  decoration_block = 2,
+  decoration_buffer_block = 3,
+  decoration_array_stride = 6,
+  decoration_matrix_stride = 7,
+  decoration_built_in = 11,
+  decoration_location = 30,
+  decoration_binding = 33,
+  decoration_descriptor_set = 34,
+  decoration_offset = 35,
+};
+
+enum SpvStorageClass : uint32_t {
+  storage_uniform_constant = 0,
+  storage_input = 1,
+  storage_uniform = 2,
+  storage_push_constant = 9,
+  storage_storage_buffer = 12,
+};
+
+const uint32_t spirv_magic = 0x07230203;
+const uint32_t unset = ~0u;
+
+struct SpvId {
+  uint32_t opcode{0};
+  uint32_t type_id{0}; // result type of constants and variables
+  // operands following the result id
+  std::vector<uint32_t> operands;
+  std::string name;
+  uint32_t set{unset};
+  uint32_t binding{unset};
+  uint32_t location{unset};
+  uint32_t spec_id{unset};
+  uint32_t array_stride{0};
+  bool block{false};
+  bool buffer_block{false};
+  bool built_in{false};
+  std::vector<uint32_t> member_offsets;
+  std::vector<uint32_t> member_matrix_strides;
+};
+
+std::string readString(const uint32_t *words, size_t word_count) {
+  const char *chars = reinterpret_cast<const char *>(words);
+  return std::string(chars, strnlen(chars, word_count * 4));
+}
+
+VkShaderStageFlags executionModelStage(uint32_t execution_model) {
+  switch (execution_model) {
+  case 0:
+    return VK_SHADER_STAGE_VERTEX_BIT;
+  case 1:
+    return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+  case 2:
+    return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+  case 3:
+    return VK_SHADER_STAGE_GEOMETRY_BIT;
+  case 4:
+    return VK_SHADER_STAGE_FRAGMENT_BIT;
+  case 5:
+    return VK_SHADER_STAGE_COMPUTE_BIT;
+  default:
+    break;
+  }
+  return 0;
+}
+
+VkFormat vertexFormat(const SpvId &scalar, uint32_t components) {
+  static const VkFormat float_formats[3][4] = {
+      {VK_FORMAT_R16_SFLOAT, VK_FORMAT_R16G16_SFLOAT,
+       VK_FORMAT_R16G16B16_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT},
+      {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT,
+       VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT},
+      {VK_FORMAT_R64_SFLOAT, VK_FORMAT_R64G64_SFLOAT,
+       VK_FORMAT_R64G64B64_SFLOAT, VK_FORMAT_R64G64B64A64_SFLOAT}};
+  static const VkFormat sint_formats[3][4] = {
+      {VK_FORMAT_R16_SINT, VK_FORMAT_R16G16_SINT, VK_FORMAT_R16G16B16_SINT,
+       VK_FORMAT_R16G16B16A16_SINT},
+      {VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT,
+       VK_FORMAT_R32G32B32A32_SINT},
+      {VK_FORMAT_R64_SINT, VK_FORMAT_R64G64_SINT, VK_FORMAT_R64G64B64_SINT,
+       VK_FORMAT_R64G64B64A64_SINT}};
+  static const VkFormat uint_formats[3][4] = {
+      {VK_FORMAT_R16_UINT, VK_FORMAT_R16G16_UINT, VK_FORMAT_R16G16B16_UINT,
+       VK_FORMAT_R16G16B16A16_UINT},
+      {VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT,
+       VK_FORMAT_R32G32B32A32_UINT},
+      {VK_FORMAT_R64_UINT, VK_FORMAT_R64G64_UINT, VK_FORMAT_R64G64B64_UINT,
+       VK_FORMAT_R64G64B64A64_UINT}};
+  if (scalar.operands.empty() || components < 1 || components > 4)
+    return VK_FORMAT_UNDEFINED;
+  uint32_t width = scalar.operands[0];
+  int w = width == 16 ? 0 : width == 32 ? 1 : width == 64 ? 2 : -1;
+  if (w < 0)
+    return VK_FORMAT_UNDEFINED;
+  if (scalar.opcode == op_type_float)
+    return float_formats[w][components - 1];
+  if (scalar.opcode == op_type_int)
+    return scalar.operands.size() > 1 && scalar.operands[1]
+               ? sint_formats[w][components - 1]
+               : uint_formats[w][components - 1];
+  return VK_FORMAT_UNDEFINED;
+}
+
+class SpvModule {
+public:
+  bool parse(const uint32_t *words, size_t word_count) {
+    if (word_count < 5 || words[0] != spirv_magic)
+      return false;
+    ids_.resize(words[3]);
+    for (size_t i = 5; i < word_count;) {
+      uint32_t opcode = words[i] & 0xffff;
+      uint32_t count = words[i] >> 16;
+      if (!count || i + count > word_count)
+        return false;
+      if (!instruction(opcode, words + i, count))
+        return false;
+      i += count;
+    }
+    return true;
+  }
+
+  const SpvId *id(uint32_t id) const {
+    return id < ids_.size() ? &ids_[id] : nullptr;
+  }
+
+  ///\return uint32_t array length (1 if not an array, 0 if unsized)
+  uint32_t arrayLength(const SpvId &type) const {
+    if (type.opcode == op_type_runtime_array)
+      return 0;
+    if (type.opcode != op_type_array || type.operands.size() < 2)
+      return 1;
+    auto *length = id(type.operands[1]);
+    if (!length || length->opcode != op_constant || length->operands.empty())
+      return 1;
+    return length->operands[0];
+  }
+
+  ///\return const SpvId* type without outer arrays, **count** gets the
+  /// total number of elements
+  const SpvId *stripArrays(const SpvId *type, uint32_t &count) const {
+    count = 1;
+    while (type && (type->opcode == op_type_array ||
+                    type->opcode == op_type_runtime_array)) {
+      count *= arrayLength(*type);
+      type = id(type->operands[0]);
+    }
+    return type;
+  }
+
+  ///\return uint32_t size in bytes of a type inside a block
+  uint32_t typeSize(const SpvId &type, uint32_t matrix_stride = 0) const {
+    switch (type.opcode) {
+    case op_type_bool:
+      return 4;
+    case op_type_int:
+    case op_type_float:
+      return type.operands[0] / 8;
+    case op_type_vector:
+    case op_type_matrix: {
+      auto *element = id(type.operands[0]);
+      if (!element)
+        return 0;
+      uint32_t element_size =
+          type.opcode == op_type_matrix && matrix_stride ? matrix_stride
+                                                         : typeSize(*element);
+      return type.operands[1] * element_size;
+    }
+    case op_type_array: {
+      auto *element = id(type.operands[0]);
+      if (!element)
+        return 0;
+      uint32_t stride =
+          type.array_stride ? type.array_stride : typeSize(*element);
+      return arrayLength(type) * stride;
+    }
+    case op_type_struct: {
+      uint32_t size = 0;
+      for (size_t m = 0; m < type.operands.size(); ++m) {
+        auto *member = id(type.operands[m]);
+        if (!member || m >= type.member_offsets.size())
+          continue;
+        uint32_t stride = m < type.member_matrix_strides.size()
+                              ? type.member_matrix_strides[m]
+                              : 0;
+        size = std::max(size,
+                        type.member_offsets[m] + typeSize(*member, stride));
+      }
+      return size;
+    }
+    default:
+      break;
+    }
+    return 0;
+  }
+
+  std::vector<uint32_t> variables;
+  std::vector<uint32_t> spec_constants;
+  uint32_t execution_model{unset};
+  std::string entry_point;
+
+private:
+  bool instruction(uint32_t opcode, const uint32_t *words, uint32_t count) {
+    switch (opcode) {
+    case op_name:
+      if (count < 2 || words[1] >= ids_.size())
+        return false;
+      ids_[words[1]].name = readString(words + 2, count - 2);
+      break;
+    case op_entry_point:
+      if (count < 3)
+        return false;
+      // only the first entry point is reflected
+      if (execution_model == unset) {
+        execution_model = words[1];
+        entry_point = readString(words + 3, count - 3);
+      }
+      break;
+    case op_decorate:
+      if (count < 3 || words[1] >= ids_.size())
+        return false;
+      decorate(ids_[words[1]], words[2], count > 3 ? words[3] : 0);
+      break;
+    case op_member_decorate: {
+      if (count < 4 || words[1] >= ids_.size())
+        return false;
+      auto &type = ids_[words[1]];
+      uint32_t member = words[2];
+      uint32_t value = count > 4 ? words[4] : 0;
+      if (words[3] == decoration_offset) {
+        if (type.member_offsets.size() <= member)
+          type.member_offsets.resize(member + 1, 0);
+        type.member_offsets[member] = value;
+      } else if (words[3] == decoration_matrix_stride) {
+        if (type.member_matrix_strides.size() <= member)
+          type.member_matrix_strides.resize(member + 1, 0);
+        type.member_matrix_strides[member] = value;
+      } else if (words[3] == decoration_built_in)
+        type.built_in = true;
+      break;
+    }
+    case op_type_bool:
+    case op_type_int:
+    case op_type_float:
+    case op_type_vector:
+    case op_type_matrix:
+    case op_type_image:
+    case op_type_sampler:
+    case op_type_sampled_image:
+    case op_type_array:
+    case op_type_runtime_array:
+    case op_type_struct:
+    case op_type_pointer:
+      if (count < 2 || words[1] >= ids_.size())
+        return false;
+      ids_[words[1]].opcode = opcode;
+      ids_[words[1]].operands.assign(words + 2, words + count);
+      break;
+    case op_constant:
+    case op_spec_constant_true:
+    case op_spec_constant_false:
+    case op_spec_constant:
+    case op_variable: {
+      if (count < 3 || words[2] >= ids_.size())
+        return false;
+      auto &result = ids_[words[2]];
+      result.opcode = opcode;
+      result.type_id = words[1];
+      result.operands.assign(words + 3, words + count);
+      if (opcode == op_variable)
+        variables.emplace_back(words[2]);
+      else if (opcode != op_constant)
+        spec_constants.emplace_back(words[2]);
+      break;
+    }
+    default:
+      break;
+    }
+    return true;
+  }
+
+  static void decorate(SpvId &target, uint32_t decoration, uint32_t value) {
+    switch (decoration) {
+    case decoration_spec_id:
+      target.spec_id = value;
+      break;
+    case decoration_block:
+      target.block = true;
+      break;
+    case decoration_buffer_block:
+      target.buffer_block = true;
+      break;
+    case decoration_array_stride:
+      target.array_stride = value;
+      break;
+    case decoration_built_in:
+      target.built_in = true;
+      break;
+    case decoration_location:
+      target.location = value;
+      break;
+    case decoration_binding:
+      target.binding = value;
+      break;
+    case decoration_descriptor_set:
+      target.set = value;
+      break;
+    default:
+      break;
+    }
+  }
+
+  std::vector<SpvId> ids_;
+};
+
+VkDescriptorType descriptorType(const SpvId &type, uint32_t storage_class) {
+  switch (type.opcode) {
+  case op_type_sampler:
+    return VK_DESCRIPTOR_TYPE_SAMPLER;
+  case op_type_sampled_image:
+    return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  case op_type_image: {
+    // operands: sampled type, dim, depth, arrayed, ms, sampled, format
+    if (type.operands.size() < 6)
+      break;
+    uint32_t dim = type.operands[1];
+    bool sampled = type.operands[5] == 1;
+    if (dim == 5) // Buffer
+      return sampled ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
+                     : VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+    if (dim == 6) // SubpassData
+      return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    return sampled ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
+                   : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+  }
+  case op_type_struct:
+    if (storage_class == storage_storage_buffer || type.buffer_block)
+      return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    if (storage_class == storage_uniform)
+      return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    break;
+  default:
+    break;
+  }
+  return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+}
+
+} // namespace
+
+ShaderReflection::ShaderReflection() = default;
+
+ShaderReflection::ShaderReflection(const void *code, size_t size) {
+  parse(code, size);
+}
+
+bool ShaderReflection::parse(const void *code, size_t size) {
+  *this = ShaderReflection();
+  if (!code || size % 4)
+    return false;
+  SpvModule module;
+  if (!module.parse(reinterpret_cast<const uint32_t *>(code), size / 4)) {
+    INFO("Invalid SPIR-V module.");
+    return false;
+  }
+  stages_ = executionModelStage(module.execution_model);
+  entry_point_ = module.entry_point;
+  for (auto variable_id : module.variables) {
+    auto *variable = module.id(variable_id);
+    auto *pointer = module.id(variable->type_id);
+    if (!pointer || pointer->opcode != op_type_pointer ||
+        pointer->operands.size() < 2 || variable->operands.empty())
+      continue;
+    uint32_t storage_class = variable->operands[0];
+    auto *type = module.id(pointer->operands[1]);
+    if (!type)
+      continue;
+    if (storage_class == storage_uniform_constant ||
+        storage_class == storage_uniform ||
+        storage_class == storage_storage_buffer) {
+      if (variable->binding == unset)
+        continue;
+      DescriptorBinding binding;
+      binding.set = variable->set == unset ? 0 : variable->set;
+      binding.binding = variable->binding;
+      auto *element = module.stripArrays(type, binding.count);
+      if (!element)
+        continue;
+      binding.type = descriptorType(*element, storage_class);
+      binding.stages = stages_;
+      binding.name = variable->name.empty() ? element->name : variable->name;
+      if (binding.type == VK_DESCRIPTOR_TYPE_MAX_ENUM) {
+        INFO("Unsupported descriptor type for " + binding.name);
+        continue;
+      }
+      bindings_.emplace_back(binding);
+    } else if (storage_class == storage_push_constant) {
+      if (type->opcode != op_type_struct)
+        continue;
+      uint32_t offset = 0;
+      if (!type->member_offsets.empty())
+        offset = *std::min_element(type->member_offsets.begin(),
+                                   type->member_offsets.end());
+      uint32_t end = module.typeSize(*type);
+      if (end > offset)
+        push_constant_ranges_.push_back({stages_, offset, end - offset});
+    } else if (storage_class == storage_input &&
+               stages_ == VK_SHADER_STAGE_VERTEX_BIT) {
+      if (variable->built_in || type->built_in ||
+          variable->location == unset)
+        continue;
+      uint32_t count = 1;
+      auto *element = module.stripArrays(type, count);
+      if (!element)
+        continue;
+      // matrices take one location per column
+      uint32_t columns = 1;
+      if (element->opcode == op_type_matrix) {
+        columns = element->operands[1];
+        element = module.id(element->operands[0]);
+      }
+      if (!element)
+        continue;
+      uint32_t components = 1;
+      const SpvId *scalar = element;
+      if (element->opcode == op_type_vector) {
+        components = element->operands[1];
+        scalar = module.id(element->operands[0]);
+      }
+      if (!scalar)
+        continue;
+      VertexInput input;
+      input.format = vertexFormat(*scalar, components);
+      input.size = components * scalar->operands[0] / 8;
+      input.name = variable->name;
+      // 64 bit 3 and 4 component vectors take two locations
+      uint32_t step = scalar->operands[0] == 64 && components > 2 ? 2 : 1;
+      for (uint32_t i = 0; i < count * columns; ++i) {
+        input.location = variable->location + i * step;
+        vertex_inputs_.emplace_back(input);
+      }
+    }
+  }
+  for (auto constant_id : module.spec_constants) {
+    auto *constant = module.id(constant_id);
+    if (constant->spec_id == unset)
+      continue;
+    SpecializationConstant spec;
+    spec.constant_id = constant->spec_id;
+    if (auto *type = module.id(constant->type_id))
+      spec.size = module.typeSize(*type);
+    if (constant->opcode == op_spec_constant_true)
+      spec.default_value = 1;
+    else if (constant->opcode == op_spec_constant &&
+             !constant->operands.empty())
+      spec.default_value = constant->operands[0];
+    spec.name = constant->name;
+    specialization_constants_.emplace_back(spec);
+  }
+  std::sort(bindings_.begin(), bindings_.end(),
+            [](const DescriptorBinding &a, const DescriptorBinding &b) {
+              return a.set < b.set || (a.set == b.set && a.binding < b.binding);
+            });
+  std::sort(vertex_inputs_.begin(), vertex_inputs_.end(),
+            [](const VertexInput &a, const VertexInput &b) {
+              return a.location < b.location;
+            });
+  std::sort(specialization_constants_.begin(), specialization_constants_.end(),
+            [](const SpecializationConstant &a,
+               const SpecializationConstant &b) {
+              return a.constant_id < b.constant_id;
+            });
+  good_ = true;
+  return true;
+}
+
+ShaderReflection ShaderReflection::merge(
+    const std::vector<const ShaderReflection *> &reflections,
+    VkShaderStageFlags shared_stages) {
+  ShaderReflection merged;
+  merged.good_ = true;
+  VkPushConstantRange push_range{shared_stages, ~0u, 0};
+  for (const auto *reflection : reflections) {
+    if (!reflection || !reflection->good_) {
+      merged.good_ = false;
+      continue;
+    }
+    merged.stages_ |= reflection->stages_;
+    if (merged.entry_point_.empty())
+      merged.entry_point_ = reflection->entry_point_;
+    for (const auto &binding : reflection->bindings_) {
+      auto it = std::find_if(
+          merged.bindings_.begin(), merged.bindings_.end(),
+          [&](const DescriptorBinding &b) {
+            return b.set == binding.set && b.binding == binding.binding;
+          });
+      if (it == merged.bindings_.end()) {
+        merged.bindings_.emplace_back(binding);
+        merged.bindings_.back().stages |= shared_stages;
+        continue;
+      }
+      if (it->type != binding.type) {
+        INFO("Conflicting descriptor types for " + binding.name);
+        merged.good_ = false;
+      }
+      it->stages |= binding.stages;
+      if (!it->count || !binding.count)
+        it->count = 0;
+      else
+        it->count = std::max(it->count, binding.count);
+    }
+    // a single range covering all stages keeps each stage in one range
+    for (const auto &range : reflection->push_constant_ranges_) {
+      push_range.stageFlags |= range.stageFlags;
+      uint32_t end = std::max(push_range.offset == ~0u
+                                  ? 0
+                                  : push_range.offset + push_range.size,
+                              range.offset + range.size);
+      push_range.offset = std::min(push_range.offset, range.offset);
+      push_range.size = end - push_range.offset;
+    }
+    if (reflection->stages_ & VK_SHADER_STAGE_VERTEX_BIT)
+      merged.vertex_inputs_ = reflection->vertex_inputs_;
+    for (const auto &spec : reflection->specialization_constants_)
+      if (std::none_of(merged.specialization_constants_.begin(),
+                       merged.specialization_constants_.end(),
+                       [&](const SpecializationConstant &s) {
+                         return s.constant_id == spec.constant_id;
+                       }))
+        merged.specialization_constants_.emplace_back(spec);
+  }
+  if (push_range.size)
+    merged.push_constant_ranges_.emplace_back(push_range);
+  std::sort(merged.bindings_.begin(), merged.bindings_.end(),
+            [](const DescriptorBinding &a, const DescriptorBinding &b) {
+              return a.set < b.set || (a.set == b.set && a.binding < b.binding);
+            });
+  std::sort(merged.specialization_constants_.begin(),
+            merged.specialization_constants_.end(),
+            [](const SpecializationConstant &a,
+               const SpecializationConstant &b) {
+              return a.constant_id < b.constant_id;
+            });
+  return merged;
+}
+
+bool ShaderReflection::good() const { return good_; }
+
+VkShaderStageFlags ShaderReflection::stages() const { return stages_; }
+
+const std::string &ShaderReflection::entryPoint() const {
+  return entry_point_;
+}
+
+const std::vector<ShaderReflection::DescriptorBinding> &
+ShaderReflection::descriptorBindings() const {
+  return bindings_;
+}
+
+uint32_t ShaderReflection::setCount() const {
+  return bindings_.empty() ? 0 : bindings_.back().set + 1;
+}
+
+std::vector<VkDescriptorSetLayoutBinding>
+ShaderReflection::setLayoutBindings(uint32_t set) const {
+  std::vector<VkDescriptorSetLayoutBinding> bindings;
+  for (const auto &binding : bindings_)
+    if (binding.set == set)
+      bindings.push_back({binding.binding, binding.type, binding.count,
+                          binding.stages, nullptr});
+  return bindings;
+}
+
+const std::vector<VkPushConstantRange> &
+ShaderReflection::pushConstantRanges() const {
+  return push_constant_ranges_;
+}
+
+const std::vector<ShaderReflection::VertexInput> &
+ShaderReflection::vertexInputs() const {
+  return vertex_inputs_;
+}
+
+const std::vector<ShaderReflection::SpecializationConstant> &
+ShaderReflection::specializationConstants() const {
+  return specialization_constants_;
+}
+
+} // namespace circe::vk
@@ -0,0 +1,128 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_shader_reflection.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_SHADER_REFLECTION_H
+#define CIRCE_VK_SHADER_REFLECTION_H
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+
+namespace circe::vk {
+
+/// \brief Interface of a SPIR-V module: descriptor bindings, push constant
+/// ranges, vertex inputs and specialization constants. The module is parsed
+/// directly (no external reflection library), only the first entry point is
+/// considered. Reflections of the stages of a pipeline can be merged and fed
+/// to DescriptorLayoutCache::setLayouts and
+/// GraphicsPipeline::VertexInputState::addReflectedInputs. Ex:
+///   auto interface = ShaderReflection::merge(
+///       {&vert_module.reflection(), &frag_module.reflection()});
+///   auto *layout = layout_cache.pipelineLayout(interface);
+class ShaderReflection final {
+public:
+  struct DescriptorBinding {
+    uint32_t set{0};
+    uint32_t binding{0};
+    VkDescriptorType type{VK_DESCRIPTOR_TYPE_MAX_ENUM};
+    uint32_t count{1}; //!< 0 for runtime (unsized) arrays
+    VkShaderStageFlags stages{0};
+    std::string name;
+  };
+  struct VertexInput {
+    uint32_t location{0};
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    uint32_t size{0}; //!< in bytes
+    std::string name;
+  };
+  struct SpecializationConstant {
+    uint32_t constant_id{0};
+    uint32_t size{4};          //!< in bytes (booleans are VkBool32)
+    uint32_t default_value{0}; //!< lower 32 bits of the default value
+    std::string name;
+  };
+  ShaderReflection();
+  ///\param code **[in]** SPIR-V words
+  ///\param size **[in]** code size in bytes
+  ShaderReflection(const void *code, size_t size);
+  ///\brief Combines the interfaces of the stages of a pipeline. Bindings
+  /// used by multiple stages get the union of their stages and all push
+  /// constants are merged into a single range.
+  ///\param reflections **[in]**
+  ///\param shared_stages **[in | optional = 0]** stages added to every
+  /// binding and push constant range. Using the same value (ex:
+  /// VK_SHADER_STAGE_ALL_GRAPHICS) for all pipelines makes layouts of sets
+  /// used by different stage combinations identical, so sets stay bound
+  /// across pipeline switches.
+  ///\return ShaderReflection not good() if bindings conflict
+  static ShaderReflection
+  merge(const std::vector<const ShaderReflection *> &reflections,
+        VkShaderStageFlags shared_stages = 0);
+  ///\param code **[in]** SPIR-V words
+  ///\param size **[in]** code size in bytes
+  ///\return bool true if the code is valid SPIR-V
+  bool parse(const void *code, size_t size);
+  ///\return bool true if parsed (or merged) successfully
+  [[nodiscard]] bool good() const;
+  ///\return VkShaderStageFlags stage of the entry point (union of stages for
+  /// merged reflections)
+  [[nodiscard]] VkShaderStageFlags stages() const;
+  ///\return const std::string& entry point name
+  [[nodiscard]] const std::string &entryPoint() const;
+  ///\return const std::vector<DescriptorBinding>& sorted by set and binding
+  [[nodiscard]] const std::vector<DescriptorBinding> &
+  descriptorBindings() const;
+  ///\return uint32_t number of set indices (highest set + 1)
+  [[nodiscard]] uint32_t setCount() const;
+  ///\param set **[in]**
+  ///\return std::vector<VkDescriptorSetLayoutBinding> bindings of **set**
+  [[nodiscard]] std::vector<VkDescriptorSetLayoutBinding>
+  setLayoutBindings(uint32_t set) const;
+  ///\return const std::vector<VkPushConstantRange>&
+  [[nodiscard]] const std::vector<VkPushConstantRange> &
+  pushConstantRanges() const;
+  ///\return const std::vector<VertexInput>& vertex stage inputs (builtins
+  /// excluded), sorted by location. Matrices and arrays take one entry per
+  /// location.
+  [[nodiscard]] const std::vector<VertexInput> &vertexInputs() const;
+  ///\return const std::vector<SpecializationConstant>& sorted by id
+  [[nodiscard]] const std::vector<SpecializationConstant> &
+  specializationConstants() const;
+
+private:
+  bool good_{false};
+  VkShaderStageFlags stages_{0};
+  std::string entry_point_;
+  std::vector<DescriptorBinding> bindings_;
+  std::vector<VkPushConstantRange> push_constant_ranges_;
+  std::vector<VertexInput> vertex_inputs_;
+  std::vector<SpecializationConstant> specialization_constants_;
+};
+
+} // namespace circe::vk
+
+#endif
@@ -0,0 +1,372 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_shader_reloader.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_shader_reloader.h"
+#include "logging.h"
+#include "vk_hash.h"
+#include "vk_mapped_file.h"
+#include <algorithm>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace circe::vk {
+
+namespace {
+
+std::string normalizedPath(const std::string &filename) {
+  std::error_code error;
+  auto path = std::filesystem::absolute(filename, error);
+  return (error ? std::filesystem::path(filename) : path)
+      .lexically_normal()
+      .string();
+}
+
+} // namespace
+
+ShaderReloader::ShaderReloader(const LogicalDevice *logical_device,
+                               PipelineCompiler &compiler,
+                               uint32_t retire_frames)
+    : logical_device_(logical_device), compiler_(compiler),
+      retire_frames_(retire_frames) {
+#ifdef __linux__
+  inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd_ < 0)
+    INFO("Could not initialize inotify, shaders won't be reloaded.")
+#endif
+  watcher_ = std::thread(&ShaderReloader::watchLoop, this);
+}
+
+ShaderReloader::~ShaderReloader() {
+  stop_ = true;
+  watcher_.join();
+#ifdef __linux__
+  if (inotify_fd_ >= 0)
+    close(inotify_fd_);
+#endif
+  // rebuilds read the state of their pipelines
+  for (auto &rebuild : rebuilds_) {
+    VkPipeline vk_pipeline = rebuild.request.get();
+    if (rebuild.pipeline && vk_pipeline != VK_NULL_HANDLE)
+      vkDestroyPipeline(logical_device_->handle(), vk_pipeline, nullptr);
+  }
+  destroyRetired(true);
+}
+
+bool ShaderReloader::watch(const std::string &filename,
+                           const std::shared_ptr<ShaderModule> &module) {
+  if (!module)
+    return false;
+  auto path = normalizedPath(filename);
+  WatchedFile file;
+  file.module = module;
+  {
+    MappedFile content(path);
+    if (!content.good()) {
+      INFO("Could not read shader file: " + path);
+      return false;
+    }
+    file.content_hash = hashBytes(content.data(), content.size());
+  }
+  std::error_code error;
+  file.write_time = std::filesystem::last_write_time(path, error);
+  std::lock_guard<std::mutex> guard(mutex_);
+#ifdef __linux__
+  // directories are watched, so files replaced by renaming are caught too
+  auto directory = std::filesystem::path(path).parent_path().string();
+  bool watched = std::any_of(
+      watched_directories_.begin(), watched_directories_.end(),
+      [&](const auto &entry) { return entry.second == directory; });
+  if (!watched) {
+    int wd = inotify_fd_ < 0
+                 ? -1
+                 : inotify_add_watch(inotify_fd_, directory.c_str(),
+                                     IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+      INFO("Could not watch shader directory: " + directory);
+      return false;
+    }
+    watched_directories_[wd] = directory;
+  }
+#endif
+  files_[path] = std::move(file);
+  return true;
+}
+
+void ShaderReloader::addPipeline(GraphicsPipeline *pipeline) {
+  pipelines_[pipeline] = true;
+}
+
+void ShaderReloader::addPipeline(ComputePipeline *pipeline) {
+  pipelines_[pipeline] = false;
+}
+
+void ShaderReloader::removePipeline(Pipeline *pipeline) {
+  pipelines_.erase(pipeline);
+  // the rebuild reads the pipeline state until it is ready
+  for (auto &rebuild : rebuilds_)
+    if (rebuild.pipeline == pipeline) {
+      VkPipeline vk_pipeline = rebuild.request.get();
+      if (vk_pipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(logical_device_->handle(), vk_pipeline, nullptr);
+      rebuild.pipeline = nullptr;
+    }
+  for (auto &rebuild : deferred_)
+    if (rebuild.pipeline == pipeline)
+      rebuild.pipeline = nullptr;
+}
+
+bool ShaderReloader::update() {
+  frame_++;
+  destroyRetired(false);
+  bool swapped = false;
+  if (!module_changes_.empty())
+    swapped = finishRebuild();
+  // a single rebuild is in flight at a time, later changes wait for it
+  if (module_changes_.empty() && submitRebuild())
+    swapped |= finishRebuild();
+  return swapped;
+}
+
+std::shared_ptr<ShaderModule>
+ShaderReloader::module(const std::string &filename) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = files_.find(normalizedPath(filename));
+  if (it == files_.end())
+    return nullptr;
+  return it->second.module;
+}
+
+bool ShaderReloader::busy() const { return !module_changes_.empty(); }
+
+ShaderReloader::Statistics ShaderReloader::statistics() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return statistics_;
+}
+
+void ShaderReloader::watchLoop() {
+#ifdef __linux__
+  if (inotify_fd_ < 0)
+    return;
+  alignas(inotify_event) char buffer[4096];
+  while (!stop_) {
+    pollfd descriptor{inotify_fd_, POLLIN, 0};
+    if (poll(&descriptor, 1, 100) <= 0)
+      continue;
+    ssize_t length = read(inotify_fd_, buffer, sizeof(buffer));
+    for (ssize_t offset = 0; offset < length;) {
+      auto *event = reinterpret_cast<inotify_event *>(buffer + offset);
+      offset += sizeof(inotify_event) + event->len;
+      if (!event->len)
+        continue;
+      std::string directory;
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = watched_directories_.find(event->wd);
+        if (it == watched_directories_.end())
+          continue;
+        directory = it->second;
+      }
+      fileChanged((std::filesystem::path(directory) / event->name).string());
+    }
+  }
+#else
+  while (!stop_) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    std::vector<std::string> changed;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      for (auto &file : files_) {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(file.first, error);
+        if (!error && time != file.second.write_time) {
+          file.second.write_time = time;
+          changed.emplace_back(file.first);
+        }
+      }
+    }
+    for (auto &filename : changed)
+      fileChanged(filename);
+  }
+#endif
+}
+
+void ShaderReloader::fileChanged(const std::string &filename) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!files_.count(filename))
+      return;
+  }
+  MappedFile content(filename);
+  if (!content.good())
+    return;
+  // editors and compilers often touch files without changing them
+  size_t hash = hashBytes(content.data(), content.size());
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto &file = files_[filename];
+    if (file.content_hash == hash)
+      return;
+    file.content_hash = hash;
+  }
+  auto module = std::make_shared<ShaderModule>(logical_device_, content.data(),
+                                               content.size());
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (module->handle() == VK_NULL_HANDLE) {
+    INFO("Could not reload shader: " + filename);
+    statistics_.failed++;
+    return;
+  }
+  // only the latest version of a file is kept
+  changes_[filename] = module;
+}
+
+bool ShaderReloader::submitRebuild() {
+  std::unordered_map<VkShaderModule, VkShaderModule> replacements;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (changes_.empty())
+      return false;
+    for (auto &change : changes_) {
+      auto &old_module = files_[change.first].module;
+      replacements[old_module->handle()] = change.second->handle();
+      module_changes_.push_back({change.first, old_module, change.second});
+    }
+    changes_.clear();
+  }
+  for (auto &entry : pipelines_) {
+    auto *pipeline = entry.first;
+    auto stages = pipeline->shader_stage_infos_;
+    bool affected = false;
+    for (auto &stage : stages) {
+      auto it = replacements.find(stage.module);
+      if (it != replacements.end()) {
+        stage.module = it->second;
+        affected = true;
+      }
+    }
+    if (!affected)
+      continue;
+    Rebuild rebuild;
+    rebuild.pipeline = pipeline;
+    rebuild.graphics = entry.second;
+    rebuild.stages = std::move(stages);
+    // pipelines not created yet only get the new modules if the rebuild
+    // works, the new modules are destroyed otherwise
+    if (pipeline->vk_pipeline_ == VK_NULL_HANDLE)
+      deferred_.emplace_back(std::move(rebuild));
+    else
+      rebuilds_.emplace_back(std::move(rebuild));
+  }
+  // create infos point to the stages, so rebuilds_ must not grow anymore
+  for (auto &rebuild : rebuilds_) {
+    if (rebuild.graphics) {
+      auto *pipeline = static_cast<GraphicsPipeline *>(rebuild.pipeline);
+      rebuild.graphics_info = *pipeline->createInfo();
+      rebuild.graphics_info.pStages = rebuild.stages.data();
+      rebuild.request = compiler_.compile(rebuild.graphics_info);
+    } else {
+      auto *pipeline = static_cast<ComputePipeline *>(rebuild.pipeline);
+      rebuild.compute_info = *pipeline->createInfo();
+      rebuild.compute_info.stage = rebuild.stages[0];
+      rebuild.request = compiler_.compile(rebuild.compute_info);
+    }
+  }
+  rebuild_start_ = std::chrono::steady_clock::now();
+  return true;
+}
+
+bool ShaderReloader::finishRebuild() {
+  for (auto &rebuild : rebuilds_)
+    if (!rebuild.request.ready())
+      return false;
+  bool failed = false;
+  for (auto &rebuild : rebuilds_)
+    failed |= rebuild.pipeline && rebuild.request.get() == VK_NULL_HANDLE;
+  bool swapped = false;
+  if (failed) {
+    // all or nothing: keep the previous pipelines and modules
+    INFO("Shader reload failed, keeping the previous pipelines.")
+    for (auto &rebuild : rebuilds_) {
+      VkPipeline vk_pipeline = rebuild.request.get();
+      if (rebuild.pipeline && vk_pipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(logical_device_->handle(), vk_pipeline, nullptr);
+    }
+  } else {
+    for (auto &rebuild : rebuilds_) {
+      if (!rebuild.pipeline)
+        continue;
+      auto *pipeline = rebuild.pipeline;
+      retired_.push_back({frame_, pipeline->vk_pipeline_, nullptr});
+      pipeline->vk_pipeline_ = rebuild.request.get();
+      // same size, so create infos pointing to the stages stay valid
+      std::copy(rebuild.stages.begin(), rebuild.stages.end(),
+                pipeline->shader_stage_infos_.begin());
+      swapped = true;
+    }
+    for (auto &rebuild : deferred_)
+      if (rebuild.pipeline)
+        rebuild.pipeline->shader_stage_infos_ = rebuild.stages;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (failed)
+    statistics_.failed++;
+  else {
+    for (auto &change : module_changes_) {
+      files_[change.filename].module = change.new_module;
+      retired_.push_back({frame_, VK_NULL_HANDLE, change.old_module});
+    }
+    statistics_.reloads++;
+    statistics_.rebuilt_pipelines += rebuilds_.size();
+    statistics_.last_rebuild_time =
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - rebuild_start_)
+            .count();
+  }
+  module_changes_.clear();
+  rebuilds_.clear();
+  deferred_.clear();
+  return swapped;
+}
+
+void ShaderReloader::destroyRetired(bool all) {
+  auto it = std::remove_if(retired_.begin(), retired_.end(),
+                           [&](Retired &retired) {
+                             if (!all &&
+                                 frame_ - retired.frame < retire_frames_)
+                               return false;
+                             if (retired.vk_pipeline != VK_NULL_HANDLE)
+                               vkDestroyPipeline(logical_device_->handle(),
+                                                 retired.vk_pipeline, nullptr);
+                             return true;
+                           });
+  retired_.erase(it, retired_.end());
+}
+
+} // namespace circe::vk
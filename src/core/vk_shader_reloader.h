@@ -0,0 +1,166 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_shader_reloader.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_SHADER_RELOADER_H
+#define CIRCE_VK_SHADER_RELOADER_H
+
+#include "vk_pipeline_compiler.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <unordered_map>
+
+namespace circe::vk {
+
+/// \brief Reloads SPIR-V files as they change on disk and rebuilds the
+/// pipelines using them, without restarting the application.
+/// A watcher thread (inotify on Linux, modification time polling elsewhere)
+/// recreates the shader modules of changed files. update(), called once per
+/// frame, submits the rebuild of every dependent pipeline to a
+/// PipelineCompiler and, once all of them are ready, swaps them in at once.
+/// update() never waits for a compilation. Replaced pipelines and modules
+/// are destroyed a few frames later, after command buffers recorded with
+/// them are done. Registered pipelines must not be modified while a rebuild
+/// is pending. Ex:
+///   ShaderReloader reloader(device, compiler);
+///   reloader.watch(SHADERS_PATH "/frag.spv", frag_module);
+///   reloader.addPipeline(&pipeline);
+///   ...
+///   if (reloader.update()) // once per frame
+///     render_engine.invalidateCommandBuffers();
+class ShaderReloader final {
+public:
+  struct Statistics {
+    uint64_t reloads{0};           //!< rebuilds swapped in
+    uint64_t failed{0};            //!< modules or rebuilds that failed
+    uint64_t rebuilt_pipelines{0}; //!< pipelines swapped in
+    double last_rebuild_time{0};   //!< submission to swap of the last
+                                   //!< rebuild (ms)
+  };
+  ///\param logical_device **[in]**
+  ///\param compiler **[in]** compiles the rebuilt pipelines, must outlive
+  /// the reloader
+  ///\param retire_frames **[in | optional = 8]** number of update() calls
+  /// replaced objects are kept alive. Must be greater than the number of
+  /// frames a command buffer recorded before a swap can still be in use
+  /// (swapchain images + frames in flight).
+  ShaderReloader(const LogicalDevice *logical_device,
+                 PipelineCompiler &compiler, uint32_t retire_frames = 8);
+  ShaderReloader(const ShaderReloader &other) = delete;
+  ///\brief Stops watching, waits pending rebuilds and destroys retired
+  /// objects
+  ~ShaderReloader();
+  ///\brief Watches a SPIR-V file. Pipelines using **module** are rebuilt
+  /// when the file changes.
+  ///\param filename **[in]**
+  ///\param module **[in]** current module of the file
+  ///\return bool false if the file can't be watched
+  bool watch(const std::string &filename,
+             const std::shared_ptr<ShaderModule> &module);
+  ///\param pipeline **[in]** must stay registered while alive
+  void addPipeline(GraphicsPipeline *pipeline);
+  ///\param pipeline **[in]** must stay registered while alive
+  void addPipeline(ComputePipeline *pipeline);
+  ///\brief Must be called before a registered pipeline is destroyed
+  ///\param pipeline **[in]**
+  void removePipeline(Pipeline *pipeline);
+  ///\brief Frame boundary: swaps finished rebuilds in, submits rebuilds of
+  /// newly changed files and destroys retired objects. Never blocks on
+  /// compilation.
+  ///\return bool true if pipelines were swapped (command buffers using them
+  /// must be recorded again)
+  bool update();
+  ///\param filename **[in]**
+  ///\return std::shared_ptr<ShaderModule> current module of a watched file
+  [[nodiscard]] std::shared_ptr<ShaderModule>
+  module(const std::string &filename) const;
+  ///\return bool true if a rebuild is in progress
+  [[nodiscard]] bool busy() const;
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+
+private:
+  struct WatchedFile {
+    std::shared_ptr<ShaderModule> module;
+    size_t content_hash{0};
+    std::filesystem::file_time_type write_time{}; // for polling
+  };
+  struct ModuleChange {
+    std::string filename;
+    std::shared_ptr<ShaderModule> old_module;
+    std::shared_ptr<ShaderModule> new_module;
+  };
+  struct Rebuild {
+    Pipeline *pipeline = nullptr;
+    bool graphics = true;
+    std::vector<VkPipelineShaderStageCreateInfo> stages;
+    VkGraphicsPipelineCreateInfo graphics_info{};
+    VkComputePipelineCreateInfo compute_info{};
+    PipelineCompiler::Request request;
+  };
+  struct Retired {
+    uint64_t frame{0};
+    VkPipeline vk_pipeline = VK_NULL_HANDLE;
+    std::shared_ptr<ShaderModule> module;
+  };
+  void watchLoop();
+  ///\param filename **[in]** normalized path of a changed file
+  void fileChanged(const std::string &filename);
+  ///\return bool true if a rebuild was submitted
+  bool submitRebuild();
+  ///\return bool true if the pending rebuild was swapped in
+  bool finishRebuild();
+  void destroyRetired(bool all);
+
+  const LogicalDevice *logical_device_ = nullptr;
+  PipelineCompiler &compiler_;
+  uint32_t retire_frames_{8};
+  uint64_t frame_{0};
+  // watcher thread
+  std::thread watcher_;
+  std::atomic<bool> stop_{false};
+  int inotify_fd_{-1};
+  std::map<int, std::string> watched_directories_;
+  // guarded by mutex_
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, WatchedFile> files_;
+  std::unordered_map<std::string, std::shared_ptr<ShaderModule>> changes_;
+  Statistics statistics_;
+  // frame loop state
+  std::unordered_map<Pipeline *, bool> pipelines_; // pipeline -> graphics
+  std::vector<ModuleChange> module_changes_; // of the pending rebuild
+  std::vector<Rebuild> rebuilds_;
+  // pipelines without handle, their stages are switched if the rebuild works
+  std::vector<Rebuild> deferred_;
+  std::chrono::steady_clock::time_point rebuild_start_;
+  std::vector<Retired> retired_;
+};
+
+} // namespace circe::vk
+
+#endif
@@ -0,0 +1,88 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_staging_buffer.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_staging_buffer.h"
+#include "logging.h"
+#include "vulkan_debug.h"
+#include <iostream>
+
+namespace circe::vk {
+
+StagingBuffer::StagingBuffer(const LogicalDevice *logical_device,
+                             VkDeviceSize size) {
+  buffer_ = std::make_unique<Buffer>(logical_device, size,
+                                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+  memory_ = std::make_unique<DeviceMemory>(
+      *buffer_,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+  if (!memory_->bind(*buffer_) || !memory_->map()) {
+    INFO("could not create staging buffer");
+    return;
+  }
+  mapped_ = static_cast<unsigned char *>(memory_->mapped());
+}
+
+StagingBuffer::~StagingBuffer() {
+  if (memory_)
+    memory_->unmap();
+}
+
+bool StagingBuffer::good() const { return mapped_ != nullptr; }
+
+void *StagingBuffer::reserve(VkDeviceSize size, VkDeviceSize &offset,
+                             VkDeviceSize alignment) {
+  if (!mapped_)
+    return nullptr;
+  VkDeviceSize head = head_.load();
+  VkDeviceSize end = 0;
+  do {
+    offset = (head + alignment - 1) / alignment * alignment;
+    end = offset + size;
+    if (end > buffer_->size())
+      return nullptr;
+  } while (!head_.compare_exchange_weak(head, end));
+  VkDeviceSize peak = peak_.load();
+  while (end > peak && !peak_.compare_exchange_weak(peak, end))
+    ;
+  return mapped_ + offset;
+}
+
+void StagingBuffer::reset() { head_ = 0; }
+
+const Buffer &StagingBuffer::buffer() const { return *buffer_; }
+
+unsigned char *StagingBuffer::data() const { return mapped_; }
+
+VkDeviceSize StagingBuffer::size() const { return buffer_->size(); }
+
+VkDeviceSize StagingBuffer::used() const { return head_; }
+
+VkDeviceSize StagingBuffer::peakUsage() const { return peak_; }
+
+} // namespace circe::vk
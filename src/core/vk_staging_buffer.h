@@ -0,0 +1,92 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_staging_buffer.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_STAGING_BUFFER_H
+#define CIRCE_VK_STAGING_BUFFER_H
+
+#include "vk_buffer.h"
+#include "vk_device_memory.h"
+#include <atomic>
+#include <memory>
+
+namespace circe::vk {
+
+/// \brief Persistently mapped host visible buffer used as the source of
+/// transfers. Ranges are reserved up front (from any thread) and written in
+/// place, so producers can fill the staging memory directly instead of
+/// filling a temporary allocation that is copied afterwards. Reservations are
+/// linear and released all at once by reset(), after the transfers reading
+/// the buffer have completed.
+/// Host cached memory is preferred: decoders read back what they have
+/// written (ex: PNG filters), which is very slow on write-combined memory.
+/// Usage:
+///   StagingBuffer staging(device, 64u << 20);
+///   VkDeviceSize offset = 0;
+///   void *texels = staging.reserve(texels_size, offset);
+///   // write texels, then copy from staging.buffer() at offset
+class StagingBuffer final {
+public:
+  ///\param logical_device **[in]**
+  ///\param size **[in]** capacity in bytes
+  StagingBuffer(const LogicalDevice *logical_device, VkDeviceSize size);
+  StagingBuffer(const StagingBuffer &other) = delete;
+  ~StagingBuffer();
+  ///\return bool true if the buffer was created and mapped
+  [[nodiscard]] bool good() const;
+  ///\brief Reserves a range of the buffer. Thread safe.
+  ///\param size **[in]** number of bytes
+  ///\param offset **[out]** offset of the range in the buffer
+  ///\param alignment **[in | optional = 16]** offset alignment (buffer-image
+  /// copies require multiples of 4 and of the texel size)
+  ///\return void* mapped address of the range, nullptr if it does not fit
+  void *reserve(VkDeviceSize size, VkDeviceSize &offset,
+                VkDeviceSize alignment = 16);
+  ///\brief Releases all reservations. Must not be called while transfers
+  /// from the buffer are pending.
+  void reset();
+  ///\return const Buffer& transfer source buffer
+  [[nodiscard]] const Buffer &buffer() const;
+  ///\return unsigned char* mapped address of the first byte
+  [[nodiscard]] unsigned char *data() const;
+  ///\return VkDeviceSize capacity in bytes
+  [[nodiscard]] VkDeviceSize size() const;
+  ///\return VkDeviceSize reserved bytes (including alignment padding)
+  [[nodiscard]] VkDeviceSize used() const;
+  ///\return VkDeviceSize maximum number of bytes reserved at once
+  [[nodiscard]] VkDeviceSize peakUsage() const;
+
+private:
+  std::unique_ptr<Buffer> buffer_;
+  std::unique_ptr<DeviceMemory> memory_;
+  unsigned char *mapped_ = nullptr;
+  std::atomic<VkDeviceSize> head_{0};
+  std::atomic<VkDeviceSize> peak_{0};
+};
+
+} // namespace circe::vk
+
+#endif
@@ -86,7 +86,8 @@ VkSwapchainKHR Swapchain::handle() {
     }
     images_.clear();
     for (auto &image : images)
-      images_.emplace_back(logical_device_, image);
+      images_.emplace_back(logical_device_, image, surface_format_.format,
+                           image_size_, info_.imageUsage);
   }
 
   return vk_swapchain_;
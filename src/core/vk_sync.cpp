@@ -27,6 +27,7 @@
 
 #include "vk_sync.h"
 #include "logging.h"
+#include "vk_command_buffer.h"
 #include "vulkan_debug.h"
 
 namespace circe::vk {
@@ -109,31 +110,77 @@ ImageMemoryBarrier::ImageMemoryBarrier() {
 
 ImageMemoryBarrier::ImageMemoryBarrier(const Image &image,
                                        VkImageLayout old_layout,
-                                       VkImageLayout new_layout) {
+                                       VkImageLayout new_layout)
+    : ImageMemoryBarrier(image, old_layout, new_layout, 0, image.mipLevels()) {
+}
+
+ImageMemoryBarrier::ImageMemoryBarrier(
+    const Image &image, VkImageLayout old_layout, VkImageLayout new_layout,
+    uint32_t base_mip_level, uint32_t mip_level_count,
+    uint32_t base_array_layer, uint32_t array_layer_count,
+    VkImageAspectFlags aspect_mask) {
   vk_image_memory_barrier_.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
   vk_image_memory_barrier_.oldLayout = old_layout;
   vk_image_memory_barrier_.newLayout = new_layout;
   vk_image_memory_barrier_.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
   vk_image_memory_barrier_.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
   vk_image_memory_barrier_.image = image.handle();
-  vk_image_memory_barrier_.subresourceRange.aspectMask =
-      VK_IMAGE_ASPECT_COLOR_BIT;
-  vk_image_memory_barrier_.subresourceRange.baseMipLevel = 0;
-  vk_image_memory_barrier_.subresourceRange.levelCount = image.mipLevels();
-  vk_image_memory_barrier_.subresourceRange.baseArrayLayer = 0;
-  vk_image_memory_barrier_.subresourceRange.layerCount = 1;
-
-  if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED &&
-      new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-    vk_image_memory_barrier_.srcAccessMask = 0;
-    vk_image_memory_barrier_.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  } else if (old_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
-             new_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-    vk_image_memory_barrier_.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    vk_image_memory_barrier_.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-  } else {
+  vk_image_memory_barrier_.subresourceRange.aspectMask = aspect_mask;
+  vk_image_memory_barrier_.subresourceRange.baseMipLevel = base_mip_level;
+  vk_image_memory_barrier_.subresourceRange.levelCount = mip_level_count;
+  vk_image_memory_barrier_.subresourceRange.baseArrayLayer = base_array_layer;
+  vk_image_memory_barrier_.subresourceRange.layerCount = array_layer_count;
+
+  if (!accessMask(old_layout, true, vk_image_memory_barrier_.srcAccessMask) ||
+      !accessMask(new_layout, false, vk_image_memory_barrier_.dstAccessMask))
     INFO("unsupported layout transition!")
+}
+
+bool ImageMemoryBarrier::accessMask(VkImageLayout layout, bool src,
+                                    VkAccessFlags &access) {
+  switch (layout) {
+  case VK_IMAGE_LAYOUT_UNDEFINED:
+    // contents are discarded, images can't be transitioned to this layout
+    access = 0;
+    return src;
+  case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+    access = 0;
+    return true;
+  case VK_IMAGE_LAYOUT_PREINITIALIZED:
+    access = VK_ACCESS_HOST_WRITE_BIT;
+    return src;
+  case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+    access = VK_ACCESS_TRANSFER_WRITE_BIT;
+    return true;
+  case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+    access = VK_ACCESS_TRANSFER_READ_BIT;
+    return true;
+  case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+    access = VK_ACCESS_SHADER_READ_BIT;
+    return true;
+  case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+    access = src ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                 : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    return true;
+  case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+    access = src ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                 : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    return true;
+  case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+    access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+             VK_ACCESS_SHADER_READ_BIT;
+    return true;
+  case VK_IMAGE_LAYOUT_GENERAL:
+    access = src ? VK_ACCESS_SHADER_WRITE_BIT
+                 : VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    return true;
+  default:
+    break;
   }
+  access = 0;
+  return false;
 }
 
 VkImageMemoryBarrier ImageMemoryBarrier::handle() const {
@@ -144,4 +191,98 @@ VkImageMemoryBarrier &ImageMemoryBarrier::handle() {
   return vk_image_memory_barrier_;
 }
 
+void PipelineBarrier::add(const ImageMemoryBarrier &barrier,
+                          VkPipelineStageFlags src_stages,
+                          VkPipelineStageFlags dst_stages) {
+  vk_image_barriers_.emplace_back(barrier.handle());
+  src_stages_ |= src_stages;
+  dst_stages_ |= dst_stages;
+}
+
+void PipelineBarrier::add(const Image &image, ImageUsage usage,
+                          uint32_t base_mip_level, uint32_t mip_level_count,
+                          uint32_t base_array_layer,
+                          uint32_t array_layer_count) {
+  image.state().use(ImageState::access(usage), image.handle(),
+                    vk_image_barriers_, src_stages_, dst_stages_,
+                    base_mip_level, mip_level_count, base_array_layer,
+                    array_layer_count);
+}
+
+void PipelineBarrier::add(const Buffer &buffer, VkAccessFlags src_access,
+                          VkAccessFlags dst_access,
+                          VkPipelineStageFlags src_stages,
+                          VkPipelineStageFlags dst_stages, VkDeviceSize offset,
+                          VkDeviceSize size) {
+  VkBufferMemoryBarrier barrier = {
+      VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, // VkStructureType sType
+      nullptr,                                 // const void * pNext
+      src_access,              // VkAccessFlags            srcAccessMask
+      dst_access,              // VkAccessFlags            dstAccessMask
+      VK_QUEUE_FAMILY_IGNORED, // uint32_t                 srcQueueFamilyIndex
+      VK_QUEUE_FAMILY_IGNORED, // uint32_t                 dstQueueFamilyIndex
+      buffer.handle(),         // VkBuffer                 buffer
+      offset,                  // VkDeviceSize             offset
+      size                     // VkDeviceSize             size
+  };
+  vk_buffer_barriers_.emplace_back(barrier);
+  src_stages_ |= src_stages;
+  dst_stages_ |= dst_stages;
+}
+
+void PipelineBarrier::add(VkAccessFlags src_access, VkAccessFlags dst_access,
+                          VkPipelineStageFlags src_stages,
+                          VkPipelineStageFlags dst_stages) {
+  VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr,
+                             src_access, dst_access};
+  vk_memory_barriers_.emplace_back(barrier);
+  src_stages_ |= src_stages;
+  dst_stages_ |= dst_stages;
+}
+
+void PipelineBarrier::flush(const CommandBuffer &command_buffer,
+                            VkDependencyFlags dependency_flags) {
+  if (empty())
+    return;
+  vkCmdPipelineBarrier(
+      command_buffer.handle(),
+      src_stages_ ? src_stages_ : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+      dst_stages_ ? dst_stages_ : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+      dependency_flags, vk_memory_barriers_.size(),
+      vk_memory_barriers_.data(), vk_buffer_barriers_.size(),
+      vk_buffer_barriers_.data(), vk_image_barriers_.size(),
+      vk_image_barriers_.data());
+  clear();
+}
+
+void PipelineBarrier::clear() {
+  src_stages_ = dst_stages_ = 0;
+  vk_image_barriers_.clear();
+  vk_buffer_barriers_.clear();
+  vk_memory_barriers_.clear();
+}
+
+bool PipelineBarrier::empty() const {
+  return vk_image_barriers_.empty() && vk_buffer_barriers_.empty() &&
+         vk_memory_barriers_.empty();
+}
+
+VkPipelineStageFlags PipelineBarrier::srcStages() const { return src_stages_; }
+
+VkPipelineStageFlags PipelineBarrier::dstStages() const { return dst_stages_; }
+
+const std::vector<VkImageMemoryBarrier> &
+PipelineBarrier::imageBarriers() const {
+  return vk_image_barriers_;
+}
+
+const std::vector<VkBufferMemoryBarrier> &
+PipelineBarrier::bufferBarriers() const {
+  return vk_buffer_barriers_;
+}
+
+const std::vector<VkMemoryBarrier> &PipelineBarrier::memoryBarriers() const {
+  return vk_memory_barriers_;
+}
+
 } // namespace circe::vk
\ No newline at end of file
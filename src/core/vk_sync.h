@@ -28,8 +28,10 @@
 #ifndef CIRCE_VULKAN_SYNC_H
 #define CIRCE_VULKAN_SYNC_H
 
+#include "vk_buffer.h"
 #include "vk_image.h"
 #include "vulkan_logical_device.h"
+#include <vector>
 
 namespace circe::vk {
 
@@ -90,18 +92,114 @@ private:
   VkSemaphore vk_semaphore_ = VK_NULL_HANDLE;
 };
 
+class CommandBuffer;
+
 class ImageMemoryBarrier {
 public:
   ImageMemoryBarrier();
   ImageMemoryBarrier(const Image &image, VkImageLayout old_layout,
                      VkImageLayout new_layout);
+  ///\brief Creates a barrier over a range of mip levels and array layers.
+  /// Access masks are deduced from the layouts.
+  ///\param image **[in]**
+  ///\param old_layout **[in]**
+  ///\param new_layout **[in]**
+  ///\param base_mip_level **[in]**
+  ///\param mip_level_count **[in]**
+  ///\param base_array_layer **[in | optional = 0]**
+  ///\param array_layer_count **[in | optional = 1]**
+  ///\param aspect_mask **[in | optional = VK_IMAGE_ASPECT_COLOR_BIT]**
+  ImageMemoryBarrier(const Image &image, VkImageLayout old_layout,
+                     VkImageLayout new_layout, uint32_t base_mip_level,
+                     uint32_t mip_level_count, uint32_t base_array_layer = 0,
+                     uint32_t array_layer_count = 1,
+                     VkImageAspectFlags aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT);
   [[nodiscard]] VkImageMemoryBarrier handle() const;
   [[nodiscard]] VkImageMemoryBarrier &handle();
+  ///\brief Computes the access mask usually associated to an image layout
+  /// when it is the source or the destination of a layout transition.
+  ///\param layout **[in]**
+  ///\param src **[in]** true if layout is the old layout of the transition
+  ///\param access **[out]**
+  ///\return bool false if the layout is not supported
+  static bool accessMask(VkImageLayout layout, bool src, VkAccessFlags &access);
 
 private:
   VkImageMemoryBarrier vk_image_memory_barrier_{};
 };
 
+/// Accumulates image, buffer and global memory barriers so they can be
+/// recorded by a single vkCmdPipelineBarrier call. Source and destination
+/// stages of all barriers are merged (or-ed) together, which is correct as long
+/// as the barriers are independent from each other (a barrier cannot wait on
+/// another barrier of the same batch).
+/// Usage:
+///   PipelineBarrier barriers;
+///   barriers.add(ImageMemoryBarrier(...), src_stages, dst_stages);
+///   barriers.add(buffer, ...);
+///   barriers.flush(command_buffer);
+class PipelineBarrier {
+public:
+  PipelineBarrier() = default;
+  ///\param barrier **[in]**
+  ///\param src_stages **[in]** stages that must finish before the barrier
+  ///\param dst_stages **[in]** stages that wait on the barrier
+  void add(const ImageMemoryBarrier &barrier, VkPipelineStageFlags src_stages,
+           VkPipelineStageFlags dst_stages);
+  ///\brief Declares a new usage of a range of subresources of the image. Only
+  /// the barriers needed to go from the tracked state of the image to the new
+  /// usage are added, and the image state is updated.
+  ///\param image **[in]**
+  ///\param usage **[in]**
+  ///\param base_mip_level **[in | optional = 0]**
+  ///\param mip_level_count **[in | optional = VK_REMAINING_MIP_LEVELS]**
+  ///\param base_array_layer **[in | optional = 0]**
+  ///\param array_layer_count **[in | optional = VK_REMAINING_ARRAY_LAYERS]**
+  void add(const Image &image, ImageUsage usage, uint32_t base_mip_level = 0,
+           uint32_t mip_level_count = VK_REMAINING_MIP_LEVELS,
+           uint32_t base_array_layer = 0,
+           uint32_t array_layer_count = VK_REMAINING_ARRAY_LAYERS);
+  ///\param buffer **[in]**
+  ///\param src_access **[in]**
+  ///\param dst_access **[in]**
+  ///\param src_stages **[in]**
+  ///\param dst_stages **[in]**
+  ///\param offset **[in | optional = 0]**
+  ///\param size **[in | optional = VK_WHOLE_SIZE]**
+  void add(const Buffer &buffer, VkAccessFlags src_access,
+           VkAccessFlags dst_access, VkPipelineStageFlags src_stages,
+           VkPipelineStageFlags dst_stages, VkDeviceSize offset = 0,
+           VkDeviceSize size = VK_WHOLE_SIZE);
+  ///\brief Adds a global memory barrier (affects all resources)
+  ///\param src_access **[in]**
+  ///\param dst_access **[in]**
+  ///\param src_stages **[in]**
+  ///\param dst_stages **[in]**
+  void add(VkAccessFlags src_access, VkAccessFlags dst_access,
+           VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages);
+  ///\brief Records all accumulated barriers with a single vkCmdPipelineBarrier
+  /// call and clears the batch. Nothing is recorded if the batch is empty.
+  ///\param command_buffer **[in]**
+  ///\param dependency_flags **[in | optional = 0]**
+  void flush(const CommandBuffer &command_buffer,
+             VkDependencyFlags dependency_flags = 0);
+  void clear();
+  [[nodiscard]] bool empty() const;
+  [[nodiscard]] VkPipelineStageFlags srcStages() const;
+  [[nodiscard]] VkPipelineStageFlags dstStages() const;
+  [[nodiscard]] const std::vector<VkImageMemoryBarrier> &imageBarriers() const;
+  [[nodiscard]] const std::vector<VkBufferMemoryBarrier> &
+  bufferBarriers() const;
+  [[nodiscard]] const std::vector<VkMemoryBarrier> &memoryBarriers() const;
+
+private:
+  VkPipelineStageFlags src_stages_ = 0;
+  VkPipelineStageFlags dst_stages_ = 0;
+  std::vector<VkImageMemoryBarrier> vk_image_barriers_;
+  std::vector<VkBufferMemoryBarrier> vk_buffer_barriers_;
+  std::vector<VkMemoryBarrier> vk_memory_barriers_;
+};
+
 } // namespace circe::vk
 
 #endif
\ No newline at end of file
@@ -0,0 +1,324 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_texture_atlas.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_texture_atlas.h"
+#include "logging.h"
+#include "vk_image_decoder.h"
+#include "vk_mip_generator.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <imstb_rectpack.h>
+
+namespace circe::vk {
+
+/// Skyline of a layer, in cells
+struct TextureAtlas::Layer {
+  stbrp_context context{};
+  std::vector<stbrp_node> nodes;
+};
+
+TextureAtlas::TextureAtlas(const LogicalDevice *logical_device,
+                           const Options &options)
+    : logical_device_(logical_device), options_(options) {
+  options_.mip_levels =
+      std::max(1u, std::min(options_.mip_levels,
+                            MipGenerator::levelCount(options_.size,
+                                                     options_.size)));
+  cell_size_ = 1u << (options_.mip_levels - 1);
+}
+
+TextureAtlas::~TextureAtlas() = default;
+
+bool TextureAtlas::add(const std::string &filename, uint32_t &id) {
+  VkExtent3D size{};
+  D_RETURN_FALSE_IF_NOT(ImageDecoder::info(filename, size),
+                        "could not read atlas image file " + filename);
+  std::vector<uint8_t> rgba(ImageDecoder::destinationSize(size));
+  RETURN_FALSE_IF_NOT(ImageDecoder::decodeRGBA8(filename, size, rgba.data(),
+                                                rgba.size()))
+  rgba.resize(ImageDecoder::rgba8Size(size));
+  RETURN_FALSE_IF_NOT(add(rgba.data(), size.width, size.height, id))
+  // keep the decoded texels instead of the copy
+  pending_.back().rgba.swap(rgba);
+  return true;
+}
+
+bool TextureAtlas::add(const uint8_t *rgba, uint32_t width, uint32_t height,
+                       uint32_t &id) {
+  RETURN_FALSE_IF_NOT(rgba && width && height)
+  const uint32_t layer_cells = options_.size / cell_size_;
+  D_RETURN_FALSE_IF_NOT(cellCount(width) <= layer_cells &&
+                            cellCount(height) <= layer_cells,
+                        "image does not fit in an atlas layer");
+  Pending pending;
+  id = static_cast<uint32_t>(rects_.size());
+  pending.id = id;
+  pending.width = width;
+  pending.height = height;
+  pending.rgba.assign(rgba, rgba + static_cast<size_t>(width) * height * 4);
+  pending_.emplace_back(std::move(pending));
+  rects_.emplace_back();
+  failed_.emplace_back(false);
+  return true;
+}
+
+uint32_t TextureAtlas::cellCount(uint32_t texels) const {
+  return (texels + 2 * options_.padding + cell_size_ - 1) / cell_size_;
+}
+
+bool TextureAtlas::update(CommandBuffer &cb) {
+  destroyRetired();
+  if (pending_.empty()) {
+    frame_++;
+    return false;
+  }
+  // texels and mip chains do not depend on the placement, so they are staged
+  // first and images that cannot be staged never take cells
+  const int layer_cells = static_cast<int>(options_.size / cell_size_);
+  VkDeviceSize staging_size = 0;
+  for (const auto &pending : pending_)
+    staging_size +=
+        MipGenerator::chainSize(cellCount(pending.width) * cell_size_,
+                                cellCount(pending.height) * cell_size_);
+  staging_ = std::make_unique<StagingBuffer>(logical_device_, staging_size);
+  std::vector<std::vector<VkBufferImageCopy>> image_regions(pending_.size());
+  std::vector<stbrp_rect> rects(pending_.size());
+  std::vector<stbrp_rect> unpacked;
+  for (size_t i = 0; i < pending_.size(); ++i) {
+    if (!staging_->good() || !stage(pending_[i], image_regions[i])) {
+      INFO("could not stage atlas image");
+      fail(pending_[i].id);
+      continue;
+    }
+    rects[i].id = static_cast<int>(i);
+    rects[i].w = static_cast<stbrp_coord>(cellCount(pending_[i].width));
+    rects[i].h = static_cast<stbrp_coord>(cellCount(pending_[i].height));
+    unpacked.emplace_back(rects[i]);
+  }
+  // pack the new images into the free space of the layers, in order, and
+  // open layers for what is left
+  std::vector<uint32_t> layers(pending_.size(), 0);
+  std::vector<size_t> packed;
+  for (uint32_t layer = 0; !unpacked.empty(); ++layer) {
+    if (layer == layers_.size()) {
+      auto new_layer = std::make_unique<Layer>();
+      new_layer->nodes.resize(layer_cells);
+      stbrp_init_target(&new_layer->context, layer_cells, layer_cells,
+                        new_layer->nodes.data(), layer_cells);
+      layers_.emplace_back(std::move(new_layer));
+    }
+    stbrp_pack_rects(&layers_[layer]->context, unpacked.data(),
+                     static_cast<int>(unpacked.size()));
+    std::vector<stbrp_rect> remaining;
+    for (auto &rect : unpacked)
+      if (rect.was_packed) {
+        rects[rect.id] = rect;
+        layers[rect.id] = layer;
+        packed.emplace_back(rect.id);
+      } else
+        remaining.emplace_back(rect);
+    unpacked.swap(remaining);
+  }
+  bool replaced = false;
+  if (!packed.empty() &&
+      (!image_ || image_->arrayLayers() < layers_.size())) {
+    if (!reallocate(cb)) {
+      // only the layers opened by this update are dropped, the images packed
+      // in the layers of the current image are still uploaded
+      INFO("could not allocate the atlas image");
+      const uint32_t image_layers = image_ ? image_->arrayLayers() : 0;
+      layers_.resize(image_layers);
+      std::vector<size_t> kept;
+      for (auto i : packed)
+        if (layers[i] < image_layers)
+          kept.emplace_back(i);
+        else
+          fail(pending_[i].id);
+      packed.swap(kept);
+    } else
+      replaced = true;
+  }
+  if (packed.empty()) {
+    staging_.reset();
+    pending_.clear();
+    frame_++;
+    return false;
+  }
+  if (!replaced)
+    cb.use(*image_, ImageUsage::TRANSFER_DST);
+  std::vector<VkBufferImageCopy> regions;
+  for (auto i : packed) {
+    const auto &pending = pending_[i];
+    const uint32_t x = rects[i].x * cell_size_;
+    const uint32_t y = rects[i].y * cell_size_;
+    for (uint32_t level = 0; level < image_regions[i].size(); ++level) {
+      auto &region = image_regions[i][level];
+      region.imageOffset = {static_cast<int32_t>(x >> level),
+                            static_cast<int32_t>(y >> level), 0};
+      region.imageSubresource.baseArrayLayer = layers[i];
+      regions.emplace_back(region);
+      statistics_.uploaded_bytes += static_cast<uint64_t>(
+          region.imageExtent.width) * region.imageExtent.height * 4;
+    }
+    auto &rect = rects_[pending.id];
+    const float size = static_cast<float>(options_.size);
+    rect.layer = layers[i];
+    rect.u0 = (x + options_.padding) / size;
+    rect.v0 = (y + options_.padding) / size;
+    rect.u1 = (x + options_.padding + pending.width) / size;
+    rect.v1 = (y + options_.padding + pending.height) / size;
+    used_cells_ += static_cast<uint64_t>(rects[i].w) * rects[i].h;
+    statistics_.images++;
+  }
+  cb.copy(staging_->buffer(), *image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          regions);
+  cb.use(*image_, ImageUsage::SAMPLED_FRAGMENT);
+  Retired retired;
+  retired.frame = frame_;
+  retired.staging = std::move(staging_);
+  retired_.emplace_back(std::move(retired));
+  pending_.clear();
+  statistics_.layers = static_cast<uint32_t>(layers_.size());
+  statistics_.occupancy =
+      static_cast<double>(used_cells_) /
+      (static_cast<double>(layer_cells) * layer_cells * layers_.size());
+  frame_++;
+  return replaced;
+}
+
+bool TextureAtlas::reallocate(CommandBuffer &cb) {
+  const auto layer_count = static_cast<uint32_t>(layers_.size());
+  auto image = std::make_unique<Image>(
+      logical_device_, VK_IMAGE_TYPE_2D,
+      options_.srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM,
+      VkExtent3D{options_.size, options_.size, 1}, options_.mip_levels,
+      layer_count, VK_SAMPLE_COUNT_1_BIT,
+      VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+          VK_IMAGE_USAGE_SAMPLED_BIT,
+      false);
+  RETURN_FALSE_IF_NOT(image->good())
+  auto memory = std::make_unique<DeviceMemory>(
+      *image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  RETURN_FALSE_IF_NOT(memory->bind(*image))
+  cb.use(*image, ImageUsage::TRANSFER_DST);
+  if (image_) {
+    // the previous layers keep their contents
+    cb.use(*image_, ImageUsage::TRANSFER_SRC);
+    std::vector<VkImageCopy> regions(options_.mip_levels);
+    for (uint32_t level = 0; level < options_.mip_levels; ++level) {
+      const uint32_t size = std::max(options_.size >> level, 1u);
+      regions[level].srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0,
+                                       image_->arrayLayers()};
+      regions[level].dstSubresource = regions[level].srcSubresource;
+      regions[level].extent = {size, size, 1};
+    }
+    cb.copy(*image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions);
+    // command buffers of previous frames may still sample it
+    Retired retired;
+    retired.frame = frame_;
+    retired.memory = std::move(memory_);
+    retired.image = std::move(image_);
+    retired.view = std::move(view_);
+    retired_.emplace_back(std::move(retired));
+    statistics_.reallocations++;
+  }
+  memory_ = std::move(memory);
+  image_ = std::move(image);
+  view_ = std::make_unique<Image::View>(image_.get(),
+                                        VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+                                        image_->format(),
+                                        VK_IMAGE_ASPECT_COLOR_BIT);
+  return true;
+}
+
+bool TextureAtlas::stage(const Pending &pending,
+                         std::vector<VkBufferImageCopy> &regions) {
+  const uint32_t width = cellCount(pending.width) * cell_size_;
+  const uint32_t height = cellCount(pending.height) * cell_size_;
+  VkDeviceSize offset = 0;
+  auto *texels = static_cast<uint8_t *>(
+      staging_->reserve(MipGenerator::chainSize(width, height), offset));
+  RETURN_FALSE_IF_NOT(texels)
+  // border texels are repeated over the padding and the rest of the cell, so
+  // filtering (at any level) never reaches the neighbour images
+  const uint32_t padding = options_.padding;
+  const size_t row_size = static_cast<size_t>(pending.width) * 4;
+  for (uint32_t j = 0; j < height; ++j) {
+    const uint32_t src_j =
+        std::min(j > padding ? j - padding : 0, pending.height - 1);
+    const uint8_t *src = pending.rgba.data() + src_j * row_size;
+    uint8_t *dst = texels + static_cast<size_t>(j) * width * 4;
+    for (uint32_t i = 0; i < padding; ++i)
+      std::memcpy(dst + i * 4, src, 4);
+    std::memcpy(dst + padding * 4, src, row_size);
+    for (uint32_t i = padding + pending.width; i < width; ++i)
+      std::memcpy(dst + i * 4, src + row_size - 4, 4);
+  }
+  regions = MipGenerator::copyRegions(width, height, offset);
+  std::vector<uint8_t *> levels;
+  for (size_t i = 1; i < regions.size(); ++i)
+    levels.emplace_back(texels + (regions[i].bufferOffset - offset));
+  MipGenerator mip_generator(1);
+  MipGenerator::Options options;
+  options.srgb = options_.srgb;
+  RETURN_FALSE_IF_NOT(mip_generator.generate(texels, width, height, levels,
+                                             options))
+  // cells are multiples of the smallest level footprint, so the levels of
+  // the atlas are exact halvings of the cell
+  regions.resize(std::min<size_t>(regions.size(), options_.mip_levels));
+  return true;
+}
+
+void TextureAtlas::fail(uint32_t id) {
+  failed_[id] = true;
+  statistics_.failed++;
+}
+
+void TextureAtlas::destroyRetired() {
+  while (!retired_.empty() &&
+         frame_ - retired_.front().frame >= options_.retire_frames)
+    retired_.pop_front();
+}
+
+const TextureAtlas::Rect &TextureAtlas::rect(uint32_t id) const {
+  return rects_[id];
+}
+
+bool TextureAtlas::failed(uint32_t id) const { return failed_[id]; }
+
+const Image::View *TextureAtlas::view() const { return view_.get(); }
+
+TextureAtlas::Statistics TextureAtlas::statistics() const {
+  return statistics_;
+}
+
+} // namespace circe::vk
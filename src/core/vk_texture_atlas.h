@@ -0,0 +1,179 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_texture_atlas.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_TEXTURE_ATLAS_H
+#define CIRCE_VK_TEXTURE_ATLAS_H
+
+#include "vk_command_buffer.h"
+#include "vk_device_memory.h"
+#include "vk_image.h"
+#include "vk_staging_buffer.h"
+#include <deque>
+#include <string>
+
+namespace circe::vk {
+
+/// \brief Packs many small RGBA8 images (icons, decals, ...) into the layers
+/// of a single 2D array image, so they share one view and one descriptor.
+/// Images are placed by the skyline packer of stb_rect_pack on a grid of
+/// cells of 2^(mip_levels - 1) texels, so every image starts on a texel of
+/// each mip level. Each image gets its own mip chain, filtered from a copy
+/// surrounded by its border texels repeated over the padding: levels never
+/// mix texels of neighbouring images while the padding is at least one texel
+/// wide.
+/// Packing is incremental: images added since the last update are packed in
+/// the free space of the existing layers and only their texels are uploaded.
+/// New layers reallocate the image, and the previous layers are copied into
+/// it. Replaced images are destroyed a few updates later.
+/// Usage:
+///   TextureAtlas atlas(device);
+///   uint32_t icon;
+///   atlas.add(TEXTURES_PATH "/icon.png", icon);
+///   if (atlas.update(cb)) // once per frame, before recording the draws
+///     // rewrite descriptors with atlas.view()
+///   auto rect = atlas.rect(icon); // sample at (mix(uv0, uv1, t), layer)
+class TextureAtlas final {
+public:
+  struct Options {
+    // explicit constructor instead of member initializers, so Options{} can
+    // be a default argument inside TextureAtlas
+    Options()
+        : size(2048), mip_levels(4), padding(8), srgb(true),
+          retire_frames(3) {}
+    uint32_t size;          //!< width and height of the layers
+    uint32_t mip_levels;    //!< levels of the atlas image
+    uint32_t padding;       //!< border texels around each image (level 0),
+                            //!< 2^(mip_levels - 1) keeps one on every level
+    bool srgb;              //!< VK_FORMAT_R8G8B8A8_SRGB or _UNORM
+    uint32_t retire_frames; //!< update() calls replaced images are kept
+  };
+  /// \brief Location of an image (without its padding) in the atlas
+  struct Rect {
+    uint32_t layer{0};
+    float u0{0}, v0{0}; //!< top left corner
+    float u1{0}, v1{0}; //!< bottom right corner
+  };
+  struct Statistics {
+    uint32_t images{0};         //!< packed images
+    uint32_t layers{0};         //!< array layers of the atlas image
+    uint64_t reallocations{0};  //!< images created to add layers
+    uint64_t uploaded_bytes{0}; //!< texel bytes uploaded (all levels)
+    uint32_t failed{0};         //!< images that could not be uploaded
+    double occupancy{0};        //!< area of the cells in use / total area
+  };
+  ///\param logical_device **[in]**
+  ///\param options **[in | optional = {}]**
+  explicit TextureAtlas(const LogicalDevice *logical_device,
+                        const Options &options = {});
+  TextureAtlas(const TextureAtlas &other) = delete;
+  ~TextureAtlas();
+  ///\brief Queues an image file, packed by the next update()
+  ///\param filename **[in]**
+  ///\param id **[out]** image identifier
+  ///\return bool true if the file was decoded and fits in a layer
+  bool add(const std::string &filename, uint32_t &id);
+  ///\brief Queues an image, packed by the next update()
+  ///\param rgba **[in]** tightly packed RGBA8 texels (copied)
+  ///\param width **[in]**
+  ///\param height **[in]**
+  ///\param id **[out]** image identifier
+  ///\return bool true if the image fits in a layer
+  bool add(const uint8_t *rgba, uint32_t width, uint32_t height,
+           uint32_t &id);
+  ///\brief Packs and uploads the images added since the last update. The
+  /// command buffer must be submitted before any command sampling the
+  /// atlas. Destroys images replaced retire_frames updates ago.
+  /// Images that cannot be staged, or that need new layers when the atlas
+  /// image cannot grow, are dropped and marked as failed; their cells are
+  /// released.
+  ///\param cb **[in]** recording command buffer
+  ///\return bool true if the atlas image was replaced (descriptors must be
+  /// rewritten with view())
+  bool update(CommandBuffer &cb);
+  ///\param id **[in]**
+  ///\return const Rect& location of the image, valid after the update that
+  /// packed it
+  [[nodiscard]] const Rect &rect(uint32_t id) const;
+  ///\param id **[in]**
+  ///\return bool true if the update that should have packed the image
+  /// could not upload it (its rect stays zeroed)
+  [[nodiscard]] bool failed(uint32_t id) const;
+  ///\return const Image::View* 2D array view of all layers, nullptr before
+  /// the first update
+  [[nodiscard]] const Image::View *view() const;
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+
+private:
+  struct Layer;
+  struct Pending {
+    uint32_t id{0};
+    uint32_t width{0};
+    uint32_t height{0};
+    std::vector<uint8_t> rgba;
+  };
+  struct Retired {
+    uint64_t frame{0};
+    std::unique_ptr<DeviceMemory> memory;
+    std::unique_ptr<Image> image;
+    std::unique_ptr<Image::View> view;
+    std::unique_ptr<StagingBuffer> staging;
+  };
+  ///\return uint32_t width (or height) of the cells of an image side
+  [[nodiscard]] uint32_t cellCount(uint32_t texels) const;
+  ///\brief Creates an image with all the layers, copying the previous ones
+  ///\return bool true if success
+  bool reallocate(CommandBuffer &cb);
+  ///\brief Writes the padded image and its mip chain into staging memory
+  ///\param regions **[out]** copies of the levels into the atlas (image
+  /// offsets and layers are set once the image is packed)
+  ///\return bool true if success
+  bool stage(const Pending &pending, std::vector<VkBufferImageCopy> &regions);
+  ///\brief Marks an image as failed
+  void fail(uint32_t id);
+  void destroyRetired();
+
+  const LogicalDevice *logical_device_ = nullptr;
+  Options options_;
+  uint32_t cell_size_{1};
+  uint64_t frame_{0};
+  std::vector<Rect> rects_;
+  std::vector<bool> failed_; //!< indexed by image id
+  std::vector<Pending> pending_;
+  std::vector<std::unique_ptr<Layer>> layers_;
+  uint64_t used_cells_{0};
+  std::unique_ptr<DeviceMemory> memory_;
+  std::unique_ptr<Image> image_;
+  std::unique_ptr<Image::View> view_;
+  std::unique_ptr<StagingBuffer> staging_;
+  std::deque<Retired> retired_;
+  Statistics statistics_;
+};
+
+} // namespace circe::vk
+
+#endif
@@ -0,0 +1,656 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_texture_container.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_texture_container.h"
+#include "logging.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+namespace circe::vk {
+
+namespace {
+
+constexpr uint8_t kKTX2Identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32,
+                                         0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+struct KTX2Header {
+  uint8_t identifier[12];
+  uint32_t vk_format;
+  uint32_t type_size;
+  uint32_t pixel_width;
+  uint32_t pixel_height;
+  uint32_t pixel_depth;
+  uint32_t layer_count;
+  uint32_t face_count;
+  uint32_t level_count;
+  uint32_t supercompression_scheme;
+  uint32_t dfd_byte_offset;
+  uint32_t dfd_byte_length;
+  uint32_t kvd_byte_offset;
+  uint32_t kvd_byte_length;
+  uint64_t sgd_byte_offset;
+  uint64_t sgd_byte_length;
+};
+
+struct KTX2Level {
+  uint64_t byte_offset;
+  uint64_t byte_length;
+  uint64_t uncompressed_byte_length;
+};
+
+constexpr uint32_t fourCC(char a, char b, char c, char d) {
+  return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) |
+         (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+struct DDSPixelFormat {
+  uint32_t size;
+  uint32_t flags;
+  uint32_t four_cc;
+  uint32_t rgb_bit_count;
+  uint32_t r_mask;
+  uint32_t g_mask;
+  uint32_t b_mask;
+  uint32_t a_mask;
+};
+
+struct DDSHeader {
+  uint32_t size;
+  uint32_t flags;
+  uint32_t height;
+  uint32_t width;
+  uint32_t pitch_or_linear_size;
+  uint32_t depth;
+  uint32_t mip_map_count;
+  uint32_t reserved1[11];
+  DDSPixelFormat pixel_format;
+  uint32_t caps;
+  uint32_t caps2;
+  uint32_t caps3;
+  uint32_t caps4;
+  uint32_t reserved2;
+};
+
+struct DDSHeaderDX10 {
+  uint32_t dxgi_format;
+  uint32_t resource_dimension;
+  uint32_t misc_flag;
+  uint32_t array_size;
+  uint32_t misc_flags2;
+};
+
+constexpr uint32_t kDDSHeaderFlags = 0x1 | 0x2 | 0x4 | 0x1000; // required
+constexpr uint32_t kDDSHeaderMipMapCount = 0x20000;
+constexpr uint32_t kDDSHeaderLinearSize = 0x80000;
+constexpr uint32_t kDDSCapsComplex = 0x8;
+constexpr uint32_t kDDSCapsTexture = 0x1000;
+constexpr uint32_t kDDSCapsMipMap = 0x400000;
+constexpr uint32_t kDDSPixelFormatFourCC = 0x4;
+constexpr uint32_t kDDSPixelFormatRGB = 0x40;
+constexpr uint32_t kDDSCaps2Cubemap = 0x200;
+constexpr uint32_t kDDSCaps2Volume = 0x200000;
+constexpr uint32_t kDDSResourceMiscTextureCube = 0x4;
+constexpr uint32_t kDDSResourceDimensionTexture1D = 2;
+constexpr uint32_t kDDSResourceDimensionTexture2D = 3;
+constexpr uint32_t kDDSResourceDimensionTexture3D = 4;
+
+VkFormat dxgiFormat(uint32_t dxgi_format) {
+  switch (dxgi_format) {
+  case 2:
+    return VK_FORMAT_R32G32B32A32_SFLOAT;
+  case 10:
+    return VK_FORMAT_R16G16B16A16_SFLOAT;
+  case 28:
+    return VK_FORMAT_R8G8B8A8_UNORM;
+  case 29:
+    return VK_FORMAT_R8G8B8A8_SRGB;
+  case 41:
+    return VK_FORMAT_R32_SFLOAT;
+  case 49:
+    return VK_FORMAT_R8G8_UNORM;
+  case 54:
+    return VK_FORMAT_R16_SFLOAT;
+  case 61:
+    return VK_FORMAT_R8_UNORM;
+  case 71:
+    return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+  case 72:
+    return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+  case 74:
+    return VK_FORMAT_BC2_UNORM_BLOCK;
+  case 75:
+    return VK_FORMAT_BC2_SRGB_BLOCK;
+  case 77:
+    return VK_FORMAT_BC3_UNORM_BLOCK;
+  case 78:
+    return VK_FORMAT_BC3_SRGB_BLOCK;
+  case 80:
+    return VK_FORMAT_BC4_UNORM_BLOCK;
+  case 81:
+    return VK_FORMAT_BC4_SNORM_BLOCK;
+  case 83:
+    return VK_FORMAT_BC5_UNORM_BLOCK;
+  case 84:
+    return VK_FORMAT_BC5_SNORM_BLOCK;
+  case 87:
+    return VK_FORMAT_B8G8R8A8_UNORM;
+  case 91:
+    return VK_FORMAT_B8G8R8A8_SRGB;
+  case 95:
+    return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+  case 96:
+    return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+  case 98:
+    return VK_FORMAT_BC7_UNORM_BLOCK;
+  case 99:
+    return VK_FORMAT_BC7_SRGB_BLOCK;
+  default:
+    break;
+  }
+  return VK_FORMAT_UNDEFINED;
+}
+
+uint32_t dxgiFormat(VkFormat format) {
+  // BC1 without alpha has no DXGI format of its own
+  if (format == VK_FORMAT_BC1_RGB_UNORM_BLOCK)
+    return 71;
+  if (format == VK_FORMAT_BC1_RGB_SRGB_BLOCK)
+    return 72;
+  for (uint32_t dxgi_format = 1; dxgi_format < 100; ++dxgi_format)
+    if (dxgiFormat(dxgi_format) == format)
+      return dxgi_format;
+  return 0;
+}
+
+VkFormat ddsFormat(const DDSPixelFormat &pf) {
+  if (pf.flags & kDDSPixelFormatFourCC) {
+    switch (pf.four_cc) {
+    case fourCC('D', 'X', 'T', '1'):
+      return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case fourCC('D', 'X', 'T', '2'):
+    case fourCC('D', 'X', 'T', '3'):
+      return VK_FORMAT_BC2_UNORM_BLOCK;
+    case fourCC('D', 'X', 'T', '4'):
+    case fourCC('D', 'X', 'T', '5'):
+      return VK_FORMAT_BC3_UNORM_BLOCK;
+    case fourCC('A', 'T', 'I', '1'):
+    case fourCC('B', 'C', '4', 'U'):
+      return VK_FORMAT_BC4_UNORM_BLOCK;
+    case fourCC('B', 'C', '4', 'S'):
+      return VK_FORMAT_BC4_SNORM_BLOCK;
+    case fourCC('A', 'T', 'I', '2'):
+    case fourCC('B', 'C', '5', 'U'):
+      return VK_FORMAT_BC5_UNORM_BLOCK;
+    case fourCC('B', 'C', '5', 'S'):
+      return VK_FORMAT_BC5_SNORM_BLOCK;
+    // legacy D3DFMT values
+    case 111:
+      return VK_FORMAT_R16_SFLOAT;
+    case 113:
+      return VK_FORMAT_R16G16B16A16_SFLOAT;
+    case 114:
+      return VK_FORMAT_R32_SFLOAT;
+    case 116:
+      return VK_FORMAT_R32G32B32A32_SFLOAT;
+    default:
+      break;
+    }
+    return VK_FORMAT_UNDEFINED;
+  }
+  if ((pf.flags & kDDSPixelFormatRGB) && pf.rgb_bit_count == 32) {
+    if (pf.r_mask == 0x000000ff && pf.b_mask == 0x00ff0000)
+      return VK_FORMAT_R8G8B8A8_UNORM;
+    if (pf.r_mask == 0x00ff0000 && pf.b_mask == 0x000000ff)
+      return VK_FORMAT_B8G8R8A8_UNORM;
+  }
+  return VK_FORMAT_UNDEFINED;
+}
+
+template <typename T> bool read(const MappedFile &file, size_t offset, T &t) {
+  if (offset + sizeof(T) > file.size())
+    return false;
+  std::memcpy(&t, static_cast<const uint8_t *>(file.data()) + offset,
+              sizeof(T));
+  return true;
+}
+
+} // namespace
+
+TextureContainer::TextureContainer(const std::string &filename) {
+  open(filename);
+}
+
+bool TextureContainer::open(const std::string &filename) {
+  regions_.clear();
+  format_ = VK_FORMAT_UNDEFINED;
+  if (!file_.open(filename)) {
+    INFO("could not open texture container " + filename);
+    return false;
+  }
+  uint8_t identifier[12]{};
+  read(file_, 0, identifier);
+  bool parsed = false;
+  if (std::memcmp(identifier, kKTX2Identifier, 12) == 0)
+    parsed = parseKTX2();
+  else if (std::memcmp(identifier, "DDS ", 4) == 0)
+    parsed = parseDDS();
+  else
+    INFO("unknown texture container " + filename);
+  if (!parsed) {
+    INFO("could not parse texture container " + filename);
+    regions_.clear();
+    format_ = VK_FORMAT_UNDEFINED;
+    file_.close();
+  }
+  return parsed;
+}
+
+bool TextureContainer::parseKTX2() {
+  KTX2Header header{};
+  if (!read(file_, 0, header))
+    return false;
+  if (header.supercompression_scheme != 0) {
+    INFO("supercompressed KTX2 files are not supported");
+    return false;
+  }
+  format_ = static_cast<VkFormat>(header.vk_format);
+  VkExtent2D block{};
+  uint32_t block_size = 0;
+  if (!blockInfo(format_, block, block_size)) {
+    INFO("unsupported KTX2 format " + std::to_string(header.vk_format));
+    return false;
+  }
+  image_type_ = !header.pixel_height  ? VK_IMAGE_TYPE_1D
+                : header.pixel_depth ? VK_IMAGE_TYPE_3D
+                                     : VK_IMAGE_TYPE_2D;
+  size_ = {header.pixel_width, std::max(header.pixel_height, 1u),
+           std::max(header.pixel_depth, 1u)};
+  array_layers_ = std::max(header.layer_count, 1u);
+  cubemap_ = header.face_count == 6;
+  // 0 levels asks for mips to be generated at load time, only the base
+  // level is stored
+  mip_levels_ = std::max(header.level_count, 1u);
+  uint32_t layers = array_layers_ * (cubemap_ ? 6 : 1);
+  for (uint32_t level = 0; level < mip_levels_; ++level) {
+    KTX2Level index{};
+    if (!read(file_, sizeof(KTX2Header) + level * sizeof(KTX2Level), index))
+      return false;
+    Region region;
+    region.mip_level = level;
+    region.layer_count = layers;
+    region.extent = {std::max(size_.width >> level, 1u),
+                     std::max(size_.height >> level, 1u),
+                     std::max(size_.depth >> level, 1u)};
+    // compared without sums, crafted offsets and lengths must not wrap
+    if (index.byte_offset > file_.size() ||
+        index.byte_length > file_.size() - index.byte_offset ||
+        levelSize(level) > file_.size() / layers)
+      return false;
+    region.offset = index.byte_offset;
+    region.size = levelSize(level) * layers;
+    if (index.byte_length < region.size)
+      return false;
+    regions_.emplace_back(region);
+  }
+  return true;
+}
+
+bool TextureContainer::parseDDS() {
+  DDSHeader header{};
+  if (!read(file_, 4, header) || header.size != sizeof(DDSHeader))
+    return false;
+  size_t offset = 4 + sizeof(DDSHeader);
+  size_ = {header.width, std::max(header.height, 1u), 1};
+  mip_levels_ = std::max(header.mip_map_count, 1u);
+  array_layers_ = 1;
+  image_type_ = VK_IMAGE_TYPE_2D;
+  if (header.pixel_format.four_cc == fourCC('D', 'X', '1', '0')) {
+    DDSHeaderDX10 dx10{};
+    if (!read(file_, offset, dx10))
+      return false;
+    offset += sizeof(DDSHeaderDX10);
+    format_ = dxgiFormat(dx10.dxgi_format);
+    array_layers_ = std::max(dx10.array_size, 1u);
+    cubemap_ = dx10.misc_flag & kDDSResourceMiscTextureCube;
+    if (dx10.resource_dimension == kDDSResourceDimensionTexture1D)
+      image_type_ = VK_IMAGE_TYPE_1D;
+    else if (dx10.resource_dimension == kDDSResourceDimensionTexture3D)
+      image_type_ = VK_IMAGE_TYPE_3D;
+  } else {
+    format_ = ddsFormat(header.pixel_format);
+    cubemap_ = header.caps2 & kDDSCaps2Cubemap;
+    if (header.caps2 & kDDSCaps2Volume)
+      image_type_ = VK_IMAGE_TYPE_3D;
+  }
+  if (image_type_ == VK_IMAGE_TYPE_3D)
+    size_.depth = std::max(header.depth, 1u);
+  VkExtent2D block{};
+  uint32_t block_size = 0;
+  if (!blockInfo(format_, block, block_size)) {
+    INFO("unsupported DDS format");
+    return false;
+  }
+  // DDS stores each layer (or face) with its whole mip chain
+  uint32_t layers = array_layers_ * (cubemap_ ? 6 : 1);
+  for (uint32_t layer = 0; layer < layers; ++layer)
+    for (uint32_t level = 0; level < mip_levels_; ++level) {
+      Region region;
+      region.mip_level = level;
+      region.base_array_layer = layer;
+      region.extent = {std::max(size_.width >> level, 1u),
+                       std::max(size_.height >> level, 1u),
+                       std::max(size_.depth >> level, 1u)};
+      region.offset = offset;
+      region.size = levelSize(level);
+      if (offset > file_.size() || region.size > file_.size() - offset)
+        return false;
+      offset += region.size;
+      regions_.emplace_back(region);
+    }
+  return true;
+}
+
+size_t TextureContainer::levelSize(uint32_t mip_level) const {
+  VkExtent2D block{};
+  uint32_t block_size = 0;
+  blockInfo(format_, block, block_size);
+  size_t width = std::max(size_.width >> mip_level, 1u);
+  size_t height = std::max(size_.height >> mip_level, 1u);
+  size_t depth = std::max(size_.depth >> mip_level, 1u);
+  return (width + block.width - 1) / block.width *
+         ((height + block.height - 1) / block.height) * depth * block_size;
+}
+
+bool TextureContainer::good() const { return !regions_.empty(); }
+
+VkFormat TextureContainer::format() const { return format_; }
+
+VkImageType TextureContainer::imageType() const { return image_type_; }
+
+VkExtent3D TextureContainer::size() const { return size_; }
+
+uint32_t TextureContainer::mipLevels() const { return mip_levels_; }
+
+uint32_t TextureContainer::arrayLayers() const { return array_layers_; }
+
+bool TextureContainer::cubemap() const { return cubemap_; }
+
+const std::vector<TextureContainer::Region> &
+TextureContainer::regions() const {
+  return regions_;
+}
+
+VkDeviceSize TextureContainer::dataSize() const {
+  VkDeviceSize size = 0;
+  for (const auto &region : regions_)
+    size += region.size;
+  return size;
+}
+
+VkDeviceSize TextureContainer::stagingSize() const {
+  VkExtent2D block{};
+  uint32_t block_size = 0;
+  blockInfo(format_, block, block_size);
+  // worst case alignment padding of each region
+  return dataSize() + regions_.size() * std::lcm(block_size, 4u);
+}
+
+bool TextureContainer::stage(
+    StagingBuffer &staging,
+    std::vector<VkBufferImageCopy> &copy_regions) const {
+  RETURN_FALSE_IF_NOT(good())
+  VkDeviceSize offset = 0;
+  void *destination = staging.reserve(stagingSize(), offset);
+  D_RETURN_FALSE_IF_NOT(destination, "staging buffer is too small");
+  stage(destination, offset, copy_regions);
+  return true;
+}
+
+void TextureContainer::stage(
+    void *destination, VkDeviceSize buffer_offset,
+    std::vector<VkBufferImageCopy> &copy_regions) const {
+  VkExtent2D block{};
+  uint32_t block_size = 0;
+  blockInfo(format_, block, block_size);
+  // buffer offsets must be multiples of 4 and of the block size
+  VkDeviceSize alignment = std::lcm(block_size, 4u);
+  VkDeviceSize offset = buffer_offset;
+  copy_regions.clear();
+  for (const auto &region : regions_) {
+    offset = (offset + alignment - 1) / alignment * alignment;
+    std::memcpy(static_cast<uint8_t *>(destination) + (offset - buffer_offset),
+                static_cast<const uint8_t *>(file_.data()) + region.offset,
+                region.size);
+    VkBufferImageCopy copy = {};
+    copy.bufferOffset = offset;
+    copy.bufferRowLength = 0;
+    copy.bufferImageHeight = 0;
+    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy.imageSubresource.mipLevel = region.mip_level;
+    copy.imageSubresource.baseArrayLayer = region.base_array_layer;
+    copy.imageSubresource.layerCount = region.layer_count;
+    copy.imageOffset = {0, 0, 0};
+    copy.imageExtent = region.extent;
+    copy_regions.emplace_back(copy);
+    offset += region.size;
+  }
+}
+
+bool TextureContainer::isSupported(const PhysicalDevice &physical_device,
+                                   VkFormat format) {
+  VkFormatProperties properties{};
+  if (!physical_device.formatProperties(format, properties))
+    return false;
+  return properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+}
+
+bool TextureContainer::writeDDS(
+    const std::string &filename, VkFormat format, VkExtent2D size,
+    const std::vector<std::vector<uint8_t>> &levels) {
+  uint32_t dxgi_format = dxgiFormat(format);
+  D_RETURN_FALSE_IF_NOT(dxgi_format && !levels.empty(),
+                        "format can not be written as DDS");
+  DDSHeader header{};
+  header.size = sizeof(DDSHeader);
+  header.flags = kDDSHeaderFlags | kDDSHeaderLinearSize |
+                 (levels.size() > 1 ? kDDSHeaderMipMapCount : 0);
+  header.width = size.width;
+  header.height = size.height;
+  header.pitch_or_linear_size = static_cast<uint32_t>(levels[0].size());
+  header.depth = 1;
+  header.mip_map_count = static_cast<uint32_t>(levels.size());
+  header.pixel_format.size = sizeof(DDSPixelFormat);
+  header.pixel_format.flags = kDDSPixelFormatFourCC;
+  header.pixel_format.four_cc = fourCC('D', 'X', '1', '0');
+  header.caps = kDDSCapsTexture |
+                (levels.size() > 1 ? kDDSCapsComplex | kDDSCapsMipMap : 0);
+  DDSHeaderDX10 dx10{};
+  dx10.dxgi_format = dxgi_format;
+  dx10.resource_dimension = kDDSResourceDimensionTexture2D;
+  dx10.array_size = 1;
+  std::ofstream file(filename, std::ios::binary);
+  D_RETURN_FALSE_IF_NOT(file.good(), "could not write " + filename);
+  file.write("DDS ", 4);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(&dx10), sizeof(dx10));
+  for (const auto &level : levels)
+    file.write(reinterpret_cast<const char *>(level.data()), level.size());
+  return file.good();
+}
+
+bool TextureContainer::blockInfo(VkFormat format, VkExtent2D &block,
+                                 uint32_t &block_size) {
+  block = {1, 1};
+  switch (format) {
+  case VK_FORMAT_R8_UNORM:
+  case VK_FORMAT_R8_SNORM:
+  case VK_FORMAT_R8_UINT:
+  case VK_FORMAT_R8_SRGB:
+    block_size = 1;
+    return true;
+  case VK_FORMAT_R8G8_UNORM:
+  case VK_FORMAT_R8G8_SNORM:
+  case VK_FORMAT_R8G8_UINT:
+  case VK_FORMAT_R8G8_SRGB:
+  case VK_FORMAT_R16_UNORM:
+  case VK_FORMAT_R16_SFLOAT:
+  case VK_FORMAT_R5G6B5_UNORM_PACK16:
+    block_size = 2;
+    return true;
+  case VK_FORMAT_R8G8B8_UNORM:
+  case VK_FORMAT_R8G8B8_SRGB:
+  case VK_FORMAT_B8G8R8_UNORM:
+  case VK_FORMAT_B8G8R8_SRGB:
+    block_size = 3;
+    return true;
+  case VK_FORMAT_R8G8B8A8_UNORM:
+  case VK_FORMAT_R8G8B8A8_SNORM:
+  case VK_FORMAT_R8G8B8A8_UINT:
+  case VK_FORMAT_R8G8B8A8_SRGB:
+  case VK_FORMAT_B8G8R8A8_UNORM:
+  case VK_FORMAT_B8G8R8A8_SRGB:
+  case VK_FORMAT_R16G16_UNORM:
+  case VK_FORMAT_R16G16_SFLOAT:
+  case VK_FORMAT_R32_SFLOAT:
+  case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+  case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+  case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:
+    block_size = 4;
+    return true;
+  case VK_FORMAT_R16G16B16A16_UNORM:
+  case VK_FORMAT_R16G16B16A16_SFLOAT:
+  case VK_FORMAT_R32G32_SFLOAT:
+    block_size = 8;
+    return true;
+  case VK_FORMAT_R32G32B32A32_SFLOAT:
+    block_size = 16;
+    return true;
+  default:
+    break;
+  }
+  block = {4, 4};
+  switch (format) {
+  case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+  case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+  case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+  case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+  case VK_FORMAT_BC4_UNORM_BLOCK:
+  case VK_FORMAT_BC4_SNORM_BLOCK:
+  case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+  case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+  case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+  case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+  case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+  case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+    block_size = 8;
+    return true;
+  case VK_FORMAT_BC2_UNORM_BLOCK:
+  case VK_FORMAT_BC2_SRGB_BLOCK:
+  case VK_FORMAT_BC3_UNORM_BLOCK:
+  case VK_FORMAT_BC3_SRGB_BLOCK:
+  case VK_FORMAT_BC5_UNORM_BLOCK:
+  case VK_FORMAT_BC5_SNORM_BLOCK:
+  case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+  case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+  case VK_FORMAT_BC7_UNORM_BLOCK:
+  case VK_FORMAT_BC7_SRGB_BLOCK:
+  case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+  case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+  case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+  case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+  case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+    block_size = 16;
+    return true;
+  default:
+    break;
+  }
+  // ASTC blocks are always 16 bytes
+  block_size = 16;
+  switch (format) {
+  case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:
+    block = {5, 4};
+    return true;
+  case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
+    block = {5, 5};
+    return true;
+  case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:
+    block = {6, 5};
+    return true;
+  case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+    block = {6, 6};
+    return true;
+  case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:
+    block = {8, 5};
+    return true;
+  case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:
+    block = {8, 6};
+    return true;
+  case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+    block = {8, 8};
+    return true;
+  case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:
+    block = {10, 5};
+    return true;
+  case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:
+    block = {10, 6};
+    return true;
+  case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:
+    block = {10, 8};
+    return true;
+  case VK_FORMAT_ASTC_10x10_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
+    block = {10, 10};
+    return true;
+  case VK_FORMAT_ASTC_12x10_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
+    block = {12, 10};
+    return true;
+  case VK_FORMAT_ASTC_12x12_UNORM_BLOCK:
+  case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
+    block = {12, 12};
+    return true;
+  default:
+    break;
+  }
+  return false;
+}
+
+} // namespace circe::vk
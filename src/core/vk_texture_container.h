@@ -0,0 +1,139 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_texture_container.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_TEXTURE_CONTAINER_H
+#define CIRCE_VK_TEXTURE_CONTAINER_H
+
+#include "vk_mapped_file.h"
+#include "vk_staging_buffer.h"
+#include "vulkan_physical_device.h"
+#include <vector>
+
+namespace circe::vk {
+
+/// \brief Texture file containers holding GPU ready data: KTX2 and DDS.
+/// Containers carry precomputed mip levels, array layers and cube faces,
+/// usually in block-compressed formats (BC1-BC7, ETC2/EAC, ASTC), so the
+/// texels are copied as they are, without decoding or mip generation.
+/// The file is memory mapped, its payload is copied once into staging
+/// memory. Supercompressed KTX2 files (BasisLZ, zstd) are not supported.
+/// Usage:
+///   TextureContainer container(TEXTURES_PATH "/albedo.ktx2");
+///   if (container.good() &&
+///       TextureContainer::isSupported(*physical_device, container.format()))
+///     Texture texture(device, container, family_index, queue);
+class TextureContainer final {
+public:
+  /// \brief Location of the texels of a mip level (of one or more layers)
+  /// inside the file
+  struct Region {
+    uint32_t mip_level{0};
+    uint32_t base_array_layer{0};
+    uint32_t layer_count{1};
+    VkExtent3D extent{};
+    size_t offset{0}; //!< from the beginning of the file
+    size_t size{0};
+  };
+  TextureContainer() = default;
+  ///\param filename **[in]** .ktx2 or .dds file
+  explicit TextureContainer(const std::string &filename);
+  ///\param filename **[in]** .ktx2 or .dds file
+  ///\return bool true if success
+  bool open(const std::string &filename);
+  ///\return bool true if the file was parsed
+  [[nodiscard]] bool good() const;
+  [[nodiscard]] VkFormat format() const;
+  [[nodiscard]] VkImageType imageType() const;
+  ///\return VkExtent3D dimensions of the first mip level (in texels)
+  [[nodiscard]] VkExtent3D size() const;
+  [[nodiscard]] uint32_t mipLevels() const;
+  ///\return uint32_t number of array layers (cube faces not included)
+  [[nodiscard]] uint32_t arrayLayers() const;
+  [[nodiscard]] bool cubemap() const;
+  ///\return const std::vector<Region>& texel ranges of all subresources
+  [[nodiscard]] const std::vector<Region> &regions() const;
+  ///\return VkDeviceSize number of texel bytes of all subresources
+  [[nodiscard]] VkDeviceSize dataSize() const;
+  ///\return VkDeviceSize staging memory needed by stage()
+  [[nodiscard]] VkDeviceSize stagingSize() const;
+  ///\brief Copies all texels into the staging buffer
+  ///\param staging **[in]**
+  ///\param copy_regions **[out]** copies from the staging buffer into an
+  /// image created from this container
+  ///\return bool true if success
+  bool stage(StagingBuffer &staging,
+             std::vector<VkBufferImageCopy> &copy_regions) const;
+  ///\brief Copies all texels into a range of a staging buffer
+  ///\param destination **[in]** mapped range of at least stagingSize() bytes
+  ///\param buffer_offset **[in]** offset of the range in the buffer
+  ///\param copy_regions **[out]** copies from the staging buffer into an
+  /// image created from this container
+  void stage(void *destination, VkDeviceSize buffer_offset,
+             std::vector<VkBufferImageCopy> &copy_regions) const;
+  ///\brief Checks if images of the format can be sampled (optimal tiling)
+  ///\param physical_device **[in]**
+  ///\param format **[in]**
+  ///\return bool true if supported
+  static bool isSupported(const PhysicalDevice &physical_device,
+                          VkFormat format);
+  ///\brief Writes a 2D texture as a DDS file (DX10 header)
+  ///\param filename **[in]**
+  ///\param format **[in]** any format with a DXGI equivalent (BC1-BC7,
+  /// RGBA8, ...)
+  ///\param size **[in]** dimensions of the first mip level
+  ///\param levels **[in]** texels of each mip level, from the largest
+  ///\return bool true if success
+  static bool writeDDS(const std::string &filename, VkFormat format,
+                       VkExtent2D size,
+                       const std::vector<std::vector<uint8_t>> &levels);
+  ///\brief Texel block dimensions and size of a format
+  ///\param format **[in]**
+  ///\param block **[out]** 1x1 for uncompressed formats
+  ///\param block_size **[out]** bytes per block
+  ///\return bool false if the format is not known
+  static bool blockInfo(VkFormat format, VkExtent2D &block,
+                        uint32_t &block_size);
+
+private:
+  bool parseKTX2();
+  bool parseDDS();
+  ///\return size_t bytes of one layer of a mip level
+  size_t levelSize(uint32_t mip_level) const;
+
+  MappedFile file_;
+  VkFormat format_{VK_FORMAT_UNDEFINED};
+  VkImageType image_type_{VK_IMAGE_TYPE_2D};
+  VkExtent3D size_{};
+  uint32_t mip_levels_{1};
+  uint32_t array_layers_{1};
+  bool cubemap_{false};
+  std::vector<Region> regions_;
+};
+
+} // namespace circe::vk
+
+#endif
@@ -27,93 +27,146 @@
 
 #include "vk_texture_image.h"
 #include "logging.h"
+#include "vk_bindless.h"
 #include "vk_buffer.h"
 #include "vk_command_buffer.h"
+#include "vk_image_decoder.h"
+#include "vk_mip_downsampler.h"
+#include "vk_mip_generator.h"
+#include "vk_staging_buffer.h"
 #include "vk_sync.h"
+#include "vk_texture_container.h"
 #include "vulkan_debug.h"
-
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
+#include <algorithm>
 
 namespace circe::vk {
 
 Texture::Texture(const LogicalDevice *logical_device,
                  const std::string &filename, uint32_t queue_family_index,
-                 VkQueue queue)
+                 VkQueue queue, MipDownsampler *downsampler)
     : logical_device_(logical_device) {
   auto tex_image_format = VK_FORMAT_R8G8B8A8_SRGB;
-  int tex_width, tex_height, tex_channels;
-  stbi_uc *pixels = stbi_load(filename.c_str(), &tex_width, &tex_height,
-                              &tex_channels, STBI_rgb_alpha);
-  if (!pixels) {
+  const bool compute_mipmaps =
+      downsampler && MipDownsampler::isSupported(
+                         *logical_device_->physicalDevice(), tex_image_format);
+  // the header gives the size of the staging memory, texels are then
+  // decoded straight into it
+  VkExtent3D size = {};
+  if (!ImageDecoder::info(filename, size)) {
     INFO("could not load texture image file!");
     return;
   }
-  uint32_t mip_levels =
-      static_cast<uint32_t>(std::floor(
-          std::log2((tex_width > tex_height) ? tex_width : tex_height))) +
-      1;
-  VkDeviceSize image_size = tex_width * tex_height * 4;
-
-  Buffer staging_buffer(logical_device_, image_size,
-                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-  DeviceMemory staging_buffer_memory(staging_buffer,
-                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-  staging_buffer_memory.bind(staging_buffer);
-  staging_buffer_memory.copy(pixels, staging_buffer.size());
-  stbi_image_free(pixels);
+  // without linear blits the whole chain is generated on the host, right
+  // after the first level in the staging memory
+  const bool host_mipmaps =
+      !compute_mipmaps && !supportsLinearBlit(
+                              *logical_device_->physicalDevice(),
+                              tex_image_format);
+  VkDeviceSize staging_size = ImageDecoder::destinationSize(size);
+  if (host_mipmaps)
+    staging_size = std::max(staging_size,
+                            MipGenerator::chainSize(size.width, size.height));
+  StagingBuffer staging_buffer(logical_device_, staging_size);
+  VkDeviceSize offset = 0;
+  void *texels = staging_buffer.reserve(staging_buffer.size(), offset);
+  if (!texels || !ImageDecoder::decodeRGBA8(
+                     filename, size, texels,
+                     ImageDecoder::destinationSize(size))) {
+    INFO("could not load texture image file!");
+    return;
+  }
+  uint32_t mip_levels = MipGenerator::levelCount(size.width, size.height);
+  std::vector<VkBufferImageCopy> regions;
+  if (host_mipmaps) {
+    regions = MipGenerator::copyRegions(size.width, size.height, offset);
+    std::vector<uint8_t *> levels;
+    for (size_t i = 1; i < regions.size(); ++i)
+      levels.emplace_back(static_cast<uint8_t *>(texels) +
+                          (regions[i].bufferOffset - offset));
+    MipGenerator mip_generator;
+    if (!mip_generator.generate(static_cast<const uint8_t *>(texels),
+                                size.width, size.height, levels)) {
+      INFO("could not generate texture mip levels!");
+      return;
+    }
+  }
   // Allocate image data on device
-  VkExtent3D size = {};
-  size.width = tex_width;
-  size.height = tex_height;
-  size.depth = 1;
-  image_ = std::make_unique<Image>(
-      logical_device_, VK_IMAGE_TYPE_2D, tex_image_format, size, mip_levels, 1,
-      VK_SAMPLE_COUNT_1_BIT,
-      VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-          VK_IMAGE_USAGE_SAMPLED_BIT,
-      false);
-  image_memory_ = std::make_unique<DeviceMemory>(
-      *image_, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  image_memory_->bind(*image_);
-  // copy data to device
-  CommandPool::submitCommandBuffer(
-      logical_device_, queue_family_index, queue, [&](CommandBuffer &cb) {
-        ImageMemoryBarrier barrier(*image_, VK_IMAGE_LAYOUT_UNDEFINED,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        cb.transitionImageLayout(barrier, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT);
-        VkBufferImageCopy region = {};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {size.width, size.height, 1};
-        cb.copy(staging_buffer, *image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                {region});
-        // ImageMemoryBarrier after_barrier(
-        //     *image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        //     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        // cb.transitionImageLayout(after_barrier,
-        // VK_PIPELINE_STAGE_TRANSFER_BIT,
-        //                          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-      });
-  generateMipmaps(queue, queue_family_index);
+  VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                            VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                            VK_IMAGE_USAGE_SAMPLED_BIT;
+  if (compute_mipmaps)
+    image_ = std::make_unique<Image>(
+        logical_device_, VK_IMAGE_TYPE_2D,
+        MipDownsampler::storageFormat(tex_image_format), size, mip_levels, 1,
+        VK_SAMPLE_COUNT_1_BIT, usage | MipDownsampler::imageUsage(), false,
+        MipDownsampler::imageCreateFlags(tex_image_format));
+  else
+    image_ = std::make_unique<Image>(logical_device_, VK_IMAGE_TYPE_2D,
+                                     tex_image_format, size, mip_levels, 1,
+                                     VK_SAMPLE_COUNT_1_BIT, usage, false);
+  allocateMemory();
+  // copy data to device and fill the mip chain with a single submission
+  CommandPool::submitCommandBuffer(logical_device_, queue_family_index, queue,
+                                   [&](CommandBuffer &cb) {
+                                     if (host_mipmaps) {
+                                       recordUpload(cb,
+                                                    staging_buffer.buffer(),
+                                                    regions);
+                                       cb.use(*image_,
+                                              ImageUsage::SAMPLED_FRAGMENT);
+                                       return;
+                                     }
+                                     recordUpload(cb, staging_buffer.buffer(),
+                                                  offset);
+                                     if (compute_mipmaps)
+                                       generateMipmaps(cb, *downsampler,
+                                                       tex_image_format);
+                                     else
+                                       generateMipmaps(cb);
+                                   });
+  // the submission is complete, views of the downsampler can go
+  if (compute_mipmaps)
+    downsampler->release(*image_);
 }
 
 Texture::Texture(const LogicalDevice *logical_device, VkImageType type,
                  VkFormat format, VkExtent3D size, uint32_t num_mipmaps,
                  uint32_t num_layers, VkSampleCountFlagBits samples,
-                 VkImageUsageFlags usage_scenarios, bool cubemap)
+                 VkImageUsageFlags usage_scenarios, bool cubemap,
+                 VkImageCreateFlags create_flags)
+    : logical_device_(logical_device) {
+  image_ = std::make_unique<Image>(logical_device_, type, format, size,
+                                   num_mipmaps, num_layers, samples,
+                                   usage_scenarios, cubemap, create_flags);
+}
+
+Texture::Texture(const LogicalDevice *logical_device,
+                 const TextureContainer &container,
+                 uint32_t queue_family_index, VkQueue queue)
     : logical_device_(logical_device) {
-  image_ =
-      std::make_unique<Image>(logical_device_, type, format, size, num_mipmaps,
-                              num_layers, samples, usage_scenarios, cubemap);
+  if (!container.good())
+    return;
+  if (!TextureContainer::isSupported(*logical_device_->physicalDevice(),
+                                     container.format())) {
+    INFO("texture container format is not supported by the device!");
+    return;
+  }
+  StagingBuffer staging_buffer(logical_device_, container.stagingSize());
+  std::vector<VkBufferImageCopy> regions;
+  if (!container.stage(staging_buffer, regions))
+    return;
+  image_ = std::make_unique<Image>(
+      logical_device_, container.imageType(), container.format(),
+      container.size(), container.mipLevels(), container.arrayLayers(),
+      VK_SAMPLE_COUNT_1_BIT,
+      VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+      container.cubemap());
+  allocateMemory();
+  CommandPool::submitCommandBuffer(
+      logical_device_, queue_family_index, queue, [&](CommandBuffer &cb) {
+        recordUpload(cb, staging_buffer.buffer(), regions);
+        cb.use(*image_, ImageUsage::SAMPLED_FRAGMENT);
+      });
 }
 
 void Texture::setData(const unsigned char *data, uint32_t queue_family_index,
@@ -126,117 +179,172 @@ void Texture::setData(const unsigned char *data, uint32_t queue_family_index,
                                          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
   staging_buffer_memory.bind(staging_buffer);
   staging_buffer_memory.copy(data, staging_buffer.size());
-  image_memory_ = std::make_unique<DeviceMemory>(
-      *image_, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  image_memory_->bind(*image_);
+  allocateMemory();
   // copy data to device
   CommandPool::submitCommandBuffer(
       logical_device_, queue_family_index, queue, [&](CommandBuffer &cb) {
-        ImageMemoryBarrier barrier(*image_, VK_IMAGE_LAYOUT_UNDEFINED,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        cb.transitionImageLayout(barrier, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT);
-        VkBufferImageCopy region = {};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = image_->size();
-        cb.copy(staging_buffer, *image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                {region});
-        ImageMemoryBarrier after_barrier(
-            *image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        cb.transitionImageLayout(after_barrier, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        recordUpload(cb, staging_buffer);
+        cb.use(*image_, ImageUsage::SAMPLED_FRAGMENT);
       });
 }
 
+Texture::~Texture() { unregisterBindless(); }
+
 const Image *Texture::image() const { return image_.get(); }
 
-void Texture::generateMipmaps(VkQueue queue, uint32_t queue_family_index) {
+uint32_t Texture::registerBindless(BindlessTextureTable &table,
+                                   VkFormat format) {
+  if (bindless_table_ == &table)
+    return bindless_index_;
+  unregisterBindless();
+  if (!image_ || !image_->good())
+    return ~0u;
+  bindless_view_ = std::make_unique<Image::View>(
+      image_.get(), VK_IMAGE_VIEW_TYPE_2D,
+      format == VK_FORMAT_UNDEFINED ? image_->format() : format,
+      VK_IMAGE_ASPECT_COLOR_BIT, 0, image_->mipLevels(), 0, 1);
+  bindless_index_ = table.addImage(*bindless_view_);
+  if (bindless_index_ == ~0u) {
+    bindless_view_.reset();
+    return ~0u;
+  }
+  bindless_table_ = &table;
+  return bindless_index_;
+}
+
+void Texture::unregisterBindless() {
+  if (!bindless_table_)
+    return;
+  bindless_table_->removeImage(bindless_index_);
+  // as the image, the view must no longer be read by frames in flight
+  bindless_table_ = nullptr;
+  bindless_index_ = ~0u;
+  bindless_view_.reset();
+}
+
+uint32_t Texture::bindlessIndex() const { return bindless_index_; }
+
+bool Texture::allocateMemory() {
+  RETURN_FALSE_IF_NOT(image_ && image_->good())
+  image_memory_ = std::make_unique<DeviceMemory>(
+      *image_, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  return image_memory_->bind(*image_);
+}
+
+void Texture::recordUpload(const CommandBuffer &cb,
+                           const Buffer &staging_buffer, VkDeviceSize offset) {
+  // previous contents are discarded
+  image_->state().set({});
+  cb.use(*image_, ImageUsage::TRANSFER_DST);
+  VkBufferImageCopy region = {};
+  region.bufferOffset = offset;
+  region.bufferRowLength = 0;
+  region.bufferImageHeight = 0;
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.mipLevel = 0;
+  region.imageSubresource.baseArrayLayer = 0;
+  region.imageSubresource.layerCount = 1;
+  region.imageOffset = {0, 0, 0};
+  region.imageExtent = image_->size();
+  cb.copy(staging_buffer, *image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          {region});
+}
+
+void Texture::recordUpload(const CommandBuffer &cb,
+                           const Buffer &staging_buffer,
+                           const std::vector<VkBufferImageCopy> &regions) {
+  // previous contents are discarded
+  image_->state().set({});
+  cb.use(*image_, ImageUsage::TRANSFER_DST);
+  cb.copy(staging_buffer, *image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          regions);
+}
+
+void Texture::recordCopy(const CommandBuffer &cb, const Texture &source,
+                         uint32_t source_level, uint32_t level) {
+  const auto size = source.image_->size();
+  const uint32_t level_count =
+      std::min(image_->mipLevels() - level,
+               source.image_->mipLevels() - source_level);
+  const uint32_t layer_count = image_->arrayLayers();
+  cb.use(*source.image_, ImageUsage::TRANSFER_SRC, source_level, level_count);
+  cb.use(*image_, ImageUsage::TRANSFER_DST, level, level_count);
+  std::vector<VkImageCopy> regions(level_count);
+  for (uint32_t i = 0; i < level_count; ++i) {
+    const uint32_t src_level = source_level + i;
+    regions[i].srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, src_level, 0,
+                                 layer_count};
+    regions[i].dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level + i, 0,
+                                 layer_count};
+    regions[i].extent = {std::max(size.width >> src_level, 1u),
+                         std::max(size.height >> src_level, 1u),
+                         std::max(size.depth >> src_level, 1u)};
+  }
+  cb.copy(*source.image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *image_,
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions);
+}
+
+void Texture::generateMipmaps(const CommandBuffer &cb) {
+  const uint32_t mip_levels = image_->mipLevels();
   // check first if we have support for the blit command:
-  VkFormatProperties format_properties;
-  logical_device_->physicalDevice()->formatProperties(image_->format(),
-                                                     format_properties);
-  if (!(format_properties.optimalTilingFeatures &
-        VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+  if (!supportsLinearBlit(*logical_device_->physicalDevice(),
+                          image_->format())) {
     INFO("texture image format does not support linear blitting!");
+    // leave the image in a sampleable state anyway
+    cb.use(*image_, ImageUsage::SAMPLED_FRAGMENT);
     return;
   }
-  // Perform several image transitions (one for each mip level)
-  CommandPool::submitCommandBuffer(
-      logical_device_, queue_family_index, queue, [&](CommandBuffer &cb) {
-        // the same barrier object will be used to
-        // all transitions
-        ImageMemoryBarrier barrier;
-        // first, set common parameters for the barrier
-        auto &vk_barrier = barrier.handle();
-        vk_barrier.image = image_->handle();
-        vk_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        vk_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        vk_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        vk_barrier.subresourceRange.baseArrayLayer = 0;
-        vk_barrier.subresourceRange.layerCount = 1;
-        vk_barrier.subresourceRange.levelCount = 1;
-
-        int32_t mip_width = image_->size().width;
-        int32_t mip_height = image_->size().height;
-        // for each mip level image record the VkCmdBlitImage command
-        for (uint32_t i = 1; i < image_->mipLevels(); ++i) {
-          vk_barrier.subresourceRange.baseMipLevel = i - 1;
-          vk_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-          vk_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-          vk_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-          vk_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-          cb.transitionImageLayout(barrier, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                   VK_PIPELINE_STAGE_TRANSFER_BIT);
-          // define blit command data
-          VkImageBlit blit = {};
-          blit.srcOffsets[0] = {0, 0, 0};
-          blit.srcOffsets[1] = {mip_width, mip_height, 1};
-          blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-          blit.srcSubresource.mipLevel = i - 1;
-          blit.srcSubresource.baseArrayLayer = 0;
-          blit.srcSubresource.layerCount = 1;
-          blit.dstOffsets[0] = {0, 0, 0};
-          blit.dstOffsets[1] = {mip_width > 1 ? mip_width / 2 : 1,
-                                mip_height > 1 ? mip_height / 2 : 1, 1};
-          blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-          blit.dstSubresource.mipLevel = i;
-          blit.dstSubresource.baseArrayLayer = 0;
-          blit.dstSubresource.layerCount = 1;
-          // record command
-          cb.blit(*image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *image_,
-                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, {blit},
-                  VK_FILTER_LINEAR);
-          // now transition the mip level i-1
-          vk_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-          vk_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-          vk_barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-          vk_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-          // This transition waits on the current blit command to finish
-          // All sampling operations will wait on this transition to finish.
-          cb.transitionImageLayout(barrier, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                   VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-          if (mip_width > 1)
-            mip_width /= 2;
-          if (mip_height > 1)
-            mip_height /= 2;
-        }
-        // Now, transition the last mip level
-        vk_barrier.subresourceRange.baseMipLevel = image_->mipLevels() - 1;
-        vk_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        vk_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        vk_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        vk_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        cb.transitionImageLayout(barrier, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-      });
+  int32_t mip_width = image_->size().width;
+  int32_t mip_height = image_->size().height;
+  // for each mip level image record the VkCmdBlitImage command
+  for (uint32_t i = 1; i < mip_levels; ++i) {
+    // level i - 1 was written by the copy or by the previous blit, it must
+    // become the source of the next blit (level i is already a transfer
+    // destination since the upload)
+    cb.use(*image_, ImageUsage::TRANSFER_SRC, i - 1, 1);
+    // define blit command data
+    VkImageBlit blit = {};
+    blit.srcOffsets[0] = {0, 0, 0};
+    blit.srcOffsets[1] = {mip_width, mip_height, 1};
+    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.srcSubresource.mipLevel = i - 1;
+    blit.srcSubresource.baseArrayLayer = 0;
+    blit.srcSubresource.layerCount = 1;
+    blit.dstOffsets[0] = {0, 0, 0};
+    blit.dstOffsets[1] = {mip_width > 1 ? mip_width / 2 : 1,
+                          mip_height > 1 ? mip_height / 2 : 1, 1};
+    blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.dstSubresource.mipLevel = i;
+    blit.dstSubresource.baseArrayLayer = 0;
+    blit.dstSubresource.layerCount = 1;
+    // record command
+    cb.blit(*image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *image_,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, {blit}, VK_FILTER_LINEAR);
+    if (mip_width > 1)
+      mip_width /= 2;
+    if (mip_height > 1)
+      mip_height /= 2;
+  }
+  // Levels [0, mip_levels - 1) are blit sources now and the last level was the
+  // destination of the last blit. Instead of transitioning each level right
+  // after its blit, the whole chain goes to the shader read layout at once
+  // (the tracker merges levels sharing the same state into one barrier).
+  // All sampling operations will wait on this barrier.
+  cb.use(*image_, ImageUsage::SAMPLED_FRAGMENT);
+}
+
+bool Texture::generateMipmaps(CommandBuffer &cb, MipDownsampler &downsampler,
+                              VkFormat format) {
+  return downsampler.record(cb, *image_, format);
+}
+
+bool Texture::supportsLinearBlit(const PhysicalDevice &physical_device,
+                                 VkFormat format) {
+  VkFormatProperties format_properties;
+  if (!physical_device.formatProperties(format, format_properties))
+    return false;
+  return format_properties.optimalTilingFeatures &
+         VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
 }
 
 } // namespace circe::vk
@@ -34,11 +34,27 @@
 
 namespace circe::vk {
 
+class BindlessTextureTable;
+class Buffer;
+class CommandBuffer;
+class MipDownsampler;
+class TextureContainer;
+
 class Texture {
 public:
+  ///\brief Loads an image file into a R8G8B8A8_SRGB image with a full mip
+  /// chain
+  ///\param logical_device **[in]**
+  ///\param filename **[in]**
+  ///\param queue_family_index **[in]**
+  ///\param queue **[in]**
+  ///\param downsampler **[in | optional = nullptr]** if given (and the
+  /// device supports it), mip levels are generated by compute dispatches
+  /// instead of blits. The image is then created with the R8G8B8A8_UNORM
+  /// storage format and must be sampled through sRGB views.
   explicit Texture(const LogicalDevice *logical_device,
                    const std::string &filename, uint32_t queue_family_index,
-                   VkQueue queue);
+                   VkQueue queue, MipDownsampler *downsampler = nullptr);
   /// \param logical_device **[in]** logical device (on which the image
   /// will be created)
   /// \param type **[in]** number of dimensions of the image
@@ -50,21 +66,97 @@ public:
   /// \param samples **[in]** number of samples
   /// \param usage_scenarios **[in]**
   /// \param cubemap **[in]**
+  /// \param create_flags **[in | optional = 0]** extra image creation flags
   Texture(const LogicalDevice *logical_device, VkImageType type,
           VkFormat format, VkExtent3D size, uint32_t num_mipmaps,
           uint32_t num_layers, VkSampleCountFlagBits samples,
-          VkImageUsageFlags usage_scenarios, bool cubemap);
+          VkImageUsageFlags usage_scenarios, bool cubemap,
+          VkImageCreateFlags create_flags = 0);
+  ///\brief Creates the image with the format, mip levels and layers stored
+  /// in the container and uploads all of them with a single copy command.
+  /// No mip levels are generated.
+  ///\param logical_device **[in]**
+  ///\param container **[in]** parsed KTX2 or DDS file
+  ///\param queue_family_index **[in]**
+  ///\param queue **[in]**
+  Texture(const LogicalDevice *logical_device,
+          const TextureContainer &container, uint32_t queue_family_index,
+          VkQueue queue);
+  Texture(const Texture &other) = delete;
+  ~Texture();
   void setData(const unsigned char *data, uint32_t queue_family_index,
                VkQueue queue);
+  ///\brief Allocates and binds device local memory to the image
+  ///\return bool true if success
+  bool allocateMemory();
+  ///\brief Records the copy of the staging buffer into the first mip level.
+  /// All mip levels are left in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL.
+  ///\param cb **[in]**
+  ///\param staging_buffer **[in]**
+  ///\param offset **[in | optional = 0]** offset of the texels in the buffer
+  void recordUpload(const CommandBuffer &cb, const Buffer &staging_buffer,
+                    VkDeviceSize offset = 0);
+  ///\brief Records the copy of several subresources with a single command.
+  /// All mip levels are left in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL.
+  ///\param cb **[in]**
+  ///\param staging_buffer **[in]**
+  ///\param regions **[in]**
+  void recordUpload(const CommandBuffer &cb, const Buffer &staging_buffer,
+                    const std::vector<VkBufferImageCopy> &regions);
+  ///\brief Records the copy of consecutive mip levels of another texture
+  /// (same format and layers) into consecutive mip levels of this one. The
+  /// destination levels are left in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL.
+  ///\param cb **[in]**
+  ///\param source **[in]**
+  ///\param source_level **[in]** first source level
+  ///\param level **[in | optional = 0]** destination of source_level
+  void recordCopy(const CommandBuffer &cb, const Texture &source,
+                  uint32_t source_level, uint32_t level = 0);
+  ///\brief Records the blit chain that fills all mip levels from the first.
+  /// All mip levels are left in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+  ///\param cb **[in]**
+  void generateMipmaps(const CommandBuffer &cb);
+  ///\brief Records the compute dispatches that fill all mip levels from the
+  /// first (see MipDownsampler for the image requirements).
+  /// All mip levels are left in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+  ///\param cb **[in]**
+  ///\param downsampler **[in]**
+  ///\param format **[in | optional = VK_FORMAT_UNDEFINED]** format the
+  /// texels are sampled with (ex: sRGB), undefined means the image format
+  ///\return bool true if success
+  bool generateMipmaps(CommandBuffer &cb, MipDownsampler &downsampler,
+                       VkFormat format = VK_FORMAT_UNDEFINED);
+  ///\brief Checks if mip levels of the format can be generated on the device
+  /// with linear blits. Otherwise, levels must be generated on the host (see
+  /// MipGenerator) and uploaded along with the first.
+  ///\param physical_device **[in]**
+  ///\param format **[in]**
+  ///\return bool true if the format supports linear filtered blits
+  static bool supportsLinearBlit(const PhysicalDevice &physical_device,
+                                 VkFormat format);
   [[nodiscard]] const Image *image() const;
+  ///\brief Registers a 2D view of all mip levels into a bindless table. The
+  /// slot is released by unregisterBindless or on destruction, which (as
+  /// the destruction of the image) must wait for the frames reading it.
+  ///\param table **[in]** must outlive the registration
+  ///\param format **[in | optional = VK_FORMAT_UNDEFINED]** view format
+  /// (ex: sRGB of a storage image), undefined means the image format
+  ///\return uint32_t slot index to be passed to shaders (~0u on failure)
+  uint32_t registerBindless(BindlessTextureTable &table,
+                            VkFormat format = VK_FORMAT_UNDEFINED);
+  ///\brief Releases the bindless slot (if registered)
+  void unregisterBindless();
+  ///\return uint32_t bindless slot index (~0u if not registered)
+  [[nodiscard]] uint32_t bindlessIndex() const;
 
 private:
-  ///\param queue **[in]**
-  ///\param queue_family_index **[in]**
-  void generateMipmaps(VkQueue queue, uint32_t queue_family_index);
   const LogicalDevice *logical_device_ = nullptr;
   std::unique_ptr<Image> image_;
   std::unique_ptr<DeviceMemory> image_memory_;
+  // bindless registration
+  BindlessTextureTable *bindless_table_ = nullptr;
+  std::unique_ptr<Image::View> bindless_view_;
+  uint32_t bindless_index_{~0u};
 };
 
 } // namespace circe::vk
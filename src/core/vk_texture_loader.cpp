@@ -0,0 +1,453 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_texture_loader.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_texture_loader.h"
+#include "logging.h"
+#include "vk_image_decoder.h"
+#include "vk_mip_generator.h"
+#include "vk_texture_container.h"
+#include "vulkan_debug.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+namespace circe::vk {
+
+TextureLoader::Handle::Handle(std::shared_ptr<State> state)
+    : state_(std::move(state)) {}
+
+bool TextureLoader::Handle::ready() const { return state_ && state_->ready; }
+
+bool TextureLoader::Handle::failed() const {
+  return state_ && state_->failed;
+}
+
+const Image::View &TextureLoader::Handle::view() const {
+  if (ready())
+    return *state_->view;
+  return *state_->placeholder;
+}
+
+const Texture *TextureLoader::Handle::texture() const {
+  if (ready())
+    return state_->texture.get();
+  return nullptr;
+}
+
+bool TextureLoader::Handle::valid() const { return state_ != nullptr; }
+
+TextureLoader::TextureLoader(const LogicalDevice *logical_device,
+                             uint32_t queue_family_index, VkQueue queue,
+                             uint32_t worker_count,
+                             VkDeviceSize max_batch_size)
+    : logical_device_(logical_device), queue_family_index_(queue_family_index),
+      vk_queue_(queue), max_batch_size_(max_batch_size) {
+  command_pool_ = std::make_unique<CommandPool>(
+      logical_device_, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      queue_family_index_);
+  blit_srgb_ = Texture::supportsLinearBlit(*logical_device_->physicalDevice(),
+                                           VK_FORMAT_R8G8B8A8_SRGB);
+  blit_unorm_ = Texture::supportsLinearBlit(
+      *logical_device_->physicalDevice(), VK_FORMAT_R8G8B8A8_UNORM);
+  createPlaceholder();
+  if (!worker_count) {
+    auto hardware_threads = std::thread::hardware_concurrency();
+    worker_count = hardware_threads > 1 ? hardware_threads - 1 : 1;
+  }
+  for (uint32_t i = 0; i < worker_count; ++i)
+    workers_.emplace_back(&TextureLoader::workerLoop, this);
+}
+
+TextureLoader::~TextureLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  requests_condition_.notify_all();
+  for (auto &worker : workers_)
+    worker.join();
+  for (auto &batch : submitted_batches_) {
+    batch->fence->wait();
+    command_pool_->freeCommandBuffers(batch->command_buffers);
+  }
+}
+
+void TextureLoader::createPlaceholder() {
+  // 2x2 magenta/black checker, easy to spot while textures are streaming
+  const unsigned char texels[16] = {255, 0, 255, 255, 0,   0, 0,   255,
+                                    0,   0, 0,   255, 255, 0, 255, 255};
+  placeholder_ = std::make_unique<Texture>(
+      logical_device_, VK_IMAGE_TYPE_2D, VK_FORMAT_R8G8B8A8_UNORM,
+      VkExtent3D{2, 2, 1}, 1, 1, VK_SAMPLE_COUNT_1_BIT,
+      VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, false);
+  placeholder_->setData(texels, queue_family_index_, vk_queue_);
+  placeholder_view_ = std::make_unique<Image::View>(
+      placeholder_->image(), VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R8G8B8A8_UNORM,
+      VK_IMAGE_ASPECT_COLOR_BIT);
+}
+
+TextureLoader::Handle TextureLoader::load(const std::string &filename,
+                                          bool srgb, bool mipmaps) {
+  auto state = std::make_shared<Handle::State>();
+  state->filename = filename;
+  state->srgb = srgb;
+  state->mipmaps = mipmaps;
+  state->placeholder = placeholder_view_.get();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!statistics_.textures && !statistics_.failed && !pending_)
+      start_ = std::chrono::steady_clock::now();
+    requests_.push_back(state);
+    pending_++;
+  }
+  requests_condition_.notify_one();
+  return Handle(state);
+}
+
+void TextureLoader::workerLoop() {
+  while (true) {
+    std::shared_ptr<Handle::State> state;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      requests_condition_.wait(lock,
+                               [&] { return stop_ || !requests_.empty(); });
+      if (stop_)
+        return;
+      state = requests_.front();
+      requests_.pop_front();
+    }
+    Decoded decoded;
+    decoded.state = state;
+    std::shared_ptr<Batch> batch;
+    auto extension = state->filename.substr(
+        std::min(state->filename.find_last_of('.'), state->filename.size()));
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   ::tolower);
+    auto start = std::chrono::steady_clock::now();
+    bool staged = extension == ".ktx2" || extension == ".dds"
+                      ? stageContainer(decoded, batch)
+                      : stageImage(decoded, batch);
+    std::chrono::duration<double, std::milli> decode_time =
+        std::chrono::steady_clock::now() - start;
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.decode_time += decode_time.count();
+    if (batch)
+      batch->writing--;
+    if (!staged) {
+      INFO("could not load texture image file " + state->filename);
+      fail({decoded});
+      continue;
+    }
+    batch->decoded.emplace_back(std::move(decoded));
+  }
+}
+
+bool TextureLoader::stageImage(Decoded &decoded,
+                               std::shared_ptr<Batch> &batch) {
+  auto &state = decoded.state;
+  if (!ImageDecoder::info(state->filename, decoded.size))
+    return false;
+  const uint32_t width = decoded.size.width;
+  const uint32_t height = decoded.size.height;
+  decoded.format =
+      state->srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+  decoded.mip_levels =
+      state->mipmaps ? MipGenerator::levelCount(width, height) : 1;
+  // without linear blits the worker generates the chain right after the
+  // first level in the staging memory
+  const bool host_mipmaps = decoded.mip_levels > 1 &&
+                            !(state->srgb ? blit_srgb_ : blit_unorm_);
+  const VkDeviceSize decode_size = ImageDecoder::destinationSize(decoded.size);
+  VkDeviceSize bytes = decode_size;
+  if (host_mipmaps)
+    bytes = std::max(bytes, MipGenerator::chainSize(width, height));
+  VkDeviceSize offset = 0;
+  void *texels = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch = reserve(bytes, offset, texels);
+  }
+  if (!texels || !ImageDecoder::decodeRGBA8(state->filename, decoded.size,
+                                            texels, decode_size))
+    return false;
+  decoded.bytes = ImageDecoder::rgba8Size(decoded.size);
+  if (host_mipmaps) {
+    decoded.regions = MipGenerator::copyRegions(width, height, offset);
+    std::vector<uint8_t *> levels;
+    for (size_t i = 1; i < decoded.regions.size(); ++i)
+      levels.emplace_back(static_cast<uint8_t *>(texels) +
+                          (decoded.regions[i].bufferOffset - offset));
+    // workers already run in parallel, each one filters its own texture
+    MipGenerator mip_generator(1);
+    MipGenerator::Options options;
+    options.srgb = state->srgb;
+    if (!mip_generator.generate(static_cast<const uint8_t *>(texels), width,
+                                height, levels, options))
+      return false;
+    decoded.bytes = MipGenerator::chainSize(width, height);
+    return true;
+  }
+  decoded.generate_mipmaps = decoded.mip_levels > 1;
+  VkBufferImageCopy region = {};
+  region.bufferOffset = offset;
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent = decoded.size;
+  decoded.regions = {region};
+  return true;
+}
+
+bool TextureLoader::stageContainer(Decoded &decoded,
+                                   std::shared_ptr<Batch> &batch) {
+  TextureContainer container(decoded.state->filename);
+  if (!container.good())
+    return false;
+  if (!TextureContainer::isSupported(*logical_device_->physicalDevice(),
+                                     container.format())) {
+    INFO("texture container format is not supported by the device");
+    return false;
+  }
+  VkDeviceSize offset = 0;
+  void *texels = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch = reserve(container.stagingSize(), offset, texels);
+  }
+  if (!texels)
+    return false;
+  container.stage(texels, offset, decoded.regions);
+  decoded.format = container.format();
+  decoded.type = container.imageType();
+  decoded.size = container.size();
+  decoded.mip_levels = container.mipLevels();
+  decoded.array_layers = container.arrayLayers();
+  decoded.cubemap = container.cubemap();
+  decoded.bytes = container.dataSize();
+  return true;
+}
+
+std::shared_ptr<TextureLoader::Batch>
+TextureLoader::reserve(VkDeviceSize size, VkDeviceSize &offset,
+                       void *&texels) {
+  if (open_batch_) {
+    texels = open_batch_->staging->reserve(size, offset);
+    if (texels) {
+      open_batch_->writing++;
+      return open_batch_;
+    }
+    closed_batches_.emplace_back(std::move(open_batch_));
+  }
+  auto batch = std::make_shared<Batch>();
+  auto capacity = std::max(max_batch_size_, size);
+  if (capacity == max_batch_size_ && !free_staging_.empty()) {
+    batch->staging = std::move(free_staging_.back());
+    free_staging_.pop_back();
+  } else {
+    batch->staging = std::make_unique<StagingBuffer>(logical_device_, capacity);
+    statistics_.staging_bytes += capacity;
+    statistics_.peak_staging_bytes =
+        std::max(statistics_.peak_staging_bytes, statistics_.staging_bytes);
+  }
+  texels = batch->staging->reserve(size, offset);
+  if (!texels) {
+    statistics_.staging_bytes -= batch->staging->size();
+    return nullptr;
+  }
+  batch->writing++;
+  // textures larger than a batch do not keep the batch open
+  if (capacity == max_batch_size_)
+    open_batch_ = batch;
+  else
+    closed_batches_.emplace_back(batch);
+  return batch;
+}
+
+void TextureLoader::fail(const std::vector<Decoded> &decoded) {
+  for (auto &d : decoded) {
+    d.state->texture.reset();
+    d.state->failed = true;
+    statistics_.failed++;
+    pending_--;
+  }
+}
+
+uint32_t TextureLoader::update() {
+  uint32_t count = finishBatches();
+  // the open batch is closed as soon as it has content, so uploads start
+  // while workers keep decoding into a new batch
+  std::shared_ptr<Batch> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_batch_ && !open_batch_->decoded.empty())
+      closed_batches_.emplace_back(std::move(open_batch_));
+    // one submission per frame keeps the transfer cost of a frame bounded
+    for (auto it = closed_batches_.begin(); it != closed_batches_.end(); ++it)
+      if (!(*it)->writing) {
+        batch = *it;
+        closed_batches_.erase(it);
+        break;
+      }
+  }
+  if (batch)
+    submitBatch(batch);
+  return count;
+}
+
+bool TextureLoader::submitBatch(std::shared_ptr<Batch> batch) {
+  // no worker references the batch anymore
+  if (!batch->decoded.empty() &&
+      !command_pool_->allocateCommandBuffers(VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                                             1, batch->command_buffers)) {
+    INFO("could not allocate texture batch command buffer");
+    std::lock_guard<std::mutex> lock(mutex_);
+    fail(batch->decoded);
+    batch->decoded.clear();
+  }
+  if (batch->decoded.empty()) {
+    batch->staging->reset();
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_staging_.emplace_back(std::move(batch->staging));
+    return false;
+  }
+  auto &cb = batch->command_buffers[0];
+  if (!cb.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT))
+    INFO("could not begin texture batch command buffer");
+  for (auto &d : batch->decoded) {
+    auto &state = d.state;
+    state->texture = std::make_unique<Texture>(
+        logical_device_, d.type, d.format, d.size, d.mip_levels,
+        d.array_layers, VK_SAMPLE_COUNT_1_BIT,
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+            VK_IMAGE_USAGE_SAMPLED_BIT,
+        d.cubemap);
+    state->texture->allocateMemory();
+    state->texture->recordUpload(cb, batch->staging->buffer(), d.regions);
+    if (d.generate_mipmaps)
+      state->texture->generateMipmaps(cb);
+    else
+      cb.use(*state->texture->image(), ImageUsage::SAMPLED_FRAGMENT);
+  }
+  if (!cb.end())
+    INFO("could not end texture batch command buffer");
+  batch->fence = std::make_unique<Fence>(logical_device_);
+  if (!cb.submit(vk_queue_, batch->fence->handle())) {
+    INFO("could not submit texture batch");
+    command_pool_->freeCommandBuffers(batch->command_buffers);
+    batch->staging->reset();
+    std::lock_guard<std::mutex> lock(mutex_);
+    fail(batch->decoded);
+    free_staging_.emplace_back(std::move(batch->staging));
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.batches++;
+  }
+  submitted_batches_.emplace_back(std::move(batch));
+  return true;
+}
+
+uint32_t TextureLoader::finishBatches() {
+  uint32_t count = 0;
+  // batches complete in submission order (same queue)
+  while (!submitted_batches_.empty() &&
+         submitted_batches_.front()->fence->status() == VK_SUCCESS) {
+    auto batch = std::move(submitted_batches_.front());
+    submitted_batches_.pop_front();
+    VkDeviceSize bytes = 0;
+    for (auto &d : batch->decoded) {
+      auto &state = d.state;
+      auto *image = state->texture->image();
+      VkImageViewType view_type = VK_IMAGE_VIEW_TYPE_2D;
+      if (d.cubemap)
+        view_type = d.array_layers > 1 ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY
+                                       : VK_IMAGE_VIEW_TYPE_CUBE;
+      else if (d.type == VK_IMAGE_TYPE_3D)
+        view_type = VK_IMAGE_VIEW_TYPE_3D;
+      else if (d.type == VK_IMAGE_TYPE_1D)
+        view_type = d.array_layers > 1 ? VK_IMAGE_VIEW_TYPE_1D_ARRAY
+                                       : VK_IMAGE_VIEW_TYPE_1D;
+      else if (d.array_layers > 1)
+        view_type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+      state->view = std::make_unique<Image::View>(
+          image, view_type, image->format(), VK_IMAGE_ASPECT_COLOR_BIT);
+      state->ready = true;
+      bytes += d.bytes;
+      count++;
+    }
+    command_pool_->freeCommandBuffers(batch->command_buffers);
+    batch->staging->reset();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // oversized staging buffers are not worth keeping around
+    if (batch->staging->size() == max_batch_size_) {
+      free_staging_.emplace_back(std::move(batch->staging));
+    } else {
+      statistics_.staging_bytes -= batch->staging->size();
+      batch->staging.reset();
+    }
+    statistics_.textures += batch->decoded.size();
+    statistics_.bytes += bytes;
+    pending_ -= batch->decoded.size();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start_;
+    statistics_.elapsed_time = elapsed.count();
+  }
+  return count;
+}
+
+void TextureLoader::waitIdle() {
+  while (pendingCount()) {
+    update();
+    if (!submitted_batches_.empty())
+      submitted_batches_.front()->fence->wait();
+    else
+      std::this_thread::yield();
+  }
+}
+
+uint32_t TextureLoader::pendingCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_;
+}
+
+const Image::View &TextureLoader::placeholder() const {
+  return *placeholder_view_;
+}
+
+TextureLoader::Statistics TextureLoader::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto statistics = statistics_;
+  if (statistics.elapsed_time > 0) {
+    double seconds = statistics.elapsed_time / 1000.0;
+    statistics.megabytes_per_second =
+        statistics.bytes / (1024.0 * 1024.0) / seconds;
+    statistics.textures_per_second = statistics.textures / seconds;
+  }
+  return statistics;
+}
+
+} // namespace circe::vk
@@ -0,0 +1,212 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_texture_loader.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_TEXTURE_LOADER_H
+#define CIRCE_VK_TEXTURE_LOADER_H
+
+#include "vk_command_buffer.h"
+#include "vk_staging_buffer.h"
+#include "vk_sync.h"
+#include "vk_texture_image.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace circe::vk {
+
+/// \brief Loads textures without blocking the render thread.
+/// Image files are decoded by a pool of worker threads directly into
+/// persistently mapped staging buffers: workers read the image header,
+/// reserve the texels range in the open batch and decode in place. Batches
+/// are uploaded by update() (called once per frame on the thread that owns
+/// the queue): one command buffer and one submission per batch, including
+/// the mip chain blits. Submissions are tracked with fences and never
+/// waited, their staging buffers are recycled once complete. Until its
+/// upload completes, a texture handle shows a placeholder, so it can be
+/// bound right away. Ex:
+///   TextureLoader loader(device, family_index, queue);
+///   auto albedo = loader.load(TEXTURES_PATH "/chalet.jpg");
+///   // albedo.view() is the placeholder now
+///   ...
+///   loader.update(); // once per frame
+///   if (albedo.ready()) // rewrite descriptors with albedo.view()
+class TextureLoader final {
+public:
+  /// \brief Shared handle of a texture being loaded
+  class Handle {
+  public:
+    Handle() = default;
+    ///\return bool true if the texture was uploaded and can be sampled
+    [[nodiscard]] bool ready() const;
+    ///\return bool true if the file could not be loaded
+    [[nodiscard]] bool failed() const;
+    ///\return const Image::View& texture view once ready, placeholder view
+    /// otherwise
+    [[nodiscard]] const Image::View &view() const;
+    ///\return const Texture* nullptr until ready
+    [[nodiscard]] const Texture *texture() const;
+    ///\return bool true if this handle refers to a texture
+    [[nodiscard]] bool valid() const;
+
+  private:
+    friend class TextureLoader;
+    struct State {
+      std::string filename;
+      bool srgb{true};
+      bool mipmaps{true};
+      std::atomic<bool> ready{false};
+      std::atomic<bool> failed{false};
+      const Image::View *placeholder = nullptr;
+      std::unique_ptr<Texture> texture;
+      std::unique_ptr<Image::View> view;
+    };
+    explicit Handle(std::shared_ptr<State> state);
+    std::shared_ptr<State> state_;
+  };
+  struct Statistics {
+    uint64_t textures{0};          //!< textures uploaded
+    uint64_t failed{0};            //!< files that could not be loaded
+    uint64_t batches{0};           //!< upload submissions
+    uint64_t bytes{0};             //!< texel bytes uploaded (stored levels)
+    uint64_t staging_bytes{0};     //!< staging memory currently allocated
+    uint64_t peak_staging_bytes{0}; //!< maximum of staging_bytes
+    double decode_time{0};         //!< sum of worker decode times (ms)
+    double elapsed_time{0};        //!< first request to last upload (ms)
+    double megabytes_per_second{0}; //!< bytes / elapsed_time
+    double textures_per_second{0};  //!< textures / elapsed_time
+  };
+  ///\param logical_device **[in]**
+  ///\param queue_family_index **[in]**
+  ///\param queue **[in]** queue used by update() for uploads
+  ///\param worker_count **[in | optional = 0]** 0 means one less than the
+  /// number of hardware threads
+  ///\param max_batch_size **[in | optional = 64MB]** size of the staging
+  /// buffer of each batch (larger textures get a batch of their own)
+  TextureLoader(const LogicalDevice *logical_device,
+                uint32_t queue_family_index, VkQueue queue,
+                uint32_t worker_count = 0,
+                VkDeviceSize max_batch_size = 64u << 20);
+  TextureLoader(const TextureLoader &other) = delete;
+  ///\brief Joins the workers and waits for uploads in flight
+  ~TextureLoader();
+  ///\brief Queues a texture for loading. Image files (stb_image) become
+  /// RGBA8 textures. KTX2 and DDS containers are uploaded with their own
+  /// format, mip levels and layers (srgb and mipmaps are ignored).
+  ///\param filename **[in]**
+  ///\param srgb **[in | optional = true]** VK_FORMAT_R8G8B8A8_SRGB or
+  /// VK_FORMAT_R8G8B8A8_UNORM
+  ///\param mipmaps **[in | optional = true]** generate the full mip chain
+  ///\return Handle usable right away (shows the placeholder until ready)
+  Handle load(const std::string &filename, bool srgb = true,
+              bool mipmaps = true);
+  ///\brief Completes finished uploads and submits decoded textures. Must be
+  /// called from the thread that owns the queue. Never blocks on the device.
+  ///\return uint32_t number of textures that became ready
+  uint32_t update();
+  ///\brief Blocks until every queued texture is ready or failed (calls
+  /// update())
+  void waitIdle();
+  ///\return uint32_t number of textures not ready or failed yet
+  [[nodiscard]] uint32_t pendingCount() const;
+  ///\return const Image::View& view shown by textures not loaded yet
+  [[nodiscard]] const Image::View &placeholder() const;
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+
+private:
+  struct Decoded {
+    std::shared_ptr<Handle::State> state;
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    VkImageType type{VK_IMAGE_TYPE_2D};
+    VkExtent3D size{};
+    uint32_t mip_levels{1};
+    uint32_t array_layers{1};
+    bool cubemap{false};
+    bool generate_mipmaps{false};
+    VkDeviceSize bytes{0}; //!< texel bytes
+    std::vector<VkBufferImageCopy> regions;
+  };
+  struct Batch {
+    std::unique_ptr<StagingBuffer> staging;
+    // written by workers (under mutex_) until submission
+    std::vector<Decoded> decoded;
+    uint32_t writing{0}; //!< decodes in flight into the staging buffer
+    // render thread
+    std::vector<CommandBuffer> command_buffers;
+    std::unique_ptr<Fence> fence;
+  };
+  void workerLoop();
+  ///\brief Decodes an image file into the staging memory of a batch
+  bool stageImage(Decoded &decoded, std::shared_ptr<Batch> &batch);
+  ///\brief Copies the contents of a KTX2 or DDS file into the staging memory
+  /// of a batch
+  bool stageContainer(Decoded &decoded, std::shared_ptr<Batch> &batch);
+  void createPlaceholder();
+  ///\brief Reserves staging memory for a texture, opens a new batch if the
+  /// open one is full. mutex_ must be locked.
+  std::shared_ptr<Batch> reserve(VkDeviceSize size, VkDeviceSize &offset,
+                                 void *&texels);
+  ///\brief Records and submits the uploads of a batch (render thread)
+  ///\return bool true if the batch was submitted
+  bool submitBatch(std::shared_ptr<Batch> batch);
+  ///\return uint32_t number of textures completed by finished batches
+  uint32_t finishBatches();
+  ///\brief Marks textures of a batch as failed. mutex_ must be locked.
+  void fail(const std::vector<Decoded> &decoded);
+
+  const LogicalDevice *logical_device_ = nullptr;
+  uint32_t queue_family_index_{0};
+  VkQueue vk_queue_ = VK_NULL_HANDLE;
+  VkDeviceSize max_batch_size_{0};
+  // formats without linear blits get their mip levels generated by workers
+  bool blit_srgb_{true};
+  bool blit_unorm_{true};
+  std::unique_ptr<CommandPool> command_pool_;
+  std::unique_ptr<Texture> placeholder_;
+  std::unique_ptr<Image::View> placeholder_view_;
+  // workers
+  std::vector<std::thread> workers_;
+  mutable std::mutex mutex_;
+  std::condition_variable requests_condition_;
+  std::deque<std::shared_ptr<Handle::State>> requests_;
+  std::shared_ptr<Batch> open_batch_;
+  std::deque<std::shared_ptr<Batch>> closed_batches_;
+  std::vector<std::unique_ptr<StagingBuffer>> free_staging_;
+  bool stop_{false};
+  uint32_t pending_{0};
+  Statistics statistics_;
+  std::chrono::steady_clock::time_point start_;
+  // render thread
+  std::deque<std::shared_ptr<Batch>> submitted_batches_;
+};
+
+} // namespace circe::vk
+
+#endif
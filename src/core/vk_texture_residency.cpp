@@ -0,0 +1,430 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_texture_residency.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_texture_residency.h"
+#include "logging.h"
+#include "vk_image_decoder.h"
+#include "vk_mip_generator.h"
+#include "vk_texture_container.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <numeric>
+
+namespace circe::vk {
+
+namespace {
+
+VkImageViewType viewType(VkImageType type, uint32_t array_layers,
+                         bool cubemap) {
+  if (cubemap)
+    return array_layers > 1 ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY
+                            : VK_IMAGE_VIEW_TYPE_CUBE;
+  if (type == VK_IMAGE_TYPE_3D)
+    return VK_IMAGE_VIEW_TYPE_3D;
+  if (type == VK_IMAGE_TYPE_1D)
+    return array_layers > 1 ? VK_IMAGE_VIEW_TYPE_1D_ARRAY
+                            : VK_IMAGE_VIEW_TYPE_1D;
+  return array_layers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY
+                          : VK_IMAGE_VIEW_TYPE_2D;
+}
+
+} // namespace
+
+TextureResidency::TextureResidency(const LogicalDevice *logical_device,
+                                   VkInstance instance, const Options &options)
+    : logical_device_(logical_device), vk_instance_(instance),
+      options_(options) {
+  const auto &memory_properties =
+      logical_device_->physicalDevice()->memoryProperties();
+  for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
+    if (memory_properties.memoryTypes[i].propertyFlags &
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+      device_local_heap_ = memory_properties.memoryTypes[i].heapIndex;
+      break;
+    }
+}
+
+bool TextureResidency::add(const std::string &filename, uint32_t &id,
+                           bool srgb) {
+  Entry entry;
+  entry.filename = filename;
+  entry.srgb = srgb;
+  auto extension =
+      filename.substr(std::min(filename.find_last_of('.'), filename.size()));
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 ::tolower);
+  entry.container = extension == ".ktx2" || extension == ".dds";
+  if (entry.container) {
+    TextureContainer container(filename);
+    D_RETURN_FALSE_IF_NOT(container.good(),
+                          "could not read texture container " + filename);
+    D_RETURN_FALSE_IF_NOT(
+        TextureContainer::isSupported(*logical_device_->physicalDevice(),
+                                      container.format()),
+        "texture container format is not supported by the device");
+    entry.format = container.format();
+    entry.type = container.imageType();
+    entry.size = container.size();
+    entry.mip_levels = container.mipLevels();
+    entry.array_layers = container.arrayLayers();
+    entry.cubemap = container.cubemap();
+  } else {
+    D_RETURN_FALSE_IF_NOT(ImageDecoder::info(filename, entry.size),
+                          "could not read texture image file " + filename);
+    entry.format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    entry.mip_levels =
+        MipGenerator::levelCount(entry.size.width, entry.size.height);
+  }
+  // the first level small enough to stay resident
+  while (entry.min_level + 1 < entry.mip_levels &&
+         std::max(entry.size.width, entry.size.height) >> entry.min_level >
+             options_.min_resident_size)
+    entry.min_level++;
+  // nothing is resident yet
+  entry.resident_level = entry.mip_levels;
+  id = static_cast<uint32_t>(entries_.size());
+  entries_.emplace_back(std::move(entry));
+  return true;
+}
+
+void TextureResidency::use(uint32_t id) { entries_[id].last_use = frame_; }
+
+std::vector<uint32_t> TextureResidency::update(CommandBuffer &cb) {
+  destroyRetired();
+  std::vector<uint32_t> changed;
+  const VkDeviceSize budget = computeBudget();
+  // textures used by the last frame want all their levels, the others keep
+  // what they have (at least their lowest levels)
+  VkDeviceSize total = 0;
+  statistics_.requested_bytes = 0;
+  for (auto &entry : entries_) {
+    if (entry.last_use == frame_) {
+      entry.target_level = 0;
+      statistics_.requested_bytes += levelsSize(entry, 0);
+    } else
+      entry.target_level = std::min(entry.resident_level, entry.min_level);
+    total += levelsSize(entry, entry.target_level);
+  }
+  // least recently used first
+  std::vector<uint32_t> order(entries_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return entries_[a].last_use < entries_[b].last_use;
+  });
+  // over budget: the least recently used textures lose their top levels
+  for (auto i : order) {
+    auto &entry = entries_[i];
+    if (total <= budget || entry.last_use == frame_)
+      break;
+    while (total > budget && entry.target_level < entry.min_level) {
+      total -= levelsSize(entry, entry.target_level) -
+               levelsSize(entry, entry.target_level + 1);
+      entry.target_level++;
+    }
+  }
+  // the textures of the last frame alone do not fit: all of them lose their
+  // top level, until they fit
+  bool dropped = true;
+  while (total > budget && dropped) {
+    dropped = false;
+    for (auto i : order) {
+      auto &entry = entries_[i];
+      if (total <= budget)
+        break;
+      if (entry.last_use != frame_ || entry.target_level >= entry.min_level)
+        continue;
+      total -= levelsSize(entry, entry.target_level) -
+               levelsSize(entry, entry.target_level + 1);
+      entry.target_level++;
+      dropped = true;
+    }
+  }
+  for (auto i : order) {
+    auto &entry = entries_[i];
+    if (entry.texture && entry.target_level > entry.resident_level &&
+        evict(cb, entry))
+      changed.emplace_back(i);
+  }
+  // most recently used first
+  VkDeviceSize stream_bytes = options_.max_stream_bytes;
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    auto &entry = entries_[*it];
+    if (!entry.failed && entry.target_level < entry.resident_level &&
+        stream(cb, entry, stream_bytes))
+      changed.emplace_back(*it);
+  }
+  if (staging_) {
+    Retired retired;
+    retired.frame = frame_;
+    retired.staging = std::move(staging_);
+    retired_.emplace_back(std::move(retired));
+  }
+  statistics_.textures = static_cast<uint32_t>(entries_.size());
+  statistics_.fully_resident = 0;
+  for (auto &entry : entries_)
+    if (!entry.resident_level)
+      statistics_.fully_resident++;
+  frame_++;
+  return changed;
+}
+
+VkDeviceSize TextureResidency::computeBudget() {
+  const auto *physical_device = logical_device_->physicalDevice();
+  const VkDeviceSize heap_size = physical_device->memoryProperties()
+                                     .memoryHeaps[device_local_heap_]
+                                     .size;
+  VkDeviceSize budget =
+      options_.budget ? options_.budget : heap_size / 4 * 3;
+  std::vector<VkDeviceSize> heap_budgets, heap_usages;
+  statistics_.memory_budget_extension =
+      physical_device->memoryBudget(vk_instance_, heap_budgets, heap_usages);
+  if (statistics_.memory_budget_extension) {
+    // the heap usage includes our textures (retired ones will be freed
+    // soon), the rest belongs to other allocations and processes
+    const VkDeviceSize ours =
+        statistics_.resident_bytes + statistics_.retired_bytes;
+    const VkDeviceSize usage = heap_usages[device_local_heap_];
+    const VkDeviceSize others = usage > ours ? usage - ours : 0;
+    const VkDeviceSize heap_budget = heap_budgets[device_local_heap_];
+    VkDeviceSize available = heap_budget > others ? heap_budget - others : 0;
+    // keep a margin, the heap budget changes as other processes allocate
+    budget = std::min(budget, available - available / 10);
+  }
+  statistics_.budget = budget;
+  return budget;
+}
+
+VkDeviceSize TextureResidency::levelsSize(const Entry &entry,
+                                          uint32_t first_level) const {
+  VkExtent2D block{1, 1};
+  uint32_t block_size = 4;
+  TextureContainer::blockInfo(entry.format, block, block_size);
+  const VkDeviceSize layers = entry.array_layers * (entry.cubemap ? 6 : 1);
+  VkDeviceSize size = 0;
+  for (uint32_t level = first_level; level < entry.mip_levels; ++level) {
+    const VkDeviceSize width = std::max(entry.size.width >> level, 1u);
+    const VkDeviceSize height = std::max(entry.size.height >> level, 1u);
+    const VkDeviceSize depth = std::max(entry.size.depth >> level, 1u);
+    size += (width + block.width - 1) / block.width *
+            ((height + block.height - 1) / block.height) * depth * block_size *
+            layers;
+  }
+  return size;
+}
+
+std::unique_ptr<Texture> TextureResidency::createTexture(const Entry &entry,
+                                                         uint32_t level) const {
+  const VkExtent3D size = {std::max(entry.size.width >> level, 1u),
+                           std::max(entry.size.height >> level, 1u),
+                           std::max(entry.size.depth >> level, 1u)};
+  auto texture = std::make_unique<Texture>(
+      logical_device_, entry.type, entry.format, size,
+      entry.mip_levels - level, entry.array_layers, VK_SAMPLE_COUNT_1_BIT,
+      VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+          VK_IMAGE_USAGE_SAMPLED_BIT,
+      entry.cubemap);
+  if (!texture->allocateMemory()) {
+    INFO("could not allocate texture memory for " + entry.filename);
+    return nullptr;
+  }
+  return texture;
+}
+
+void TextureResidency::replace(Entry &entry, std::unique_ptr<Texture> texture,
+                               uint32_t level) {
+  if (entry.texture) {
+    // command buffers of previous frames may still sample it
+    Retired retired;
+    retired.frame = frame_;
+    retired.texture = std::move(entry.texture);
+    retired.view = std::move(entry.view);
+    retired.bytes = entry.bytes;
+    statistics_.resident_bytes -= entry.bytes;
+    statistics_.retired_bytes += entry.bytes;
+    retired_.emplace_back(std::move(retired));
+  }
+  entry.texture = std::move(texture);
+  auto *image = entry.texture->image();
+  VkMemoryRequirements memory_requirements{};
+  image->memoryRequirements(memory_requirements);
+  entry.bytes = memory_requirements.size;
+  statistics_.resident_bytes += entry.bytes;
+  entry.view = std::make_unique<Image::View>(
+      image, viewType(entry.type, entry.array_layers, entry.cubemap),
+      entry.format, VK_IMAGE_ASPECT_COLOR_BIT);
+  entry.resident_level = level;
+}
+
+bool TextureResidency::evict(CommandBuffer &cb, Entry &entry) {
+  auto texture = createTexture(entry, entry.target_level);
+  if (!texture)
+    return false;
+  texture->recordCopy(cb, *entry.texture,
+                      entry.target_level - entry.resident_level);
+  cb.use(*texture->image(), ImageUsage::SAMPLED_FRAGMENT);
+  statistics_.evicted_levels += entry.target_level - entry.resident_level;
+  replace(entry, std::move(texture), entry.target_level);
+  return true;
+}
+
+bool TextureResidency::stream(CommandBuffer &cb, Entry &entry,
+                              VkDeviceSize &stream_bytes) {
+  const VkDeviceSize bytes = levelsSize(entry, entry.target_level) -
+                             levelsSize(entry, entry.resident_level);
+  // files are read whole, whatever the levels uploaded
+  const VkDeviceSize staging_bytes =
+      entry.container
+          ? levelsSize(entry, 0)
+          : std::max(ImageDecoder::destinationSize(entry.size),
+                     MipGenerator::chainSize(entry.size.width,
+                                             entry.size.height));
+  // textures larger than the limit are streamed alone
+  if (staging_bytes > stream_bytes &&
+      stream_bytes < options_.max_stream_bytes)
+    return false;
+  stream_bytes -= std::min(staging_bytes, stream_bytes);
+  std::vector<VkBufferImageCopy> regions;
+  if (!stage(entry, regions)) {
+    INFO("could not stream texture " + entry.filename);
+    entry.failed = true;
+    return false;
+  }
+  auto texture = createTexture(entry, entry.target_level);
+  if (!texture)
+    return false;
+  // only the missing levels are uploaded, the resident ones are copied
+  std::vector<VkBufferImageCopy> uploads;
+  for (auto region : regions) {
+    auto &level = region.imageSubresource.mipLevel;
+    if (level < entry.target_level || level >= entry.resident_level)
+      continue;
+    level -= entry.target_level;
+    uploads.emplace_back(region);
+  }
+  texture->recordUpload(cb, staging_->buffer(), uploads);
+  if (entry.texture)
+    texture->recordCopy(cb, *entry.texture, 0,
+                        entry.resident_level - entry.target_level);
+  cb.use(*texture->image(), ImageUsage::SAMPLED_FRAGMENT);
+  statistics_.streamed_levels += entry.resident_level - entry.target_level;
+  statistics_.streamed_bytes += bytes;
+  replace(entry, std::move(texture), entry.target_level);
+  return true;
+}
+
+bool TextureResidency::stage(const Entry &entry,
+                             std::vector<VkBufferImageCopy> &regions) {
+  VkDeviceSize offset = 0;
+  if (entry.container) {
+    TextureContainer container(entry.filename);
+    // the file must still match the registered texture
+    RETURN_FALSE_IF_NOT(container.good() &&
+                        container.format() == entry.format &&
+                        container.mipLevels() == entry.mip_levels)
+    void *texels = reserve(container.stagingSize(), offset);
+    RETURN_FALSE_IF_NOT(texels)
+    container.stage(texels, offset, regions);
+    return true;
+  }
+  VkExtent3D size{};
+  RETURN_FALSE_IF_NOT(ImageDecoder::info(entry.filename, size) &&
+                      size.width == entry.size.width &&
+                      size.height == entry.size.height)
+  // the chain is generated right after the first level, as the loader does
+  // for formats without linear blits
+  const VkDeviceSize decode_size = ImageDecoder::destinationSize(size);
+  void *texels = reserve(
+      std::max(decode_size, MipGenerator::chainSize(size.width, size.height)),
+      offset);
+  RETURN_FALSE_IF_NOT(texels)
+  RETURN_FALSE_IF_NOT(
+      ImageDecoder::decodeRGBA8(entry.filename, size, texels, decode_size))
+  regions = MipGenerator::copyRegions(size.width, size.height, offset);
+  std::vector<uint8_t *> levels;
+  for (size_t i = 1; i < regions.size(); ++i)
+    levels.emplace_back(static_cast<uint8_t *>(texels) +
+                        (regions[i].bufferOffset - offset));
+  MipGenerator mip_generator;
+  MipGenerator::Options options;
+  options.srgb = entry.srgb;
+  return mip_generator.generate(static_cast<const uint8_t *>(texels),
+                                size.width, size.height, levels, options);
+}
+
+void *TextureResidency::reserve(VkDeviceSize size, VkDeviceSize &offset) {
+  if (staging_) {
+    if (void *texels = staging_->reserve(size, offset))
+      return texels;
+    // full, the buffer is released with the others of this update
+    Retired retired;
+    retired.frame = frame_;
+    retired.staging = std::move(staging_);
+    retired_.emplace_back(std::move(retired));
+  }
+  if (size <= options_.max_stream_bytes && !free_staging_.empty()) {
+    staging_ = std::move(free_staging_.back());
+    free_staging_.pop_back();
+  } else
+    staging_ = std::make_unique<StagingBuffer>(
+        logical_device_, std::max(size, options_.max_stream_bytes));
+  if (!staging_->good())
+    return nullptr;
+  return staging_->reserve(size, offset);
+}
+
+void TextureResidency::destroyRetired() {
+  while (!retired_.empty() &&
+         frame_ - retired_.front().frame >= options_.retire_frames) {
+    auto &retired = retired_.front();
+    statistics_.retired_bytes -= retired.bytes;
+    if (retired.staging &&
+        retired.staging->size() == options_.max_stream_bytes) {
+      retired.staging->reset();
+      free_staging_.emplace_back(std::move(retired.staging));
+    }
+    retired_.pop_front();
+  }
+}
+
+const Image::View *TextureResidency::view(uint32_t id) const {
+  return entries_[id].view.get();
+}
+
+uint32_t TextureResidency::residentLevel(uint32_t id) const {
+  return entries_[id].resident_level;
+}
+
+void TextureResidency::setBudget(VkDeviceSize budget) {
+  options_.budget = budget;
+}
+
+TextureResidency::Statistics TextureResidency::statistics() const {
+  return statistics_;
+}
+
+} // namespace circe::vk
@@ -0,0 +1,195 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_texture_residency.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_TEXTURE_RESIDENCY_H
+#define CIRCE_VK_TEXTURE_RESIDENCY_H
+
+#include "vk_command_buffer.h"
+#include "vk_staging_buffer.h"
+#include "vk_texture_image.h"
+#include <deque>
+
+namespace circe::vk {
+
+/// \brief Keeps the mip chains of a set of textures within a device memory
+/// budget. Each texture records the frame it was last used in. When the
+/// textures do not fit, the top mip levels of the least recently used ones
+/// are dropped: the texture is replaced by a smaller image holding only its
+/// lower levels, filled by an image copy. Levels of textures used again are
+/// streamed back in (re-read from their files), most recently used first,
+/// with a limit of staging bytes per update. The budget is either given or a
+/// fraction of the device local heap, and is further limited by the heap
+/// budget reported by VK_EXT_memory_budget when available.
+/// Replaced textures (and the staging memory of their uploads) are destroyed
+/// a few updates later, so views must be re-read after each update.
+/// Usage:
+///   TextureResidency residency(device, instance);
+///   uint32_t albedo;
+///   residency.add(TEXTURES_PATH "/chalet.jpg", albedo);
+///   ...
+///   // once per frame, before recording the draws
+///   for (auto id : residency.update(cb))
+///     // rewrite descriptors with residency.view(id)
+///   residency.use(albedo); // the frame samples albedo
+class TextureResidency final {
+public:
+  struct Options {
+    // explicit constructor instead of member initializers, so Options{} can
+    // be a default argument inside TextureResidency
+    Options()
+        : budget(0), retire_frames(3), min_resident_size(64),
+          max_stream_bytes(32u << 20) {}
+    VkDeviceSize budget;    //!< bytes textures may use (0: 3/4 of the
+                            //!< device local heap)
+    uint32_t retire_frames; //!< update() calls replaced textures are kept
+    uint32_t min_resident_size; //!< levels of at most this many texels per
+                                //!< side are never evicted
+    VkDeviceSize max_stream_bytes; //!< staging bytes per update (files are
+                                   //!< read whole)
+  };
+  struct Statistics {
+    uint32_t textures{0};        //!< registered textures
+    uint32_t fully_resident{0};  //!< textures with all their levels resident
+    VkDeviceSize budget{0};      //!< budget of the last update
+    VkDeviceSize resident_bytes{0};  //!< device memory of resident levels
+    VkDeviceSize requested_bytes{0}; //!< device memory of all levels of the
+                                     //!< textures used in the last frame
+    VkDeviceSize retired_bytes{0};   //!< device memory waiting to be freed
+    uint64_t evicted_levels{0};  //!< mip levels dropped
+    uint64_t streamed_levels{0}; //!< mip levels streamed in
+    uint64_t streamed_bytes{0};  //!< texel bytes uploaded
+    bool memory_budget_extension{false}; //!< VK_EXT_memory_budget is used
+  };
+  ///\param logical_device **[in]**
+  ///\param instance **[in | optional = VK_NULL_HANDLE]** needed to query
+  /// VK_EXT_memory_budget (see PhysicalDevice::memoryBudget)
+  ///\param options **[in | optional = {}]**
+  explicit TextureResidency(const LogicalDevice *logical_device,
+                            VkInstance instance = VK_NULL_HANDLE,
+                            const Options &options = {});
+  TextureResidency(const TextureResidency &other) = delete;
+  ///\brief Registers a texture. Only its header is read here, its lowest
+  /// levels become resident on the next update().
+  ///\param filename **[in]** image file (RGBA8 with a full mip chain) or
+  /// KTX2/DDS container
+  ///\param id **[out]** texture identifier
+  ///\param srgb **[in | optional = true]** image files only
+  ///\return bool true if the file could be read
+  bool add(const std::string &filename, uint32_t &id, bool srgb = true);
+  ///\brief Marks the texture as used by the current frame
+  ///\param id **[in]**
+  void use(uint32_t id);
+  ///\brief Records evictions and uploads into the command buffer, which
+  /// must be submitted before any command sampling the textures. Destroys
+  /// textures replaced retire_frames updates ago.
+  ///\param cb **[in]** recording command buffer
+  ///\return std::vector<uint32_t> textures whose view changed
+  std::vector<uint32_t> update(CommandBuffer &cb);
+  ///\param id **[in]**
+  ///\return const Image::View* view of the resident levels, nullptr until
+  /// the first update after add()
+  [[nodiscard]] const Image::View *view(uint32_t id) const;
+  ///\param id **[in]**
+  ///\return uint32_t first resident level of the full mip chain (mip levels
+  /// count if none)
+  [[nodiscard]] uint32_t residentLevel(uint32_t id) const;
+  ///\brief Sets the budget of the next updates
+  ///\param budget **[in]** bytes (0: 3/4 of the device local heap)
+  void setBudget(VkDeviceSize budget);
+  ///\return Statistics
+  [[nodiscard]] Statistics statistics() const;
+
+private:
+  struct Entry {
+    std::string filename;
+    bool srgb{true};
+    bool container{false}; //!< KTX2/DDS
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    VkImageType type{VK_IMAGE_TYPE_2D};
+    VkExtent3D size{};
+    uint32_t mip_levels{1};
+    uint32_t array_layers{1};
+    bool cubemap{false};
+    uint32_t min_level{0}; //!< never evicted from this level on
+    uint32_t resident_level{0};
+    uint32_t target_level{0};
+    uint64_t last_use{0}; //!< 0: never used
+    bool failed{false};   //!< the file could not be streamed
+    std::unique_ptr<Texture> texture;
+    std::unique_ptr<Image::View> view;
+    VkDeviceSize bytes{0}; //!< device memory of the texture
+  };
+  struct Retired {
+    uint64_t frame{0};
+    std::unique_ptr<Texture> texture;
+    std::unique_ptr<Image::View> view;
+    std::unique_ptr<StagingBuffer> staging;
+    VkDeviceSize bytes{0};
+  };
+  ///\return VkDeviceSize budget of this update
+  VkDeviceSize computeBudget();
+  ///\brief Estimates the device memory of levels [first_level, mip_levels)
+  VkDeviceSize levelsSize(const Entry &entry, uint32_t first_level) const;
+  ///\return std::unique_ptr<Texture> image holding the levels
+  /// [level, mip_levels) of the entry, nullptr on failure
+  std::unique_ptr<Texture> createTexture(const Entry &entry,
+                                         uint32_t level) const;
+  ///\brief Retires the current texture of the entry and takes its place
+  void replace(Entry &entry, std::unique_ptr<Texture> texture,
+               uint32_t level);
+  ///\brief Drops the levels above target_level (image copy)
+  ///\return bool true if the texture was replaced
+  bool evict(CommandBuffer &cb, Entry &entry);
+  ///\brief Uploads the levels [target_level, resident_level) and copies the
+  /// resident ones
+  ///\param stream_bytes **[in/out]** staging bytes left in this update
+  ///\return bool true if the texture was replaced
+  bool stream(CommandBuffer &cb, Entry &entry, VkDeviceSize &stream_bytes);
+  ///\brief Decodes (or copies) the texels of the file into staging memory
+  ///\param regions **[out]** copies of all levels of the full chain
+  ///\return bool true if success
+  bool stage(const Entry &entry, std::vector<VkBufferImageCopy> &regions);
+  ///\return void* staging memory of this update, nullptr on failure
+  void *reserve(VkDeviceSize size, VkDeviceSize &offset);
+  ///\brief Destroys objects retired retire_frames updates ago
+  void destroyRetired();
+
+  const LogicalDevice *logical_device_ = nullptr;
+  VkInstance vk_instance_ = VK_NULL_HANDLE;
+  Options options_;
+  uint32_t device_local_heap_{0};
+  uint64_t frame_{1};
+  std::vector<Entry> entries_;
+  std::unique_ptr<StagingBuffer> staging_; //!< staging of this update
+  std::vector<std::unique_ptr<StagingBuffer>> free_staging_;
+  std::deque<Retired> retired_;
+  Statistics statistics_;
+};
+
+} // namespace circe::vk
+
+#endif
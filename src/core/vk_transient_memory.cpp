@@ -0,0 +1,138 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_transient_memory.cpp
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#include "vk_transient_memory.h"
+#include "logging.h"
+#include <algorithm>
+#include <map>
+
+namespace circe::vk {
+
+TransientAttachmentAllocator::TransientAttachmentAllocator(
+    const LogicalDevice *logical_device)
+    : logical_device_(logical_device) {}
+
+TransientAttachmentAllocator::~TransientAttachmentAllocator() { clear(); }
+
+void TransientAttachmentAllocator::add(const Image &image, int alias_group) {
+  if (!(image.usage() & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT))
+    INFO("Transient attachment created without TRANSIENT_ATTACHMENT usage.");
+  attachments_.push_back({&image, alias_group});
+}
+
+bool TransientAttachmentAllocator::allocate() {
+  D_RETURN_FALSE_IF_NOT(logical_device_, "Transient allocator without device.");
+  dedicated_memory_.clear();
+  pool_memory_.reset();
+  lazy_count_ = 0;
+  pooled_size_ = 0;
+  const PhysicalDevice *physical_device = logical_device_->physicalDevice();
+  struct Group {
+    std::vector<const Image *> images;
+    VkDeviceSize size = 0;
+    VkDeviceSize alignment = 1;
+    VkDeviceSize offset = 0;
+  };
+  // ungrouped images get their own group (keys below zero)
+  std::map<int, Group> groups;
+  int ungrouped = -1;
+  uint32_t pool_memory_type_bits = ~0u;
+  for (auto &attachment : attachments_) {
+    VkMemoryRequirements requirements{};
+    RETURN_FALSE_IF_NOT(attachment.image->memoryRequirements(requirements));
+    if (physical_device->hasMemoryType(
+            requirements.memoryTypeBits,
+            VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)) {
+      auto memory = std::make_unique<DeviceMemory>();
+      memory->setDevice(logical_device_);
+      RETURN_FALSE_IF_NOT(memory->allocate(
+          requirements, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+      RETURN_FALSE_IF_NOT(memory->bind(*attachment.image));
+      dedicated_memory_.emplace_back(std::move(memory));
+      lazy_count_++;
+      continue;
+    }
+    auto &group = groups[attachment.alias_group < 0 ? --ungrouped
+                                                    : attachment.alias_group];
+    group.images.emplace_back(attachment.image);
+    group.size = std::max(group.size, requirements.size);
+    group.alignment = std::max(group.alignment, requirements.alignment);
+    pool_memory_type_bits &= requirements.memoryTypeBits;
+  }
+  if (groups.empty())
+    return true;
+  if (!pool_memory_type_bits) {
+    // no memory type is shared by all attachments, fallback to one allocation
+    // per image
+    for (auto &group : groups)
+      for (auto *image : group.second.images) {
+        auto memory = std::make_unique<DeviceMemory>(
+            *image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        RETURN_FALSE_IF_NOT(memory->bind(*image));
+        dedicated_memory_.emplace_back(std::move(memory));
+      }
+    return true;
+  }
+  VkDeviceSize alignment = 1;
+  for (auto &group : groups) {
+    auto &g = group.second;
+    g.offset = (pooled_size_ + g.alignment - 1) / g.alignment * g.alignment;
+    pooled_size_ = g.offset + g.size;
+    alignment = std::max(alignment, g.alignment);
+  }
+  pool_memory_ = std::make_unique<DeviceMemory>();
+  pool_memory_->setDevice(logical_device_);
+  VkMemoryRequirements pool_requirements = {pooled_size_, alignment,
+                                            pool_memory_type_bits};
+  D_RETURN_FALSE_IF_NOT(
+      pool_memory_->allocate(pool_requirements,
+                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+      "Could not allocate transient attachment memory.");
+  for (auto &group : groups)
+    for (auto *image : group.second.images)
+      RETURN_FALSE_IF_NOT(pool_memory_->bind(*image, group.second.offset));
+  return true;
+}
+
+void TransientAttachmentAllocator::clear() {
+  attachments_.clear();
+  dedicated_memory_.clear();
+  pool_memory_.reset();
+  lazy_count_ = 0;
+  pooled_size_ = 0;
+}
+
+uint32_t TransientAttachmentAllocator::lazyAttachmentCount() const {
+  return lazy_count_;
+}
+
+VkDeviceSize TransientAttachmentAllocator::pooledSize() const {
+  return pooled_size_;
+}
+
+} // namespace circe::vk
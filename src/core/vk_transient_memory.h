@@ -0,0 +1,89 @@
+/// Copyright (c) 2019, FilipeCN.
+///
+/// The MIT License (MIT)
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///\file vk_transient_memory.h
+///\author FilipeCN (filipedecn@gmail.com)
+///\date 2026-10-18
+///
+///\brief
+
+#ifndef CIRCE_VK_TRANSIENT_MEMORY_H
+#define CIRCE_VK_TRANSIENT_MEMORY_H
+
+#include "vk_device_memory.h"
+#include <memory>
+#include <vector>
+
+namespace circe::vk {
+
+/// \brief Allocates memory for attachments that live only inside renderpasses
+/// (ex: multisampled color and depth buffers that are resolved or discarded).
+/// Images created with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT can be backed
+/// by VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT memory, which tiled GPUs never
+/// commit when the attachment stays in tile memory. When no lazily allocated
+/// memory type is available, the attachments are placed in a single shared
+/// DEVICE_LOCAL block, where attachments of the same alias group share the
+/// same range.
+/// Usage:
+///   TransientAttachmentAllocator allocator(device);
+///   allocator.add(color_image);
+///   allocator.add(depth_image);
+///   allocator.allocate();
+class TransientAttachmentAllocator final {
+public:
+  ///\param logical_device **[in]**
+  explicit TransientAttachmentAllocator(const LogicalDevice *logical_device);
+  ~TransientAttachmentAllocator();
+  ///\brief Registers an image to be backed by transient memory. The image
+  /// must have been created with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT and
+  /// must outlive its use in the command buffers.
+  ///\param image **[in]**
+  ///\param alias_group **[in | optional = -1]** images of the same (non
+  /// negative) group share memory when pooled, so they must never be in use
+  /// at the same time. -1 gives the image its own range.
+  void add(const Image &image, int alias_group = -1);
+  ///\brief Allocates and binds memory to all registered images
+  ///\return bool true if success
+  bool allocate();
+  ///\brief Frees all memory and forgets registered images
+  void clear();
+  ///\return uint32_t number of images backed by lazily allocated memory
+  [[nodiscard]] uint32_t lazyAttachmentCount() const;
+  ///\return VkDeviceSize size of the shared (committed) memory block
+  [[nodiscard]] VkDeviceSize pooledSize() const;
+
+private:
+  struct Attachment {
+    const Image *image = nullptr;
+    int alias_group = -1;
+  };
+
+  const LogicalDevice *logical_device_ = nullptr;
+  std::vector<Attachment> attachments_;
+  std::vector<std::unique_ptr<DeviceMemory>> dedicated_memory_;
+  std::unique_ptr<DeviceMemory> pool_memory_;
+  uint32_t lazy_count_ = 0;
+  VkDeviceSize pooled_size_ = 0;
+};
+
+} // namespace circe::vk
+
+#endif
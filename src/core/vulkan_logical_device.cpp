@@ -33,11 +33,31 @@ namespace circe {
 
 namespace vk {
 
+namespace {
+
+/// Finds the structure of the given type in a pNext chain
+///\tparam T feature structure type
+///\param chain **[in]** first structure of the chain (may be nullptr)
+///\param type **[in]** sType of T
+///\return const T* nullptr if the chain has no such structure
+template <typename T>
+[[maybe_unused]] const T *findFeatures(const void *chain,
+                                       VkStructureType type) {
+  for (auto *s = reinterpret_cast<const VkBaseInStructure *>(chain); s;
+       s = s->pNext)
+    if (s->sType == type)
+      return reinterpret_cast<const T *>(s);
+  return nullptr;
+}
+
+} // namespace
+
 LogicalDevice::LogicalDevice(
     const PhysicalDevice *physical_device,
     std::vector<char const *> const &desired_extensions,
     VkPhysicalDeviceFeatures *desired_features, QueueFamilies &queue_infos,
-    const std::vector<const char *> &validation_layers)
+    const std::vector<const char *> &validation_layers,
+    const void *features_chain)
     : physical_device_(physical_device) {
   for (auto &extension : desired_extensions)
     if (!physical_device->isExtensionSupported(extension)) {
@@ -58,7 +78,7 @@ LogicalDevice::LogicalDevice(
   };
   VkDeviceCreateInfo device_create_info = {
       VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO, // VkStructureType sType
-      nullptr, // const void                     * pNext
+      features_chain, // const void                     * pNext
       0,       // VkDeviceCreateFlags              flags
       static_cast<uint32_t>(
           queue_create_infos.size()), // uint32_t queueCreateInfoCount
@@ -77,8 +97,78 @@ LogicalDevice::LogicalDevice(
   };
   CHECK_VULKAN(vkCreateDevice(physical_device->handle(), &device_create_info,
                               nullptr, &vk_device_));
-  if (vk_device_ == VK_NULL_HANDLE)
+  if (vk_device_ == VK_NULL_HANDLE) {
     INFO("Could not create logical device.");
+    return;
+  }
+  enabled_extensions_.assign(desired_extensions.begin(),
+                             desired_extensions.end());
+  if (isExtensionEnabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)) {
+    extension_functions_.vkCmdPushDescriptorSetKHR =
+        reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+            procAddress("vkCmdPushDescriptorSetKHR"));
+    extension_functions_.vkCmdPushDescriptorSetWithTemplateKHR =
+        reinterpret_cast<PFN_vkCmdPushDescriptorSetWithTemplateKHR>(
+            procAddress("vkCmdPushDescriptorSetWithTemplateKHR"));
+  }
+  // extended dynamic state commands are only valid when their feature is
+  // enabled, not only the extension
+#ifdef VK_EXT_extended_dynamic_state
+  auto *dynamic_state =
+      findFeatures<VkPhysicalDeviceExtendedDynamicStateFeaturesEXT>(
+          features_chain,
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT);
+  if (dynamic_state && dynamic_state->extendedDynamicState &&
+      isExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)) {
+    auto &f = extension_functions_;
+    f.vkCmdSetCullModeEXT = reinterpret_cast<PFN_vkCmdSetCullModeEXT>(
+        procAddress("vkCmdSetCullModeEXT"));
+    f.vkCmdSetFrontFaceEXT = reinterpret_cast<PFN_vkCmdSetFrontFaceEXT>(
+        procAddress("vkCmdSetFrontFaceEXT"));
+    f.vkCmdSetPrimitiveTopologyEXT =
+        reinterpret_cast<PFN_vkCmdSetPrimitiveTopologyEXT>(
+            procAddress("vkCmdSetPrimitiveTopologyEXT"));
+    f.vkCmdSetDepthTestEnableEXT =
+        reinterpret_cast<PFN_vkCmdSetDepthTestEnableEXT>(
+            procAddress("vkCmdSetDepthTestEnableEXT"));
+    f.vkCmdSetDepthWriteEnableEXT =
+        reinterpret_cast<PFN_vkCmdSetDepthWriteEnableEXT>(
+            procAddress("vkCmdSetDepthWriteEnableEXT"));
+    f.vkCmdSetDepthCompareOpEXT =
+        reinterpret_cast<PFN_vkCmdSetDepthCompareOpEXT>(
+            procAddress("vkCmdSetDepthCompareOpEXT"));
+  }
+#endif
+#ifdef VK_EXT_extended_dynamic_state2
+  auto *dynamic_state2 =
+      findFeatures<VkPhysicalDeviceExtendedDynamicState2FeaturesEXT>(
+          features_chain,
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT);
+  if (dynamic_state2 && dynamic_state2->extendedDynamicState2 &&
+      isExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) {
+    auto &f = extension_functions_;
+    f.vkCmdSetDepthBiasEnableEXT =
+        reinterpret_cast<PFN_vkCmdSetDepthBiasEnableEXT>(
+            procAddress("vkCmdSetDepthBiasEnableEXT"));
+    f.vkCmdSetPrimitiveRestartEnableEXT =
+        reinterpret_cast<PFN_vkCmdSetPrimitiveRestartEnableEXT>(
+            procAddress("vkCmdSetPrimitiveRestartEnableEXT"));
+    f.vkCmdSetRasterizerDiscardEnableEXT =
+        reinterpret_cast<PFN_vkCmdSetRasterizerDiscardEnableEXT>(
+            procAddress("vkCmdSetRasterizerDiscardEnableEXT"));
+  }
+#endif
+#ifdef VK_EXT_extended_dynamic_state3
+  auto *dynamic_state3 =
+      findFeatures<VkPhysicalDeviceExtendedDynamicState3FeaturesEXT>(
+          features_chain,
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT);
+  if (dynamic_state3 && dynamic_state3->extendedDynamicState3PolygonMode &&
+      isExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME))
+    extension_functions_.vkCmdSetPolygonModeEXT =
+        reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
+            procAddress("vkCmdSetPolygonModeEXT"));
+#endif
 
   for (auto &info : queue_infos.families()) {
     for (size_t i = 0; i < info.priorities.size(); ++i) {
@@ -116,6 +206,29 @@ bool LogicalDevice::waitIdle() const {
   return true;
 }
 
+PFN_vkVoidFunction
+LogicalDevice::procAddress(const char *name,
+                           const char *alternative_name) const {
+  if (vk_device_ == VK_NULL_HANDLE)
+    return nullptr;
+  PFN_vkVoidFunction function = vkGetDeviceProcAddr(vk_device_, name);
+  if (!function && alternative_name)
+    function = vkGetDeviceProcAddr(vk_device_, alternative_name);
+  return function;
+}
+
+bool LogicalDevice::isExtensionEnabled(const char *extension) const {
+  for (auto &e : enabled_extensions_)
+    if (e == extension)
+      return true;
+  return false;
+}
+
+const LogicalDevice::ExtensionFunctions &
+LogicalDevice::extensionFunctions() const {
+  return extension_functions_;
+}
+
 } // namespace vk
 
 } // namespace circe
\ No newline at end of file
@@ -86,17 +86,57 @@ private:
 /// creation/destruction.
 class LogicalDevice {
 public:
+  /// Entry points of enabled device extensions, loaded once on creation
+  /// (nullptr when the extension is not enabled).
+  struct ExtensionFunctions {
+    // VK_KHR_push_descriptor
+    PFN_vkCmdPushDescriptorSetKHR vkCmdPushDescriptorSetKHR = nullptr;
+    PFN_vkCmdPushDescriptorSetWithTemplateKHR
+        vkCmdPushDescriptorSetWithTemplateKHR = nullptr;
+    // The extended dynamic state entry points below are loaded only when
+    // the extension is enabled AND its feature bit is set in the
+    // features_chain given to the constructor
+    // (VkPhysicalDeviceExtendedDynamicState{,2,3}FeaturesEXT).
+#ifdef VK_EXT_extended_dynamic_state
+    // VK_EXT_extended_dynamic_state (extendedDynamicState)
+    PFN_vkCmdSetCullModeEXT vkCmdSetCullModeEXT = nullptr;
+    PFN_vkCmdSetFrontFaceEXT vkCmdSetFrontFaceEXT = nullptr;
+    PFN_vkCmdSetPrimitiveTopologyEXT vkCmdSetPrimitiveTopologyEXT = nullptr;
+    PFN_vkCmdSetDepthTestEnableEXT vkCmdSetDepthTestEnableEXT = nullptr;
+    PFN_vkCmdSetDepthWriteEnableEXT vkCmdSetDepthWriteEnableEXT = nullptr;
+    PFN_vkCmdSetDepthCompareOpEXT vkCmdSetDepthCompareOpEXT = nullptr;
+#endif
+#ifdef VK_EXT_extended_dynamic_state2
+    // VK_EXT_extended_dynamic_state2 (extendedDynamicState2)
+    PFN_vkCmdSetDepthBiasEnableEXT vkCmdSetDepthBiasEnableEXT = nullptr;
+    PFN_vkCmdSetPrimitiveRestartEnableEXT vkCmdSetPrimitiveRestartEnableEXT =
+        nullptr;
+    PFN_vkCmdSetRasterizerDiscardEnableEXT
+        vkCmdSetRasterizerDiscardEnableEXT = nullptr;
+#endif
+#ifdef VK_EXT_extended_dynamic_state3
+    // VK_EXT_extended_dynamic_state3 (extendedDynamicState3PolygonMode)
+    PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonModeEXT = nullptr;
+#endif
+  };
   ///\brief Construct a new Logical Device object
   ///\param physical_device **[in]** physical device object
   /// \param desired_extensions **[in]** desired extensions
   /// \param desired_features **[in]** desired features
   /// \param queue_infos **[in]** queues description
+  /// \param validation_layers **[in | optional = {}]**
+  /// \param features_chain **[in | optional = nullptr]** extension feature
+  /// structures (ex: VkPhysicalDeviceDescriptorIndexingFeaturesEXT) chained
+  /// into VkDeviceCreateInfo::pNext. Extended dynamic state commands are only
+  /// loaded if their VkPhysicalDeviceExtendedDynamicState{,2,3}FeaturesEXT
+  /// structure is part of this chain with the feature bit enabled.
   LogicalDevice(const PhysicalDevice *physical_device,
                 std::vector<char const *> const &desired_extensions,
                 VkPhysicalDeviceFeatures *desired_features,
                 QueueFamilies &queue_infos,
                 const std::vector<const char *> &validation_layers =
-                std::vector<const char *>());
+                std::vector<const char *>(),
+                const void *features_chain = nullptr);
   ///\brief Default destructor
   ~LogicalDevice();
   ///\brief
@@ -119,10 +159,25 @@ public:
                             VkMemoryPropertyFlags required_flags,
                             VkMemoryPropertyFlags preferred_flags) const;
   bool waitIdle() const;
+  ///\param extension **[in]** extension name
+  ///\return bool true if the extension was enabled on device creation
+  [[nodiscard]] bool isExtensionEnabled(const char *extension) const;
+  ///\brief Retrieves a device level function that is not exported by the
+  /// loader (ex: extension functions)
+  ///\param name **[in]** function name
+  ///\param alternative_name **[in | optional = nullptr]** tried when **name**
+  /// is not found (ex: the KHR version of a core function)
+  ///\return PFN_vkVoidFunction nullptr if not available
+  [[nodiscard]] PFN_vkVoidFunction
+  procAddress(const char *name, const char *alternative_name = nullptr) const;
+  ///\return const ExtensionFunctions& loaded extension entry points
+  [[nodiscard]] const ExtensionFunctions &extensionFunctions() const;
 
 private:
   const PhysicalDevice *physical_device_{nullptr};
   VkDevice vk_device_{VK_NULL_HANDLE};
+  std::vector<std::string> enabled_extensions_;
+  ExtensionFunctions extension_functions_;
 };
 
 } // namespace vk
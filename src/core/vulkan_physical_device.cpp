@@ -129,31 +129,17 @@ uint32_t PhysicalDevice::chooseMemoryType(
     const VkMemoryRequirements &memory_requirements,
     VkMemoryPropertyFlags required_flags,
     VkMemoryPropertyFlags preferred_flags) const {
-  uint32_t selected_type = ~0u;
-  uint32_t memory_type;
-  for (memory_type = 0; memory_type < vk_memory_properties_.memoryTypeCount;
-       ++memory_type) {
-    if (memory_requirements.memoryTypeBits & (1 << memory_type)) {
-      const VkMemoryType &type = vk_memory_properties_.memoryTypes[memory_type];
-      if ((type.propertyFlags & preferred_flags) == preferred_flags) {
-        selected_type = memory_type;
-        break;
-      }
-    }
-  }
-  if (selected_type != ~0u) {
-    for (memory_type = 0; memory_type < 32; ++memory_type) {
-      if (memory_requirements.memoryTypeBits & (1 << memory_type)) {
+  // preferred flags are only a hint, a type satisfying both is tried first
+  for (auto flags : {required_flags | preferred_flags, required_flags})
+    for (uint32_t memory_type = 0;
+         memory_type < vk_memory_properties_.memoryTypeCount; ++memory_type)
+      if (memory_requirements.memoryTypeBits & (1u << memory_type)) {
         const VkMemoryType &type =
             vk_memory_properties_.memoryTypes[memory_type];
-        if ((type.propertyFlags & required_flags) == required_flags) {
-          selected_type = memory_type;
-          break;
-        }
+        if ((type.propertyFlags & flags) == flags)
+          return memory_type;
       }
-    }
-  }
-  return selected_type;
+  return ~0u;
 }
 
 bool PhysicalDevice::selectPresentationMode(
@@ -276,6 +262,41 @@ const VkPhysicalDeviceProperties &PhysicalDevice::properties() const {
   return vk_properties_;
 }
 
+const VkPhysicalDeviceMemoryProperties &
+PhysicalDevice::memoryProperties() const {
+  return vk_memory_properties_;
+}
+
+bool PhysicalDevice::hasMemoryType(uint32_t memory_type_bits,
+                                   VkMemoryPropertyFlags flags) const {
+  VkMemoryRequirements requirements{};
+  requirements.memoryTypeBits = memory_type_bits;
+  return chooseMemoryType(requirements, flags, 0) != ~0u;
+}
+
+bool PhysicalDevice::memoryBudget(
+    VkInstance instance, std::vector<VkDeviceSize> &heap_budgets,
+    std::vector<VkDeviceSize> &heap_usages) const {
+  if (instance == VK_NULL_HANDLE ||
+      !isExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+    return false;
+  auto get_memory_properties =
+      (PFN_vkGetPhysicalDeviceMemoryProperties2KHR)vkGetInstanceProcAddr(
+          instance, "vkGetPhysicalDeviceMemoryProperties2KHR");
+  if (!get_memory_properties)
+    return false;
+  VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+  budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+  VkPhysicalDeviceMemoryProperties2 properties{};
+  properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+  properties.pNext = &budget;
+  get_memory_properties(vk_device_, &properties);
+  uint32_t heap_count = properties.memoryProperties.memoryHeapCount;
+  heap_budgets.assign(budget.heapBudget, budget.heapBudget + heap_count);
+  heap_usages.assign(budget.heapUsage, budget.heapUsage + heap_count);
+  return true;
+}
+
 const VkPhysicalDeviceFeatures &PhysicalDevice::features() const {
   return vk_features_;
 }
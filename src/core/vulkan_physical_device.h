@@ -104,7 +104,7 @@ public:
   /// resource.
   ///\param required_flags **[in]** hard requirements
   ///\param preferred_flags **[in]** soft requirements
-  ///\return uint32_t memory type
+  ///\return uint32_t memory type (~0u if required flags can't be satisfied)
   [[nodiscard]] uint32_t
   chooseMemoryType(const VkMemoryRequirements &memory_requirements,
                    VkMemoryPropertyFlags required_flags,
@@ -147,6 +147,28 @@ public:
                       VkSurfaceCapabilitiesKHR &surface_capabilities) const;
   [[nodiscard]] const VkPhysicalDeviceProperties &properties() const;
   [[nodiscard]] const VkPhysicalDeviceFeatures &features() const;
+  ///\return const VkPhysicalDeviceMemoryProperties& memory heaps and types
+  [[nodiscard]] const VkPhysicalDeviceMemoryProperties &
+  memoryProperties() const;
+  ///\brief Checks if any of the memory types in **memory_type_bits** has all
+  /// the given property flags (ex: VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+  ///\param memory_type_bits **[in]** acceptable memory types
+  ///\param flags **[in]** required property flags
+  ///\return bool true if such memory type exists
+  [[nodiscard]] bool hasMemoryType(uint32_t memory_type_bits,
+                                   VkMemoryPropertyFlags flags) const;
+  ///\brief Queries the current budget and usage of each memory heap through
+  /// VK_EXT_memory_budget. The instance must have been created with
+  /// VK_KHR_get_physical_device_properties2 enabled (App::setInstance enables
+  /// it when available).
+  ///\param instance **[in]** instance the device was enumerated from
+  ///\param heap_budgets **[out]** bytes each heap can allocate (including
+  /// what is already allocated by this process)
+  ///\param heap_usages **[out]** bytes allocated by this process
+  ///\return bool false if the extension is not available
+  bool memoryBudget(VkInstance instance,
+                    std::vector<VkDeviceSize> &heap_budgets,
+                    std::vector<VkDeviceSize> &heap_usages) const;
   ///\return VkSampleCountFlagBits the highest sample count supported by the
   /// color buffer
   ///\param include_depth_buffer **[in | default = true]** if true, computes the